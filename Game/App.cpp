@@ -1,6 +1,8 @@
 #include "Game/App.hpp"
 #include "Game/Game.hpp"
 #include "Game/GameCommon.hpp"
+#include "Game/JobSystem.hpp"
+#include "Game/Profiler.hpp"
 #include "Engine/Renderer/Renderer.hpp"
 #include "Engine/Input/InputSystem.hpp"
 #include "Engine/Audio/AudioSystem.hpp"
@@ -23,6 +25,8 @@ Window*		 g_theWindow = nullptr;
 
 Game* g_theGame = nullptr;
 
+JobSystem* g_theJobSystem = nullptr;
+
 
 //public game flow functions
 void App::Startup()
@@ -51,6 +55,9 @@ void App::Startup()
 	
 	AudioSystemConfig audioSystemConfig;
 	g_theAudio = new AudioSystem(audioSystemConfig);
+
+	JobSystemConfig jobSystemConfig;
+	g_theJobSystem = new JobSystem(jobSystemConfig);
 	
 	g_theEventSystem->Startup();
 	g_theDevConsole->Startup();
@@ -58,6 +65,7 @@ void App::Startup()
 	g_theWindow->Startup();
 	g_theRenderer->Startup();
 	g_theAudio->Startup();
+	g_theJobSystem->Startup();
 
 	DebugRenderConfig debugRenderConfig;
 	debugRenderConfig.m_renderer = g_theRenderer;
@@ -78,6 +86,24 @@ void App::Startup()
 	g_theGame->Startup();
 
 	SubscribeEventCallbackFunction("quit", Event_Quit);
+	SubscribeEventCallbackFunction("BenchmarkGravity", Game::Event_BenchmarkGravity);
+	SubscribeEventCallbackFunction("BenchmarkGravityKernels", Game::Event_BenchmarkGravityKernels);
+	SubscribeEventCallbackFunction("BenchmarkModels", Game::Event_BenchmarkModels);
+	SubscribeEventCallbackFunction("BenchmarkModelLoading", Game::Event_BenchmarkModelLoading);
+	SubscribeEventCallbackFunction("BenchmarkLevelLoading", Game::Event_BenchmarkLevelLoading);
+	SubscribeEventCallbackFunction("SaveLevel", Game::Event_SaveLevel);
+	SubscribeEventCallbackFunction("LoadLevel", Game::Event_LoadLevel);
+	SubscribeEventCallbackFunction("StreamLevel", Game::Event_StreamLevel);
+	SubscribeEventCallbackFunction("PrefabQueryMode", Game::Event_PrefabQueryMode);
+	SubscribeEventCallbackFunction("GravityFieldStore", Game::Event_GravityFieldStore);
+	SubscribeEventCallbackFunction("SpawnBodies", Game::Event_SpawnBodies);
+	SubscribeEventCallbackFunction("BenchmarkBodies", Game::Event_BenchmarkBodies);
+	SubscribeEventCallbackFunction("BenchmarkJobs", Game::Event_BenchmarkJobs);
+	SubscribeEventCallbackFunction("JobThreads", Game::Event_JobThreads);
+	SubscribeEventCallbackFunction("PhysicsRate", Game::Event_PhysicsRate);
+	SubscribeEventCallbackFunction("RecordInput", Game::Event_RecordInput);
+	SubscribeEventCallbackFunction("ReplayInput", Game::Event_ReplayInput);
+	SubscribeEventCallbackFunction("ProfilerDump", Game::Event_ProfilerDump);
 
 	m_devConsoleCamera.SetOrthoView(Vec2(0.f, 0.f), Vec2(SCREEN_CAMERA_SIZE_X, SCREEN_CAMERA_SIZE_Y));
 
@@ -96,8 +122,29 @@ void App::Startup()
 	g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MINOR, " F6: Toggle Lighting Menu");
 	g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MINOR, " F7: Enter Free-Fly Mode");
 	g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MINOR, " F8: Restart Game");
+	g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MINOR, " F9: Toggle Profiler");
 	g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MINOR, " ~: Open Dev Console");
 	g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MINOR, " Escape: Exit Game");
+
+	g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MAJOR, "Commands: ");
+	g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MINOR, " BenchmarkGravity: Time gravity field broad phase against a linear scan");
+	g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MINOR, " BenchmarkGravityKernels: Time batched sphere and capsule field kernels and check them against scalar code");
+	g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MINOR, " BenchmarkModels: Time model triangle bvh against a brute force loop");
+	g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MINOR, " BenchmarkModelLoading loads=5: Time prefab loads from obj against the binary mesh cache");
+	g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MINOR, " BenchmarkLevelLoading count=10000: Time loading a level of that many planetoids from the binary and xml level files");
+	g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MINOR, " SaveLevel file=Data/Levels/Sandbox.gflevel: Save the planetoids, checkpoints and signs, a .xml file is written readable");
+	g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MINOR, " LoadLevel file=Data/Levels/Sandbox.gflevel: Replace the planetoids and checkpoints with a saved level's");
+	g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MINOR, " StreamLevel file=Data/Levels/Sandbox.gflevel cellSize=250 loadRadius=600 unloadRadius=800 budgetMB=256: Load a level's planetoids only near the player, no file stops");
+	g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MINOR, " PrefabQueryMode mode=exact|grid|hybrid prefab=all|teapot|skystation|mountain|fortress cellSize=1.0");
+	g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MINOR, " GravityFieldStore enabled=true|false: Evaluate gravity with per type field loops instead of the bvh");
+	g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MINOR, " SpawnBodies count=1000 spread=50: Drop gravity bodies around the player, count=0 clears them");
+	g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MINOR, " BenchmarkBodies: Time gravity for 1k, 10k and 100k bodies through the field store");
+	g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MINOR, " BenchmarkJobs count=100000: Time body gravity and collision on 1 to all job threads");
+	g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MINOR, " JobThreads count=N: Limit how many threads the job system uses");
+	g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MINOR, " PhysicsRate hz=120 fixed=true|false: Set the physics step rate, fixed=false steps once per frame");
+	g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MINOR, " RecordInput file=Data/Recordings/Input.gfir: Start recording player input each physics step, run again to stop and save");
+	g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MINOR, " ReplayInput file=Data/Recordings/Input.gfir headless=true|false: Replay a recording and check the player against it every tick");
+	g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MINOR, " ProfilerDump file=Data/Exported/Trace.json: Write the profiled scopes still in memory as a chrome trace");
 }
 
 
@@ -105,7 +152,9 @@ void App::Run()
 {
 	while (!IsQuitting())
 	{
+		ProfilerBeginFrame();
 		RunFrame();
+		ProfilerEndFrame();
 	}
 }
 
@@ -123,6 +172,10 @@ void App::Shutdown()
 
 	DebugRenderSystemShutdown();
 
+	g_theJobSystem->Shutdown();
+	delete g_theJobSystem;
+	g_theJobSystem = nullptr;
+
 	g_theAudio->Shutdown();
 	delete g_theAudio;
 	g_theAudio = nullptr;
@@ -151,6 +204,8 @@ void App::Shutdown()
 
 void App::RunFrame()
 {
+	PROFILE_SCOPE("App::RunFrame");
+
 	//tick the system clock
 	Clock::TickSystemClock();
 
@@ -224,7 +279,7 @@ void App::Update()
 	}
 
 	//set mouse state based on game
-	if (!g_theDevConsole->IsOpen() && Window::GetWindowContext()->HasFocus() && !g_theGame->m_isSandboxMode && !g_theGame->m_lightingMenuOpen)
+	if (!g_theDevConsole->IsOpen() && Window::GetWindowContext()->HasFocus() && !g_theGame->m_isSandboxMode && !g_theGame->m_lightingMenuOpen && !g_theGame->m_profilerMenuOpen)
 	{
 		g_theInput->SetCursorMode(true, true);
 	}
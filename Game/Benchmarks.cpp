@@ -0,0 +1,817 @@
+#include "Game/Benchmarks.hpp"
+#include "Game/BoundingVolumeHierarchy.hpp"
+#include "Game/GravityFieldStore.hpp"
+#include "Game/GravityFieldKernels.hpp"
+#include "Game/JobSystem.hpp"
+#include "Game/Simulation.hpp"
+#include "Game/Game.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/GravityFields.hpp"
+#include "Game/Planetoids.hpp"
+#include "Game/Player.hpp"
+#include "Game/Model.hpp"
+#include "Game/ModelMeshCache.hpp"
+#include "Game/LevelFile.hpp"
+#include "Game/PlaytestCourse.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
+#include "Engine/Renderer/CPUMesh.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <string.h>
+
+
+//planetoid with a field but no mesh, so benchmarks can spawn tens of thousands of them
+class BenchmarkPLTD : public Planetoid
+{
+//public member functions
+public:
+	//constructor
+	BenchmarkPLTD(Vec3 position, float radius, Vec3 boneEnd, float gravityRadius) : Planetoid(position), m_radius(radius), m_boneEnd(boneEnd)
+	{
+		if (m_boneEnd == m_position) m_field = new SphereField(this, gravityRadius);
+		else						 m_field = new CapsuleField(this, gravityRadius, m_position, m_boneEnd);
+	}
+
+	//game flow functions
+	virtual void Render() const override {}
+
+	//planetoid utilities
+	virtual bool CollideWithPlayer(Player* player, std::vector<int>& nearbyScratch) override
+	{
+		UNUSED(nearbyScratch);
+		return PushSphereOutOfFixedCapsule3D(player->m_position, player->m_collisionRadius, m_position, m_boneEnd, m_radius);
+	}
+
+	virtual Vec3 GetNearestPointOnPlanetoid(Vec3 playerPos) const override
+	{
+		return GetNearestPointOnCapsule3D(playerPos, m_position, m_boneEnd, m_radius);
+	}
+
+	virtual AABB3 CalculateWorldBounds() const override
+	{
+		return BoundingVolumeHierarchy::GetBoundsOfCapsule3D(m_position, m_boneEnd, m_radius);
+	}
+
+//public member variables
+public:
+	float m_radius = 1.0f;
+	Vec3  m_boneEnd = Vec3();
+};
+
+
+//procedural shapes with real meshes spread through a cube, so a level made of them can be saved and loaded like a built one
+//prefabs are left out, they'd mostly be timing their model loads
+static void SpawnBenchmarkLevel(RandomNumberGenerator& rng, int numPlanetoids, float worldHalfSize, PlaytestCourse& out_level)
+{
+	out_level.m_planetoids.reserve(out_level.m_planetoids.size() + numPlanetoids);
+	for (int pltdIndex = 0; pltdIndex < numPlanetoids; pltdIndex++)
+	{
+		Vec3 position = Vec3(rng.RollRandomFloatInRange(-worldHalfSize, worldHalfSize), rng.RollRandomFloatInRange(-worldHalfSize, worldHalfSize),
+			rng.RollRandomFloatInRange(-worldHalfSize, worldHalfSize));
+		EulerAngles orientation = EulerAngles(rng.RollRandomFloatInRange(0.0f, 360.0f), rng.RollRandomFloatInRange(-90.0f, 90.0f), rng.RollRandomFloatInRange(0.0f, 360.0f));
+		Rgba8 color = Rgba8(static_cast<unsigned char>(rng.RollRandomIntInRange(0, 255)), static_cast<unsigned char>(rng.RollRandomIntInRange(0, 255)),
+			static_cast<unsigned char>(rng.RollRandomIntInRange(0, 255)));
+		float size = rng.RollRandomFloatInRange(3.0f, 20.0f);
+
+		Planetoid* planetoid = nullptr;
+		switch (pltdIndex % 4)
+		{
+			case 0:	 planetoid = new SpherePLTD(position, size, true, size + 10.0f, GRAVITY_STANDARD, color); break;
+			case 1:	 planetoid = new CapsulePLTD(position, size * 0.5f, size, orientation.GetAsMatrix_XFwd_YLeft_ZUp().GetIBasis3D(), true, size + 5.0f, GRAVITY_STANDARD, color); break;
+			case 2:	 planetoid = new RoundCubePLTD(position, size, size, size, 0.5f, orientation, true, size + 10.0f, size + 10.0f, size + 10.0f, GRAVITY_STANDARD, color); break;
+			default: planetoid = new TorusPLTD(position, size * 0.25f, size, orientation, true, 5.0f, GRAVITY_STANDARD, color); break;
+		}
+		planetoid->UpdateWorldBounds();
+		out_level.m_planetoids.emplace_back(planetoid);
+	}
+}
+
+
+static void DeleteBenchmarkLevel(PlaytestCourse& level)
+{
+	for (int pltdIndex = 0; pltdIndex < level.m_planetoids.size(); pltdIndex++)
+	{
+		delete level.m_planetoids[pltdIndex];
+	}
+	level.m_planetoids.clear();
+}
+
+
+//times reading one level file numLoads times, planetoids included, and returns the seconds per load
+static double TimeLevelLoads(std::string const& filePath, int numLoads, int& out_numPlanetoidsLoaded)
+{
+	out_numPlanetoidsLoaded = 0;
+	double startTime = GetCurrentTimeSeconds();
+	for (int loadIndex = 0; loadIndex < numLoads; loadIndex++)
+	{
+		PlaytestCourse level;
+		ReadLevelFile(level, filePath);
+		out_numPlanetoidsLoaded = static_cast<int>(level.m_planetoids.size());
+		DeleteBenchmarkLevel(level);
+	}
+	return (GetCurrentTimeSeconds() - startTime) / static_cast<double>(numLoads);
+}
+
+
+//half spheres and half capsules spread through a cube, the same mix RunGravityFieldBenchmark uses
+static void SpawnBenchmarkPlanetoids(RandomNumberGenerator& rng, int numPlanetoids, float worldHalfSize, std::vector<Planetoid*>& out_planetoids)
+{
+	out_planetoids.reserve(out_planetoids.size() + numPlanetoids);
+	for (int pltdIndex = 0; pltdIndex < numPlanetoids; pltdIndex++)
+	{
+		Vec3 position = Vec3(rng.RollRandomFloatInRange(-worldHalfSize, worldHalfSize), rng.RollRandomFloatInRange(-worldHalfSize, worldHalfSize),
+			rng.RollRandomFloatInRange(-worldHalfSize, worldHalfSize));
+		float radius = rng.RollRandomFloatInRange(3.0f, 20.0f);
+		Vec3 boneEnd = position;
+		if (pltdIndex % 2 == 1)
+		{
+			boneEnd += Vec3(rng.RollRandomFloatInRange(-10.0f, 10.0f), rng.RollRandomFloatInRange(-10.0f, 10.0f), rng.RollRandomFloatInRange(-10.0f, 10.0f));
+		}
+
+		out_planetoids.emplace_back(new BenchmarkPLTD(position, radius, boneEnd, radius + rng.RollRandomFloatInRange(5.0f, 15.0f)));
+	}
+}
+
+
+//
+//benchmark functions
+//
+void RunGravityFieldBenchmark(int numPlanetoids, int numQueries)
+{
+	RandomNumberGenerator rng;
+	rng.SeedRNG(numPlanetoids);
+
+	//grow the world with the planetoid count so density stays the same, like a bigger level rather than a more crowded one
+	float worldHalfSize = 250.0f * cbrtf(static_cast<float>(numPlanetoids) / 100.0f);
+
+	//half spheres and half capsules
+	std::vector<Planetoid*> planetoids;
+	std::vector<AABB3> fieldBounds;
+	planetoids.reserve(numPlanetoids);
+	fieldBounds.reserve(numPlanetoids);
+	for (int pltdIndex = 0; pltdIndex < numPlanetoids; pltdIndex++)
+	{
+		Vec3 position = Vec3(rng.RollRandomFloatInRange(-worldHalfSize, worldHalfSize), rng.RollRandomFloatInRange(-worldHalfSize, worldHalfSize),
+			rng.RollRandomFloatInRange(-worldHalfSize, worldHalfSize));
+		float radius = rng.RollRandomFloatInRange(3.0f, 20.0f);
+		Vec3 boneEnd = position;
+		if (pltdIndex % 2 == 1)
+		{
+			boneEnd += Vec3(rng.RollRandomFloatInRange(-10.0f, 10.0f), rng.RollRandomFloatInRange(-10.0f, 10.0f), rng.RollRandomFloatInRange(-10.0f, 10.0f));
+		}
+
+		BenchmarkPLTD* pltd = new BenchmarkPLTD(position, radius, boneEnd, radius + rng.RollRandomFloatInRange(5.0f, 15.0f));
+		planetoids.emplace_back(pltd);
+		fieldBounds.emplace_back(pltd->m_field->GetWorldBounds());
+	}
+
+	std::vector<Vec3> queryPositions;
+	queryPositions.reserve(numQueries);
+	for (int queryIndex = 0; queryIndex < numQueries; queryIndex++)
+	{
+		queryPositions.emplace_back(Vec3(rng.RollRandomFloatInRange(-worldHalfSize, worldHalfSize), rng.RollRandomFloatInRange(-worldHalfSize, worldHalfSize),
+			rng.RollRandomFloatInRange(-worldHalfSize, worldHalfSize)));
+	}
+
+	Player player = Player(nullptr);
+
+	//linear scan, same as the original Game::ApplyGravity
+	std::vector<GravityField const*> linearResults;
+	linearResults.reserve(numQueries);
+	double linearStartTime = GetCurrentTimeSeconds();
+	for (int queryIndex = 0; queryIndex < numQueries; queryIndex++)
+	{
+		player.m_position = queryPositions[queryIndex];
+		player.m_currentGravitySource = nullptr;
+		for (int pltdIndex = 0; pltdIndex < numPlanetoids; pltdIndex++)
+		{
+			planetoids[pltdIndex]->m_field->ApplyGravity(&player);
+		}
+		linearResults.emplace_back(player.m_currentGravitySource);
+	}
+	double linearSeconds = GetCurrentTimeSeconds() - linearStartTime;
+
+	//bvh build
+	double buildStartTime = GetCurrentTimeSeconds();
+	BoundingVolumeHierarchy bvh;
+	bvh.Build(fieldBounds);
+	double buildSeconds = GetCurrentTimeSeconds() - buildStartTime;
+
+	//bvh query, candidates visited in spawn order so the chosen source matches the linear scan
+	std::vector<int> candidates;
+	int numCandidates = 0;
+	int numMismatches = 0;
+	double bvhStartTime = GetCurrentTimeSeconds();
+	for (int queryIndex = 0; queryIndex < numQueries; queryIndex++)
+	{
+		player.m_position = queryPositions[queryIndex];
+		player.m_currentGravitySource = nullptr;
+
+		candidates.clear();
+		bvh.QuerySphere(player.m_position, player.m_collisionRadius, candidates);
+		std::sort(candidates.begin(), candidates.end());
+		for (int candidateIndex = 0; candidateIndex < static_cast<int>(candidates.size()); candidateIndex++)
+		{
+			planetoids[candidates[candidateIndex]]->m_field->ApplyGravity(&player);
+		}
+
+		numCandidates += static_cast<int>(candidates.size());
+		if (player.m_currentGravitySource != linearResults[queryIndex])
+		{
+			numMismatches++;
+		}
+	}
+	double bvhSeconds = GetCurrentTimeSeconds() - bvhStartTime;
+
+	//field store, every field scanned by per type loops instead of a virtual call each
+	double storeBuildStartTime = GetCurrentTimeSeconds();
+	GravityFieldStore store;
+	store.Build(planetoids);
+	double storeBuildSeconds = GetCurrentTimeSeconds() - storeBuildStartTime;
+
+	int numStoreMismatches = 0;
+	double storeStartTime = GetCurrentTimeSeconds();
+	for (int queryIndex = 0; queryIndex < numQueries; queryIndex++)
+	{
+		player.m_position = queryPositions[queryIndex];
+		player.m_currentGravitySource = nullptr;
+		store.ApplyGravity(&player);
+
+		if (player.m_currentGravitySource != linearResults[queryIndex])
+		{
+			numStoreMismatches++;
+		}
+	}
+	double storeSeconds = GetCurrentTimeSeconds() - storeStartTime;
+
+	double linearMsPerQuery = (linearSeconds * 1000.0) / static_cast<double>(numQueries);
+	double bvhMsPerQuery = (bvhSeconds * 1000.0) / static_cast<double>(numQueries);
+	double speedup = (bvhSeconds > 0.0) ? linearSeconds / bvhSeconds : 0.0;
+	float candidatesPerQuery = static_cast<float>(numCandidates) / static_cast<float>(numQueries);
+
+	g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MINOR, Stringf(" %i planetoids: linear %.4f ms/query, bvh %.4f ms/query (%.1fx), build %.2f ms", numPlanetoids, linearMsPerQuery,
+		bvhMsPerQuery, speedup, buildSeconds * 1000.0));
+	g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MINOR, Stringf("   %.2f candidates/query, %i mismatched gravity sources", candidatesPerQuery, numMismatches));
+
+	double storeMsPerQuery = (storeSeconds * 1000.0) / static_cast<double>(numQueries);
+	double storeSpeedup = (storeSeconds > 0.0) ? linearSeconds / storeSeconds : 0.0;
+	g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MINOR, Stringf("   field store %.4f ms/query (%.1fx over linear), build %.2f ms, %i mismatched gravity sources", storeMsPerQuery,
+		storeSpeedup, storeBuildSeconds * 1000.0, numStoreMismatches));
+
+	for (int pltdIndex = 0; pltdIndex < numPlanetoids; pltdIndex++)
+	{
+		delete planetoids[pltdIndex];
+	}
+}
+
+
+void RunGravityKernelBenchmark(int numFields, int numQueries)
+{
+	RandomNumberGenerator rng;
+	rng.SeedRNG(numFields);
+
+	float worldHalfSize = 250.0f * cbrtf(static_cast<float>(numFields) / 100.0f);
+
+	//buffers are filled directly, the kernels don't need planetoids behind them
+	SphereFieldBuffers spheres;
+	CapsuleFieldBuffers capsules;
+	for (int fieldIndex = 0; fieldIndex < numFields; fieldIndex++)
+	{
+		Vec3 center = Vec3(rng.RollRandomFloatInRange(-worldHalfSize, worldHalfSize), rng.RollRandomFloatInRange(-worldHalfSize, worldHalfSize),
+			rng.RollRandomFloatInRange(-worldHalfSize, worldHalfSize));
+		Vec3 boneEnd = center + Vec3(rng.RollRandomFloatInRange(-10.0f, 10.0f), rng.RollRandomFloatInRange(-10.0f, 10.0f), rng.RollRandomFloatInRange(-10.0f, 10.0f));
+		float radius = rng.RollRandomFloatInRange(8.0f, 35.0f);
+
+		spheres.m_centerX.emplace_back(center.x);
+		spheres.m_centerY.emplace_back(center.y);
+		spheres.m_centerZ.emplace_back(center.z);
+		spheres.m_radius.emplace_back(radius);
+		spheres.m_force.emplace_back(GRAVITY_STANDARD);
+		spheres.m_fieldIndex.emplace_back(fieldIndex);
+
+		capsules.m_startX.emplace_back(center.x);
+		capsules.m_startY.emplace_back(center.y);
+		capsules.m_startZ.emplace_back(center.z);
+		capsules.m_endX.emplace_back(boneEnd.x);
+		capsules.m_endY.emplace_back(boneEnd.y);
+		capsules.m_endZ.emplace_back(boneEnd.z);
+		capsules.m_radius.emplace_back(radius);
+		capsules.m_force.emplace_back(GRAVITY_STANDARD);
+		capsules.m_fieldIndex.emplace_back(fieldIndex);
+	}
+
+	std::vector<Vec3> queryPositions;
+	queryPositions.reserve(numQueries);
+	for (int queryIndex = 0; queryIndex < numQueries; queryIndex++)
+	{
+		queryPositions.emplace_back(Vec3(rng.RollRandomFloatInRange(-worldHalfSize, worldHalfSize), rng.RollRandomFloatInRange(-worldHalfSize, worldHalfSize),
+			rng.RollRandomFloatInRange(-worldHalfSize, worldHalfSize)));
+	}
+
+	//each pass xors the overlap masks together so the compiler can't drop the kernel calls
+	float const collisionRadius = 0.5f;
+	Vec3 gravityVectors[GRAVITY_KERNEL_BATCH_WIDTH];
+	int scalarChecksum = 0;
+	double scalarStartTime = GetCurrentTimeSeconds();
+	for (int queryIndex = 0; queryIndex < numQueries; queryIndex++)
+	{
+		for (int firstField = 0; firstField < numFields; firstField += GRAVITY_KERNEL_BATCH_WIDTH)
+		{
+			scalarChecksum ^= EvaluateSphereFieldBatchScalar(spheres, firstField, queryPositions[queryIndex], collisionRadius, gravityVectors);
+			scalarChecksum ^= EvaluateCapsuleFieldBatchScalar(capsules, firstField, queryPositions[queryIndex], collisionRadius, gravityVectors);
+		}
+	}
+	double scalarSeconds = GetCurrentTimeSeconds() - scalarStartTime;
+
+	int batchChecksum = 0;
+	double batchStartTime = GetCurrentTimeSeconds();
+	for (int queryIndex = 0; queryIndex < numQueries; queryIndex++)
+	{
+		for (int firstField = 0; firstField < numFields; firstField += GRAVITY_KERNEL_BATCH_WIDTH)
+		{
+			batchChecksum ^= EvaluateSphereFieldBatch(spheres, firstField, queryPositions[queryIndex], collisionRadius, gravityVectors);
+			batchChecksum ^= EvaluateCapsuleFieldBatch(capsules, firstField, queryPositions[queryIndex], collisionRadius, gravityVectors);
+		}
+	}
+	double batchSeconds = GetCurrentTimeSeconds() - batchStartTime;
+
+	//agreement check, every mask and every gravity vector has to match the scalar kernel bit for bit
+	int numOverlaps = 0;
+	int numMismatches = (scalarChecksum != batchChecksum) ? 1 : 0;
+	for (int queryIndex = 0; queryIndex < numQueries; queryIndex++)
+	{
+		for (int firstField = 0; firstField < numFields; firstField += GRAVITY_KERNEL_BATCH_WIDTH)
+		{
+			Vec3 scalarVectors[GRAVITY_KERNEL_BATCH_WIDTH];
+			Vec3 batchVectors[GRAVITY_KERNEL_BATCH_WIDTH];
+			for (int fieldType = 0; fieldType < 2; fieldType++)
+			{
+				int scalarMask = 0;
+				int batchMask = 0;
+				if (fieldType == 0)
+				{
+					scalarMask = EvaluateSphereFieldBatchScalar(spheres, firstField, queryPositions[queryIndex], collisionRadius, scalarVectors);
+					batchMask = EvaluateSphereFieldBatch(spheres, firstField, queryPositions[queryIndex], collisionRadius, batchVectors);
+				}
+				else
+				{
+					scalarMask = EvaluateCapsuleFieldBatchScalar(capsules, firstField, queryPositions[queryIndex], collisionRadius, scalarVectors);
+					batchMask = EvaluateCapsuleFieldBatch(capsules, firstField, queryPositions[queryIndex], collisionRadius, batchVectors);
+				}
+
+				if (scalarMask != batchMask)
+				{
+					numMismatches++;
+					continue;
+				}
+
+				for (int laneIndex = 0; laneIndex < GRAVITY_KERNEL_BATCH_WIDTH; laneIndex++)
+				{
+					if ((scalarMask & (1 << laneIndex)) == 0)
+					{
+						continue;
+					}
+
+					numOverlaps++;
+					if (memcmp(&scalarVectors[laneIndex], &batchVectors[laneIndex], sizeof(Vec3)) != 0)
+					{
+						numMismatches++;
+					}
+				}
+			}
+		}
+	}
+
+	double scalarMsPerQuery = (scalarSeconds * 1000.0) / static_cast<double>(numQueries);
+	double batchMsPerQuery = (batchSeconds * 1000.0) / static_cast<double>(numQueries);
+	double speedup = (batchSeconds > 0.0) ? scalarSeconds / batchSeconds : 0.0;
+
+	g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MINOR, Stringf(" %i spheres + %i capsules: scalar %.4f ms/query, %s %.4f ms/query (%.1fx)", numFields, numFields, scalarMsPerQuery,
+		GRAVITY_KERNELS_USE_SSE ? "sse" : "scalar fallback", batchMsPerQuery, speedup));
+	g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MINOR, Stringf("   %i overlaps checked, %i differ from the scalar kernel", numOverlaps, numMismatches));
+}
+
+
+void RunGravityBodyBenchmark(int numBodies, int numPlanetoids)
+{
+	RandomNumberGenerator rng;
+	rng.SeedRNG(numBodies);
+
+	float worldHalfSize = 250.0f * cbrtf(static_cast<float>(numPlanetoids) / 100.0f);
+
+	std::vector<Planetoid*> planetoids;
+	SpawnBenchmarkPlanetoids(rng, numPlanetoids, worldHalfSize, planetoids);
+
+	GravityFieldStore store;
+	store.Build(planetoids);
+
+	std::vector<Vec3> positions;
+	std::vector<float> collisionRadii;
+	std::vector<GravityBodyState> states;
+	positions.reserve(numBodies);
+	collisionRadii.reserve(numBodies);
+	states.resize(numBodies);
+	for (int bodyIndex = 0; bodyIndex < numBodies; bodyIndex++)
+	{
+		positions.emplace_back(Vec3(rng.RollRandomFloatInRange(-worldHalfSize, worldHalfSize), rng.RollRandomFloatInRange(-worldHalfSize, worldHalfSize),
+			rng.RollRandomFloatInRange(-worldHalfSize, worldHalfSize)));
+		collisionRadii.emplace_back(0.25f);
+	}
+
+	double bodyStartTime = GetCurrentTimeSeconds();
+	store.ApplyGravityToBodies(positions.data(), collisionRadii.data(), numBodies, states.data());
+	double bodySeconds = GetCurrentTimeSeconds() - bodyStartTime;
+
+	//every body has to end up under the same source as a player standing in its place
+	Player player = Player(nullptr);
+	int numWithSource = 0;
+	int numMismatches = 0;
+	for (int bodyIndex = 0; bodyIndex < numBodies; bodyIndex++)
+	{
+		player.m_position = positions[bodyIndex];
+		player.m_collisionRadius = collisionRadii[bodyIndex];
+		player.m_currentGravitySource = nullptr;
+		store.ApplyGravity(&player);
+
+		if (states[bodyIndex].m_gravitySource != nullptr)
+		{
+			numWithSource++;
+		}
+
+		if (player.m_currentGravitySource != states[bodyIndex].m_gravitySource)
+		{
+			numMismatches++;
+		}
+	}
+
+	double bodiesPerSecond = (bodySeconds > 0.0) ? static_cast<double>(numBodies) / bodySeconds : 0.0;
+	g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MINOR, Stringf(" %i bodies: %.3f ms, %.2f million bodies/s, %i under a field, %i mismatched gravity sources", numBodies,
+		bodySeconds * 1000.0, bodiesPerSecond / 1000000.0, numWithSource, numMismatches));
+
+	for (int pltdIndex = 0; pltdIndex < numPlanetoids; pltdIndex++)
+	{
+		delete planetoids[pltdIndex];
+	}
+}
+
+
+void RunJobScalingBenchmark(int numBodies, int numPlanetoids)
+{
+	if (g_theJobSystem == nullptr)
+	{
+		return;
+	}
+
+	RandomNumberGenerator rng;
+	rng.SeedRNG(numBodies);
+
+	float worldHalfSize = 250.0f * cbrtf(static_cast<float>(numPlanetoids) / 100.0f);
+
+	std::vector<Planetoid*> planetoids;
+	SpawnBenchmarkPlanetoids(rng, numPlanetoids, worldHalfSize, planetoids);
+
+	GravityFieldStore store;
+	store.Build(planetoids);
+
+	std::vector<AABB3> planetoidBounds;
+	for (int pltdIndex = 0; pltdIndex < numPlanetoids; pltdIndex++)
+	{
+		planetoidBounds.emplace_back(planetoids[pltdIndex]->CalculateWorldBounds());
+	}
+	BoundingVolumeHierarchy planetoidBVH;
+	planetoidBVH.Build(planetoidBounds);
+
+	std::vector<Vec3> startPositions;
+	std::vector<float> collisionRadii;
+	startPositions.reserve(numBodies);
+	collisionRadii.reserve(numBodies);
+	for (int bodyIndex = 0; bodyIndex < numBodies; bodyIndex++)
+	{
+		startPositions.emplace_back(Vec3(rng.RollRandomFloatInRange(-worldHalfSize, worldHalfSize), rng.RollRandomFloatInRange(-worldHalfSize, worldHalfSize),
+			rng.RollRandomFloatInRange(-worldHalfSize, worldHalfSize)));
+		collisionRadii.emplace_back(0.25f);
+	}
+
+	int numThreads = g_theJobSystem->GetNumThreads();
+	int previousNumActiveThreads = g_theJobSystem->GetNumActiveThreads();
+	std::vector<GravityBodyScratch> scratch;
+	scratch.resize(numThreads);
+	for (int threadIndex = 0; threadIndex < numThreads; threadIndex++)
+	{
+		scratch[threadIndex].m_standInPlayer = new Player(nullptr);
+	}
+
+	//one step of gravity then collision per body, the same work Game::StepGravityBodies does
+	std::vector<Vec3> positions;
+	std::vector<GravityBodyState> states;
+	auto stepBodies = [&](int firstBody, int numBodiesInChunk, int threadIndex)
+	{
+		GravityBodyScratch& threadScratch = scratch[threadIndex];
+		Player& bodyPlayer = *threadScratch.m_standInPlayer;
+		for (int bodyIndex = firstBody; bodyIndex < firstBody + numBodiesInChunk; bodyIndex++)
+		{
+			store.ApplyGravityToBody(positions[bodyIndex], collisionRadii[bodyIndex], states[bodyIndex], bodyPlayer, threadScratch.m_hits);
+
+			float radius = collisionRadii[bodyIndex];
+			Vec3 radiusVector = Vec3(radius, radius, radius);
+			threadScratch.m_collisionCandidates.clear();
+			planetoidBVH.QueryAABB(AABB3(positions[bodyIndex] - radiusVector, positions[bodyIndex] + radiusVector), threadScratch.m_collisionCandidates);
+			std::sort(threadScratch.m_collisionCandidates.begin(), threadScratch.m_collisionCandidates.end());
+
+			bodyPlayer.m_position = positions[bodyIndex];
+			bodyPlayer.m_collisionRadius = radius;
+			for (int candidateIndex = 0; candidateIndex < static_cast<int>(threadScratch.m_collisionCandidates.size()); candidateIndex++)
+			{
+				planetoids[threadScratch.m_collisionCandidates[candidateIndex]]->CollideWithPlayer(&bodyPlayer, threadScratch.m_nearbyItems);
+			}
+			positions[bodyIndex] = bodyPlayer.m_position;
+		}
+	};
+
+	std::vector<Vec3> singleThreadPositions;
+	std::vector<GravityBodyState> singleThreadStates;
+	double singleThreadSeconds = 0.0;
+	for (int numActiveThreads = 1; numActiveThreads <= numThreads; numActiveThreads++)
+	{
+		positions = startPositions;
+		states.assign(numBodies, GravityBodyState());
+		g_theJobSystem->SetNumActiveThreads(numActiveThreads);
+
+		double startTime = GetCurrentTimeSeconds();
+		g_theJobSystem->ParallelFor(numBodies, GRAVITY_BODIES_PER_JOB, stepBodies);
+		double seconds = GetCurrentTimeSeconds() - startTime;
+
+		//results can't depend on how chunks were split up, so every run has to match the single thread one exactly
+		int numMismatches = 0;
+		if (numActiveThreads == 1)
+		{
+			singleThreadPositions = positions;
+			singleThreadStates = states;
+			singleThreadSeconds = seconds;
+		}
+		else
+		{
+			for (int bodyIndex = 0; bodyIndex < numBodies; bodyIndex++)
+			{
+				if (memcmp(&positions[bodyIndex], &singleThreadPositions[bodyIndex], sizeof(Vec3)) != 0 ||
+					states[bodyIndex].m_gravitySource != singleThreadStates[bodyIndex].m_gravitySource ||
+					memcmp(&states[bodyIndex].m_gravityVector, &singleThreadStates[bodyIndex].m_gravityVector, sizeof(Vec3)) != 0)
+				{
+					numMismatches++;
+				}
+			}
+		}
+
+		double speedup = (seconds > 0.0) ? singleThreadSeconds / seconds : 0.0;
+		g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MINOR, Stringf(" %i threads: %.3f ms (%.2fx), %i bodies differ from 1 thread", numActiveThreads, seconds * 1000.0, speedup,
+			numMismatches));
+	}
+
+	g_theJobSystem->SetNumActiveThreads(previousNumActiveThreads);
+
+	for (int threadIndex = 0; threadIndex < numThreads; threadIndex++)
+	{
+		delete scratch[threadIndex].m_standInPlayer;
+	}
+
+	for (int pltdIndex = 0; pltdIndex < numPlanetoids; pltdIndex++)
+	{
+		delete planetoids[pltdIndex];
+	}
+}
+
+
+void RunModelBenchmark(std::string const& xmlFilePath, int numQueries)
+{
+	Model model(Vec3(), 1.0f, EulerAngles(), Rgba8());
+	if (!model.ParseXMLFileForOBJ(xmlFilePath))
+	{
+		return;
+	}
+
+	RandomNumberGenerator rng;
+	rng.SeedRNG(numQueries);
+
+	//nearest point queries from anywhere in and around the model
+	Vec3 boundsPadding = (model.m_asset->m_localBounds.m_maxs - model.m_asset->m_localBounds.m_mins) * 0.25f;
+	Vec3 queryMins = model.m_asset->m_localBounds.m_mins - boundsPadding;
+	Vec3 queryMaxs = model.m_asset->m_localBounds.m_maxs + boundsPadding;
+	std::vector<Vec3> queryPositions;
+	queryPositions.reserve(numQueries);
+	for (int queryIndex = 0; queryIndex < numQueries; queryIndex++)
+	{
+		queryPositions.emplace_back(Vec3(rng.RollRandomFloatInRange(queryMins.x, queryMaxs.x), rng.RollRandomFloatInRange(queryMins.y, queryMaxs.y),
+			rng.RollRandomFloatInRange(queryMins.z, queryMaxs.z)));
+	}
+
+	std::vector<Vec3> bruteForceNearestPoints;
+	bruteForceNearestPoints.reserve(numQueries);
+	double bruteForceNearestStartTime = GetCurrentTimeSeconds();
+	for (int queryIndex = 0; queryIndex < numQueries; queryIndex++)
+	{
+		bruteForceNearestPoints.emplace_back(model.GetNearestPointOnModelBruteForce(queryPositions[queryIndex]));
+	}
+	double bruteForceNearestSeconds = GetCurrentTimeSeconds() - bruteForceNearestStartTime;
+
+	std::vector<Vec3> bvhNearestPoints;
+	bvhNearestPoints.reserve(numQueries);
+	double bvhNearestStartTime = GetCurrentTimeSeconds();
+	for (int queryIndex = 0; queryIndex < numQueries; queryIndex++)
+	{
+		bvhNearestPoints.emplace_back(model.GetNearestPointOnModel(queryPositions[queryIndex]));
+	}
+	double bvhNearestSeconds = GetCurrentTimeSeconds() - bvhNearestStartTime;
+
+	//two points on different tris can be equally near, so compare distances rather than points
+	int numNearestMismatches = 0;
+	for (int queryIndex = 0; queryIndex < numQueries; queryIndex++)
+	{
+		float bruteForceDist = GetDistance3D(queryPositions[queryIndex], bruteForceNearestPoints[queryIndex]);
+		float bvhDist = GetDistance3D(queryPositions[queryIndex], bvhNearestPoints[queryIndex]);
+		if (fabsf(bruteForceDist - bvhDist) > 0.001f)
+		{
+			numNearestMismatches++;
+		}
+	}
+
+	//push queries from just off the surface, so most of them actually collide
+	Player player = Player(nullptr);
+	std::vector<Vec3> pushPositions;
+	pushPositions.reserve(numQueries);
+	for (int queryIndex = 0; queryIndex < numQueries; queryIndex++)
+	{
+		Vec3 offset = Vec3(rng.RollRandomFloatInRange(-1.0f, 1.0f), rng.RollRandomFloatInRange(-1.0f, 1.0f), rng.RollRandomFloatInRange(-1.0f, 1.0f));
+		pushPositions.emplace_back(bvhNearestPoints[queryIndex] + (offset * player.m_collisionRadius));
+	}
+
+	std::vector<Vec3> bruteForcePushedPositions;
+	bruteForcePushedPositions.reserve(numQueries);
+	double bruteForcePushStartTime = GetCurrentTimeSeconds();
+	for (int queryIndex = 0; queryIndex < numQueries; queryIndex++)
+	{
+		player.m_position = pushPositions[queryIndex];
+		model.PushPlayerOutOfAllTrisOnModelBruteForce(&player);
+		bruteForcePushedPositions.emplace_back(player.m_position);
+	}
+	double bruteForcePushSeconds = GetCurrentTimeSeconds() - bruteForcePushStartTime;
+
+	int numPushMismatches = 0;
+	std::vector<int> nearbyTris;
+	double bvhPushStartTime = GetCurrentTimeSeconds();
+	for (int queryIndex = 0; queryIndex < numQueries; queryIndex++)
+	{
+		player.m_position = pushPositions[queryIndex];
+		model.PushPlayerOutOfAllTrisOnModel(&player, nearbyTris);
+		if (GetDistanceSquared3D(player.m_position, bruteForcePushedPositions[queryIndex]) > 0.000001f)
+		{
+			numPushMismatches++;
+		}
+	}
+	double bvhPushSeconds = GetCurrentTimeSeconds() - bvhPushStartTime;
+
+	double nearestSpeedup = (bvhNearestSeconds > 0.0) ? bruteForceNearestSeconds / bvhNearestSeconds : 0.0;
+	double pushSpeedup = (bvhPushSeconds > 0.0) ? bruteForcePushSeconds / bvhPushSeconds : 0.0;
+
+	g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MINOR, Stringf(" %s: %i tris, %i bvh nodes", xmlFilePath.c_str(), static_cast<int>(model.m_asset->m_triangleFirstIndexes.size()),
+		static_cast<int>(model.m_asset->m_triangleBVH.m_nodes.size())));
+	g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MINOR, Stringf("   nearest point: brute force %.4f ms/query, bvh %.4f ms/query (%.1fx), %i mismatches",
+		(bruteForceNearestSeconds * 1000.0) / static_cast<double>(numQueries), (bvhNearestSeconds * 1000.0) / static_cast<double>(numQueries), nearestSpeedup, numNearestMismatches));
+	g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MINOR, Stringf("   push player: brute force %.4f ms/query, bvh %.4f ms/query (%.1fx), %i mismatches",
+		(bruteForcePushSeconds * 1000.0) / static_cast<double>(numQueries), (bvhPushSeconds * 1000.0) / static_cast<double>(numQueries), pushSpeedup, numPushMismatches));
+
+	//closest point grid, compared against the exact bvh results above
+	//prefabs in the scene can share the asset and may have baked this resolution already, then the bake time is only the lookup
+	double bakeStartTime = GetCurrentTimeSeconds();
+	model.BakeClosestPointGrid();
+	double bakeSeconds = GetCurrentTimeSeconds() - bakeStartTime;
+	ClosestPointGrid const& grid = *model.m_closestPointGrid;
+
+	g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MINOR, Stringf("   grid: cell %.2f, band %.2f, %i bricks, %.1f KB, bake %.1f ms, max error %.4f, mean error %.4f", grid.m_cellSize,
+		grid.m_bandWidth, grid.GetNumStoredBricks(), static_cast<float>(grid.GetMemoryBytes()) / 1024.0f, bakeSeconds * 1000.0, grid.m_maxDistanceError, grid.m_meanDistanceError));
+
+	std::vector<float> exactDistances;
+	exactDistances.reserve(numQueries);
+	for (int queryIndex = 0; queryIndex < numQueries; queryIndex++)
+	{
+		exactDistances.emplace_back(GetDistance3D(pushPositions[queryIndex], model.GetNearestPointOnModel(pushPositions[queryIndex])));
+	}
+
+	std::vector<Vec3> modeNearestPoints;
+	modeNearestPoints.resize(numQueries);
+	for (int queryMode = MODEL_QUERY_GRID; queryMode < NUM_MODEL_QUERY_MODES; queryMode++)
+	{
+		double nearestStartTime = GetCurrentTimeSeconds();
+		for (int queryIndex = 0; queryIndex < numQueries; queryIndex++)
+		{
+			modeNearestPoints[queryIndex] = model.GetNearestPointOnModel(pushPositions[queryIndex], static_cast<ModelQueryMode>(queryMode));
+		}
+		double nearestSeconds = GetCurrentTimeSeconds() - nearestStartTime;
+
+		float maxNearestError = 0.0f;
+		for (int queryIndex = 0; queryIndex < numQueries; queryIndex++)
+		{
+			float error = fabsf(GetDistance3D(pushPositions[queryIndex], modeNearestPoints[queryIndex]) - exactDistances[queryIndex]);
+			if (error > maxNearestError)
+			{
+				maxNearestError = error;
+			}
+		}
+
+		int numModePushMismatches = 0;
+		double pushStartTime = GetCurrentTimeSeconds();
+		for (int queryIndex = 0; queryIndex < numQueries; queryIndex++)
+		{
+			player.m_position = pushPositions[queryIndex];
+			model.PushPlayerOutOfAllTrisOnModel(&player, nearbyTris, static_cast<ModelQueryMode>(queryMode));
+			if (GetDistanceSquared3D(player.m_position, bruteForcePushedPositions[queryIndex]) > 0.000001f)
+			{
+				numModePushMismatches++;
+			}
+		}
+		double pushSeconds = GetCurrentTimeSeconds() - pushStartTime;
+
+		double modeNearestMsPerQuery = (nearestSeconds * 1000.0) / static_cast<double>(numQueries);
+		g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MINOR, Stringf("   %s: nearest %.4f ms/query (max error %.4f), push %.4f ms/query (%i differ from exact)",
+			(queryMode == MODEL_QUERY_GRID) ? "grid" : "hybrid", modeNearestMsPerQuery, maxNearestError, (pushSeconds * 1000.0) / static_cast<double>(numQueries), numModePushMismatches));
+	}
+}
+
+
+void RunModelLoadBenchmark(std::string const& xmlFilePath, int numLoads)
+{
+	bool wasCacheEnabled = IsModelMeshCacheEnabled();
+
+	//text obj parsing every time, the way every prefab used to load
+	SetModelMeshCacheEnabled(false);
+	double objStartTime = GetCurrentTimeSeconds();
+	for (int loadIndex = 0; loadIndex < numLoads; loadIndex++)
+	{
+		Model model(Vec3(), 1.0f, EulerAngles(), Rgba8());
+		model.ParseXMLFileForOBJ(xmlFilePath);
+	}
+	double objSeconds = GetCurrentTimeSeconds() - objStartTime;
+
+	//one untimed load makes sure the cache is written and current
+	SetModelMeshCacheEnabled(true);
+	ModelMeshCacheStats statsBefore = GetModelMeshCacheStats();
+	{
+		Model model(Vec3(), 1.0f, EulerAngles(), Rgba8());
+		model.ParseXMLFileForOBJ(xmlFilePath);
+	}
+
+	double cacheStartTime = GetCurrentTimeSeconds();
+	int numTris = 0;
+	for (int loadIndex = 0; loadIndex < numLoads; loadIndex++)
+	{
+		Model model(Vec3(), 1.0f, EulerAngles(), Rgba8());
+		model.ParseXMLFileForOBJ(xmlFilePath);
+		numTris = static_cast<int>(model.m_asset->m_cpuMesh->m_indexes.size()) / 3;
+	}
+	double cacheSeconds = GetCurrentTimeSeconds() - cacheStartTime;
+	ModelMeshCacheStats statsAfter = GetModelMeshCacheStats();
+
+	SetModelMeshCacheEnabled(wasCacheEnabled);
+
+	double speedup = (cacheSeconds > 0.0) ? objSeconds / cacheSeconds : 0.0;
+	g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MINOR, Stringf(" %s: %i tris, obj %.2f ms/load, mesh cache %.2f ms/load (%.1fx), %i hits, %i misses", xmlFilePath.c_str(), numTris,
+		(objSeconds * 1000.0) / static_cast<double>(numLoads), (cacheSeconds * 1000.0) / static_cast<double>(numLoads), speedup, statsAfter.m_numHits - statsBefore.m_numHits,
+		statsAfter.m_numMisses - statsBefore.m_numMisses));
+}
+
+
+void RunLevelLoadBenchmark(int numPlanetoids, int numLoads)
+{
+	RandomNumberGenerator rng;
+	rng.SeedRNG(numPlanetoids);
+
+	PlaytestCourse level;
+	SpawnBenchmarkLevel(rng, numPlanetoids, 2000.0f, level);
+
+	std::string binaryFilePath = std::string("Data/Levels/Benchmark") + LEVEL_FILE_BINARY_EXTENSION;
+	std::string readableFilePath = std::string("Data/Levels/Benchmark") + LEVEL_FILE_READABLE_EXTENSION;
+	bool wasWritten = WriteLevelFile(level, binaryFilePath) && WriteLevelFile(level, readableFilePath);
+	DeleteBenchmarkLevel(level);
+	if (!wasWritten)
+	{
+		g_theDevConsole->AddLine(DevConsole::COLOR_ERROR, "Could not write the benchmark levels to Data/Levels");
+		return;
+	}
+
+	int numBinaryPlanetoids = 0;
+	int numReadablePlanetoids = 0;
+	double binarySeconds = TimeLevelLoads(binaryFilePath, numLoads, numBinaryPlanetoids);
+	double readableSeconds = TimeLevelLoads(readableFilePath, numLoads, numReadablePlanetoids);
+
+	std::error_code errorCode;
+	double binaryKilobytes = static_cast<double>(std::filesystem::file_size(binaryFilePath, errorCode)) / 1024.0;
+	double readableKilobytes = static_cast<double>(std::filesystem::file_size(readableFilePath, errorCode)) / 1024.0;
+
+	double speedup = (binarySeconds > 0.0) ? readableSeconds / binarySeconds : 0.0;
+	g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MINOR, Stringf(" %i planetoids: binary %.2f ms/load (%.0f KB), xml %.2f ms/load (%.0f KB), binary is %.1fx faster", numPlanetoids,
+		binarySeconds * 1000.0, binaryKilobytes, readableSeconds * 1000.0, readableKilobytes, speedup));
+	g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MINOR, Stringf("   %.2f million planetoids/s from binary, %i/%i planetoids came back from binary/xml", static_cast<double>(numPlanetoids) / (binarySeconds * 1000000.0),
+		numBinaryPlanetoids, numReadablePlanetoids));
+}
@@ -0,0 +1,16 @@
+#pragma once
+#include "Engine/Core/EngineCommon.hpp"
+
+
+//constants
+constexpr int BENCHMARK_NUM_QUERIES = 1000;
+
+
+//benchmark functions
+void RunGravityFieldBenchmark(int numPlanetoids, int numQueries = BENCHMARK_NUM_QUERIES);
+void RunGravityKernelBenchmark(int numFields, int numQueries = BENCHMARK_NUM_QUERIES);
+void RunGravityBodyBenchmark(int numBodies, int numPlanetoids = 1000);
+void RunJobScalingBenchmark(int numBodies, int numPlanetoids = 1000);
+void RunModelBenchmark(std::string const& xmlFilePath, int numQueries = BENCHMARK_NUM_QUERIES);
+void RunModelLoadBenchmark(std::string const& xmlFilePath, int numLoads = 5);
+void RunLevelLoadBenchmark(int numPlanetoids, int numLoads = 3);
@@ -0,0 +1,87 @@
+#include "Game/BinaryFileUtils.hpp"
+#include "Engine/Core/FileUtils.hpp"
+#include <atomic>
+#include <filesystem>
+#include <system_error>
+
+#if defined(_WIN32)
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+
+//
+//hashing functions
+//
+unsigned int HashBytes32(void const* bytes, size_t numBytes, unsigned int hash)
+{
+	constexpr unsigned int FNV32_PRIME = 16777619u;
+
+	unsigned char const* byteData = static_cast<unsigned char const*>(bytes);
+	for (size_t byteIndex = 0; byteIndex < numBytes; byteIndex++)
+	{
+		hash ^= static_cast<unsigned int>(byteData[byteIndex]);
+		hash *= FNV32_PRIME;
+	}
+
+	return hash;
+}
+
+
+uint64_t HashBytes64(void const* bytes, size_t numBytes, uint64_t hash)
+{
+	constexpr uint64_t FNV64_PRIME = 1099511628211ull;
+
+	unsigned char const* byteData = static_cast<unsigned char const*>(bytes);
+	for (size_t byteIndex = 0; byteIndex < numBytes; byteIndex++)
+	{
+		hash ^= static_cast<uint64_t>(byteData[byteIndex]);
+		hash *= FNV64_PRIME;
+	}
+
+	return hash;
+}
+
+
+//
+//binary buffer functions
+//
+void AppendBytes(std::vector<uint8_t>& buffer, void const* data, size_t numBytes)
+{
+	uint8_t const* bytes = static_cast<uint8_t const*>(data);
+	buffer.insert(buffer.end(), bytes, bytes + numBytes);
+}
+
+
+bool WriteFileAtomically(std::vector<uint8_t> const& buffer, std::string const& filePath)
+{
+	static std::atomic<unsigned int> s_numTempFiles = 0;
+
+	//the process id and a counter keep two processes, or two threads, from writing the same temporary file
+#if defined(_WIN32)
+	int processId = _getpid();
+#else
+	int processId = static_cast<int>(getpid());
+#endif
+	std::string tempFilePath = filePath + "." + std::to_string(processId) + "." + std::to_string(s_numTempFiles++) + ".tmp";
+
+	if (FileWriteFromBuffer(buffer, tempFilePath) <= 0)
+	{
+		std::error_code removeError;
+		std::filesystem::remove(tempFilePath, removeError);
+		return false;
+	}
+
+	//replaces any file already there in one step, readers see either the old file or the whole new one
+	std::error_code renameError;
+	std::filesystem::rename(tempFilePath, filePath, renameError);
+	if (renameError)
+	{
+		std::error_code removeError;
+		std::filesystem::remove(tempFilePath, removeError);
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+//fnv-1a, used to key meshes and shape parameters and to checksum state so identical ones can be found again
+constexpr unsigned int FNV32_OFFSET_BASIS = 2166136261u;
+constexpr uint64_t	   FNV64_OFFSET_BASIS = 14695981039346656037ull;
+unsigned int HashBytes32(void const* bytes, size_t numBytes, unsigned int hash = FNV32_OFFSET_BASIS);
+uint64_t	 HashBytes64(void const* bytes, size_t numBytes, uint64_t hash = FNV64_OFFSET_BASIS);
+
+
+//binary buffer functions
+void AppendBytes(std::vector<uint8_t>& buffer, void const* data, size_t numBytes);
+
+//writes next to filePath and renames it into place, so a crash or a second writer never leaves a half written file behind
+bool WriteFileAtomically(std::vector<uint8_t> const& buffer, std::string const& filePath);
@@ -0,0 +1,269 @@
+#include "Game/BoundingVolumeHierarchy.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include <algorithm>
+
+
+//
+//tree building functions
+//
+void BoundingVolumeHierarchy::Build(std::vector<AABB3> const& itemBounds, int maxItemsPerLeaf)
+{
+	Clear();
+
+	if (itemBounds.empty())
+	{
+		return;
+	}
+
+	if (maxItemsPerLeaf < 1)
+	{
+		maxItemsPerLeaf = 1;
+	}
+
+	m_itemBounds = itemBounds;
+	m_itemIndexes.reserve(itemBounds.size());
+	for (int itemIndex = 0; itemIndex < static_cast<int>(itemBounds.size()); itemIndex++)
+	{
+		m_itemIndexes.emplace_back(itemIndex);
+	}
+
+	//a binary tree with one item per leaf never needs more than 2n - 1 nodes
+	m_nodes.reserve(itemBounds.size() * 2);
+	BuildNode(0, static_cast<int>(itemBounds.size()), maxItemsPerLeaf);
+}
+
+
+void BoundingVolumeHierarchy::Clear()
+{
+	m_nodes.clear();
+	m_itemIndexes.clear();
+	m_itemBounds.clear();
+}
+
+
+int BoundingVolumeHierarchy::BuildNode(int firstItem, int numItems, int maxItemsPerLeaf)
+{
+	int nodeIndex = static_cast<int>(m_nodes.size());
+	m_nodes.emplace_back(BVHNode());
+
+	//get bounds of all items in this node, and bounds of their centers to pick a split axis
+	AABB3 nodeBounds = m_itemBounds[m_itemIndexes[firstItem]];
+	Vec3 firstCenter = nodeBounds.GetCenter();
+	AABB3 centerBounds = AABB3(firstCenter, firstCenter);
+	for (int itemIndex = firstItem + 1; itemIndex < firstItem + numItems; itemIndex++)
+	{
+		AABB3 const& itemBounds = m_itemBounds[m_itemIndexes[itemIndex]];
+		StretchToIncludeAABB3D(nodeBounds, itemBounds);
+		StretchToIncludePoint3D(centerBounds, itemBounds.GetCenter());
+	}
+
+	m_nodes[nodeIndex].m_bounds = nodeBounds;
+	m_nodes[nodeIndex].m_firstItem = firstItem;
+	m_nodes[nodeIndex].m_numItems = numItems;
+
+	if (numItems <= maxItemsPerLeaf)
+	{
+		return nodeIndex;
+	}
+
+	//split at the median center along the longest axis so the tree stays balanced
+	Vec3 centerExtents = centerBounds.m_maxs - centerBounds.m_mins;
+	int splitAxis = 0;
+	if (centerExtents.y > centerExtents.x && centerExtents.y >= centerExtents.z) splitAxis = 1;
+	else if (centerExtents.z > centerExtents.x && centerExtents.z > centerExtents.y) splitAxis = 2;
+
+	auto getAxisValue = [splitAxis](Vec3 const& point)
+	{
+		if (splitAxis == 0) return point.x;
+		if (splitAxis == 1) return point.y;
+		return point.z;
+	};
+
+	int numLeftItems = numItems / 2;
+	std::nth_element(m_itemIndexes.begin() + firstItem, m_itemIndexes.begin() + firstItem + numLeftItems, m_itemIndexes.begin() + firstItem + numItems,
+		[this, &getAxisValue](int itemA, int itemB)
+		{
+			return getAxisValue(m_itemBounds[itemA].GetCenter()) < getAxisValue(m_itemBounds[itemB].GetCenter());
+		});
+
+	//children are built after the parent is placed, so the node has to be looked up again rather than held by reference
+	int leftChild = BuildNode(firstItem, numLeftItems, maxItemsPerLeaf);
+	int rightChild = BuildNode(firstItem + numLeftItems, numItems - numLeftItems, maxItemsPerLeaf);
+	m_nodes[nodeIndex].m_leftChild = leftChild;
+	m_nodes[nodeIndex].m_rightChild = rightChild;
+	m_nodes[nodeIndex].m_numItems = 0;
+
+	return nodeIndex;
+}
+
+
+//
+//tree query functions
+//
+void BoundingVolumeHierarchy::QueryAABB(AABB3 const& bounds, std::vector<int>& out_itemIndexes) const
+{
+	if (m_nodes.empty())
+	{
+		return;
+	}
+
+	int nodeStack[BVH_MAX_TRAVERSAL_DEPTH];
+	int stackSize = 0;
+	nodeStack[stackSize++] = 0;
+
+	while (stackSize > 0)
+	{
+		BVHNode const& node = m_nodes[nodeStack[--stackSize]];
+		if (!DoAABBsOverlap3D(node.m_bounds, bounds))
+		{
+			continue;
+		}
+
+		if (node.IsLeaf())
+		{
+			for (int itemIndex = node.m_firstItem; itemIndex < node.m_firstItem + node.m_numItems; itemIndex++)
+			{
+				int item = m_itemIndexes[itemIndex];
+				if (DoAABBsOverlap3D(m_itemBounds[item], bounds))
+				{
+					out_itemIndexes.emplace_back(item);
+				}
+			}
+			continue;
+		}
+
+		GUARANTEE_OR_DIE(stackSize + 2 <= BVH_MAX_TRAVERSAL_DEPTH, "BVH traversal stack overflow");
+		nodeStack[stackSize++] = node.m_rightChild;
+		nodeStack[stackSize++] = node.m_leftChild;
+	}
+}
+
+
+void BoundingVolumeHierarchy::QuerySphere(Vec3 const& center, float radius, std::vector<int>& out_itemIndexes) const
+{
+	if (m_nodes.empty())
+	{
+		return;
+	}
+
+	int nodeStack[BVH_MAX_TRAVERSAL_DEPTH];
+	int stackSize = 0;
+	nodeStack[stackSize++] = 0;
+
+	while (stackSize > 0)
+	{
+		BVHNode const& node = m_nodes[nodeStack[--stackSize]];
+		if (!DoesSphereOverlapAABB3D(center, radius, node.m_bounds))
+		{
+			continue;
+		}
+
+		if (node.IsLeaf())
+		{
+			for (int itemIndex = node.m_firstItem; itemIndex < node.m_firstItem + node.m_numItems; itemIndex++)
+			{
+				int item = m_itemIndexes[itemIndex];
+				if (DoesSphereOverlapAABB3D(center, radius, m_itemBounds[item]))
+				{
+					out_itemIndexes.emplace_back(item);
+				}
+			}
+			continue;
+		}
+
+		GUARANTEE_OR_DIE(stackSize + 2 <= BVH_MAX_TRAVERSAL_DEPTH, "BVH traversal stack overflow");
+		nodeStack[stackSize++] = node.m_rightChild;
+		nodeStack[stackSize++] = node.m_leftChild;
+	}
+}
+
+
+//
+//static bounds utilities
+//
+bool BoundingVolumeHierarchy::DoAABBsOverlap3D(AABB3 const& boundsA, AABB3 const& boundsB)
+{
+	if (boundsA.m_maxs.x < boundsB.m_mins.x || boundsA.m_mins.x > boundsB.m_maxs.x) return false;
+	if (boundsA.m_maxs.y < boundsB.m_mins.y || boundsA.m_mins.y > boundsB.m_maxs.y) return false;
+	if (boundsA.m_maxs.z < boundsB.m_mins.z || boundsA.m_mins.z > boundsB.m_maxs.z) return false;
+
+	return true;
+}
+
+
+bool BoundingVolumeHierarchy::DoesSphereOverlapAABB3D(Vec3 const& center, float radius, AABB3 const& bounds)
+{
+	return GetDistanceSquaredToAABB3D(center, bounds) <= radius * radius;
+}
+
+
+float BoundingVolumeHierarchy::GetDistanceSquaredToAABB3D(Vec3 const& point, AABB3 const& bounds)
+{
+	Vec3 nearestPoint = Vec3(GetClamped(point.x, bounds.m_mins.x, bounds.m_maxs.x), GetClamped(point.y, bounds.m_mins.y, bounds.m_maxs.y),
+		GetClamped(point.z, bounds.m_mins.z, bounds.m_maxs.z));
+
+	return GetDistanceSquared3D(point, nearestPoint);
+}
+
+
+void BoundingVolumeHierarchy::StretchToIncludeAABB3D(AABB3& bounds, AABB3 const& boundsToInclude)
+{
+	StretchToIncludePoint3D(bounds, boundsToInclude.m_mins);
+	StretchToIncludePoint3D(bounds, boundsToInclude.m_maxs);
+}
+
+
+void BoundingVolumeHierarchy::StretchToIncludePoint3D(AABB3& bounds, Vec3 const& point)
+{
+	bounds.m_mins.x = std::min(bounds.m_mins.x, point.x);
+	bounds.m_mins.y = std::min(bounds.m_mins.y, point.y);
+	bounds.m_mins.z = std::min(bounds.m_mins.z, point.z);
+	bounds.m_maxs.x = std::max(bounds.m_maxs.x, point.x);
+	bounds.m_maxs.y = std::max(bounds.m_maxs.y, point.y);
+	bounds.m_maxs.z = std::max(bounds.m_maxs.z, point.z);
+}
+
+
+AABB3 BoundingVolumeHierarchy::GetBoundsOfLocalBox3D(Mat44 const& localToWorldMatrix, Vec3 const& localMins, Vec3 const& localMaxs)
+{
+	Vec3 firstCorner = localToWorldMatrix.TransformPosition3D(localMins);
+	AABB3 worldBounds = AABB3(firstCorner, firstCorner);
+
+	for (int cornerIndex = 1; cornerIndex < 8; cornerIndex++)
+	{
+		Vec3 localCorner;
+		localCorner.x = (cornerIndex & 1) ? localMaxs.x : localMins.x;
+		localCorner.y = (cornerIndex & 2) ? localMaxs.y : localMins.y;
+		localCorner.z = (cornerIndex & 4) ? localMaxs.z : localMins.z;
+		StretchToIncludePoint3D(worldBounds, localToWorldMatrix.TransformPosition3D(localCorner));
+	}
+
+	return worldBounds;
+}
+
+
+AABB3 BoundingVolumeHierarchy::GetBoundsOfCapsule3D(Vec3 const& boneStart, Vec3 const& boneEnd, float radius)
+{
+	Vec3 radiusVector = Vec3(radius, radius, radius);
+	AABB3 worldBounds = AABB3(boneStart - radiusVector, boneStart + radiusVector);
+	StretchToIncludePoint3D(worldBounds, boneEnd - radiusVector);
+	StretchToIncludePoint3D(worldBounds, boneEnd + radiusVector);
+
+	return worldBounds;
+}
+
+
+AABB3 BoundingVolumeHierarchy::GetBoundsOfEllipsoid3D(Vec3 const& center, float xRadius, float yRadius, float zRadius, Mat44 const& orientationMatrix)
+{
+	//exact extents of a rotated ellipsoid along each world axis
+	Vec3 iRadius = orientationMatrix.GetIBasis3D() * xRadius;
+	Vec3 jRadius = orientationMatrix.GetJBasis3D() * yRadius;
+	Vec3 kRadius = orientationMatrix.GetKBasis3D() * zRadius;
+
+	Vec3 halfExtents;
+	halfExtents.x = sqrtf((iRadius.x * iRadius.x) + (jRadius.x * jRadius.x) + (kRadius.x * kRadius.x));
+	halfExtents.y = sqrtf((iRadius.y * iRadius.y) + (jRadius.y * jRadius.y) + (kRadius.y * kRadius.y));
+	halfExtents.z = sqrtf((iRadius.z * iRadius.z) + (jRadius.z * jRadius.z) + (kRadius.z * kRadius.z));
+
+	return AABB3(center - halfExtents, center + halfExtents);
+}
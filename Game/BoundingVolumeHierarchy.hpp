@@ -0,0 +1,175 @@
+#pragma once
+#include "Engine/Math/AABB3.hpp"
+#include "Engine/Math/Vec3.hpp"
+#include "Engine/Math/Mat44.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include <vector>
+#include <float.h>
+
+
+//constants
+constexpr int BVH_DEFAULT_ITEMS_PER_LEAF = 4;
+constexpr int BVH_MAX_TRAVERSAL_DEPTH = 64;
+
+
+//a single node of the tree, leaves own a contiguous range of m_itemIndexes
+struct BVHNode
+{
+	AABB3 m_bounds;
+	int   m_leftChild = -1;
+	int   m_rightChild = -1;
+	int   m_firstItem = 0;
+	int   m_numItems = 0;
+
+	bool IsLeaf() const { return m_leftChild < 0; }
+};
+
+
+//static bounding volume hierarchy over a list of world-space boxes
+//items are referred to by their index in the list passed to Build()
+class BoundingVolumeHierarchy
+{
+//public member functions
+public:
+	//tree building
+	void Build(std::vector<AABB3> const& itemBounds, int maxItemsPerLeaf = BVH_DEFAULT_ITEMS_PER_LEAF);
+	void Clear();
+
+	//tree queries
+	bool IsEmpty() const { return m_nodes.empty(); }
+	int  GetNumItems() const { return static_cast<int>(m_itemBounds.size()); }
+	void QueryAABB(AABB3 const& bounds, std::vector<int>& out_itemIndexes) const;
+	void QuerySphere(Vec3 const& center, float radius, std::vector<int>& out_itemIndexes) const;
+	template <typename ItemTestFunction>
+	bool QuerySphereAny(Vec3 const& center, float radius, ItemTestFunction const& isItemHit) const;
+	template <typename ItemDistanceSquaredFunction>
+	int  QueryNearest(Vec3 const& point, ItemDistanceSquaredFunction const& getItemDistanceSquared, float& out_distanceSquared) const;
+
+	//static bounds utilities
+	static bool  DoAABBsOverlap3D(AABB3 const& boundsA, AABB3 const& boundsB);
+	static bool  DoesSphereOverlapAABB3D(Vec3 const& center, float radius, AABB3 const& bounds);
+	static float GetDistanceSquaredToAABB3D(Vec3 const& point, AABB3 const& bounds);
+	static void  StretchToIncludeAABB3D(AABB3& bounds, AABB3 const& boundsToInclude);
+	static void  StretchToIncludePoint3D(AABB3& bounds, Vec3 const& point);
+	static AABB3 GetBoundsOfLocalBox3D(Mat44 const& localToWorldMatrix, Vec3 const& localMins, Vec3 const& localMaxs);
+	static AABB3 GetBoundsOfCapsule3D(Vec3 const& boneStart, Vec3 const& boneEnd, float radius);
+	static AABB3 GetBoundsOfEllipsoid3D(Vec3 const& center, float xRadius, float yRadius, float zRadius, Mat44 const& orientationMatrix);
+
+//private member functions
+private:
+	int  BuildNode(int firstItem, int numItems, int maxItemsPerLeaf);
+
+//public member variables
+public:
+	std::vector<BVHNode> m_nodes;
+	std::vector<int>	 m_itemIndexes;
+	std::vector<AABB3>	 m_itemBounds;
+};
+
+
+//true as soon as isItemHit(itemIndex) is true for an item whose box overlaps the sphere, without building a list of candidates
+//items are visited in tree order, so only use this when which item hits doesn't matter
+template <typename ItemTestFunction>
+bool BoundingVolumeHierarchy::QuerySphereAny(Vec3 const& center, float radius, ItemTestFunction const& isItemHit) const
+{
+	if (m_nodes.empty())
+	{
+		return false;
+	}
+
+	int nodeStack[BVH_MAX_TRAVERSAL_DEPTH];
+	int stackSize = 0;
+	nodeStack[stackSize++] = 0;
+
+	while (stackSize > 0)
+	{
+		BVHNode const& node = m_nodes[nodeStack[--stackSize]];
+		if (!DoesSphereOverlapAABB3D(center, radius, node.m_bounds))
+		{
+			continue;
+		}
+
+		if (node.IsLeaf())
+		{
+			for (int itemIndex = node.m_firstItem; itemIndex < node.m_firstItem + node.m_numItems; itemIndex++)
+			{
+				int item = m_itemIndexes[itemIndex];
+				if (DoesSphereOverlapAABB3D(center, radius, m_itemBounds[item]) && isItemHit(item))
+				{
+					return true;
+				}
+			}
+			continue;
+		}
+
+		GUARANTEE_OR_DIE(stackSize + 2 <= BVH_MAX_TRAVERSAL_DEPTH, "BVH traversal stack overflow");
+		nodeStack[stackSize++] = node.m_rightChild;
+		nodeStack[stackSize++] = node.m_leftChild;
+	}
+
+	return false;
+}
+
+
+//branch and bound search for the item closest to a point, returns -1 if nothing is closer than out_distanceSquared's starting value
+//getItemDistanceSquared(itemIndex) gives the exact squared distance to an item, NaN results are never picked
+//nodes are visited nearest first and skipped once their box is further away than the best item so far
+template <typename ItemDistanceSquaredFunction>
+int BoundingVolumeHierarchy::QueryNearest(Vec3 const& point, ItemDistanceSquaredFunction const& getItemDistanceSquared, float& out_distanceSquared) const
+{
+	int nearestItem = -1;
+	if (m_nodes.empty())
+	{
+		return nearestItem;
+	}
+
+	int nodeStack[BVH_MAX_TRAVERSAL_DEPTH];
+	int stackSize = 0;
+	nodeStack[stackSize++] = 0;
+
+	while (stackSize > 0)
+	{
+		BVHNode const& node = m_nodes[nodeStack[--stackSize]];
+		if (GetDistanceSquaredToAABB3D(point, node.m_bounds) >= out_distanceSquared)
+		{
+			continue;
+		}
+
+		if (node.IsLeaf())
+		{
+			for (int itemIndex = node.m_firstItem; itemIndex < node.m_firstItem + node.m_numItems; itemIndex++)
+			{
+				int item = m_itemIndexes[itemIndex];
+				if (GetDistanceSquaredToAABB3D(point, m_itemBounds[item]) >= out_distanceSquared)
+				{
+					continue;
+				}
+
+				float itemDistanceSquared = getItemDistanceSquared(item);
+				if (itemDistanceSquared < out_distanceSquared)
+				{
+					out_distanceSquared = itemDistanceSquared;
+					nearestItem = item;
+				}
+			}
+			continue;
+		}
+
+		//push the further child first so the nearer one is popped and tightens the bound sooner
+		GUARANTEE_OR_DIE(stackSize + 2 <= BVH_MAX_TRAVERSAL_DEPTH, "BVH traversal stack overflow");
+		float leftDistanceSquared = GetDistanceSquaredToAABB3D(point, m_nodes[node.m_leftChild].m_bounds);
+		float rightDistanceSquared = GetDistanceSquaredToAABB3D(point, m_nodes[node.m_rightChild].m_bounds);
+		if (leftDistanceSquared <= rightDistanceSquared)
+		{
+			nodeStack[stackSize++] = node.m_rightChild;
+			nodeStack[stackSize++] = node.m_leftChild;
+		}
+		else
+		{
+			nodeStack[stackSize++] = node.m_leftChild;
+			nodeStack[stackSize++] = node.m_rightChild;
+		}
+	}
+
+	return nearestItem;
+}
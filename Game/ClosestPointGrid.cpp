@@ -0,0 +1,216 @@
+#include "Game/ClosestPointGrid.hpp"
+#include "Game/ModelAsset.hpp"
+#include "Engine/Math/MathUtils.hpp"
+
+
+//local helper functions
+static Vec3 LerpOffset(Vec3 const& start, Vec3 const& end, float fraction)
+{
+	return start + ((end - start) * fraction);
+}
+
+
+//
+//grid baking functions
+//
+void ClosestPointGrid::Bake(ModelAsset const& model, float cellSize, float bandWidth)
+{
+	Clear();
+
+	if (cellSize <= 0.0f || model.m_triangleBVH.IsEmpty())
+	{
+		return;
+	}
+
+	m_cellSize = cellSize;
+	m_bandWidth = bandWidth;
+
+	//pad the model bounds by the band so points just off the surface are still covered
+	Vec3 padding = Vec3(bandWidth, bandWidth, bandWidth);
+	Vec3 gridMins = model.m_localBounds.m_mins - padding;
+	Vec3 gridMaxs = model.m_localBounds.m_maxs + padding;
+	float brickSize = cellSize * static_cast<float>(CLOSEST_POINT_GRID_BRICK_CELLS);
+
+	m_origin = gridMins;
+	m_numBricksX = static_cast<int>(ceilf((gridMaxs.x - gridMins.x) / brickSize));
+	m_numBricksY = static_cast<int>(ceilf((gridMaxs.y - gridMins.y) / brickSize));
+	m_numBricksZ = static_cast<int>(ceilf((gridMaxs.z - gridMins.z) / brickSize));
+	if (m_numBricksX < 1) m_numBricksX = 1;
+	if (m_numBricksY < 1) m_numBricksY = 1;
+	if (m_numBricksZ < 1) m_numBricksZ = 1;
+
+	m_brickSlots.resize(m_numBricksX * m_numBricksY * m_numBricksZ, -1);
+
+	//a brick can only hold points in the band if its center is within the band plus half its diagonal
+	float brickHalfDiagonal = brickSize * 0.5f * sqrtf(3.0f);
+	float brickCullDistance = bandWidth + brickHalfDiagonal;
+
+	for (int brickZ = 0; brickZ < m_numBricksZ; brickZ++)
+	{
+		for (int brickY = 0; brickY < m_numBricksY; brickY++)
+		{
+			for (int brickX = 0; brickX < m_numBricksX; brickX++)
+			{
+				Vec3 brickMins = m_origin + Vec3(static_cast<float>(brickX), static_cast<float>(brickY), static_cast<float>(brickZ)) * brickSize;
+				Vec3 brickCenter = brickMins + Vec3(brickSize, brickSize, brickSize) * 0.5f;
+
+				Vec3 brickCenterNearestPoint;
+				if (!model.GetNearestLocalPointOnModel(brickCenter, brickCenterNearestPoint, brickCullDistance * brickCullDistance))
+				{
+					continue;
+				}
+
+				m_brickSlots[GetBrickSlotIndex(brickX, brickY, brickZ)] = static_cast<int>(m_brickOffsets.size());
+				for (int vertZ = 0; vertZ < CLOSEST_POINT_GRID_BRICK_VERTS; vertZ++)
+				{
+					for (int vertY = 0; vertY < CLOSEST_POINT_GRID_BRICK_VERTS; vertY++)
+					{
+						for (int vertX = 0; vertX < CLOSEST_POINT_GRID_BRICK_VERTS; vertX++)
+						{
+							Vec3 vertPosition = brickMins + Vec3(static_cast<float>(vertX), static_cast<float>(vertY), static_cast<float>(vertZ)) * cellSize;
+							Vec3 vertNearestPoint = vertPosition;
+							model.GetNearestLocalPointOnModel(vertPosition, vertNearestPoint);
+							m_brickOffsets.emplace_back(vertNearestPoint - vertPosition);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	MeasureError(model);
+}
+
+
+void ClosestPointGrid::Clear()
+{
+	m_brickSlots.clear();
+	m_brickOffsets.clear();
+	m_numBricksX = 0;
+	m_numBricksY = 0;
+	m_numBricksZ = 0;
+	m_maxDistanceError = 0.0f;
+	m_meanDistanceError = 0.0f;
+}
+
+
+void ClosestPointGrid::MeasureError(ModelAsset const& model)
+{
+	//cell centers are the furthest points from the baked vertices, so they show the worst of the interpolation
+	float brickSize = m_cellSize * static_cast<float>(CLOSEST_POINT_GRID_BRICK_CELLS);
+	double totalError = 0.0;
+	int numSamples = 0;
+
+	for (int brickSlotIndex = 0; brickSlotIndex < m_brickSlots.size(); brickSlotIndex++)
+	{
+		if (m_brickSlots[brickSlotIndex] < 0)
+		{
+			continue;
+		}
+
+		int brickX = brickSlotIndex % m_numBricksX;
+		int brickY = (brickSlotIndex / m_numBricksX) % m_numBricksY;
+		int brickZ = brickSlotIndex / (m_numBricksX * m_numBricksY);
+		Vec3 brickMins = m_origin + Vec3(static_cast<float>(brickX), static_cast<float>(brickY), static_cast<float>(brickZ)) * brickSize;
+
+		for (int cellZ = 0; cellZ < CLOSEST_POINT_GRID_BRICK_CELLS; cellZ++)
+		{
+			for (int cellY = 0; cellY < CLOSEST_POINT_GRID_BRICK_CELLS; cellY++)
+			{
+				for (int cellX = 0; cellX < CLOSEST_POINT_GRID_BRICK_CELLS; cellX++)
+				{
+					Vec3 cellCenter = brickMins + (Vec3(static_cast<float>(cellX), static_cast<float>(cellY), static_cast<float>(cellZ)) + Vec3(0.5f, 0.5f, 0.5f)) * m_cellSize;
+
+					Vec3 exactPoint;
+					if (!model.GetNearestLocalPointOnModel(cellCenter, exactPoint, m_bandWidth * m_bandWidth))
+					{
+						continue;
+					}
+
+					Vec3 gridPoint;
+					if (!GetNearestLocalPoint(cellCenter, gridPoint))
+					{
+						continue;
+					}
+
+					float error = fabsf(GetDistance3D(cellCenter, gridPoint) - GetDistance3D(cellCenter, exactPoint));
+					if (error > m_maxDistanceError)
+					{
+						m_maxDistanceError = error;
+					}
+					totalError += static_cast<double>(error);
+					numSamples++;
+				}
+			}
+		}
+	}
+
+	if (numSamples > 0)
+	{
+		m_meanDistanceError = static_cast<float>(totalError / static_cast<double>(numSamples));
+	}
+}
+
+
+//
+//grid query functions
+//
+bool ClosestPointGrid::GetNearestLocalPoint(Vec3 const& referencePointLocal, Vec3& out_nearestLocalPoint) const
+{
+	if (m_brickSlots.empty())
+	{
+		return false;
+	}
+
+	Vec3 gridPosition = (referencePointLocal - m_origin) / m_cellSize;
+	if (gridPosition.x < 0.0f || gridPosition.y < 0.0f || gridPosition.z < 0.0f)
+	{
+		return false;
+	}
+
+	int cellX = static_cast<int>(gridPosition.x);
+	int cellY = static_cast<int>(gridPosition.y);
+	int cellZ = static_cast<int>(gridPosition.z);
+	int brickX = cellX / CLOSEST_POINT_GRID_BRICK_CELLS;
+	int brickY = cellY / CLOSEST_POINT_GRID_BRICK_CELLS;
+	int brickZ = cellZ / CLOSEST_POINT_GRID_BRICK_CELLS;
+	if (brickX >= m_numBricksX || brickY >= m_numBricksY || brickZ >= m_numBricksZ)
+	{
+		return false;
+	}
+
+	int firstBrickVert = m_brickSlots[GetBrickSlotIndex(brickX, brickY, brickZ)];
+	if (firstBrickVert < 0)
+	{
+		return false;
+	}
+
+	//corner offsets of the cell within the brick
+	int localX = cellX - (brickX * CLOSEST_POINT_GRID_BRICK_CELLS);
+	int localY = cellY - (brickY * CLOSEST_POINT_GRID_BRICK_CELLS);
+	int localZ = cellZ - (brickZ * CLOSEST_POINT_GRID_BRICK_CELLS);
+	int rowStride = CLOSEST_POINT_GRID_BRICK_VERTS;
+	int layerStride = CLOSEST_POINT_GRID_BRICK_VERTS * CLOSEST_POINT_GRID_BRICK_VERTS;
+	int cornerIndex = firstBrickVert + localX + (localY * rowStride) + (localZ * layerStride);
+
+	float fractionX = gridPosition.x - static_cast<float>(cellX);
+	float fractionY = gridPosition.y - static_cast<float>(cellY);
+	float fractionZ = gridPosition.z - static_cast<float>(cellZ);
+
+	//offsets to the closest point vary linearly across flat surfaces, so blending them is exact there
+	Vec3 offsetY0Z0 = LerpOffset(m_brickOffsets[cornerIndex], m_brickOffsets[cornerIndex + 1], fractionX);
+	Vec3 offsetY1Z0 = LerpOffset(m_brickOffsets[cornerIndex + rowStride], m_brickOffsets[cornerIndex + rowStride + 1], fractionX);
+	Vec3 offsetY0Z1 = LerpOffset(m_brickOffsets[cornerIndex + layerStride], m_brickOffsets[cornerIndex + layerStride + 1], fractionX);
+	Vec3 offsetY1Z1 = LerpOffset(m_brickOffsets[cornerIndex + layerStride + rowStride], m_brickOffsets[cornerIndex + layerStride + rowStride + 1], fractionX);
+	Vec3 offsetZ0 = LerpOffset(offsetY0Z0, offsetY1Z0, fractionY);
+	Vec3 offsetZ1 = LerpOffset(offsetY0Z1, offsetY1Z1, fractionY);
+
+	out_nearestLocalPoint = referencePointLocal + LerpOffset(offsetZ0, offsetZ1, fractionZ);
+	return true;
+}
+
+
+int ClosestPointGrid::GetMemoryBytes() const
+{
+	return static_cast<int>((m_brickSlots.size() * sizeof(int)) + (m_brickOffsets.size() * sizeof(Vec3)));
+}
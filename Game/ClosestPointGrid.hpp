@@ -0,0 +1,56 @@
+#pragma once
+#include "Engine/Math/Vec3.hpp"
+#include "Engine/Math/AABB3.hpp"
+#include <vector>
+
+
+//forward declarations
+class ModelAsset;
+
+
+//constants
+constexpr int   CLOSEST_POINT_GRID_BRICK_CELLS = 8;
+constexpr int   CLOSEST_POINT_GRID_BRICK_VERTS = CLOSEST_POINT_GRID_BRICK_CELLS + 1;
+constexpr float CLOSEST_POINT_GRID_DEFAULT_CELL_SIZE = 1.0f;
+constexpr float CLOSEST_POINT_GRID_DEFAULT_BAND_WIDTH = 4.0f;
+
+
+//sparse grid of closest points on a model, in the model's local space
+//space is split into bricks of cells, and only bricks near the surface are stored
+//each stored brick keeps the offset from every grid vertex to its closest point, which is blended trilinearly when queried
+class ClosestPointGrid
+{
+//public member functions
+public:
+	//grid baking
+	void Bake(ModelAsset const& model, float cellSize = CLOSEST_POINT_GRID_DEFAULT_CELL_SIZE, float bandWidth = CLOSEST_POINT_GRID_DEFAULT_BAND_WIDTH);
+	void Clear();
+
+	//grid queries
+	bool IsBaked() const { return !m_brickSlots.empty(); }
+	bool GetNearestLocalPoint(Vec3 const& referencePointLocal, Vec3& out_nearestLocalPoint) const;
+	int  GetNumStoredBricks() const { return static_cast<int>(m_brickOffsets.size()) / (CLOSEST_POINT_GRID_BRICK_VERTS * CLOSEST_POINT_GRID_BRICK_VERTS * CLOSEST_POINT_GRID_BRICK_VERTS); }
+	int  GetMemoryBytes() const;
+
+//private member functions
+private:
+	int  GetBrickSlotIndex(int brickX, int brickY, int brickZ) const { return brickX + (brickY * m_numBricksX) + (brickZ * m_numBricksX * m_numBricksY); }
+	void MeasureError(ModelAsset const& model);
+
+//public member variables
+public:
+	float m_cellSize = CLOSEST_POINT_GRID_DEFAULT_CELL_SIZE;
+	float m_bandWidth = CLOSEST_POINT_GRID_DEFAULT_BAND_WIDTH;
+	Vec3  m_origin = Vec3();
+	int   m_numBricksX = 0;
+	int   m_numBricksY = 0;
+	int   m_numBricksZ = 0;
+
+	//index of each brick's first vertex in m_brickOffsets, or -1 if the brick is too far from the surface to be stored
+	std::vector<int>  m_brickSlots;
+	std::vector<Vec3> m_brickOffsets;
+
+	//distance error against the exact triangle query, measured at every cell center in the band when baked
+	float m_maxDistanceError = 0.0f;
+	float m_meanDistanceError = 0.0f;
+};
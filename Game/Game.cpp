@@ -4,6 +4,16 @@
 #include "Game/Planetoids.hpp"
 #include "Game/GravityFields.hpp"
 #include "Game/Model.hpp"
+#include "Game/Benchmarks.hpp"
+#include "Game/JobSystem.hpp"
+#include "Game/Simulation.hpp"
+#include "Game/PlaytestCourse.hpp"
+#include "Game/LevelFile.hpp"
+#include "Game/WorldStreamer.hpp"
+#include "Game/Profiler.hpp"
+#include "Game/MeshUploader.hpp"
+#include "Game/GravityFieldDebugBatch.hpp"
+#include "Game/PlanetoidPreviewCache.hpp"
 #include "Engine/Math/RandomNumberGenerator.hpp"
 #include "Engine/Math/AABB2.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
@@ -18,9 +28,68 @@
 #include "Engine/Core/FileUtils.hpp"
 #include "Engine/Renderer/DebugRenderSystem.hpp"
 #include "Engine/Core/BufferUtils.hpp"
+#include "Engine/Core/DevConsole.hpp"
 #include "ThirdParty/imgui/imgui.h"
 #include "ThirdParty/imgui/backends/imgui_impl_win32.h"
 #include "ThirdParty/imgui/backends/imgui_impl_dx11.h"
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+#include <unordered_set>
+
+
+//one row of the profiler tree, every call of the same scope under the same parent folds into it
+struct ProfileTreeNode
+{
+	char const*		 m_name = nullptr;
+	double			 m_milliseconds = 0.0;
+	int				 m_numCalls = 0;
+	std::vector<int> m_childIndexes;
+};
+
+
+static ImU32 GetProfileScopeColor(char const* name)
+{
+	//hash the name so a scope keeps its color from frame to frame
+	unsigned int hash = 2166136261u;
+	for (char const* character = name; *character != '\0'; character++)
+	{
+		hash = (hash ^ static_cast<unsigned char>(*character)) * 16777619u;
+	}
+
+	return IM_COL32(140 + (hash & 0x5f), 90 + ((hash >> 8) & 0x7f), 60 + ((hash >> 16) & 0x3f), 255);
+}
+
+
+static void RenderProfileTreeNode(std::vector<ProfileTreeNode> const& nodes, int nodeIndex, double frameMilliseconds)
+{
+	ProfileTreeNode const& node = nodes[nodeIndex];
+
+	ImGui::TableNextRow();
+	ImGui::TableNextColumn();
+	ImGuiTreeNodeFlags nodeFlags = ImGuiTreeNodeFlags_DefaultOpen | ImGuiTreeNodeFlags_SpanFullWidth;
+	if (node.m_childIndexes.empty())
+	{
+		nodeFlags |= ImGuiTreeNodeFlags_Leaf;
+	}
+	bool isOpen = ImGui::TreeNodeEx(reinterpret_cast<void*>(static_cast<intptr_t>(nodeIndex)), nodeFlags, "%s", node.m_name);
+
+	ImGui::TableNextColumn();
+	ImGui::Text("%.3f", node.m_milliseconds);
+	ImGui::TableNextColumn();
+	ImGui::Text("%.1f%%", (frameMilliseconds > 0.0) ? 100.0 * node.m_milliseconds / frameMilliseconds : 0.0);
+	ImGui::TableNextColumn();
+	ImGui::Text("%i", node.m_numCalls);
+
+	if (isOpen)
+	{
+		for (int childIndex = 0; childIndex < node.m_childIndexes.size(); childIndex++)
+		{
+			RenderProfileTreeNode(nodes, node.m_childIndexes[childIndex], frameMilliseconds);
+		}
+		ImGui::TreePop();
+	}
+}
 
 
 //game flow functions
@@ -29,8 +98,24 @@ void Game::Startup()
 	//add player to scene
 	m_player = new Player(this);
 	m_player->m_position = m_player->m_playerStartPosition;
+	m_player->SnapRenderState();
 	m_player->m_playerCamera.SetUseMatrixOrientationMode(false);
 
+	//create the simulation that steps the player and gravity bodies through the planetoids
+	SimulationConfig simulationConfig;
+	simulationConfig.m_planetoids = &m_planetoids;
+	simulationConfig.m_player = m_player;
+	simulationConfig.m_jobSystem = g_theJobSystem;
+	m_simulation = new Simulation(simulationConfig);
+
+	//planetoid meshes go to the gpu once as they're added
+	m_meshUploader = new RendererMeshUploader();
+	m_fieldDebugBatch = new GravityFieldDebugBatch();
+	m_previewCache = new PlanetoidPreviewCache();
+
+	//prefab models parse on the job system's workers, so the course doesn't wait on obj files
+	SetModelAssetJobSystem(g_theJobSystem);
+
 	//create lighting shader
 	m_lightingShader = g_theRenderer->CreateShader("Data/Shaders/SpriteLit");
 	
@@ -83,6 +168,8 @@ void Game::Startup()
 
 void Game::Update()
 {
+	PROFILE_SCOPE("Game::Update");
+
 	//key press to switch in and out of sandbox mode
 	if (g_theInput->WasKeyJustPressed(KEYCODE_F1))
 	{
@@ -96,6 +183,12 @@ void Game::Update()
 		m_lightingMenuOpen = !m_lightingMenuOpen;
 	}
 
+	//key to enable or disable the profiler
+	if (g_theInput->WasKeyJustPressed(KEYCODE_F9))
+	{
+		m_profilerMenuOpen = !m_profilerMenuOpen;
+	}
+
 	Clock& sysClock = Clock::GetSystemClock();
 	std::string gameInfo = Stringf("Time: %.2f  FPS: %.1f  Time Scale: %.2f", sysClock.GetTotalSeconds(), 1.0f/sysClock.GetDeltaSeconds(), m_gameClock.GetTimeScale());
 	DebugAddScreenText(gameInfo, Vec2(SCREEN_CAMERA_SIZE_X, SCREEN_CAMERA_SIZE_Y), 16.0f, Vec2(1.0f, 1.0f), 0.0f, Rgba8(), Rgba8());
@@ -104,22 +197,88 @@ void Game::Update()
 	std::string posMessage = Stringf("Player position: %.2f, %.2f, %.2f", pos.x, pos.y, pos.z);
 	DebugAddMessage(posMessage, 0.0f);
 
-	//update player
+	UpdateWorldStreaming();
+	FinishPrefabLoads(false);
+	if (m_isPlanetoidDrawOrderDirty)
+	{
+		RebuildPlanetoidDrawOrder();
+	}
+	if (m_isDebugView)
+	{
+		std::string drawCallMessage = Stringf("Planetoid draw calls: %i  Meshes: %i", m_numPlanetoidDrawCalls, m_numPlanetoidMeshGroups);
+		DebugAddMessage(drawCallMessage, 0.0f);
+
+		ModelAssetStats modelAssetStats = GetModelAssetStats();
+		std::string modelAssetMessage = Stringf("Model assets: %i  Loading: %i  Loads: %i  Reused: %i", modelAssetStats.m_numAssets, modelAssetStats.m_numLoading, modelAssetStats.m_numLoads,
+			modelAssetStats.m_numHits);
+		DebugAddMessage(modelAssetMessage, 0.0f);
+
+		if (m_worldStreamer != nullptr)
+		{
+			WorldStreamingStats streamingStats = m_worldStreamer->GetStats();
+			std::string streamingMessage = Stringf("Streaming cells: %i/%i loaded  %i loading  Planetoids: %i  Memory: %.1f MB", streamingStats.m_numLoadedCells, streamingStats.m_numCells,
+				streamingStats.m_numLoadingCells, streamingStats.m_numLoadedPlanetoids, static_cast<float>(streamingStats.m_residentBytes) / (1024.0f * 1024.0f));
+			DebugAddMessage(streamingMessage, 0.0f);
+		}
+	}
+
+	//update player input once per frame
 	m_player->Update(m_gameClock.GetDeltaSeconds());
 
-	//update gravity fields
-	ApplyGravity();
+	//run as many fixed physics steps as this frame's time covers, then blend the last two for rendering
+	m_physicsSecondsThisFrame = 0.0;
+	m_bodySecondsThisFrame = 0.0;
+	int numPhysicsSteps = 0;
+	if (m_isFixedTimeStep)
+	{
+		m_physicsTimeAccumulator += m_gameClock.GetDeltaSeconds();
+		while (m_physicsTimeAccumulator >= m_fixedTimeStep && numPhysicsSteps < MAX_PHYSICS_STEPS_PER_FRAME)
+		{
+			UpdatePhysicsStep(m_fixedTimeStep);
+			m_physicsTimeAccumulator -= m_fixedTimeStep;
+			numPhysicsSteps++;
+		}
 
-	//handle collision
-	CollidePlayerWithAllPlanetoids();
+		//under load, drop the time the step cap couldn't cover instead of trying to catch up on later frames
+		if (m_physicsTimeAccumulator >= m_fixedTimeStep)
+		{
+			m_physicsTimeAccumulator = fmodf(m_physicsTimeAccumulator, m_fixedTimeStep);
+		}
 
-	//teleport player to playtest course when they enter the starting area
-	if (!m_inPlaytestCourse && (GetDistanceSquared3D(pos, m_playtestEnterZone) < 5.0f)/* || g_theInput->WasKeyJustPressed(KEYCODE_COMMA)*/)
+		m_player->UpdateRenderState(m_physicsTimeAccumulator / m_fixedTimeStep);
+	}
+	else
 	{
-		m_inPlaytestCourse = true;
-		pos = m_playtestStartingPoint;
-		m_player->m_orientation = Mat44();
+		UpdatePhysicsStep(m_gameClock.GetDeltaSeconds());
+		numPhysicsSteps = 1;
+		m_player->UpdateRenderState(1.0f);
 	}
+	m_player->UpdateCamera();
+
+	float physicsMilliseconds = static_cast<float>(m_physicsSecondsThisFrame * 1000.0);
+	m_physicsMilliseconds += (physicsMilliseconds - m_physicsMilliseconds) * 0.05f;
+	if (m_isFixedTimeStep)
+	{
+		DebugAddMessage(Stringf("Physics: %.4f ms/frame, %i steps at %.0f Hz", m_physicsMilliseconds, numPhysicsSteps, 1.0f / m_fixedTimeStep), 0.0f);
+	}
+	else
+	{
+		DebugAddMessage(Stringf("Physics: %.4f ms/frame, variable step", m_physicsMilliseconds), 0.0f);
+	}
+
+	//report gravity bodies
+	if (m_simulation->GetNumGravityBodies() > 0)
+	{
+		float bodyMilliseconds = static_cast<float>(m_bodySecondsThisFrame * 1000.0);
+		m_bodyMilliseconds += (bodyMilliseconds - m_bodyMilliseconds) * 0.05f;
+		int numThreads = (g_theJobSystem != nullptr) ? g_theJobSystem->GetNumActiveThreads() : 1;
+		DebugAddMessage(Stringf("Bodies: %i, %.4f ms/frame on %i threads", m_simulation->GetNumGravityBodies(), m_bodyMilliseconds, numThreads), 0.0f);
+	}
+
+	std::string broadPhaseMessage = Stringf("Broad phase: %i/%i gravity fields, %i/%i planetoids", m_simulation->GetNumGravityFieldCandidates(), m_simulation->GetNumGravityFields(),
+		m_simulation->GetNumCollisionCandidates(), m_simulation->GetNumCollidablePlanetoids());
+	DebugAddMessage(broadPhaseMessage, 0.0f);
+
 	/*if (g_theInput->WasKeyJustPressed(KEYCODE_PERIOD))
 	{
 		m_inPlaytestCourse = true;
@@ -154,46 +313,6 @@ void Game::Update()
 	//update playtest course
 	if (m_inPlaytestCourse)
 	{
-		//for playtest course, update checkpoints
-		for (int cpIndex = 0; cpIndex < m_checkpoints.size(); cpIndex++)
-		{
-			AABB3& cp = m_checkpoints[cpIndex];
-
-			Vec3 nearestPoint = GetNearestPointOnAABB3D(pos, cp);
-			if (IsPointInsideSphere3D(nearestPoint, pos, m_player->m_collisionRadius))
-			{
-				if (m_currentCheckpoint != &cp)
-				{
-					m_currentCheckpoint = &cp;
-					m_currentSection = cpIndex + 1;
-
-					switch (m_currentSection)
-					{
-						case 1:
-						{
-							m_section1StartTime = m_gameClock.GetTotalSeconds();
-							break;
-						}
-						case 2:
-						{
-							m_section2StartTime = m_gameClock.GetTotalSeconds();
-							break;
-						}
-						case 3:
-						{
-							m_section3StartTime = m_gameClock.GetTotalSeconds();
-							break;
-						}
-						case 4:
-						{
-							m_section4StartTime = m_gameClock.GetTotalSeconds();
-							break;
-						}
-					}
-				}
-			}
-		}
-
 		std::string sectionStr = Stringf("Current Section: %i", m_currentSection);
 		DebugAddMessage(sectionStr, 0.0f);
 
@@ -239,6 +358,8 @@ void Game::Update()
 
 void Game::Render() const
 {
+	PROFILE_SCOPE("Game::Render");
+
 	g_theRenderer->ClearScreen(m_skyColor);
 
 	g_theRenderer->BeginCamera(m_player->m_playerCamera);	//render game world with the world camera
@@ -246,19 +367,14 @@ void Game::Render() const
 	//game renderering here
 	g_theRenderer->SetLightConstants(g_theGame->m_sunDirection, g_theGame->m_sunIntensity, g_theGame->m_ambientIntensity);
 	RenderPlanetoids();
+	RenderGravityBodies();
 	m_player->Render();
 
 	g_theRenderer->SetBlendMode(BlendMode::ALPHA);
 	g_theRenderer->SetDepthMode(DepthMode::DISABLED);
 	if (m_isDebugView)
 	{
-		for (int pltdIndex = 0; pltdIndex < m_planetoids.size(); pltdIndex++)
-		{
-			if (m_planetoids[pltdIndex] != nullptr)
-			{
-				m_planetoids[pltdIndex]->DebugRender();
-			}
-		}
+		m_fieldDebugBatch->Render(m_planetoids);
 	}
 	g_theRenderer->SetDepthMode(DepthMode::ENABLED);
 
@@ -346,6 +462,7 @@ void Game::RenderImGui()
 		ImGui::NewLine();
 
 		ImGui::InputFloat3("Position", pltdPos, "%.1f");
+		Vec3 pltdPosition = Vec3(pltdPos[0], pltdPos[1], pltdPos[2]);
 
 		//plane
 		if (currentPlanetoidShape == 0)
@@ -365,15 +482,17 @@ void Game::RenderImGui()
 				ImGui::SetNextItemWidth(FLOAT_BOX_WIDTH);
 				ImGui::InputFloat("Gravity Field Height", &planeGravityHeight, 1.0f, 0.5f, "%.1f");
 				planeGravityHeight = GetClamped(planeGravityHeight, 0.0f, FLT_MAX);
-
-				PlanePLTD::RenderPreview(Vec3(pltdPos[0], pltdPos[1], pltdPos[2]), planeHalfLength, planeHalfWidth, EulerAngles(planeAngle[0], planeAngle[1], planeAngle[2]), planeGravityHeight,
-					pltdColor);
 			}
-			else
+
+			//position and orientation only move the cached preview
+			EulerAngles planeOrientation = EulerAngles(planeAngle[0], planeAngle[1], planeAngle[2]);
+			float planeShape[] = { planeHalfLength, planeHalfWidth, planeGravityHeight };
+			uint64_t previewKey = GetPreviewShapeKey(currentPlanetoidShape, includeGravField, planeShape, sizeof(planeShape));
+			if (!m_previewCache->IsCached(previewKey))
 			{
-				PlanePLTD::RenderPreview(Vec3(pltdPos[0], pltdPos[1], pltdPos[2]), planeHalfLength, planeHalfWidth, EulerAngles(planeAngle[0], planeAngle[1], planeAngle[2]), 0.0f,
-					pltdColor);
+				m_previewCache->SetPlanetoid(previewKey, new PlanePLTD(pltdPosition, planeHalfLength, planeHalfWidth, planeOrientation, includeGravField, planeGravityHeight, pltdGravityForce, pltdColor));
 			}
+			m_previewCache->Render(pltdPosition, planeOrientation, pltdColor);
 		}
 		//sphere
 		else if (currentPlanetoidShape == 1)
@@ -389,13 +508,16 @@ void Game::RenderImGui()
 				ImGui::SetNextItemWidth(FLOAT_BOX_WIDTH);
 				ImGui::InputFloat("Gravity Field Radius", &sphereGravityRadius, 1.0f, 0.5f, "%.1f");
 				sphereGravityRadius = GetClamped(sphereGravityRadius, 0.0f, FLT_MAX);
-
-				SpherePLTD::RenderPreview(Vec3(pltdPos[0], pltdPos[1], pltdPos[2]), spherePltdRadius, sphereGravityRadius, pltdColor);
 			}
-			else
+
+			//position only moves the cached preview
+			float sphereShape[] = { spherePltdRadius, sphereGravityRadius };
+			uint64_t previewKey = GetPreviewShapeKey(currentPlanetoidShape, includeGravField, sphereShape, sizeof(sphereShape));
+			if (!m_previewCache->IsCached(previewKey))
 			{
-				SpherePLTD::RenderPreview(Vec3(pltdPos[0], pltdPos[1], pltdPos[2]), spherePltdRadius, 0.0f, pltdColor);
+				m_previewCache->SetPlanetoid(previewKey, new SpherePLTD(pltdPosition, spherePltdRadius, includeGravField, sphereGravityRadius, pltdGravityForce, pltdColor));
 			}
+			m_previewCache->Render(pltdPosition, EulerAngles(), pltdColor);
 		}
 		//capsule
 		else if (currentPlanetoidShape == 2)
@@ -415,15 +537,16 @@ void Game::RenderImGui()
 				ImGui::SetNextItemWidth(FLOAT_BOX_WIDTH);
 				ImGui::InputFloat("Gravity Field Radius", &capsuleGravityRadius, 1.0f, 0.5f, "%.1f");
 				capsuleGravityRadius = GetClamped(capsuleGravityRadius, 0.0f, FLT_MAX);
-
-				CapsulePLTD::RenderPreview(Vec3(pltdPos[0], pltdPos[1], pltdPos[2]), capsuleRadius, capsuleLength, Vec3(capsuleDir[0], capsuleDir[1], capsuleDir[2]), capsuleGravityRadius,
-					pltdColor);
 			}
-			else
+
+			//position only moves the cached preview, CapsulePLTD::OnTransformChanged carries its world space bone along
+			float capsuleShape[] = { capsuleRadius, capsuleLength, capsuleDir[0], capsuleDir[1], capsuleDir[2], capsuleGravityRadius };
+			uint64_t previewKey = GetPreviewShapeKey(currentPlanetoidShape, includeGravField, capsuleShape, sizeof(capsuleShape));
+			if (!m_previewCache->IsCached(previewKey))
 			{
-				CapsulePLTD::RenderPreview(Vec3(pltdPos[0], pltdPos[1], pltdPos[2]), capsuleRadius, capsuleLength, Vec3(capsuleDir[0], capsuleDir[1], capsuleDir[2]), 0.0f,
-					pltdColor);
+				m_previewCache->SetPlanetoid(previewKey, new CapsulePLTD(pltdPosition, capsuleRadius, capsuleLength, Vec3(capsuleDir[0], capsuleDir[1], capsuleDir[2]), includeGravField, capsuleGravityRadius, pltdGravityForce, pltdColor));
 			}
+			m_previewCache->Render(pltdPosition, EulerAngles(), pltdColor);
 		}
 		//ellipsoid
 		else if (currentPlanetoidShape == 3)
@@ -443,15 +566,18 @@ void Game::RenderImGui()
 				ellipsoidGravRadii[0] = GetClamped(ellipsoidGravRadii[0], 0.0f, FLT_MAX);
 				ellipsoidGravRadii[1] = GetClamped(ellipsoidGravRadii[1], 0.0f, FLT_MAX);
 				ellipsoidGravRadii[2] = GetClamped(ellipsoidGravRadii[2], 0.0f, FLT_MAX);
-
-				EllipsoidPLTD::RenderPreview(Vec3(pltdPos[0], pltdPos[1], pltdPos[2]), ellipsoidRadii[0], ellipsoidRadii[1], ellipsoidRadii[2], EulerAngles(ellipsoidAngle[0], ellipsoidAngle[1],
-					ellipsoidAngle[2]), ellipsoidGravRadii[0], ellipsoidGravRadii[1], ellipsoidGravRadii[2], pltdColor);
 			}
-			else
+
+			//position and orientation only move the cached preview
+			EulerAngles ellipsoidOrientation = EulerAngles(ellipsoidAngle[0], ellipsoidAngle[1], ellipsoidAngle[2]);
+			float ellipsoidShape[] = { ellipsoidRadii[0], ellipsoidRadii[1], ellipsoidRadii[2], ellipsoidGravRadii[0], ellipsoidGravRadii[1], ellipsoidGravRadii[2] };
+			uint64_t previewKey = GetPreviewShapeKey(currentPlanetoidShape, includeGravField, ellipsoidShape, sizeof(ellipsoidShape));
+			if (!m_previewCache->IsCached(previewKey))
 			{
-				EllipsoidPLTD::RenderPreview(Vec3(pltdPos[0], pltdPos[1], pltdPos[2]), ellipsoidRadii[0], ellipsoidRadii[1], ellipsoidRadii[2], EulerAngles(ellipsoidAngle[0], ellipsoidAngle[1],
-					ellipsoidAngle[2]), 0.0f, 0.0f, 0.0f, pltdColor);
+				m_previewCache->SetPlanetoid(previewKey, new EllipsoidPLTD(pltdPosition, ellipsoidRadii[0], ellipsoidRadii[1], ellipsoidRadii[2], ellipsoidOrientation, includeGravField, ellipsoidGravRadii[0], ellipsoidGravRadii[1],
+					ellipsoidGravRadii[2], pltdGravityForce, pltdColor));
 			}
+			m_previewCache->Render(pltdPosition, ellipsoidOrientation, pltdColor);
 		}
 		//rounded cube
 		else if (currentPlanetoidShape == 4)
@@ -474,15 +600,18 @@ void Game::RenderImGui()
 				roundCubeGravDim[0] = GetClamped(roundCubeGravDim[0], 0.0f, FLT_MAX);
 				roundCubeGravDim[1] = GetClamped(roundCubeGravDim[1], 0.0f, FLT_MAX);
 				roundCubeGravDim[2] = GetClamped(roundCubeGravDim[2], 0.0f, FLT_MAX);
-
-				RoundCubePLTD::RenderPreview(Vec3(pltdPos[0], pltdPos[1], pltdPos[2]), roundCubeDim[0], roundCubeDim[1], roundCubeDim[2], roundCubeRounded, EulerAngles(roundCubeAngle[0],
-					roundCubeAngle[1], roundCubeAngle[2]), roundCubeGravDim[0], roundCubeGravDim[1], roundCubeGravDim[2], pltdColor);
 			}
-			else
+
+			//position and orientation only move the cached preview
+			EulerAngles roundCubeOrientation = EulerAngles(roundCubeAngle[0], roundCubeAngle[1], roundCubeAngle[2]);
+			float roundCubeShape[] = { roundCubeDim[0], roundCubeDim[1], roundCubeDim[2], roundCubeRounded, roundCubeGravDim[0], roundCubeGravDim[1], roundCubeGravDim[2] };
+			uint64_t previewKey = GetPreviewShapeKey(currentPlanetoidShape, includeGravField, roundCubeShape, sizeof(roundCubeShape));
+			if (!m_previewCache->IsCached(previewKey))
 			{
-				RoundCubePLTD::RenderPreview(Vec3(pltdPos[0], pltdPos[1], pltdPos[2]), roundCubeDim[0], roundCubeDim[1], roundCubeDim[2], roundCubeRounded, EulerAngles(roundCubeAngle[0],
-					roundCubeAngle[1], roundCubeAngle[2]), 0.0f, 0.0f, 0.0f, pltdColor);
+				m_previewCache->SetPlanetoid(previewKey, new RoundCubePLTD(pltdPosition, roundCubeDim[0], roundCubeDim[1], roundCubeDim[2], roundCubeRounded, roundCubeOrientation, includeGravField, roundCubeGravDim[0],
+					roundCubeGravDim[1], roundCubeGravDim[2], pltdGravityForce, pltdColor));
 			}
+			m_previewCache->Render(pltdPosition, roundCubeOrientation, pltdColor);
 		}
 		//torus
 		else if (currentPlanetoidShape == 5)
@@ -502,15 +631,17 @@ void Game::RenderImGui()
 				ImGui::SetNextItemWidth(FLOAT_BOX_WIDTH);
 				ImGui::InputFloat("Gravity Field Radius", &torusGravRadius, 1.0f, 0.5f, "%.1f");
 				torusGravRadius = GetClamped(torusGravRadius, 0.0f, FLT_MAX);
-
-				TorusPLTD::RenderPreview(Vec3(pltdPos[0], pltdPos[1], pltdPos[2]), torusTubeRadius, torusHoleRadius, EulerAngles(torusAngle[0], torusAngle[1], torusAngle[2]), torusGravRadius,
-					pltdColor);
 			}
-			else
+
+			//position and orientation only move the cached preview
+			EulerAngles torusOrientation = EulerAngles(torusAngle[0], torusAngle[1], torusAngle[2]);
+			float torusShape[] = { torusTubeRadius, torusHoleRadius, torusGravRadius };
+			uint64_t previewKey = GetPreviewShapeKey(currentPlanetoidShape, includeGravField, torusShape, sizeof(torusShape));
+			if (!m_previewCache->IsCached(previewKey))
 			{
-				TorusPLTD::RenderPreview(Vec3(pltdPos[0], pltdPos[1], pltdPos[2]), torusTubeRadius, torusHoleRadius, EulerAngles(torusAngle[0], torusAngle[1], torusAngle[2]), 0.0f,
-					pltdColor);
+				m_previewCache->SetPlanetoid(previewKey, new TorusPLTD(pltdPosition, torusTubeRadius, torusHoleRadius, torusOrientation, includeGravField, torusGravRadius, pltdGravityForce, pltdColor));
 			}
+			m_previewCache->Render(pltdPosition, torusOrientation, pltdColor);
 		}
 		//bowl
 		else if (currentPlanetoidShape == 6)
@@ -530,13 +661,17 @@ void Game::RenderImGui()
 				ImGui::SetNextItemWidth(FLOAT_BOX_WIDTH);
 				ImGui::InputFloat("Gravity Field Radius", &bowlGravRadius, 1.0f, 0.5f, "%.1f");
 				bowlGravRadius = GetClamped(bowlGravRadius, 0.0f, FLT_MAX);
-
-				BowlPLTD::RenderPreview(Vec3(pltdPos[0], pltdPos[1], pltdPos[2]), bowlRadius, bowlThickness, EulerAngles(bowlAngle[0], bowlAngle[1], bowlAngle[2]), bowlGravRadius, pltdColor);
 			}
-			else
+
+			//position and orientation only move the cached preview
+			EulerAngles bowlOrientation = EulerAngles(bowlAngle[0], bowlAngle[1], bowlAngle[2]);
+			float bowlShape[] = { bowlRadius, bowlThickness, bowlGravRadius };
+			uint64_t previewKey = GetPreviewShapeKey(currentPlanetoidShape, includeGravField, bowlShape, sizeof(bowlShape));
+			if (!m_previewCache->IsCached(previewKey))
 			{
-				BowlPLTD::RenderPreview(Vec3(pltdPos[0], pltdPos[1], pltdPos[2]), bowlRadius, bowlThickness, EulerAngles(bowlAngle[0], bowlAngle[1], bowlAngle[2]), 0.0f, pltdColor);
+				m_previewCache->SetPlanetoid(previewKey, new BowlPLTD(pltdPosition, bowlRadius, bowlThickness, bowlOrientation, includeGravField, bowlGravRadius, pltdGravityForce, pltdColor));
 			}
+			m_previewCache->Render(pltdPosition, bowlOrientation, pltdColor);
 		}
 		//mobius strip
 		/*else if (currentPlanetoidShape == 7)
@@ -621,13 +756,18 @@ void Game::RenderImGui()
 				ImGui::SetNextItemWidth(FLOAT_BOX_WIDTH);
 				ImGui::InputFloat("Gravity Field Radius", &wireGravRadius, 1.0f, 0.5f, "%.1f");
 				wireGravRadius = GetClamped(wireGravRadius, 0.0f, FLT_MAX);
-
-				WirePLTD::RenderPreview(Vec3(pltdPos[0], pltdPos[1], pltdPos[2]), wireRadius, wirePerlin, EulerAngles(wireAngle[0], wireAngle[1], wireAngle[2]), wireGravRadius, pltdColor);
 			}
-			else
+
+			//the worm samples perlin noise at its spawn position, so moving a wire changes its shape
+			EulerAngles wireOrientation = EulerAngles(wireAngle[0], wireAngle[1], wireAngle[2]);
+			float wireShape[] = { pltdPosition.x, pltdPosition.y, pltdPosition.z, wireRadius, wireGravRadius };
+			uint64_t previewKey = GetPreviewShapeKey(currentPlanetoidShape, includeGravField, wireShape, sizeof(wireShape));
+			previewKey = HashBytes64(&wirePerlin, sizeof(wirePerlin), previewKey);
+			if (!m_previewCache->IsCached(previewKey))
 			{
-				WirePLTD::RenderPreview(Vec3(pltdPos[0], pltdPos[1], pltdPos[2]), wireRadius, wirePerlin, EulerAngles(wireAngle[0], wireAngle[1], wireAngle[2]), 0.0f, pltdColor);
+				m_previewCache->SetPlanetoid(previewKey, new WirePLTD(pltdPosition, wireRadius, wirePerlin, wireOrientation, includeGravField, wireGravRadius, pltdGravityForce, pltdColor));
 			}
+			m_previewCache->Render(pltdPosition, wireOrientation, pltdColor);
 		}
 		//prefab
 		else if (currentPlanetoidShape == 8)
@@ -656,33 +796,37 @@ void Game::RenderImGui()
 
 				if (currentPrefabType != m_previousModelIndex)
 				{
+					//the old preview releases its asset, which stays loaded if a spawned prefab is still using it
+					delete m_previewModel;
+					m_previewModel = nullptr;
+
 					switch (currentPrefabType)
 					{
 						case 0:
 						{
 							m_previewModel = new Model(Vec3(pltdPos[0], pltdPos[1], pltdPos[2]), 1.0f, EulerAngles(prefabAngle[0], prefabAngle[1], prefabAngle[2]), previewColor);
-							m_previewModel->ParseXMLFileForOBJ("Data/Models/Teapot.xml");
+							m_previewModel->ParseXMLFileForOBJ("Data/Models/Teapot.xml", true);
 
 							break;
 						}
 						case 1:
 						{
 							m_previewModel = new Model(Vec3(pltdPos[0], pltdPos[1], pltdPos[2]), 1.0f, EulerAngles(prefabAngle[0], prefabAngle[1], prefabAngle[2]), previewColor);
-							m_previewModel->ParseXMLFileForOBJ("Data/Models/DrumSeparateRocketPlanet.xml");
+							m_previewModel->ParseXMLFileForOBJ("Data/Models/DrumSeparateRocketPlanet.xml", true);
 
 							break;
 						}
 						case 2:
 						{
 							m_previewModel = new Model(Vec3(pltdPos[0], pltdPos[1], pltdPos[2]), 1.0f, EulerAngles(prefabAngle[0], prefabAngle[1], prefabAngle[2]), previewColor);
-							m_previewModel->ParseXMLFileForOBJ("Data/Models/MountainPlanet.xml");
+							m_previewModel->ParseXMLFileForOBJ("Data/Models/MountainPlanet.xml", true);
 
 							break;
 						}
 						case 3:
 						{
 							m_previewModel = new Model(Vec3(pltdPos[0], pltdPos[1], pltdPos[2]), 1.0f, EulerAngles(prefabAngle[0], prefabAngle[1], prefabAngle[2]), previewColor);
-							m_previewModel->ParseXMLFileForOBJ("Data/Models/OldFortressPlanet.xml");
+							m_previewModel->ParseXMLFileForOBJ("Data/Models/OldFortressPlanet.xml", true);
 
 							break;
 						}
@@ -699,33 +843,37 @@ void Game::RenderImGui()
 
 				if (currentPrefabType != m_previousModelIndex)
 				{
+					//the old preview releases its asset, which stays loaded if a spawned prefab is still using it
+					delete m_previewModel;
+					m_previewModel = nullptr;
+
 					switch (currentPrefabType)
 					{
 						case 0:
 						{
 							m_previewModel = new Model(Vec3(pltdPos[0], pltdPos[1], pltdPos[2]), 1.0f, EulerAngles(prefabAngle[0], prefabAngle[1], prefabAngle[2]), previewColor);
-							m_previewModel->ParseXMLFileForOBJ("Data/Models/Teapot.xml");
+							m_previewModel->ParseXMLFileForOBJ("Data/Models/Teapot.xml", true);
 
 							break;
 						}
 						case 1:
 						{
 							m_previewModel = new Model(Vec3(pltdPos[0], pltdPos[1], pltdPos[2]), 1.0f, EulerAngles(prefabAngle[0], prefabAngle[1], prefabAngle[2]), previewColor);
-							m_previewModel->ParseXMLFileForOBJ("Data/Models/DrumSeparateRocketPlanet.xml");
+							m_previewModel->ParseXMLFileForOBJ("Data/Models/DrumSeparateRocketPlanet.xml", true);
 
 							break;
 						}
 						case 2:
 						{
 							m_previewModel = new Model(Vec3(pltdPos[0], pltdPos[1], pltdPos[2]), 1.0f, EulerAngles(prefabAngle[0], prefabAngle[1], prefabAngle[2]), previewColor);
-							m_previewModel->ParseXMLFileForOBJ("Data/Models/MountainPlanet.xml");
+							m_previewModel->ParseXMLFileForOBJ("Data/Models/MountainPlanet.xml", true);
 
 							break;
 						}
 						case 3:
 						{
 							m_previewModel = new Model(Vec3(pltdPos[0], pltdPos[1], pltdPos[2]), 1.0f, EulerAngles(prefabAngle[0], prefabAngle[1], prefabAngle[2]), previewColor);
-							m_previewModel->ParseXMLFileForOBJ("Data/Models/OldFortressPlanet.xml");
+							m_previewModel->ParseXMLFileForOBJ("Data/Models/OldFortressPlanet.xml", true);
 
 							break;
 						}
@@ -751,60 +899,13 @@ void Game::RenderImGui()
 		ImGui::NewLine();
 		if (ImGui::Button("Spawn Planetoid"))
 		{
-			//plane
-			if (currentPlanetoidShape == 0)
-			{
-				SpawnPlane(Vec3(pltdPos[0], pltdPos[1], pltdPos[2]), planeHalfLength, planeHalfWidth, EulerAngles(planeAngle[0], planeAngle[1], planeAngle[2]), includeGravField, planeGravityHeight, 
-					pltdGravityForce, pltdColor);
-			}
-			//sphere
-			else if(currentPlanetoidShape == 1)
-			{
-				SpawnSphere(Vec3(pltdPos[0], pltdPos[1], pltdPos[2]), spherePltdRadius, includeGravField, sphereGravityRadius, pltdGravityForce, pltdColor);
-			}
-			//capsule
-			else if (currentPlanetoidShape == 2)
-			{
-				SpawnCapsule(Vec3(pltdPos[0], pltdPos[1], pltdPos[2]), capsuleRadius, capsuleLength, Vec3(capsuleDir[0], capsuleDir[1], capsuleDir[2]), includeGravField, capsuleGravityRadius,
-					pltdGravityForce, pltdColor);
-			}
-			//ellipsoid
-			else if (currentPlanetoidShape == 3)
-			{
-				SpawnEllipsoid(Vec3(pltdPos[0], pltdPos[1], pltdPos[2]), ellipsoidRadii[0], ellipsoidRadii[1], ellipsoidRadii[2], EulerAngles(ellipsoidAngle[0], ellipsoidAngle[1], 
-					ellipsoidAngle[2]), includeGravField, ellipsoidGravRadii[0], ellipsoidGravRadii[1], ellipsoidGravRadii[2], pltdGravityForce, pltdColor);
-			}
-			//rounded cube
-			else if (currentPlanetoidShape == 4)
-			{
-				SpawnRoundedCube(Vec3(pltdPos[0], pltdPos[1], pltdPos[2]), roundCubeDim[0], roundCubeDim[1], roundCubeDim[2], roundCubeRounded, EulerAngles(roundCubeAngle[0], 
-					roundCubeAngle[1], roundCubeAngle[2]), includeGravField, roundCubeGravDim[0], roundCubeGravDim[1], roundCubeGravDim[2], pltdGravityForce, pltdColor);
-			}
-			//torus
-			else if (currentPlanetoidShape == 5)
-			{
-				SpawnTorus(Vec3(pltdPos[0], pltdPos[1], pltdPos[2]), torusTubeRadius, torusHoleRadius, EulerAngles(torusAngle[0], torusAngle[1], torusAngle[2]), includeGravField, torusGravRadius,
-					pltdGravityForce, pltdColor);
-			}
-			//bowl
-			else if (currentPlanetoidShape == 6)
-			{
-				SpawnBowl(Vec3(pltdPos[0], pltdPos[1], pltdPos[2]), bowlRadius, bowlThickness, EulerAngles(bowlAngle[0], bowlAngle[1], bowlAngle[2]), includeGravField, bowlGravRadius, pltdGravityForce, pltdColor);
-			}
-			//mobius strip
-			/*else if (currentPlanetoidShape == 7)
-			{
-				SpawnMobiusStrip(Vec3(pltdPos[0], pltdPos[1], pltdPos[2]), mobiusStripRadius, mobiusStripWidth, EulerAngles(mobiusStripAngle[0], mobiusStripAngle[1], mobiusStripAngle[2]),
-					mobiusStripGravHeight, includeGravField, pltdGravityForce, pltdColor);
-			}*/
-			//wire
-			else if (currentPlanetoidShape == 7)
+			//procedural shapes hand over the preview that was just drawn instead of generating the mesh again
+			if (currentPlanetoidShape != 8)
 			{
-				SpawnWire(Vec3(pltdPos[0], pltdPos[1], pltdPos[2]), wireRadius, wirePerlin, EulerAngles(wireAngle[0], wireAngle[1], wireAngle[2]), includeGravField, wireGravRadius, pltdGravityForce,
-					pltdColor);
+				SpawnPreviewPlanetoid(pltdGravityForce, pltdColor);
 			}
 			//prefab
-			else if (currentPlanetoidShape == 8)
+			else
 			{
 				//teapot
 				if (currentPrefabType == 0)
@@ -829,6 +930,19 @@ void Game::RenderImGui()
 			}
 		}
 
+		ImGui::NewLine();
+		if (ImGui::Button("Save Level"))
+		{
+			EventArgs args;
+			Event_SaveLevel(args);
+		}
+		ImGui::SameLine();
+		if (ImGui::Button("Load Level"))
+		{
+			EventArgs args;
+			Event_LoadLevel(args);
+		}
+
 		ImGui::NewLine();
 		ImGui::NewLine();
 		ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(1.0f, 0.0f, 0.0f, 1.0f));
@@ -867,6 +981,11 @@ void Game::RenderImGui()
 
 		ImGui::End();
 	}
+
+	if (m_profilerMenuOpen)
+	{
+		RenderProfilerImGui();
+	}
 }
 
 
@@ -962,6 +1081,9 @@ void Game::Shutdown()
 	std::string fileName = "Data/Exported/RenameThisAfterTest.txt";
 	FileWriteFromBuffer(outBuffer, fileName);
 
+	//waits on any cell still building, and deletes the ones built but not handed over yet
+	StopWorldStreaming();
+
 	//delete planetoids
 	for (int pltdIndex = 0; pltdIndex < m_planetoids.size(); pltdIndex++)
 	{
@@ -972,12 +1094,40 @@ void Game::Shutdown()
 		}
 	}
 
+	//planetoids hand their buffers back to this, so it goes after them
+	if (m_meshUploader != nullptr)
+	{
+		delete m_meshUploader;
+		m_meshUploader = nullptr;
+	}
+
+	if (m_fieldDebugBatch != nullptr)
+	{
+		delete m_fieldDebugBatch;
+		m_fieldDebugBatch = nullptr;
+	}
+
+	if (m_previewCache != nullptr)
+	{
+		delete m_previewCache;
+		m_previewCache = nullptr;
+	}
+
 	if (m_previewModel != nullptr)
 	{
 		delete m_previewModel;
 		m_previewModel = nullptr;
 	}
+
+	//loads still queued finish on the workers and clean themselves up before the job system shuts down
+	SetModelAssetJobSystem(nullptr);
 	
+	if (m_simulation != nullptr)
+	{
+		delete m_simulation;
+		m_simulation = nullptr;
+	}
+
 	if (m_player != nullptr)
 	{
 		delete m_player;
@@ -991,159 +1141,141 @@ void Game::Shutdown()
 //
 void Game::ClearAllPlanetoids()
 {
+	//the streamer would hand back planetoids that are about to be deleted
+	StopWorldStreaming();
+
 	for (int pltdIndex = 0; pltdIndex < m_planetoids.size(); pltdIndex++)
 	{
 		if (m_planetoids[pltdIndex] != nullptr)
 		{
+			m_simulation->ForgetGravitySource(m_planetoids[pltdIndex]->m_field);
 			delete m_planetoids[pltdIndex];
 			m_planetoids[pltdIndex] = nullptr;
 		}
 	}
+
+	//cleared now rather than on the next update so nothing draws a deleted planetoid
+	m_planetoidDrawOrder.clear();
+	m_isPlanetoidDrawOrderDirty = true;
+
+	m_simulation->MarkPlanetoidsDirty();
+	m_fieldDebugBatch->MarkDirty();
 }
 
 
 void Game::AddPlanetoidsForPlaytestingCourse()
 {
-	//add planetoids for starting area before course
-	SpawnSphere(Vec3(0.0f, 0.0f, -26.0f), 20.0f, true, 30.0f, GRAVITY_STANDARD, Rgba8(50, 150, 100));
-	SpawnTorus(Vec3(50.0f, 0.0f, 0.0f), 9.0f, 22.0f, EulerAngles(), true, 12.0f, GRAVITY_STANDARD, Rgba8(255, 255, 0));
-	
-	SpawnCapsule(Vec3(50.0f, 47.5f, 0.0f), 5.0f, 17.5f, Vec3(0.0f, 1.0f, 0.0f), true, 12.5f, GRAVITY_STANDARD, Rgba8(0, 175, 25));
-	SpawnMountain(Vec3(50.0f, 95.0f, -4.0f), 1.0f, EulerAngles(), true, 45.0f, GRAVITY_STANDARD, Rgba8(25, 150, 220));
-
-	SpawnCapsule(Vec3(50.0f, -47.5f, 0.0f), 5.0f, 17.5f, Vec3(0.0f, -1.0f, 0.0f), true, 12.5f, GRAVITY_STANDARD, Rgba8(25, 0, 175));
-	SpawnRoundedCube(Vec3(55.0f, -75.0f, 7.0f), 8.0f, 9.0f, 6.0f, 0.75f, EulerAngles(-20.0f, 0.0f, 0.0f), true, 18.0f, 19.0f, 16.0f, GRAVITY_STANDARD, Rgba8(200, 200, 200));
-	SpawnRoundedCube(Vec3(65.0f, -80.0f, 14.0f), 9.0f, 8.0f, 6.0f, 0.5f, EulerAngles(15.0f, 15.0f, 15.0f), true, 19.0f, 18.0f, 16.0f, GRAVITY_STANDARD, Rgba8(150, 150, 150));
-	SpawnRoundedCube(Vec3(76.0f, -76.0f, 19.0f), 10.0f, 9.0f, 12.0f, 0.25f, EulerAngles(0.0f, -5.0f, 45.0f), true, 20.0f, 19.0f, 22.0f, GRAVITY_STANDARD, Rgba8(100, 100, 100));
-
-	SpawnCapsule(Vec3(94.0f, 0.0f, 0.0f), 5.0f, 20.0f, Vec3(1.0f, 0.0f, 0.0f), true, 12.5f, GRAVITY_STANDARD, Rgba8(100, 0, 100));
-	Mat44 textTransform = Mat44::CreateTranslation3D(Vec3(114.0f, 0.0f, 10.0f));
-	textTransform.AppendZRotation(180.0f);
-	DebugAddWorldText("Enter Playtest Course Here", textTransform, 0.5f, Vec2(0.5f, 0.5f), -1.0f);
-	
-	//Section 1
-	m_checkpoints.emplace_back(AABB3(Vec3(247.0f, -5.0f, 0.0f), Vec3(253.0f, 5.0f, 15.0f)));
-	textTransform = Mat44::CreateTranslation3D(Vec3(253.0f, 0.0f, 15.0f));
-	textTransform.AppendZRotation(180.0f);
-	DebugAddWorldText("Section 1", textTransform, 0.5f, Vec2(0.5f, 0.5f), -1.0f);
-
-	SpawnSphere(Vec3(250.0f, 0.0f, 0.0f), 10.0f, true, 20.0f, GRAVITY_STANDARD, Rgba8(50, 100, 200));
-	SpawnSphere(Vec3(257.0f, -6.0f, 5.0f), 8.0f, true, 16.0f, GRAVITY_STANDARD, Rgba8(200, 100, 50));
-	SpawnSphere(Vec3(265.0f, 6.0f, 11.0f), 11.0f, true, 22.0f, GRAVITY_STANDARD, Rgba8(100, 200, 50));
-	SpawnSphere(Vec3(290.0f, -2.0f, 18.0f), 10.0f, true, 20.0f, GRAVITY_STANDARD, Rgba8(100, 50, 100));
-	SpawnEllipsoid(Vec3(305.0f, 0.0f, 30.0f), 6.0f, 6.0f, 3.5f, EulerAngles(), true, 24.0f, 24.0f, 14.0f, GRAVITY_STANDARD, Rgba8(150, 255, 0));
-	SpawnCapsule(Vec3(320.0f, 0.0f, 35.0f), 3.5f, 15.0f, Vec3(1.0f, 1.0f, 0.0f), true, 16.0f, GRAVITY_STANDARD, Rgba8(200, 75, 150));
-	SpawnCapsule(Vec3(340.0f, 10.0f, 35.0f), 3.5f, 15.0f, Vec3(1.0f, -1.0f, 0.0f), true, 16.0f, GRAVITY_STANDARD, Rgba8(125, 75, 175));
-
-	SpawnMountain(Vec3(377.0f, 0.0f, 35.0f), 1.0f, EulerAngles(315.0f, 0.0f, 0.0f), true, 45.0f, GRAVITY_STANDARD, Rgba8(0, 200, 10));
-	SpawnSphere(Vec3(379.0f, 0.0f, 90.0f), 10.0f, true, 20.0f, GRAVITY_STANDARD, Rgba8(50, 255, 255));
-	SpawnBowl(Vec3(408.0f, 0.0f, 90.0f), 10.0f, 3.5f, EulerAngles(45.0f, 30.0f, 10.0f), true, 10.0f, GRAVITY_STANDARD, Rgba8(255, 0, 250));
-	WirePerlinParameters wirePerlin;
-	wirePerlin.m_minSegments = 5;
-	wirePerlin.m_maxSegments = 5;
-	wirePerlin.m_maxYawChange = 90.0f;
-	wirePerlin.m_maxPitchChange = 45.0f;
-	wirePerlin.m_segMinLength = 10.0f;
-	wirePerlin.m_segMaxLength = 25.0f;
-	wirePerlin.m_rngSeed = 1234;
-	SpawnWire(Vec3(427.0f, 0.0f, 87.5f), 5.0f, wirePerlin, EulerAngles(), true, 10.0f, GRAVITY_STANDARD, Rgba8(187, 108, 156));
-	SpawnRoundedCube(Vec3(496.0f, 85.0f, 100.0f), 20.0f, 20.0f, 25.0f, 0.5f, EulerAngles(), true, 40.0f, 40.0f, 45.0f, GRAVITY_STANDARD, Rgba8(50, 160, 142));
-
-	//Section 2
-	m_checkpoints.emplace_back(AABB3(Vec3(511.0f, 55.0f, 102.0f), Vec3(561.0f, 115.0f, 132.0f)));
-	textTransform = Mat44::CreateTranslation3D(Vec3(516.0f, 85.0f, 115.0f));
-	textTransform.AppendZRotation(180.0f);
-	DebugAddWorldText("Section 2", textTransform, 0.5f, Vec2(0.5f, 0.5f), -1.0f);
-	SpawnRoundedCube(Vec3(536.0f, 85.0f, 102.0f), 50.0f, 50.0f, 15.0f, 0.25f, EulerAngles(), true, 75.0f, 75.0f, 40.0f, GRAVITY_STANDARD, Rgba8(50, 100, 50));
-	textTransform = Mat44::CreateTranslation3D(Vec3(536.0f, 85.0f, 115.0f));
-	textTransform.AppendZRotation(180.0f);
-	DebugAddWorldText("Jump against a wall to wall slide\n\nJump while sliding to wall jump", textTransform, 0.5f, Vec2(0.5f, 0.5f), -1.0f);
-	SpawnPlane(Vec3(545.0f, 88.0f, 120.0f), 6.0f, 11.0f, EulerAngles(0.0f, 0.0f, 90.0f), false, 0.0f, 0.0f, Rgba8(200, 0, 0));
-	SpawnPlane(Vec3(545.0f, 88.1f, 120.0f), 6.0f, 11.0f, EulerAngles(0.0f, 0.0f, -90.0f), false, 0.0f, 0.0f, Rgba8(200, 0, 0));
-	SpawnPlane(Vec3(545.0f, 82.0f, 120.0f), 6.0f, 11.0f, EulerAngles(0.0f, 0.0f, -90.0f), false, 0.0f, 0.0f, Rgba8(200, 0, 0));
-	SpawnPlane(Vec3(545.0f, 81.9f, 120.0f), 6.0f, 11.0f, EulerAngles(0.0f, 0.0f, 90.0f), false, 0.0f, 0.0f, Rgba8(200, 0, 0));
-	SpawnSphere(Vec3(545.0f, 85.0f, 152.0f), 10.0f, true, 20.0f, GRAVITY_STANDARD, Rgba8(100, 50, 50));
-	SpawnSphere(Vec3(572.0f, 85.0f, 157.0f), 10.0f, true, 20.0f, GRAVITY_STANDARD, Rgba8(50, 50, 100));
-	SpawnSphere(Vec3(588.0f, 85.0f, 155.0f), 8.0f, true, 18.0f, GRAVITY_STANDARD, Rgba8(105, 110, 125));
-
-	SpawnRoundedCube(Vec3(675.0f, 85.0f, 150.0f), 160.0f, 100.0f, 10.0f, 0.01f, EulerAngles(), true, 300.0f, 200.0f, 200.0f, GRAVITY_STANDARD, Rgba8(109, 179, 240));
-	textTransform = Mat44::CreateTranslation3D(Vec3(625.0f, 85.0f, 162.0f));
-	textTransform.AppendZRotation(180.0f);
-	DebugAddWorldText("Hold left trigger to crouch\n\nCrouch and jump while not moving to back flip", textTransform, 0.5f, Vec2(0.5f, 0.5f), -1.0f);
-	SpawnRoundedCube(Vec3(635.0f, 74.0f, 160.0f), 8.0f, 3.0f, 10.0f, 0.0f, EulerAngles(), false, 0.0f, 0.0f, 0.0f, 0.0f, Rgba8(200, 0, 0));
-	SpawnRoundedCube(Vec3(635.0f, 77.0f, 170.0f), 8.0f, 3.0f, 10.0f, 0.0f, EulerAngles(), false, 0.0f, 0.0f, 0.0f, 0.0f, Rgba8(200, 0, 0));
-	SpawnRoundedCube(Vec3(640.0f, 85.0f, 180.0f), 16.0f, 7.5f, 5.0f, 0.0f, EulerAngles(), false, 0.0f, 0.0f, 0.0f, 0.0f, Rgba8(200, 0, 0));
-	textTransform = Mat44::CreateTranslation3D(Vec3(665.0f, 85.0f, 186.0f));
-	textTransform.AppendZRotation(180.0f);
-	DebugAddWorldText("Run, crouch, and jump to long jump", textTransform, 0.5f, Vec2(0.5f, 0.5f), -1.0f);
-	SpawnRoundedCube(Vec3(670.0f, 85.0f, 180.0f), 16.0f, 10.0f, 5.0f, 0.0f, EulerAngles(), false, 0.0f, 0.0f, 0.0f, 0.0f, Rgba8(200, 0, 0));
-	SpawnRoundedCube(Vec3(686.0f, 85.0f, 185.0f), 16.0f, 10.0f, 5.0f, 0.0f, EulerAngles(), false, 0.0f, 0.0f, 0.0f, 0.0f, Rgba8(200, 0, 0));
-	SpawnSkyStation(Vec3(730.0f, 85.0f, 189.0f), 1.0f, EulerAngles(-90.0f, -30.0f, 0.0f), true, 45.0f, GRAVITY_STANDARD, Rgba8(0, 255, 125));
-	SpawnSphere(Vec3(745.0f, 85.0f, 225.0f), 10.0f, true, 25.0f, GRAVITY_STANDARD, Rgba8(194, 190, 5));
-
-	//Section 3
-	m_checkpoints.emplace_back(AABB3(Vec3(760.0f, 55.0f, 200.0f), Vec3(795.0f, 115.0f, 285.0f)));
-	textTransform = Mat44::CreateTranslation3D(Vec3(773.0f, 85.0f, 240.0f));
-	textTransform.AppendZRotation(180.0f);
-	DebugAddWorldText("Section 3", textTransform, 0.5f, Vec2(0.5f, 0.5f), -1.0f);
-	SpawnCapsule(Vec3(770.0f, 85.0f, 225.0f), 10.0f, 20.0f, Vec3(1.0f, 0.0f, 0.0f), true, 25.0f, GRAVITY_STANDARD, Rgba8(30, 20, 250));
-	SpawnFortress(Vec3(870.0f, 84.0f, 225.0f), 1.0f, EulerAngles(225.0f, 0.0f, 0.0f), true, 40.0f, GRAVITY_STANDARD, Rgba8(70, 215, 0));
-	SpawnPlane(Vec3(865.0f, 84.0f, 256.25f), 4.0f, 4.0f, EulerAngles(), false, 0.0f, 0.0f, Rgba8(70, 215, 0));
-	SpawnRoundedCube(Vec3(874.0f, 80.0f, 269.0f), 6.0f, 2.0f, 20.0f, 0.0f, EulerAngles(), false, 0.0f, 0.0f, 0.0f, 0.0f, Rgba8(200, 0, 0));
-	SpawnRoundedCube(Vec3(874.0f, 86.0f, 273.0f), 6.0f, 2.0f, 20.0f, 0.0f, EulerAngles(), false, 0.0f, 0.0f, 0.0f, 0.0f, Rgba8(200, 0, 0));
-	SpawnRoundedCube(Vec3(874.0f, 70.0f, 277.5f), 10.0f, 18.0f, 3.0f, 0.0f, EulerAngles(), false, 0.0f, 0.0f, 0.0f, 0.0f, Rgba8(200, 0, 0));
-	SpawnSphere(Vec3(874.0f, 0.0f, 282.5f), 12.0f, true, 60.0f, GRAVITY_STANDARD, Rgba8(255, 255, 0));
-	SpawnBowl(Vec3(874.0f, 0.0f, 282.5f), 20.0f, 8.0f, EulerAngles(90.0f, 85.0f, 0.0f), false, 0.0f, 0.0f, Rgba8(255, 255, 0));
-	SpawnCapsule(Vec3(874.0f, -50.0f, 284.0f), 12.0f, 100.0f, Vec3(0.0f, -1.0f, 0.0f), true, 50.0f, GRAVITY_STANDARD, Rgba8(140, 120, 190));
-	SpawnRoundedCube(Vec3(885.0f, -57.5f, 284.0f), 30.0f, 3.0f, 50.0f, 0.0f, EulerAngles(), false, 0.0f, 0.0f, 0.0f, 0.0f, Rgba8(200, 0, 0));
-	SpawnRoundedCube(Vec3(865.0f, -82.5f, 284.0f), 30.0f, 3.0f, 50.0f, 0.0f, EulerAngles(), false, 0.0f, 0.0f, 0.0f, 0.0f, Rgba8(200, 0, 0));
-	SpawnRoundedCube(Vec3(874.0f, -107.5f, 300.0f), 50.0f, 3.0f, 30.0f, 0.0f, EulerAngles(), false, 0.0f, 0.0f, 0.0f, 0.0f, Rgba8(200, 0, 0));
-	SpawnCapsule(Vec3(874.0f, -150.0f, 284.0f), 12.0f, 60.0f, Vec3(0.0f, 0.0f, 1.0f), true, 50.0f, GRAVITY_STANDARD, Rgba8(140, 120, 190));
-	SpawnCapsule(Vec3(874.0f, -150.0f, 344.0f), 12.0f, 60.0f, Vec3(0.0f, 1.0f, 1.0f), true, 50.0f, GRAVITY_STANDARD, Rgba8(140, 120, 190));
-	
-	//Section 4
-	m_checkpoints.emplace_back(AABB3(Vec3(880.0f, -148.0f, 386.0f), Vec3(920.0f, -68.0f, 419.0f)));
-	textTransform = Mat44::CreateTranslation3D(Vec3(900.0f, -108.0f, 401.0f));
-	textTransform.AppendZRotation(180.0f);
-	DebugAddWorldText("Section 4", textTransform, 0.5f, Vec2(0.5f, 0.5f), -1.0f);
-	textTransform = Mat44::CreateTranslation3D(Vec3(915.0f, -108.0f, 401.0f));
-	textTransform.AppendZRotation(180.0f);
-	DebugAddWorldText("Jump three times in a row while running\nto triple jump", textTransform, 0.5f, Vec2(0.5f, 0.5f), -1.0f);
-	SpawnRoundedCube(Vec3(912.0f, -108.0f, 386.0f), 45.0f, 30.0f, 20.0f, 0.25f, EulerAngles(), true, 45.0f, 50.0f, 40.0f, GRAVITY_STANDARD, Rgba8(255, 170, 150));
-	SpawnRoundedCube(Vec3(948.0f, -108.0f, 421.0f), 25.0f, 30.0f, 15.0f, 0.25f, EulerAngles(), true, 45.0f, 50.0f, 40.0f, GRAVITY_STANDARD, Rgba8(190, 170, 180));
-	SpawnTorus(Vec3(1045.0f, -108.0f, 450.0f), 12.0f, 50.0f, EulerAngles(0.0f, -25.0f, 0.0f), true, 42.0f, GRAVITY_STANDARD, Rgba8(60, 54, 206));
-	SpawnRoundedCube(Vec3(1045.0f, -46.0f, 450.0f), 3.0f, 60.0f, 60.0f, 0.0f, EulerAngles(0.0f, -25.0f, 0.0f), false, 0.0f, 0.0f, 0.0f, 0.0f, Rgba8(200, 0, 0));
-	SpawnRoundedCube(Vec3(1045.0f, -170.0f, 450.0f), 3.0f, 60.0f, 60.0f, 0.0f, EulerAngles(0.0f, -25.0f, 0.0f), false, 0.0f, 0.0f, 0.0f, 0.0f, Rgba8(200, 0, 0));
-	SpawnSphere(Vec3(1045.0f, -108.0f, 450.0f), 29.0f, true, 50.0f, GRAVITY_STANDARD, Rgba8(106, 187, 156));
-	SpawnSphere(Vec3(1140.0f, -108.0f, 490.0f), 10.0f, true, 40.0f, GRAVITY_STANDARD, Rgba8(255, 0, 0));
-	SpawnSphere(Vec3(1145.0f, -113.0f, 495.0f), 10.0f, true, 40.0f, GRAVITY_STANDARD, Rgba8(255, 85, 0));
-	SpawnSphere(Vec3(1150.0f, -116.0f, 502.0f), 10.0f, true, 40.0f, GRAVITY_STANDARD, Rgba8(255, 170, 0));
-	SpawnSphere(Vec3(1155.0f, -118.0f, 510.0f), 10.0f, true, 40.0f, GRAVITY_STANDARD, Rgba8(255, 255, 0));
-	SpawnSphere(Vec3(1160.0f, -119.0f, 519.0f), 10.0f, true, 40.0f, GRAVITY_STANDARD, Rgba8(170, 255, 0));
-	SpawnSphere(Vec3(1165.0f, -118.0f, 528.0f), 10.0f, true, 40.0f, GRAVITY_STANDARD, Rgba8(85, 255, 0));
-	SpawnSphere(Vec3(1170.0f, -116.0f, 536.0f), 10.0f, true, 40.0f, GRAVITY_STANDARD, Rgba8(0, 255, 0));
-	SpawnSphere(Vec3(1175.0f, -113.0f, 543.0f), 10.0f, true, 40.0f, GRAVITY_STANDARD, Rgba8(0, 255, 85));
-	SpawnSphere(Vec3(1180.0f, -108.0f, 548.0f), 10.0f, true, 40.0f, GRAVITY_STANDARD, Rgba8(0, 255, 170));
-	SpawnSphere(Vec3(1185.0f, -103.0f, 553.0f), 10.0f, true, 40.0f, GRAVITY_STANDARD, Rgba8(0, 255, 255));
-	SpawnSphere(Vec3(1190.0f, -100.0f, 560.0f), 10.0f, true, 40.0f, GRAVITY_STANDARD, Rgba8(0, 170, 255));
-	SpawnSphere(Vec3(1195.0f, -98.0f, 568.0f), 10.0f, true, 40.0f, GRAVITY_STANDARD, Rgba8(0, 85, 255));
-	SpawnSphere(Vec3(1200.0f, -97.0f, 577.0f), 10.0f, true, 40.0f, GRAVITY_STANDARD, Rgba8(0, 0, 255));
-	SpawnSphere(Vec3(1205.0f, -98.0f, 586.0f), 10.0f, true, 40.0f, GRAVITY_STANDARD, Rgba8(85, 0, 255));
-	SpawnSphere(Vec3(1210.0f, -100.0f, 594.0f), 10.0f, true, 40.0f, GRAVITY_STANDARD, Rgba8(170, 0, 255));
-	SpawnSphere(Vec3(1215.0f, -103.0f, 601.0f), 10.0f, true, 40.0f, GRAVITY_STANDARD, Rgba8(255, 0, 255));
-	SpawnSphere(Vec3(1220.0f, -108.0f, 606.0f), 10.0f, true, 40.0f, GRAVITY_STANDARD, Rgba8(255, 0, 170));
-	SpawnSphere(Vec3(1225.0f, -108.0f, 611.0f), 10.0f, true, 40.0f, GRAVITY_STANDARD, Rgba8(255, 0, 85));
-	SpawnSphere(Vec3(1325.0f, -108.0f, 711.0f), 110.0f, true, 160.0f, GRAVITY_STANDARD, Rgba8());
-	textTransform = Mat44::CreateTranslation3D(Vec3(1325.0f, -108.0f, 826.0f));
-	textTransform.AppendZRotation(180.0f);
-	DebugAddWorldText("You made it to the end! Congrats!", textTransform, 0.5f, Vec2(0.5f, 0.5f), -1.0f);
+	PlaytestCourse course;
+	LoadPlaytestCourse(course);
+	AddLevel(course);
+}
+
+
+void Game::AddLevel(PlaytestCourse const& level)
+{
+	m_planetoids.reserve(m_planetoids.size() + level.m_planetoids.size());
+	for (int pltdIndex = 0; pltdIndex < level.m_planetoids.size(); pltdIndex++)
+	{
+		AddPlanetoid(level.m_planetoids[pltdIndex]);
+	}
+
+	m_checkpoints.insert(m_checkpoints.end(), level.m_checkpoints.begin(), level.m_checkpoints.end());
+
+	for (int signIndex = 0; signIndex < level.m_signs.size(); signIndex++)
+	{
+		m_courseSigns.emplace_back(level.m_signs[signIndex]);
+		DebugAddWorldText(level.m_signs[signIndex].m_text, level.m_signs[signIndex].m_transform, 0.5f, Vec2(0.5f, 0.5f), -1.0f);
+	}
+}
+
+
+bool Game::SaveLevel(std::string const& filePath) const
+{
+	//the level only borrows the planetoids long enough to write them
+	PlaytestCourse level;
+	level.m_planetoids = m_planetoids;
+	level.m_checkpoints = m_checkpoints;
+	level.m_signs = m_courseSigns;
+	return WriteLevelFile(level, filePath);
+}
+
+
+bool Game::LoadLevel(std::string const& filePath)
+{
+	PlaytestCourse level;
+	if (!ReadLevelFile(level, filePath))
+	{
+		return false;
+	}
+
+	ResetLevel();
+	AddLevel(level);
+	return true;
+}
+
+
+void Game::RemovePlanetoids(std::vector<Planetoid*> const& planetoids)
+{
+	std::unordered_set<Planetoid*> planetoidsToRemove(planetoids.begin(), planetoids.end());
+	m_planetoids.erase(std::remove_if(m_planetoids.begin(), m_planetoids.end(), [&planetoidsToRemove](Planetoid* planetoid) { return planetoidsToRemove.count(planetoid) > 0; }),
+		m_planetoids.end());
+
+	for (int pltdIndex = 0; pltdIndex < planetoids.size(); pltdIndex++)
+	{
+		m_simulation->ForgetGravitySource(planetoids[pltdIndex]->m_field);
+		delete planetoids[pltdIndex];
+	}
+
+	//cleared now rather than on the next update so nothing draws a deleted planetoid
+	m_planetoidDrawOrder.clear();
+	m_isPlanetoidDrawOrderDirty = true;
+
+	m_simulation->MarkPlanetoidsDirty();
+	m_fieldDebugBatch->MarkDirty();
+}
+
+
+//
+//public world streaming functions
+//
+bool Game::StartWorldStreaming(std::string const& filePath, WorldStreamerConfig const& config)
+{
+	LevelDescription level;
+	if (!ReadLevelDescription(level, filePath))
+	{
+		return false;
+	}
+
+	//checkpoints and signs are tiny, so they're added up front and stay for the whole level
+	ResetLevel();
+	PlaytestCourse alwaysLoaded;
+	alwaysLoaded.m_checkpoints = level.m_checkpoints;
+	alwaysLoaded.m_signs = level.m_signs;
+	AddLevel(alwaysLoaded);
+
+	WorldStreamerConfig streamerConfig = config;
+	streamerConfig.m_jobSystem = g_theJobSystem;
+	m_worldStreamer = new WorldStreamer(streamerConfig, level);
+	UpdateWorldStreaming();
+	return true;
+}
+
+
+//planetoids already streamed in stay in the world, they just stop being streamed out again
+void Game::StopWorldStreaming()
+{
+	if (m_worldStreamer != nullptr)
+	{
+		delete m_worldStreamer;
+		m_worldStreamer = nullptr;
+	}
 }
 
 
 PlanePLTD* Game::SpawnPlane(Vec3 position, float halfLength, float halfWidth, EulerAngles orientation, bool includeField, float gravityHeight, float gravityForce, Rgba8 color)
 {
 	PlanePLTD* plane = new PlanePLTD(position, halfLength, halfWidth, orientation, includeField, gravityHeight, gravityForce, color);
-	m_planetoids.emplace_back(plane);
+	AddPlanetoid(plane);
 	return plane;
 }
 
@@ -1151,7 +1283,7 @@ PlanePLTD* Game::SpawnPlane(Vec3 position, float halfLength, float halfWidth, Eu
 SpherePLTD* Game::SpawnSphere(Vec3 position, float radius, bool includeField, float gravityRadius, float gravityForce, Rgba8 color)
 {
 	SpherePLTD* sphere = new SpherePLTD(position, radius, includeField, gravityRadius, gravityForce, color);
-	m_planetoids.emplace_back(sphere);
+	AddPlanetoid(sphere);
 	return sphere;
 }
 
@@ -1159,7 +1291,7 @@ SpherePLTD* Game::SpawnSphere(Vec3 position, float radius, bool includeField, fl
 CapsulePLTD* Game::SpawnCapsule(Vec3 position, float radius, float boneLength, Vec3 boneDirection, bool includeField, float gravityRadius, float gravityForce, Rgba8 color)
 {
 	CapsulePLTD* capsule = new CapsulePLTD(position, radius, boneLength, boneDirection, includeField, gravityRadius, gravityForce, color);
-	m_planetoids.emplace_back(capsule);
+	AddPlanetoid(capsule);
 	return capsule;
 }
 
@@ -1167,7 +1299,7 @@ CapsulePLTD* Game::SpawnCapsule(Vec3 position, float radius, float boneLength, V
 EllipsoidPLTD* Game::SpawnEllipsoid(Vec3 position, float xRadius, float yRadius, float zRadius, EulerAngles orientation, bool includeField, float gravityXRadius, float gravityYRadius, float gravityZRadius, float gravityForce, Rgba8 color)
 {
 	EllipsoidPLTD* ellipsoid = new EllipsoidPLTD(position, xRadius, yRadius, zRadius, orientation, includeField, gravityXRadius, gravityYRadius, gravityZRadius, gravityForce, color);
-	m_planetoids.emplace_back(ellipsoid);
+	AddPlanetoid(ellipsoid);
 	return ellipsoid;
 }
 
@@ -1175,7 +1307,7 @@ EllipsoidPLTD* Game::SpawnEllipsoid(Vec3 position, float xRadius, float yRadius,
 RoundCubePLTD* Game::SpawnRoundedCube(Vec3 position, float length, float width, float height, float roundedness, EulerAngles orientation, bool includeField, float gravityLength, float gravityWidth, float gravityHeight, float gravityForce, Rgba8 color)
 {
 	RoundCubePLTD* roundCube = new RoundCubePLTD(position, length, width, height, roundedness, orientation, includeField, gravityLength, gravityWidth, gravityHeight, gravityForce, color);
-	m_planetoids.emplace_back(roundCube);
+	AddPlanetoid(roundCube);
 	return roundCube;
 }
 
@@ -1183,7 +1315,7 @@ RoundCubePLTD* Game::SpawnRoundedCube(Vec3 position, float length, float width,
 TorusPLTD* Game::SpawnTorus(Vec3 position, float tubeRadius, float holeRadius, EulerAngles orientation, bool includeField, float gravityRadius, float gravityForce, Rgba8 color)
 {
 	TorusPLTD* torus = new TorusPLTD(position, tubeRadius, holeRadius, orientation, includeField, gravityRadius, gravityForce, color);
-	m_planetoids.emplace_back(torus);
+	AddPlanetoid(torus);
 	return torus;
 }
 
@@ -1191,7 +1323,7 @@ TorusPLTD* Game::SpawnTorus(Vec3 position, float tubeRadius, float holeRadius, E
 BowlPLTD* Game::SpawnBowl(Vec3 position, float radius, float thickness, EulerAngles orientation, bool includeField, float gravityRadius, float gravityForce, Rgba8 color)
 {
 	BowlPLTD* bowl = new BowlPLTD(position, radius, thickness, orientation, includeField, gravityRadius, gravityForce, color);
-	m_planetoids.emplace_back(bowl);
+	AddPlanetoid(bowl);
 	return bowl;
 }
 
@@ -1199,7 +1331,7 @@ BowlPLTD* Game::SpawnBowl(Vec3 position, float radius, float thickness, EulerAng
 MobiusPLTD* Game::SpawnMobiusStrip(Vec3 position, float radius, float width, EulerAngles orientation, bool includeField, float gravityHeight, float gravityForce, Rgba8 color)
 {
 	MobiusPLTD* strip = new MobiusPLTD(position, radius, width * 0.5f, orientation, includeField, gravityHeight, gravityForce, color);
-	m_planetoids.emplace_back(strip);
+	AddPlanetoid(strip);
 	return strip;
 }
 
@@ -1207,7 +1339,7 @@ MobiusPLTD* Game::SpawnMobiusStrip(Vec3 position, float radius, float width, Eul
 WirePLTD* Game::SpawnWire(Vec3 position, float radius, WirePerlinParameters perlinStruct, EulerAngles orientation, bool includeField, float gravityRadius, float gravityForce, Rgba8 color)
 {
 	WirePLTD* wire = new WirePLTD(position, radius, perlinStruct, orientation, includeField, gravityRadius, gravityForce, color);
-	m_planetoids.emplace_back(wire);
+	AddPlanetoid(wire);
 	return wire;
 }
 
@@ -1215,7 +1347,7 @@ WirePLTD* Game::SpawnWire(Vec3 position, float radius, WirePerlinParameters perl
 TeapotPLTD* Game::SpawnTeapot(Vec3 position, float scale, EulerAngles orientation, bool includeField, float gravityRadius, float gravityForce, Rgba8 color)
 {
 	TeapotPLTD* teapot = new TeapotPLTD(position, scale, orientation, color, includeField, gravityRadius, gravityForce);
-	m_planetoids.emplace_back(teapot);
+	AddPlanetoid(teapot);
 	return teapot;
 }
 
@@ -1223,7 +1355,7 @@ TeapotPLTD* Game::SpawnTeapot(Vec3 position, float scale, EulerAngles orientatio
 SkyStationPLTD* Game::SpawnSkyStation(Vec3 position, float scale, EulerAngles orientation, bool includeField, float gravityRadius, float gravityForce, Rgba8 color)
 {
 	SkyStationPLTD* skyStation = new SkyStationPLTD(position, scale, orientation, color, includeField, gravityRadius, gravityForce);
-	m_planetoids.emplace_back(skyStation);
+	AddPlanetoid(skyStation);
 	return skyStation;
 }
 
@@ -1231,7 +1363,7 @@ SkyStationPLTD* Game::SpawnSkyStation(Vec3 position, float scale, EulerAngles or
 MountainPLTD* Game::SpawnMountain(Vec3 position, float scale, EulerAngles orientation, bool includeField, float gravityRadius, float gravityForce, Rgba8 color)
 {
 	MountainPLTD* mountain = new MountainPLTD(position, scale, orientation, color, includeField, gravityRadius, gravityForce);
-	m_planetoids.emplace_back(mountain);
+	AddPlanetoid(mountain);
 	return mountain;
 }
 
@@ -1239,11 +1371,63 @@ MountainPLTD* Game::SpawnMountain(Vec3 position, float scale, EulerAngles orient
 FortressPLTD* Game::SpawnFortress(Vec3 position, float scale, EulerAngles orientation, bool includeField, float gravityHeight, float gravityForce, Rgba8 color)
 {
 	FortressPLTD* fortress = new FortressPLTD(position, scale, orientation, color, includeField, gravityHeight, gravityForce);
-	m_planetoids.emplace_back(fortress);
+	AddPlanetoid(fortress);
 	return fortress;
 }
 
 
+Planetoid* Game::SpawnPreviewPlanetoid(float gravityForce, Rgba8 color)
+{
+	//the preview is already generated and placed, color and force aren't part of its key so they're applied here
+	Planetoid* planetoid = m_previewCache->TakePlanetoid();
+	if (planetoid == nullptr)
+	{
+		return nullptr;
+	}
+
+	planetoid->m_color = color;
+	if (planetoid->m_field != nullptr)
+	{
+		planetoid->m_field->m_force = gravityForce;
+	}
+
+	AddPlanetoid(planetoid);
+	return planetoid;
+}
+
+
+void Game::AddPlanetoid(Planetoid* planetoid)
+{
+	planetoid->UpdateWorldBounds();
+	planetoid->CreateGPUMesh(*m_meshUploader);
+	m_planetoids.emplace_back(planetoid);
+	m_isPlanetoidDrawOrderDirty = true;
+	m_simulation->MarkPlanetoidsDirty();
+	m_fieldDebugBatch->MarkDirty();
+}
+
+
+//
+//public gravity body functions
+//
+void Game::SpawnGravityBodies(int numBodies, Vec3 const& center, float spread, float collisionRadius)
+{
+	m_simulation->ReserveGravityBodies(m_simulation->GetNumGravityBodies() + numBodies);
+
+	for (int bodyIndex = 0; bodyIndex < numBodies; bodyIndex++)
+	{
+		Vec3 offset = Vec3(g_rng.RollRandomFloatInRange(-spread, spread), g_rng.RollRandomFloatInRange(-spread, spread), g_rng.RollRandomFloatInRange(-spread, spread));
+		m_simulation->AddGravityBody(center + offset, collisionRadius);
+	}
+}
+
+
+void Game::ClearGravityBodies()
+{
+	m_simulation->ClearGravityBodies();
+}
+
+
 //
 //public mode switching functions
 //
@@ -1260,45 +1444,951 @@ void Game::ExitSandboxMode()
 
 
 //
-//game flow sub-functions
+//static game utilities
 //
-void Game::RenderPlanetoids() const
+bool Game::Event_BenchmarkGravity(EventArgs& args)
 {
-	for (int pltdIndex = 0; pltdIndex < m_planetoids.size(); pltdIndex++)
-	{
-		if (m_planetoids[pltdIndex] != nullptr)
-		{
-			m_planetoids[pltdIndex]->Render();
-		}
-	}
+	UNUSED(args);
+
+	g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MAJOR, "Gravity field benchmark (linear scan vs bvh vs field store):");
+	RunGravityFieldBenchmark(100);
+	RunGravityFieldBenchmark(1000);
+	RunGravityFieldBenchmark(10000);
+
+	return true;
 }
 
 
-//
-//gravity management functions
-//
-void Game::ApplyGravity()
+bool Game::Event_BenchmarkGravityKernels(EventArgs& args)
 {
-	for (int pltdIndex = 0; pltdIndex < m_planetoids.size(); pltdIndex++)
-	{
-		if (m_planetoids[pltdIndex] != nullptr && m_planetoids[pltdIndex]->m_field != nullptr)
-		{
-			m_planetoids[pltdIndex]->m_field->ApplyGravity(m_player);
-		}
-	}
+	UNUSED(args);
+
+	g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MAJOR, "Gravity field batch kernel benchmark (scalar vs batch):");
+	RunGravityKernelBenchmark(100);
+	RunGravityKernelBenchmark(1000);
+	RunGravityKernelBenchmark(10000);
+
+	return true;
 }
 
 
-//
-//collision handling functions
-//
-void Game::CollidePlayerWithAllPlanetoids()
+bool Game::Event_BenchmarkModels(EventArgs& args)
 {
-	for (int pltdIndex = 0; pltdIndex < m_planetoids.size(); pltdIndex++)
-	{
-		if (m_planetoids[pltdIndex] != nullptr)
+	UNUSED(args);
+
+	g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MAJOR, "Model triangle benchmark (brute force vs bvh):");
+	RunModelBenchmark("Data/Models/Teapot.xml");
+	RunModelBenchmark("Data/Models/DrumSeparateRocketPlanet.xml");
+	RunModelBenchmark("Data/Models/MountainPlanet.xml");
+	RunModelBenchmark("Data/Models/OldFortressPlanet.xml");
+
+	return true;
+}
+
+
+bool Game::Event_BenchmarkModelLoading(EventArgs& args)
+{
+	int numLoads = args.GetValue("loads", 5);
+	if (numLoads <= 0)
+	{
+		g_theDevConsole->AddLine(DevConsole::COLOR_ERROR, "loads must be greater than 0");
+		return false;
+	}
+
+	g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MAJOR, "Model loading benchmark (obj vs binary mesh cache):");
+	RunModelLoadBenchmark("Data/Models/Teapot.xml", numLoads);
+	RunModelLoadBenchmark("Data/Models/DrumSeparateRocketPlanet.xml", numLoads);
+	RunModelLoadBenchmark("Data/Models/MountainPlanet.xml", numLoads);
+	RunModelLoadBenchmark("Data/Models/OldFortressPlanet.xml", numLoads);
+
+	return true;
+}
+
+
+bool Game::Event_BenchmarkLevelLoading(EventArgs& args)
+{
+	int numPlanetoids = args.GetValue("count", 10000);
+	if (numPlanetoids <= 0)
+	{
+		g_theDevConsole->AddLine(DevConsole::COLOR_ERROR, "count must be greater than 0");
+		return false;
+	}
+
+	g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MAJOR, "Level loading benchmark (binary vs xml level file):");
+	RunLevelLoadBenchmark(numPlanetoids);
+	return true;
+}
+
+
+bool Game::Event_SaveLevel(EventArgs& args)
+{
+	if (g_theGame == nullptr)
+	{
+		return false;
+	}
+
+	//only the cells near the player are in m_planetoids, saving them would quietly drop the rest of the level
+	if (g_theGame->m_worldStreamer != nullptr)
+	{
+		g_theDevConsole->AddLine(DevConsole::COLOR_ERROR, "Stop streaming with StreamLevel before saving the level");
+		return false;
+	}
+
+	std::string filePath = args.GetValue("file", std::string(SANDBOX_LEVEL_PATH));
+	if (!g_theGame->SaveLevel(filePath))
+	{
+		g_theDevConsole->AddLine(DevConsole::COLOR_ERROR, Stringf("Could not write level %s", filePath.c_str()));
+		return false;
+	}
+
+	g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MAJOR, Stringf("Saved level to %s", filePath.c_str()));
+	return true;
+}
+
+
+bool Game::Event_LoadLevel(EventArgs& args)
+{
+	if (g_theGame == nullptr)
+	{
+		return false;
+	}
+
+	//a recording or replay is only good for the planetoids it started with
+	if (g_theGame->m_isRecordingInput || g_theGame->m_isReplayingInput)
+	{
+		g_theDevConsole->AddLine(DevConsole::COLOR_ERROR, "Levels can't be loaded while input is recording or replaying");
+		return false;
+	}
+
+	std::string filePath = args.GetValue("file", std::string(SANDBOX_LEVEL_PATH));
+	double startTime = GetCurrentTimeSeconds();
+	if (!g_theGame->LoadLevel(filePath))
+	{
+		g_theDevConsole->AddLine(DevConsole::COLOR_ERROR, Stringf("Could not read level %s", filePath.c_str()));
+		return false;
+	}
+	double loadSeconds = GetCurrentTimeSeconds() - startTime;
+
+	g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MAJOR, Stringf("Loaded %i planetoids from %s in %.2f ms", static_cast<int>(g_theGame->m_planetoids.size()), filePath.c_str(),
+		loadSeconds * 1000.0));
+	return true;
+}
+
+
+bool Game::Event_StreamLevel(EventArgs& args)
+{
+	if (g_theGame == nullptr)
+	{
+		return false;
+	}
+
+	std::string filePath = args.GetValue("file", std::string());
+	if (filePath.empty())
+	{
+		g_theGame->StopWorldStreaming();
+		g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MAJOR, "Stopped streaming, the planetoids that were loaded stay");
+		return true;
+	}
+
+	//a recording or replay is only good for the planetoids it started with
+	if (g_theGame->m_isRecordingInput || g_theGame->m_isReplayingInput)
+	{
+		g_theDevConsole->AddLine(DevConsole::COLOR_ERROR, "Levels can't be streamed while input is recording or replaying");
+		return false;
+	}
+
+	WorldStreamerConfig config;
+	config.m_cellSize = args.GetValue("cellSize", WORLD_STREAMING_DEFAULT_CELL_SIZE);
+	config.m_loadRadius = args.GetValue("loadRadius", WORLD_STREAMING_DEFAULT_LOAD_RADIUS);
+	config.m_unloadRadius = args.GetValue("unloadRadius", WORLD_STREAMING_DEFAULT_UNLOAD_RADIUS);
+	config.m_budgetBytes = static_cast<size_t>(args.GetValue("budgetMB", static_cast<int>(WORLD_STREAMING_DEFAULT_BUDGET_BYTES / (1024 * 1024)))) * 1024 * 1024;
+	if (config.m_cellSize <= 0.0f || config.m_unloadRadius < config.m_loadRadius)
+	{
+		g_theDevConsole->AddLine(DevConsole::COLOR_ERROR, "cellSize must be greater than 0 and unloadRadius at least loadRadius");
+		return false;
+	}
+
+	if (!g_theGame->StartWorldStreaming(filePath, config))
+	{
+		g_theDevConsole->AddLine(DevConsole::COLOR_ERROR, Stringf("Could not read level %s", filePath.c_str()));
+		return false;
+	}
+
+	WorldStreamingStats stats = g_theGame->m_worldStreamer->GetStats();
+	g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MAJOR, Stringf("Streaming %s in %i cells, loading within %.0f and unloading past %.0f", filePath.c_str(), stats.m_numCells,
+		config.m_loadRadius, config.m_unloadRadius));
+	return true;
+}
+
+
+bool Game::Event_PrefabQueryMode(EventArgs& args)
+{
+	std::string modeName = args.GetValue("mode", "exact");
+	std::string prefabName = args.GetValue("prefab", "all");
+	float cellSize = args.GetValue("cellSize", CLOSEST_POINT_GRID_DEFAULT_CELL_SIZE);
+
+	ModelQueryMode queryMode = MODEL_QUERY_EXACT;
+	if (modeName == "grid")			queryMode = MODEL_QUERY_GRID;
+	else if (modeName == "hybrid")	queryMode = MODEL_QUERY_HYBRID;
+	else if (modeName != "exact")
+	{
+		g_theDevConsole->AddLine(DevConsole::COLOR_ERROR, "Invalid mode, use exact, grid, or hybrid");
+		return false;
+	}
+
+	if (g_theGame == nullptr)
+	{
+		return false;
+	}
+
+	int numPrefabsChanged = 0;
+	for (int pltdIndex = 0; pltdIndex < g_theGame->m_planetoids.size(); pltdIndex++)
+	{
+		PrefabPLTD* prefab = dynamic_cast<PrefabPLTD*>(g_theGame->m_planetoids[pltdIndex]);
+		if (prefab == nullptr)
+		{
+			continue;
+		}
+
+		bool isMatchingPrefab = (prefabName == "all");
+		if (prefabName == "teapot")			isMatchingPrefab = dynamic_cast<TeapotPLTD*>(prefab) != nullptr;
+		else if (prefabName == "skystation")	isMatchingPrefab = dynamic_cast<SkyStationPLTD*>(prefab) != nullptr;
+		else if (prefabName == "mountain")	isMatchingPrefab = dynamic_cast<MountainPLTD*>(prefab) != nullptr;
+		else if (prefabName == "fortress")	isMatchingPrefab = dynamic_cast<FortressPLTD*>(prefab) != nullptr;
+		if (!isMatchingPrefab)
 		{
-			m_planetoids[pltdIndex]->CollideWithPlayer(m_player);
+			continue;
+		}
+
+		prefab->SetQueryMode(queryMode, cellSize);
+		numPrefabsChanged++;
+
+		ClosestPointGrid const* grid = prefab->m_model->m_closestPointGrid;
+		if (queryMode != MODEL_QUERY_EXACT && grid != nullptr)
+		{
+			g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MINOR, Stringf(" Prefab %i: %i bricks, %.1f KB, max error %.4f, mean error %.4f", pltdIndex, grid->GetNumStoredBricks(),
+				static_cast<float>(grid->GetMemoryBytes()) / 1024.0f, grid->m_maxDistanceError, grid->m_meanDistanceError));
 		}
 	}
+
+	g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MAJOR, Stringf("Set %i prefabs to %s queries", numPrefabsChanged, modeName.c_str()));
+	return true;
+}
+
+
+bool Game::Event_SpawnBodies(EventArgs& args)
+{
+	if (g_theGame == nullptr)
+	{
+		return false;
+	}
+
+	int numBodies = args.GetValue("count", 1000);
+	float spread = args.GetValue("spread", 50.0f);
+	if (numBodies <= 0)
+	{
+		g_theGame->ClearGravityBodies();
+		g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MAJOR, "Cleared gravity bodies");
+		return true;
+	}
+
+	g_theGame->SpawnGravityBodies(numBodies, g_theGame->m_player->m_position, spread);
+	g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MAJOR, Stringf("Spawned %i gravity bodies, %i total", numBodies, g_theGame->m_simulation->GetNumGravityBodies()));
+	return true;
+}
+
+
+bool Game::Event_BenchmarkBodies(EventArgs& args)
+{
+	UNUSED(args);
+
+	g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MAJOR, "Gravity body throughput benchmark (field store, 1000 planetoids):");
+	RunGravityBodyBenchmark(1000);
+	RunGravityBodyBenchmark(10000);
+	RunGravityBodyBenchmark(100000);
+
+	return true;
+}
+
+
+bool Game::Event_BenchmarkJobs(EventArgs& args)
+{
+	int numBodies = args.GetValue("count", 100000);
+
+	g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MAJOR, Stringf("Job system scaling benchmark (%i bodies, 1000 planetoids):", numBodies));
+	RunJobScalingBenchmark(numBodies);
+
+	return true;
+}
+
+
+bool Game::Event_JobThreads(EventArgs& args)
+{
+	if (g_theJobSystem == nullptr)
+	{
+		return false;
+	}
+
+	int numThreads = args.GetValue("count", g_theJobSystem->GetNumThreads());
+	g_theJobSystem->SetNumActiveThreads(numThreads);
+	g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MAJOR, Stringf("Job system using %i of %i threads", g_theJobSystem->GetNumActiveThreads(),
+		g_theJobSystem->GetNumThreads()));
+	return true;
+}
+
+
+bool Game::Event_PhysicsRate(EventArgs& args)
+{
+	if (g_theGame == nullptr)
+	{
+		return false;
+	}
+
+	if (g_theGame->m_isRecordingInput || g_theGame->m_isReplayingInput)
+	{
+		g_theDevConsole->AddLine(DevConsole::COLOR_ERROR, "Can't change the physics rate while recording or replaying input");
+		return false;
+	}
+
+	float stepsPerSecond = args.GetValue("hz", 1.0f / g_theGame->m_fixedTimeStep);
+	if (stepsPerSecond <= 0.0f)
+	{
+		g_theDevConsole->AddLine(DevConsole::COLOR_ERROR, "Invalid hz, must be greater than 0");
+		return false;
+	}
+
+	g_theGame->m_fixedTimeStep = 1.0f / stepsPerSecond;
+	g_theGame->m_isFixedTimeStep = args.GetValue("fixed", g_theGame->m_isFixedTimeStep);
+	g_theGame->m_physicsTimeAccumulator = 0.0f;
+
+	if (g_theGame->m_isFixedTimeStep)
+	{
+		g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MAJOR, Stringf("Physics stepping at a fixed %.0f Hz, at most %i steps per frame", stepsPerSecond, MAX_PHYSICS_STEPS_PER_FRAME));
+	}
+	else
+	{
+		g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MAJOR, "Physics stepping once per frame with the frame's delta");
+	}
+	return true;
+}
+
+
+bool Game::Event_GravityFieldStore(EventArgs& args)
+{
+	if (g_theGame == nullptr)
+	{
+		return false;
+	}
+
+	Simulation* simulation = g_theGame->m_simulation;
+	simulation->m_useGravityFieldStore = args.GetValue("enabled", !simulation->m_useGravityFieldStore);
+
+	GravityFieldStore const& store = simulation->GetGravityFieldStore();
+	g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MAJOR, Stringf("Gravity field store %s", simulation->m_useGravityFieldStore ? "enabled" : "disabled"));
+	g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MINOR, Stringf(" %i fields, %i through virtual calls", store.GetNumFields(), store.GetNumVirtualFields()));
+	return true;
+}
+
+
+bool Game::Event_RecordInput(EventArgs& args)
+{
+	if (g_theGame == nullptr)
+	{
+		return false;
+	}
+
+	if (g_theGame->m_isRecordingInput)
+	{
+		g_theGame->StopInputRecording();
+		return true;
+	}
+
+	if (g_theGame->m_isReplayingInput || !g_theGame->m_isFixedTimeStep || g_theGame->m_worldStreamer != nullptr)
+	{
+		g_theDevConsole->AddLine(DevConsole::COLOR_ERROR, "Input can only be recorded with a fixed physics step, no replay running and no level streaming");
+		return false;
+	}
+
+	std::string filePath = args.GetValue("file", std::string("Data/Recordings/Input.gfir"));
+	g_theGame->StartInputRecording(filePath);
+	g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MAJOR, Stringf("Recording input at %.0f Hz, run RecordInput again to stop", 1.0f / g_theGame->m_fixedTimeStep));
+	return true;
+}
+
+
+bool Game::Event_ReplayInput(EventArgs& args)
+{
+	if (g_theGame == nullptr)
+	{
+		return false;
+	}
+
+	if (g_theGame->m_isRecordingInput || g_theGame->m_isReplayingInput)
+	{
+		g_theDevConsole->AddLine(DevConsole::COLOR_ERROR, "A recording or replay is already running");
+		return false;
+	}
+
+	std::string filePath = args.GetValue("file", std::string("Data/Recordings/Input.gfir"));
+	InputRecording recording;
+	if (!ReadInputRecording(recording, filePath))
+	{
+		g_theDevConsole->AddLine(DevConsole::COLOR_ERROR, Stringf("Could not read input recording %s", filePath.c_str()));
+		return false;
+	}
+
+	if (!g_theGame->StartInputReplay(recording))
+	{
+		return false;
+	}
+
+	//headless replays run every tick right away with nothing rendered in between
+	if (args.GetValue("headless", false))
+	{
+		double startTime = GetCurrentTimeSeconds();
+		while (g_theGame->m_isReplayingInput)
+		{
+			g_theGame->UpdatePhysicsStep(g_theGame->m_fixedTimeStep);
+		}
+		double elapsedSeconds = GetCurrentTimeSeconds() - startTime;
+		g_theGame->m_player->SnapRenderState();
+
+		int numTicks = static_cast<int>(recording.m_commands.size());
+		g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MINOR, Stringf(" %i ticks in %.2f ms, %.1fx real time", numTicks, elapsedSeconds * 1000.0,
+			static_cast<double>(numTicks) * recording.m_tickSeconds / elapsedSeconds));
+		return true;
+	}
+
+	g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MAJOR, Stringf("Replaying %i ticks from %s", static_cast<int>(recording.m_commands.size()), filePath.c_str()));
+	return true;
+}
+
+
+bool Game::Event_ProfilerDump(EventArgs& args)
+{
+	std::string filePath = args.GetValue("file", std::string("Data/Exported/Trace.json"));
+	if (!WriteProfilerChromeTrace(filePath))
+	{
+		g_theDevConsole->AddLine(DevConsole::COLOR_ERROR, Stringf("Could not write profiler trace to %s", filePath.c_str()));
+		return false;
+	}
+
+	g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MAJOR, Stringf("Wrote profiler trace to %s, open it in chrome://tracing or ui.perfetto.dev", filePath.c_str()));
+	return true;
+}
+
+
+//
+//game flow sub-functions
+//
+void Game::RenderPlanetoids() const
+{
+	//every procedural planetoid draws the same way, so state is bound once and each draw only changes its model constants
+	g_theRenderer->BindShader(m_lightingShader);
+	g_theRenderer->BindTexture(nullptr);
+	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
+	for (int drawIndex = 0; drawIndex < m_planetoidDrawOrder.size(); drawIndex++)
+	{
+		Planetoid const* planetoid = m_planetoidDrawOrder[drawIndex];
+		g_theRenderer->SetModelConstants(planetoid->GetModelMatrix(), planetoid->m_color);
+		planetoid->DrawGPUMesh();
+	}
+
+	//prefabs draw through their own models
+	for (int pltdIndex = 0; pltdIndex < m_planetoids.size(); pltdIndex++)
+	{
+		if (m_planetoids[pltdIndex] != nullptr && m_planetoids[pltdIndex]->m_gpuMesh == nullptr)
+		{
+			m_planetoids[pltdIndex]->Render();
+		}
+	}
+}
+
+
+void Game::RebuildPlanetoidDrawOrder()
+{
+	m_planetoidDrawOrder.clear();
+	m_numPlanetoidDrawCalls = 0;
+	for (int pltdIndex = 0; pltdIndex < m_planetoids.size(); pltdIndex++)
+	{
+		Planetoid* planetoid = m_planetoids[pltdIndex];
+		if (planetoid == nullptr)
+		{
+			continue;
+		}
+
+		if (planetoid->m_gpuMesh != nullptr)
+		{
+			m_planetoidDrawOrder.emplace_back(planetoid);
+		}
+		m_numPlanetoidDrawCalls++;
+	}
+
+	//stable so planetoids sharing a mesh keep their spawn order
+	std::stable_sort(m_planetoidDrawOrder.begin(), m_planetoidDrawOrder.end(), [](Planetoid const* a, Planetoid const* b) { return a->m_meshKey < b->m_meshKey; });
+
+	m_numPlanetoidMeshGroups = 0;
+	for (int drawIndex = 0; drawIndex < m_planetoidDrawOrder.size(); drawIndex++)
+	{
+		if (drawIndex == 0 || m_planetoidDrawOrder[drawIndex]->m_gpuMesh != m_planetoidDrawOrder[drawIndex - 1]->m_gpuMesh)
+		{
+			m_numPlanetoidMeshGroups++;
+		}
+	}
+
+	m_isPlanetoidDrawOrderDirty = false;
+}
+
+
+void Game::UpdateWorldStreaming()
+{
+	if (m_worldStreamer == nullptr)
+	{
+		return;
+	}
+
+	WorldStreamingChanges changes;
+	m_worldStreamer->Update(m_player->m_position, changes);
+	if (!changes.m_planetoidsToRemove.empty())
+	{
+		RemovePlanetoids(changes.m_planetoidsToRemove);
+	}
+
+	m_planetoids.reserve(m_planetoids.size() + changes.m_planetoidsToAdd.size());
+	for (int pltdIndex = 0; pltdIndex < changes.m_planetoidsToAdd.size(); pltdIndex++)
+	{
+		AddPlanetoid(changes.m_planetoidsToAdd[pltdIndex]);
+	}
+}
+
+
+//world text is debug render text with no way to take it down, so signs already up stay up
+void Game::ResetLevel()
+{
+	ClearAllPlanetoids();
+	m_planetoids.clear();
+	m_checkpoints.clear();
+	m_courseSigns.clear();
+	m_currentCheckpoint = nullptr;
+	m_inPlaytestCourse = false;
+	m_currentSection = 0;
+}
+
+
+void Game::FinishPrefabLoads(bool waitForAll)
+{
+	int numAssetsFinished = waitForAll ? WaitForModelAssetLoads() : FinishModelAssetLoads();
+	if (numAssetsFinished == 0)
+	{
+		return;
+	}
+
+	//prefabs sharing an asset all become ready together, refreshing ones that already were is cheap
+	for (int pltdIndex = 0; pltdIndex < m_planetoids.size(); pltdIndex++)
+	{
+		PrefabPLTD* prefab = dynamic_cast<PrefabPLTD*>(m_planetoids[pltdIndex]);
+		if (prefab != nullptr && prefab->m_model->IsReady())
+		{
+			prefab->OnModelLoaded();
+		}
+	}
+
+	m_simulation->MarkPlanetoidsDirty();
+}
+
+
+void Game::RenderProfilerImGui()
+{
+	static ProfiledFrame frame;
+	static std::vector<float> frameHistory;
+	static bool isPaused = false;
+
+	//pausing holds on to the last frame so it can be looked over
+	if (!isPaused)
+	{
+		GetLastProfiledFrame(frame);
+		GetProfiledFrameHistory(frameHistory);
+	}
+
+	ImGui::SetNextWindowPos(ImVec2(370.0f, 20.0f), ImGuiCond_FirstUseEver);
+	ImGui::SetNextWindowSize(ImVec2(630.0f, 650.0f), ImGuiCond_FirstUseEver);
+	ImGui::Begin("Profiler");
+
+	long long frameNanoseconds = std::max(frame.m_endNanoseconds - frame.m_startNanoseconds, 1LL);
+	double frameMilliseconds = static_cast<double>(frameNanoseconds) * 0.000001;
+	ImGui::Checkbox("Pause", &isPaused);
+	ImGui::SameLine();
+	ImGui::Text("Frame: %.2f ms  Scopes: %i", frameMilliseconds, static_cast<int>(frame.m_events.size()));
+	if (!frameHistory.empty())
+	{
+		ImGui::PlotLines("##FrameTimes", frameHistory.data(), static_cast<int>(frameHistory.size()), 0, "frame ms", 0.0f, 33.3f, ImVec2(-1.0f, 60.0f));
+	}
+
+	//flame view, one row per scope depth with the whole frame stretched across the window
+	constexpr float FLAME_ROW_HEIGHT = 18.0f;
+	int maxDepth = 0;
+	for (int eventIndex = 0; eventIndex < frame.m_events.size(); eventIndex++)
+	{
+		maxDepth = std::max(maxDepth, frame.m_events[eventIndex].m_depth);
+	}
+
+	ImVec2 flameOrigin = ImGui::GetCursorScreenPos();
+	ImVec2 flameSize = ImVec2(std::max(ImGui::GetContentRegionAvail().x, 1.0f), FLAME_ROW_HEIGHT * static_cast<float>(maxDepth + 1));
+	ImGui::InvisibleButton("##FlameView", flameSize);
+
+	ImDrawList* drawList = ImGui::GetWindowDrawList();
+	for (int eventIndex = 0; eventIndex < frame.m_events.size(); eventIndex++)
+	{
+		ProfileEvent const& event = frame.m_events[eventIndex];
+		float startFraction = static_cast<float>(static_cast<double>(event.m_startNanoseconds - frame.m_startNanoseconds) / static_cast<double>(frameNanoseconds));
+		float endFraction = static_cast<float>(static_cast<double>(event.m_endNanoseconds - frame.m_startNanoseconds) / static_cast<double>(frameNanoseconds));
+
+		ImVec2 rectMins = ImVec2(flameOrigin.x + startFraction * flameSize.x, flameOrigin.y + static_cast<float>(event.m_depth) * FLAME_ROW_HEIGHT);
+		ImVec2 rectMaxs = ImVec2(std::max(flameOrigin.x + endFraction * flameSize.x, rectMins.x + 1.0f), rectMins.y + FLAME_ROW_HEIGHT - 1.0f);
+		drawList->AddRectFilled(rectMins, rectMaxs, GetProfileScopeColor(event.m_name));
+
+		//only label bars wide enough to read
+		if (rectMaxs.x - rectMins.x > 40.0f)
+		{
+			drawList->PushClipRect(rectMins, rectMaxs, true);
+			drawList->AddText(ImVec2(rectMins.x + 3.0f, rectMins.y + 2.0f), IM_COL32(0, 0, 0, 255), event.m_name);
+			drawList->PopClipRect();
+		}
+
+		if (ImGui::IsMouseHoveringRect(rectMins, rectMaxs))
+		{
+			ImGui::SetTooltip("%s\n%.3f ms", event.m_name, static_cast<double>(event.m_endNanoseconds - event.m_startNanoseconds) * 0.000001);
+		}
+	}
+
+	//fold the frame into a tree, events are sorted by start time so each one's parent is the last node opened one level up
+	std::vector<ProfileTreeNode> treeNodes;
+	std::vector<int> rootIndexes;
+	std::vector<int> openNodeIndexes;
+	for (int eventIndex = 0; eventIndex < frame.m_events.size(); eventIndex++)
+	{
+		ProfileEvent const& event = frame.m_events[eventIndex];
+		openNodeIndexes.resize(std::min(static_cast<int>(openNodeIndexes.size()), event.m_depth));
+		std::vector<int>& siblingIndexes = openNodeIndexes.empty() ? rootIndexes : treeNodes[openNodeIndexes.back()].m_childIndexes;
+
+		int nodeIndex = -1;
+		for (int siblingIndex = 0; siblingIndex < siblingIndexes.size(); siblingIndex++)
+		{
+			if (strcmp(treeNodes[siblingIndexes[siblingIndex]].m_name, event.m_name) == 0)
+			{
+				nodeIndex = siblingIndexes[siblingIndex];
+				break;
+			}
+		}
+
+		if (nodeIndex < 0)
+		{
+			nodeIndex = static_cast<int>(treeNodes.size());
+			siblingIndexes.emplace_back(nodeIndex);
+			treeNodes.emplace_back(ProfileTreeNode());
+			treeNodes.back().m_name = event.m_name;
+		}
+
+		treeNodes[nodeIndex].m_milliseconds += static_cast<double>(event.m_endNanoseconds - event.m_startNanoseconds) * 0.000001;
+		treeNodes[nodeIndex].m_numCalls++;
+		openNodeIndexes.emplace_back(nodeIndex);
+	}
+
+	ImGui::NewLine();
+	if (ImGui::BeginTable("##ProfileTree", 4, ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY))
+	{
+		ImGui::TableSetupColumn("Scope");
+		ImGui::TableSetupColumn("ms", ImGuiTableColumnFlags_WidthFixed, 70.0f);
+		ImGui::TableSetupColumn("Frame", ImGuiTableColumnFlags_WidthFixed, 60.0f);
+		ImGui::TableSetupColumn("Calls", ImGuiTableColumnFlags_WidthFixed, 50.0f);
+		ImGui::TableHeadersRow();
+
+		for (int rootIndex = 0; rootIndex < rootIndexes.size(); rootIndex++)
+		{
+			RenderProfileTreeNode(treeNodes, rootIndexes[rootIndex], frameMilliseconds);
+		}
+		ImGui::EndTable();
+	}
+
+	ImGui::End();
+}
+
+
+//
+//physics step functions
+//
+void Game::UpdatePhysicsStep(float deltaSeconds)
+{
+	PROFILE_SCOPE("Game::UpdatePhysicsStep");
+
+	double physicsStartTime = GetCurrentTimeSeconds();
+
+	//update player, gravity, and collision, a replay swaps the live input for the recorded command
+	PlayerCommand command = m_player->TakePendingCommand();
+	if (m_isReplayingInput)
+	{
+		command = m_inputRecording.m_commands[m_replayTickIndex];
+	}
+	if (m_isRecordingInput)
+	{
+		m_inputRecording.m_commands.emplace_back(command);
+	}
+
+	m_simulation->StepPlayer(deltaSeconds, command);
+	RecordPlayerActions();
+	if (!m_isReplayingInput || m_inputRecording.m_isSteppingPlaytestTriggers)
+	{
+		UpdatePlaytestTriggers();
+	}
+	UpdateInputRecording();
+
+	double bodyStartTime = GetCurrentTimeSeconds();
+	m_physicsSecondsThisFrame += bodyStartTime - physicsStartTime;
+
+	//update gravity bodies
+	if (m_simulation->GetNumGravityBodies() > 0)
+	{
+		m_simulation->StepBodies(deltaSeconds);
+		m_bodySecondsThisFrame += GetCurrentTimeSeconds() - bodyStartTime;
+	}
+}
+
+
+void Game::RecordPlayerActions()
+{
+	float currentTime = m_gameClock.GetTotalSeconds();
+
+	for (int actionIndex = 0; actionIndex < m_player->m_actionsThisTick.size(); actionIndex++)
+	{
+		switch (m_player->m_actionsThisTick[actionIndex])
+		{
+			case PLAYER_ACTION_STANDARD_JUMP: m_standardJumpTimes.emplace_back(currentTime); break;
+			case PLAYER_ACTION_DOUBLE_JUMP:	  m_doubleJumpTimes.emplace_back(currentTime); break;
+			case PLAYER_ACTION_TRIPLE_JUMP:	  m_tripleJumpTimes.emplace_back(currentTime); break;
+			case PLAYER_ACTION_LONG_JUMP:	  m_longJumpTimes.emplace_back(currentTime); break;
+			case PLAYER_ACTION_WALL_JUMP:	  m_wallJumpTimes.emplace_back(currentTime); break;
+			case PLAYER_ACTION_SIDE_FLIP:	  m_sideFlipTimes.emplace_back(currentTime); break;
+			case PLAYER_ACTION_BACK_FLIP:	  m_backFlipTimes.emplace_back(currentTime); break;
+			case PLAYER_ACTION_RESPAWN:
+			{
+				switch (m_currentSection)
+				{
+					case 1: m_section1RespawnTimes.emplace_back(currentTime); break;
+					case 2: m_section2RespawnTimes.emplace_back(currentTime); break;
+					case 3: m_section3RespawnTimes.emplace_back(currentTime); break;
+					case 4: m_section4RespawnTimes.emplace_back(currentTime); break;
+				}
+				break;
+			}
+		}
+	}
+}
+
+
+void Game::UpdatePlaytestTriggers()
+{
+	//the triggers themselves are shared with the headless benchmark, the game only adds section timing on top
+	PlaytestProgress progress;
+	progress.m_inPlaytestCourse = m_inPlaytestCourse;
+	progress.m_checkpointIndex = (m_currentCheckpoint != nullptr) ? static_cast<int>(m_currentCheckpoint - m_checkpoints.data()) : -1;
+
+	bool reachedCheckpoint = StepPlaytestTriggers(*m_player, m_checkpoints, progress);
+	m_inPlaytestCourse = progress.m_inPlaytestCourse;
+	if (!reachedCheckpoint)
+	{
+		return;
+	}
+
+	m_currentCheckpoint = &m_checkpoints[progress.m_checkpointIndex];
+	m_currentSection = progress.m_checkpointIndex + 1;
+
+	switch (m_currentSection)
+	{
+		case 1:
+		{
+			m_section1StartTime = m_gameClock.GetTotalSeconds();
+			break;
+		}
+		case 2:
+		{
+			m_section2StartTime = m_gameClock.GetTotalSeconds();
+			break;
+		}
+		case 3:
+		{
+			m_section3StartTime = m_gameClock.GetTotalSeconds();
+			break;
+		}
+		case 4:
+		{
+			m_section4StartTime = m_gameClock.GetTotalSeconds();
+			break;
+		}
+	}
+}
+
+
+//
+//input recording functions
+//
+void Game::StartInputRecording(std::string const& filePath)
+{
+	//the scene checksum covers prefab bounds, which are only final once their models are in
+	FinishPrefabLoads(true);
+
+	m_inputRecording = InputRecording();
+	m_inputRecording.m_tickSeconds = m_fixedTimeStep;
+	m_inputRecording.m_playerStart = TakePlayerSnapshot(*m_player);
+
+	//the scene goes in as level records, so a replay can rebuild it wherever it's started from
+	PlaytestCourse scene;
+	scene.m_planetoids = m_planetoids;
+	scene.m_checkpoints = m_checkpoints;
+	scene.m_signs = m_courseSigns;
+	MakeLevelDescription(scene, m_inputRecording.m_scene);
+	m_inputRecording.m_numPlanetoids = GetNumPlanetoids(m_planetoids);
+	m_inputRecording.m_sceneChecksum = GetSceneChecksum(m_planetoids);
+	m_inputRecording.m_inPlaytestCourse = m_inPlaytestCourse;
+	m_inputRecording.m_checkpointIndex = (m_currentCheckpoint != nullptr) ? static_cast<int>(m_currentCheckpoint - m_checkpoints.data()) : -1;
+
+	//start from the snapshot itself, so the recorded run and its replays begin from identical state
+	RestorePlayerSnapshot(*m_player, m_inputRecording.m_playerStart);
+	m_physicsTimeAccumulator = 0.0f;
+
+	m_inputRecordingPath = filePath;
+	m_isRecordingInput = true;
+}
+
+
+void Game::StopInputRecording()
+{
+	m_isRecordingInput = false;
+
+	int numTicks = static_cast<int>(m_inputRecording.m_commands.size());
+	if (!WriteInputRecording(m_inputRecording, m_inputRecordingPath))
+	{
+		g_theDevConsole->AddLine(DevConsole::COLOR_ERROR, Stringf("Failed to write input recording to %s", m_inputRecordingPath.c_str()));
+		return;
+	}
+
+	g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MAJOR, Stringf("Recorded %i ticks (%.2f s) to %s", numTicks, static_cast<float>(numTicks) * m_inputRecording.m_tickSeconds,
+		m_inputRecordingPath.c_str()));
+}
+
+
+bool Game::StartInputReplay(InputRecording const& recording)
+{
+	FinishPrefabLoads(true);
+
+	//a recording made somewhere else brings its scene along, replaying it replaces the current one
+	if (recording.m_numPlanetoids != GetNumPlanetoids(m_planetoids) || recording.m_sceneChecksum != GetSceneChecksum(m_planetoids))
+	{
+		PlaytestCourse scene;
+		CreateLevelFromDescription(recording.m_scene, scene);
+		ResetLevel();
+		AddLevel(scene);
+		FinishPrefabLoads(true);
+
+		if (recording.m_numPlanetoids != GetNumPlanetoids(m_planetoids) || recording.m_sceneChecksum != GetSceneChecksum(m_planetoids))
+		{
+			g_theDevConsole->AddLine(DevConsole::COLOR_ERROR, "Recording's scene did not rebuild the same as when it was recorded");
+			return false;
+		}
+
+		g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MINOR, "Loaded the scene the recording was made in");
+	}
+
+	if (recording.m_commands.empty() || recording.m_tickSeconds <= 0.0f)
+	{
+		g_theDevConsole->AddLine(DevConsole::COLOR_ERROR, "Recording has no ticks");
+		return false;
+	}
+
+	m_inputRecording = recording;
+	m_isFixedTimeStep = true;
+	m_fixedTimeStep = recording.m_tickSeconds;
+	m_physicsTimeAccumulator = 0.0f;
+
+	//put the player and course back where they were when recording started
+	RestorePlayerSnapshot(*m_player, recording.m_playerStart);
+	m_inPlaytestCourse = recording.m_inPlaytestCourse;
+	bool hasCheckpoint = recording.m_checkpointIndex >= 0 && recording.m_checkpointIndex < m_checkpoints.size();
+	m_currentCheckpoint = hasCheckpoint ? &m_checkpoints[recording.m_checkpointIndex] : nullptr;
+	m_currentSection = hasCheckpoint ? recording.m_checkpointIndex + 1 : 0;
+
+	m_replayTickIndex = 0;
+	m_replayFirstDivergentTick = -1;
+	m_isReplayingInput = true;
+	return true;
+}
+
+
+void Game::StopInputReplay()
+{
+	m_isReplayingInput = false;
+
+	if (m_replayFirstDivergentTick < 0)
+	{
+		g_theDevConsole->AddLine(DevConsole::COLOR_INFO_MAJOR, Stringf("Replayed %i ticks, player state matched the recording on every tick", m_replayTickIndex));
+	}
+	else
+	{
+		g_theDevConsole->AddLine(DevConsole::COLOR_ERROR, Stringf("Replayed %i ticks, player state first diverged on tick %i", m_replayTickIndex, m_replayFirstDivergentTick));
+	}
+}
+
+
+void Game::UpdateInputRecording()
+{
+	if (m_isRecordingInput)
+	{
+		m_inputRecording.m_checksums.emplace_back(GetPlayerStateChecksum(*m_player));
+		return;
+	}
+
+	if (!m_isReplayingInput)
+	{
+		return;
+	}
+
+	if (m_replayFirstDivergentTick < 0 && GetPlayerStateChecksum(*m_player) != m_inputRecording.m_checksums[m_replayTickIndex])
+	{
+		m_replayFirstDivergentTick = m_replayTickIndex;
+	}
+
+	m_replayTickIndex++;
+	if (m_replayTickIndex >= m_inputRecording.m_commands.size())
+	{
+		StopInputReplay();
+	}
+}
+
+
+//
+//gravity body sub-functions
+//
+void Game::RenderGravityBodies() const
+{
+	if (m_simulation->m_bodyPositions.empty())
+	{
+		return;
+	}
+
+	std::vector<Vertex_PCU> verts;
+	verts.reserve(m_simulation->m_bodyPositions.size() * 36);
+	for (int bodyIndex = 0; bodyIndex < m_simulation->m_bodyPositions.size(); bodyIndex++)
+	{
+		Vec3 const& center = m_simulation->m_bodyPositions[bodyIndex];
+		float radius = m_simulation->m_bodyRadii[bodyIndex];
+		Rgba8 color = (m_simulation->m_bodyStates[bodyIndex].m_gravitySource != nullptr) ? Rgba8(255, 200, 0) : Rgba8(150, 150, 150);
+		AddVertsForCube3D(verts, center + Vec3(radius, radius, -radius), center + Vec3(radius, -radius, -radius), center + Vec3(radius, radius, radius),
+			center + Vec3(radius, -radius, radius), center + Vec3(-radius, radius, -radius), center + Vec3(-radius, -radius, -radius), center + Vec3(-radius, radius, radius),
+			center + Vec3(-radius, -radius, radius), color);
+	}
+
+	g_theRenderer->BindShader(nullptr);
+	g_theRenderer->BindTexture(nullptr);
+	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
+	g_theRenderer->SetModelConstants(Mat44(), Rgba8());
+	g_theRenderer->DrawVertexArray(verts);
 }
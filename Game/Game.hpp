@@ -1,9 +1,13 @@
 #pragma once
 #include "Game/GameCommon.hpp"
+#include "Game/InputRecording.hpp"
+#include "Game/PlaytestCourse.hpp"
 #include "Engine/Renderer/Camera.hpp"
 #include "Engine/Core/Clock.hpp"
 #include "Engine/Core/Rgba8.hpp"
 #include "Engine/Math/AABB3.hpp"
+#include "Engine/Math/EulerAngles.hpp"
+#include <vector>
 
 
 //forward declarations
@@ -25,6 +29,18 @@ class  SkyStationPLTD;
 class  MountainPLTD;
 class  FortressPLTD;
 class  Model;
+class  Simulation;
+class  MeshUploader;
+class  GravityFieldDebugBatch;
+class  PlanetoidPreviewCache;
+class  WorldStreamer;
+struct WorldStreamerConfig;
+
+
+//constants
+constexpr float DEFAULT_PHYSICS_STEP_SECONDS = 1.0f / 120.0f;
+constexpr int MAX_PHYSICS_STEPS_PER_FRAME = 8;
+constexpr char const* SANDBOX_LEVEL_PATH = "Data/Levels/Sandbox.gflevel";
 
 
 class Game 
@@ -41,6 +57,14 @@ public:
 	//planetoid spawning functions
 	void ClearAllPlanetoids();
 	void AddPlanetoidsForPlaytestingCourse();
+	void AddLevel(PlaytestCourse const& level);
+	bool SaveLevel(std::string const& filePath) const;
+	bool LoadLevel(std::string const& filePath);
+	void RemovePlanetoids(std::vector<Planetoid*> const& planetoids);
+
+	//world streaming functions
+	bool StartWorldStreaming(std::string const& filePath, WorldStreamerConfig const& config);
+	void StopWorldStreaming();
 	PlanePLTD*		SpawnPlane(Vec3 position, float halfLength, float halfWidth, EulerAngles orientation, bool includeField, float gravityHeight, float gravityForce = 100.0f, Rgba8 color = Rgba8());
 	SpherePLTD*		SpawnSphere(Vec3 position, float radius, bool includeField, float gravityRadius, float gravityForce = 100.0f, Rgba8 color = Rgba8());
 	CapsulePLTD*	SpawnCapsule(Vec3 position, float radius, float boneLength, Vec3 boneDirection, bool includeField, float gravityRadius, float gravityForce = 100.0f, Rgba8 color = Rgba8());
@@ -54,11 +78,36 @@ public:
 	SkyStationPLTD* SpawnSkyStation(Vec3 position, float scale, EulerAngles orientation, bool includeField, float gravityRadius, float gravityForce, Rgba8 color);
 	MountainPLTD*	SpawnMountain(Vec3 position, float scale, EulerAngles orientation, bool includeField, float gravityRadius, float gravityForce, Rgba8 color);
 	FortressPLTD*	SpawnFortress(Vec3 position, float scale, EulerAngles orientation, bool includeField, float gravityHeight, float gravityForce, Rgba8 color);
+	Planetoid*		SpawnPreviewPlanetoid(float gravityForce, Rgba8 color);
+
+	//gravity body functions
+	void SpawnGravityBodies(int numBodies, Vec3 const& center, float spread, float collisionRadius = 0.25f);
+	void ClearGravityBodies();
 
 	//mode switching functions
 	void EnterSandboxMode();
 	void ExitSandboxMode();
 
+	//static game utilities
+	static bool Event_BenchmarkGravity(EventArgs& args);
+	static bool Event_BenchmarkGravityKernels(EventArgs& args);
+	static bool Event_BenchmarkModels(EventArgs& args);
+	static bool Event_BenchmarkModelLoading(EventArgs& args);
+	static bool Event_BenchmarkLevelLoading(EventArgs& args);
+	static bool Event_SaveLevel(EventArgs& args);
+	static bool Event_LoadLevel(EventArgs& args);
+	static bool Event_StreamLevel(EventArgs& args);
+	static bool Event_PrefabQueryMode(EventArgs& args);
+	static bool Event_GravityFieldStore(EventArgs& args);
+	static bool Event_SpawnBodies(EventArgs& args);
+	static bool Event_BenchmarkBodies(EventArgs& args);
+	static bool Event_BenchmarkJobs(EventArgs& args);
+	static bool Event_JobThreads(EventArgs& args);
+	static bool Event_PhysicsRate(EventArgs& args);
+	static bool Event_RecordInput(EventArgs& args);
+	static bool Event_ReplayInput(EventArgs& args);
+	static bool Event_ProfilerDump(EventArgs& args);
+
 //public member variables
 public:
 	//game state bools
@@ -74,6 +123,27 @@ public:
 	Model*  m_previewModel = nullptr;
 	int		m_previousModelIndex = -1;
 
+	//gravity, collision and gravity bodies, stepped from UpdatePhysicsStep
+	Simulation* m_simulation = nullptr;
+
+	//creates each planetoid's vertex buffer once in AddPlanetoid
+	MeshUploader* m_meshUploader = nullptr;
+
+	//planetoids with a gpu mesh, sorted so ones sharing a mesh draw back to back
+	std::vector<Planetoid*> m_planetoidDrawOrder;
+	bool					m_isPlanetoidDrawOrderDirty = true;
+	int						m_numPlanetoidDrawCalls = 0;
+	int						m_numPlanetoidMeshGroups = 0;
+
+	//gravity field shells for debug view, rebuilt only when planetoids change
+	GravityFieldDebugBatch* m_fieldDebugBatch = nullptr;
+
+	//the sandbox spawn menu's preview planetoid, regenerated only when its shape parameters change
+	PlanetoidPreviewCache* m_previewCache = nullptr;
+
+	//brings a level's planetoids in and out around the player, null when the whole level is loaded
+	WorldStreamer* m_worldStreamer = nullptr;
+
 	//rendering variables
 	Shader* m_lightingShader = nullptr;
 	Rgba8   m_skyColor = Rgba8(50, 50, 50);
@@ -84,12 +154,12 @@ public:
 	//imgui variables
 	bool m_isSandboxMode = false;
 	bool m_lightingMenuOpen = false;
+	bool m_profilerMenuOpen = false;
 
 	//playtest course variables
-	Vec3 m_playtestEnterZone = Vec3(115.0f, 0.0f, 5.0f);
-	Vec3 m_playtestStartingPoint = Vec3(250.0f, 0.0f, 11.5f);
 	bool m_inPlaytestCourse = false;
 	std::vector<AABB3> m_checkpoints;
+	std::vector<CourseSign> m_courseSigns;	//kept so a saved level has them too
 	AABB3* m_currentCheckpoint = nullptr;
 	int	m_currentSection = 0;
 	float m_section1Duration = 0.0f;
@@ -116,15 +186,51 @@ public:
 private:
 	//game flow sub-functions
 	void RenderPlanetoids() const;
-
-	//gravity management functions
-	void ApplyGravity();
-
-	//collision management functions
-	void CollidePlayerWithAllPlanetoids();
+	void RebuildPlanetoidDrawOrder();
+	void FinishPrefabLoads(bool waitForAll);
+	void UpdateWorldStreaming();
+	void ResetLevel();
+	void RenderProfilerImGui();
+
+	//physics step functions
+	void UpdatePhysicsStep(float deltaSeconds);
+	void RecordPlayerActions();
+	void UpdatePlaytestTriggers();
+
+	//input recording functions
+	void StartInputRecording(std::string const& filePath);
+	void StopInputRecording();
+	bool StartInputReplay(InputRecording const& recording);
+	void StopInputReplay();
+	void UpdateInputRecording();
+
+	//planetoid spawning sub-functions
+	void AddPlanetoid(Planetoid* planetoid);
+
+	//gravity body sub-functions
+	void RenderGravityBodies() const;
 
 //private member variables
 private:
 	//camera variables
 	Camera m_screenCamera;
+
+	//fixed timestep variables, leftover frame time carries over in the accumulator
+	bool  m_isFixedTimeStep = true;
+	float m_fixedTimeStep = DEFAULT_PHYSICS_STEP_SECONDS;
+	float m_physicsTimeAccumulator = 0.0f;
+
+	//gravity and collision time, smoothed over recent frames so it can be read off the screen
+	float  m_physicsMilliseconds = 0.0f;
+	float  m_bodyMilliseconds = 0.0f;
+	double m_physicsSecondsThisFrame = 0.0;
+	double m_bodySecondsThisFrame = 0.0;
+
+	//input recording variables, every physics step records or replays one command
+	InputRecording m_inputRecording;
+	std::string	   m_inputRecordingPath;
+	bool		   m_isRecordingInput = false;
+	bool		   m_isReplayingInput = false;
+	int			   m_replayTickIndex = 0;
+	int			   m_replayFirstDivergentTick = -1;
 };
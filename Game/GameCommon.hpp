@@ -12,6 +12,7 @@ class AudioSystem;
 class Window;
 class Game;
 class RandomNumberGenerator;
+class JobSystem;
 
 //external declarations
 extern App* g_theApp;
@@ -20,6 +21,7 @@ extern InputSystem* g_theInput;
 extern AudioSystem* g_theAudio;
 extern Window* g_theWindow;
 extern Game* g_theGame;
+extern JobSystem* g_theJobSystem;
 
 extern RandomNumberGenerator g_rng;
 
@@ -0,0 +1,101 @@
+#include "Game/GravityFieldDebugBatch.hpp"
+#include "Game/GravityFields.hpp"
+#include "Game/Planetoids.hpp"
+#include "Game/GameCommon.hpp"
+#include "Engine/Renderer/Renderer.hpp"
+#include "Engine/Renderer/VertexBuffer.hpp"
+
+
+//
+//destructor
+//
+GravityFieldDebugBatch::~GravityFieldDebugBatch()
+{
+	if (m_vertexBuffer != nullptr)
+	{
+		delete m_vertexBuffer;
+		m_vertexBuffer = nullptr;
+	}
+}
+
+
+//
+//public debug batch functions
+//
+void GravityFieldDebugBatch::Render(std::vector<Planetoid*> const& planetoids)
+{
+	bool needsRebuild = m_isDirty;
+	for (int pltdIndex = 0; pltdIndex < planetoids.size() && !needsRebuild; pltdIndex++)
+	{
+		if (planetoids[pltdIndex] != nullptr && planetoids[pltdIndex]->m_field != nullptr && planetoids[pltdIndex]->m_field->m_isDebugShellDirty)
+		{
+			needsRebuild = true;
+		}
+	}
+
+	if (needsRebuild)
+	{
+		Rebuild(planetoids);
+	}
+
+	if (m_numVertexes == 0)
+	{
+		return;
+	}
+
+	g_theRenderer->BindShader(nullptr);
+	g_theRenderer->BindTexture(nullptr);
+	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
+	g_theRenderer->SetModelConstants(Mat44(), g_gravFieldColor);
+	g_theRenderer->DrawVertexBuffer(m_vertexBuffer, m_numVertexes);
+}
+
+
+//
+//private debug batch functions
+//
+void GravityFieldDebugBatch::Rebuild(std::vector<Planetoid*> const& planetoids)
+{
+	//a changed planetoid list means every shell has to be gathered again
+	if (m_isDirty)
+	{
+		m_fields.clear();
+		for (int pltdIndex = 0; pltdIndex < planetoids.size(); pltdIndex++)
+		{
+			if (planetoids[pltdIndex] != nullptr && planetoids[pltdIndex]->m_field != nullptr)
+			{
+				m_fields.emplace_back(planetoids[pltdIndex]->m_field);
+				m_fields.back()->m_isDebugShellDirty = true;
+			}
+		}
+		m_fieldVerts.resize(m_fields.size());
+		m_isDirty = false;
+	}
+
+	m_batchVerts.clear();
+	for (int fieldIndex = 0; fieldIndex < m_fields.size(); fieldIndex++)
+	{
+		GravityField* field = m_fields[fieldIndex];
+		if (field->m_isDebugShellDirty)
+		{
+			m_fieldVerts[fieldIndex].clear();
+			field->AddWorldVertsForDebugShell(m_fieldVerts[fieldIndex]);
+			field->m_isDebugShellDirty = false;
+		}
+
+		m_batchVerts.insert(m_batchVerts.end(), m_fieldVerts[fieldIndex].begin(), m_fieldVerts[fieldIndex].end());
+	}
+
+	m_numVertexes = static_cast<int>(m_batchVerts.size());
+	if (m_numVertexes == 0)
+	{
+		return;
+	}
+
+	size_t numBytes = m_batchVerts.size() * sizeof(Vertex_PCU);
+	if (m_vertexBuffer == nullptr)
+	{
+		m_vertexBuffer = g_theRenderer->CreateVertexBuffer(numBytes, sizeof(Vertex_PCU));
+	}
+	g_theRenderer->CopyCPUToGPU(m_batchVerts.data(), numBytes, m_vertexBuffer);
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include "Engine/Core/Vertex_PCU.hpp"
+#include <vector>
+
+
+//forward declarations
+class Planetoid;
+class GravityField;
+class VertexBuffer;
+
+
+//every gravity field's translucent shell in one world space vertex buffer, drawn with a single call in debug view
+class GravityFieldDebugBatch
+{
+//public member functions
+public:
+	~GravityFieldDebugBatch();
+
+	void Render(std::vector<Planetoid*> const& planetoids);
+	void MarkDirty() { m_isDirty = true; }
+
+//private member functions
+private:
+	void Rebuild(std::vector<Planetoid*> const& planetoids);
+
+//private member variables
+private:
+	//each field's shell is kept, so one moved planetoid doesn't tessellate every other field again
+	std::vector<GravityField*>			 m_fields;
+	std::vector<std::vector<Vertex_PCU>> m_fieldVerts;
+	std::vector<Vertex_PCU>				 m_batchVerts;
+
+	VertexBuffer* m_vertexBuffer = nullptr;
+	int			  m_numVertexes = 0;
+	bool		  m_isDirty = true;	//set when planetoids are added or removed
+};
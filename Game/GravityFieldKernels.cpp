@@ -0,0 +1,302 @@
+#include "Game/GravityFieldKernels.hpp"
+#include <algorithm>
+#include <math.h>
+#if GRAVITY_KERNELS_USE_SSE
+#include <emmintrin.h>
+#endif
+
+
+//copies up to a batch of values into a padded array, so the last partial batch can be loaded like a full one
+static int LoadBatch(std::vector<float> const& values, int firstField, float* out_batch)
+{
+	int numFields = std::min(GRAVITY_KERNEL_BATCH_WIDTH, static_cast<int>(values.size()) - firstField);
+	for (int laneIndex = 0; laneIndex < GRAVITY_KERNEL_BATCH_WIDTH; laneIndex++)
+	{
+		out_batch[laneIndex] = (laneIndex < numFields) ? values[firstField + laneIndex] : 0.0f;
+	}
+
+	return numFields;
+}
+
+
+static int GetLaneMask(int numFields)
+{
+	return (1 << numFields) - 1;
+}
+
+
+//
+//scalar kernels
+//
+int EvaluateSphereFieldBatchScalar(SphereFieldBuffers const& spheres, int firstField, Vec3 const& position, float collisionRadius, Vec3* out_gravityVectors)
+{
+	int numFields = std::min(GRAVITY_KERNEL_BATCH_WIDTH, static_cast<int>(spheres.m_fieldIndex.size()) - firstField);
+	int overlapMask = 0;
+
+	for (int laneIndex = 0; laneIndex < numFields; laneIndex++)
+	{
+		int sphereIndex = firstField + laneIndex;
+		float toCenterX = spheres.m_centerX[sphereIndex] - position.x;
+		float toCenterY = spheres.m_centerY[sphereIndex] - position.y;
+		float toCenterZ = spheres.m_centerZ[sphereIndex] - position.z;
+		float distanceSq = (toCenterX * toCenterX) + (toCenterY * toCenterY) + (toCenterZ * toCenterZ);
+		float reach = spheres.m_radius[sphereIndex] + collisionRadius;
+		if (!(distanceSq < reach * reach))
+		{
+			continue;
+		}
+
+		//a player exactly at the center gets no direction, same as Vec3::Normalize on a zero vector
+		float scale = (distanceSq > 0.0f) ? spheres.m_force[sphereIndex] / sqrtf(distanceSq) : 0.0f;
+		out_gravityVectors[laneIndex] = Vec3(toCenterX * scale, toCenterY * scale, toCenterZ * scale);
+		overlapMask |= 1 << laneIndex;
+	}
+
+	return overlapMask;
+}
+
+
+int EvaluateCapsuleFieldBatchScalar(CapsuleFieldBuffers const& capsules, int firstField, Vec3 const& position, float collisionRadius, Vec3* out_gravityVectors)
+{
+	int numFields = std::min(GRAVITY_KERNEL_BATCH_WIDTH, static_cast<int>(capsules.m_fieldIndex.size()) - firstField);
+	int overlapMask = 0;
+
+	for (int laneIndex = 0; laneIndex < numFields; laneIndex++)
+	{
+		int capsuleIndex = firstField + laneIndex;
+		float boneX = capsules.m_endX[capsuleIndex] - capsules.m_startX[capsuleIndex];
+		float boneY = capsules.m_endY[capsuleIndex] - capsules.m_startY[capsuleIndex];
+		float boneZ = capsules.m_endZ[capsuleIndex] - capsules.m_startZ[capsuleIndex];
+		float fromStartX = position.x - capsules.m_startX[capsuleIndex];
+		float fromStartY = position.y - capsules.m_startY[capsuleIndex];
+		float fromStartZ = position.z - capsules.m_startZ[capsuleIndex];
+
+		float boneLengthSq = (boneX * boneX) + (boneY * boneY) + (boneZ * boneZ);
+		float fractionAlongBone = 0.0f;
+		if (boneLengthSq > 0.0f)
+		{
+			float projection = ((fromStartX * boneX) + (fromStartY * boneY) + (fromStartZ * boneZ)) / boneLengthSq;
+			//written the way _mm_max_ps and _mm_min_ps pick, so a projection of -0 clamps to the same zero
+			fractionAlongBone = (projection > 0.0f) ? projection : 0.0f;
+			fractionAlongBone = (fractionAlongBone < 1.0f) ? fractionAlongBone : 1.0f;
+		}
+
+		float toBoneX = (boneX * fractionAlongBone) - fromStartX;
+		float toBoneY = (boneY * fractionAlongBone) - fromStartY;
+		float toBoneZ = (boneZ * fractionAlongBone) - fromStartZ;
+		float distanceSq = (toBoneX * toBoneX) + (toBoneY * toBoneY) + (toBoneZ * toBoneZ);
+		float reach = capsules.m_radius[capsuleIndex] + collisionRadius;
+		if (!(distanceSq < reach * reach))
+		{
+			continue;
+		}
+
+		float scale = (distanceSq > 0.0f) ? capsules.m_force[capsuleIndex] / sqrtf(distanceSq) : 0.0f;
+		out_gravityVectors[laneIndex] = Vec3(toBoneX * scale, toBoneY * scale, toBoneZ * scale);
+		overlapMask |= 1 << laneIndex;
+	}
+
+	return overlapMask;
+}
+
+
+int GetBoundingSphereOverlapBatchScalar(BoundedFieldBuffers const& fields, int firstField, Vec3 const& position, float collisionRadius)
+{
+	int numFields = std::min(GRAVITY_KERNEL_BATCH_WIDTH, static_cast<int>(fields.m_fieldIndex.size()) - firstField);
+	int overlapMask = 0;
+
+	for (int laneIndex = 0; laneIndex < numFields; laneIndex++)
+	{
+		int fieldIndex = firstField + laneIndex;
+		float toCenterX = fields.m_centerX[fieldIndex] - position.x;
+		float toCenterY = fields.m_centerY[fieldIndex] - position.y;
+		float toCenterZ = fields.m_centerZ[fieldIndex] - position.z;
+		float distanceSq = (toCenterX * toCenterX) + (toCenterY * toCenterY) + (toCenterZ * toCenterZ);
+		float reach = fields.m_boundingRadius[fieldIndex] + collisionRadius;
+		if (distanceSq < reach * reach)
+		{
+			overlapMask |= 1 << laneIndex;
+		}
+	}
+
+	return overlapMask;
+}
+
+
+//
+//sse kernels
+//
+#if GRAVITY_KERNELS_USE_SSE
+int EvaluateSphereFieldBatchSSE(SphereFieldBuffers const& spheres, int firstField, Vec3 const& position, float collisionRadius, Vec3* out_gravityVectors)
+{
+	float centerX[GRAVITY_KERNEL_BATCH_WIDTH];
+	float centerY[GRAVITY_KERNEL_BATCH_WIDTH];
+	float centerZ[GRAVITY_KERNEL_BATCH_WIDTH];
+	float radius[GRAVITY_KERNEL_BATCH_WIDTH];
+	float force[GRAVITY_KERNEL_BATCH_WIDTH];
+	int numFields = LoadBatch(spheres.m_centerX, firstField, centerX);
+	LoadBatch(spheres.m_centerY, firstField, centerY);
+	LoadBatch(spheres.m_centerZ, firstField, centerZ);
+	LoadBatch(spheres.m_radius, firstField, radius);
+	LoadBatch(spheres.m_force, firstField, force);
+
+	__m128 zero = _mm_setzero_ps();
+	__m128 toCenterX = _mm_sub_ps(_mm_loadu_ps(centerX), _mm_set1_ps(position.x));
+	__m128 toCenterY = _mm_sub_ps(_mm_loadu_ps(centerY), _mm_set1_ps(position.y));
+	__m128 toCenterZ = _mm_sub_ps(_mm_loadu_ps(centerZ), _mm_set1_ps(position.z));
+	__m128 distanceSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(toCenterX, toCenterX), _mm_mul_ps(toCenterY, toCenterY)), _mm_mul_ps(toCenterZ, toCenterZ));
+	__m128 reach = _mm_add_ps(_mm_loadu_ps(radius), _mm_set1_ps(collisionRadius));
+
+	int overlapMask = _mm_movemask_ps(_mm_cmplt_ps(distanceSq, _mm_mul_ps(reach, reach))) & GetLaneMask(numFields);
+	if (overlapMask == 0)
+	{
+		return 0;
+	}
+
+	//zero length lanes divide by zero here, and are masked back to a zero scale like the scalar kernel
+	__m128 scale = _mm_div_ps(_mm_loadu_ps(force), _mm_sqrt_ps(distanceSq));
+	scale = _mm_and_ps(scale, _mm_cmpgt_ps(distanceSq, zero));
+
+	float gravityX[GRAVITY_KERNEL_BATCH_WIDTH];
+	float gravityY[GRAVITY_KERNEL_BATCH_WIDTH];
+	float gravityZ[GRAVITY_KERNEL_BATCH_WIDTH];
+	_mm_storeu_ps(gravityX, _mm_mul_ps(toCenterX, scale));
+	_mm_storeu_ps(gravityY, _mm_mul_ps(toCenterY, scale));
+	_mm_storeu_ps(gravityZ, _mm_mul_ps(toCenterZ, scale));
+
+	for (int laneIndex = 0; laneIndex < numFields; laneIndex++)
+	{
+		if (overlapMask & (1 << laneIndex))
+		{
+			out_gravityVectors[laneIndex] = Vec3(gravityX[laneIndex], gravityY[laneIndex], gravityZ[laneIndex]);
+		}
+	}
+
+	return overlapMask;
+}
+
+
+int EvaluateCapsuleFieldBatchSSE(CapsuleFieldBuffers const& capsules, int firstField, Vec3 const& position, float collisionRadius, Vec3* out_gravityVectors)
+{
+	float startX[GRAVITY_KERNEL_BATCH_WIDTH];
+	float startY[GRAVITY_KERNEL_BATCH_WIDTH];
+	float startZ[GRAVITY_KERNEL_BATCH_WIDTH];
+	float endX[GRAVITY_KERNEL_BATCH_WIDTH];
+	float endY[GRAVITY_KERNEL_BATCH_WIDTH];
+	float endZ[GRAVITY_KERNEL_BATCH_WIDTH];
+	float radius[GRAVITY_KERNEL_BATCH_WIDTH];
+	float force[GRAVITY_KERNEL_BATCH_WIDTH];
+	int numFields = LoadBatch(capsules.m_startX, firstField, startX);
+	LoadBatch(capsules.m_startY, firstField, startY);
+	LoadBatch(capsules.m_startZ, firstField, startZ);
+	LoadBatch(capsules.m_endX, firstField, endX);
+	LoadBatch(capsules.m_endY, firstField, endY);
+	LoadBatch(capsules.m_endZ, firstField, endZ);
+	LoadBatch(capsules.m_radius, firstField, radius);
+	LoadBatch(capsules.m_force, firstField, force);
+
+	__m128 zero = _mm_setzero_ps();
+	__m128 one = _mm_set1_ps(1.0f);
+	__m128 start4X = _mm_loadu_ps(startX);
+	__m128 start4Y = _mm_loadu_ps(startY);
+	__m128 start4Z = _mm_loadu_ps(startZ);
+	__m128 boneX = _mm_sub_ps(_mm_loadu_ps(endX), start4X);
+	__m128 boneY = _mm_sub_ps(_mm_loadu_ps(endY), start4Y);
+	__m128 boneZ = _mm_sub_ps(_mm_loadu_ps(endZ), start4Z);
+	__m128 fromStartX = _mm_sub_ps(_mm_set1_ps(position.x), start4X);
+	__m128 fromStartY = _mm_sub_ps(_mm_set1_ps(position.y), start4Y);
+	__m128 fromStartZ = _mm_sub_ps(_mm_set1_ps(position.z), start4Z);
+
+	__m128 boneLengthSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(boneX, boneX), _mm_mul_ps(boneY, boneY)), _mm_mul_ps(boneZ, boneZ));
+	__m128 projection = _mm_add_ps(_mm_add_ps(_mm_mul_ps(fromStartX, boneX), _mm_mul_ps(fromStartY, boneY)), _mm_mul_ps(fromStartZ, boneZ));
+	projection = _mm_div_ps(projection, boneLengthSq);
+	__m128 fractionAlongBone = _mm_min_ps(_mm_max_ps(projection, zero), one);
+	fractionAlongBone = _mm_and_ps(fractionAlongBone, _mm_cmpgt_ps(boneLengthSq, zero));
+
+	__m128 toBoneX = _mm_sub_ps(_mm_mul_ps(boneX, fractionAlongBone), fromStartX);
+	__m128 toBoneY = _mm_sub_ps(_mm_mul_ps(boneY, fractionAlongBone), fromStartY);
+	__m128 toBoneZ = _mm_sub_ps(_mm_mul_ps(boneZ, fractionAlongBone), fromStartZ);
+	__m128 distanceSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(toBoneX, toBoneX), _mm_mul_ps(toBoneY, toBoneY)), _mm_mul_ps(toBoneZ, toBoneZ));
+	__m128 reach = _mm_add_ps(_mm_loadu_ps(radius), _mm_set1_ps(collisionRadius));
+
+	int overlapMask = _mm_movemask_ps(_mm_cmplt_ps(distanceSq, _mm_mul_ps(reach, reach))) & GetLaneMask(numFields);
+	if (overlapMask == 0)
+	{
+		return 0;
+	}
+
+	__m128 scale = _mm_div_ps(_mm_loadu_ps(force), _mm_sqrt_ps(distanceSq));
+	scale = _mm_and_ps(scale, _mm_cmpgt_ps(distanceSq, zero));
+
+	float gravityX[GRAVITY_KERNEL_BATCH_WIDTH];
+	float gravityY[GRAVITY_KERNEL_BATCH_WIDTH];
+	float gravityZ[GRAVITY_KERNEL_BATCH_WIDTH];
+	_mm_storeu_ps(gravityX, _mm_mul_ps(toBoneX, scale));
+	_mm_storeu_ps(gravityY, _mm_mul_ps(toBoneY, scale));
+	_mm_storeu_ps(gravityZ, _mm_mul_ps(toBoneZ, scale));
+
+	for (int laneIndex = 0; laneIndex < numFields; laneIndex++)
+	{
+		if (overlapMask & (1 << laneIndex))
+		{
+			out_gravityVectors[laneIndex] = Vec3(gravityX[laneIndex], gravityY[laneIndex], gravityZ[laneIndex]);
+		}
+	}
+
+	return overlapMask;
+}
+
+
+int GetBoundingSphereOverlapBatchSSE(BoundedFieldBuffers const& fields, int firstField, Vec3 const& position, float collisionRadius)
+{
+	float centerX[GRAVITY_KERNEL_BATCH_WIDTH];
+	float centerY[GRAVITY_KERNEL_BATCH_WIDTH];
+	float centerZ[GRAVITY_KERNEL_BATCH_WIDTH];
+	float boundingRadius[GRAVITY_KERNEL_BATCH_WIDTH];
+	int numFields = LoadBatch(fields.m_centerX, firstField, centerX);
+	LoadBatch(fields.m_centerY, firstField, centerY);
+	LoadBatch(fields.m_centerZ, firstField, centerZ);
+	LoadBatch(fields.m_boundingRadius, firstField, boundingRadius);
+
+	__m128 toCenterX = _mm_sub_ps(_mm_loadu_ps(centerX), _mm_set1_ps(position.x));
+	__m128 toCenterY = _mm_sub_ps(_mm_loadu_ps(centerY), _mm_set1_ps(position.y));
+	__m128 toCenterZ = _mm_sub_ps(_mm_loadu_ps(centerZ), _mm_set1_ps(position.z));
+	__m128 distanceSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(toCenterX, toCenterX), _mm_mul_ps(toCenterY, toCenterY)), _mm_mul_ps(toCenterZ, toCenterZ));
+	__m128 reach = _mm_add_ps(_mm_loadu_ps(boundingRadius), _mm_set1_ps(collisionRadius));
+
+	return _mm_movemask_ps(_mm_cmplt_ps(distanceSq, _mm_mul_ps(reach, reach))) & GetLaneMask(numFields);
+}
+#endif
+
+
+//
+//dispatching kernels
+//
+int EvaluateSphereFieldBatch(SphereFieldBuffers const& spheres, int firstField, Vec3 const& position, float collisionRadius, Vec3* out_gravityVectors)
+{
+#if GRAVITY_KERNELS_USE_SSE
+	return EvaluateSphereFieldBatchSSE(spheres, firstField, position, collisionRadius, out_gravityVectors);
+#else
+	return EvaluateSphereFieldBatchScalar(spheres, firstField, position, collisionRadius, out_gravityVectors);
+#endif
+}
+
+
+int EvaluateCapsuleFieldBatch(CapsuleFieldBuffers const& capsules, int firstField, Vec3 const& position, float collisionRadius, Vec3* out_gravityVectors)
+{
+#if GRAVITY_KERNELS_USE_SSE
+	return EvaluateCapsuleFieldBatchSSE(capsules, firstField, position, collisionRadius, out_gravityVectors);
+#else
+	return EvaluateCapsuleFieldBatchScalar(capsules, firstField, position, collisionRadius, out_gravityVectors);
+#endif
+}
+
+
+int GetBoundingSphereOverlapBatch(BoundedFieldBuffers const& fields, int firstField, Vec3 const& position, float collisionRadius)
+{
+#if GRAVITY_KERNELS_USE_SSE
+	return GetBoundingSphereOverlapBatchSSE(fields, firstField, position, collisionRadius);
+#else
+	return GetBoundingSphereOverlapBatchScalar(fields, firstField, position, collisionRadius);
+#endif
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include "Game/GravityFieldStore.hpp"
+
+
+//sse2 is always there on x64, so the scalar kernels are only the fallback for other targets
+#if defined(_M_X64) || defined(__SSE2__)
+#define GRAVITY_KERNELS_USE_SSE 1
+#else
+#define GRAVITY_KERNELS_USE_SSE 0
+#endif
+
+
+//constants
+constexpr int GRAVITY_KERNEL_BATCH_WIDTH = 4;
+
+
+//batch kernels, each tests up to GRAVITY_KERNEL_BATCH_WIDTH fields of one type starting at firstField against a player sphere
+//bit n of the returned mask is set if field firstField + n contains the player, out_gravityVectors[n] is only written for set bits
+//the sse and scalar versions do the same operations in the same order, so their results agree bit for bit
+int EvaluateSphereFieldBatch(SphereFieldBuffers const& spheres, int firstField, Vec3 const& position, float collisionRadius, Vec3* out_gravityVectors);
+int EvaluateSphereFieldBatchScalar(SphereFieldBuffers const& spheres, int firstField, Vec3 const& position, float collisionRadius, Vec3* out_gravityVectors);
+int EvaluateCapsuleFieldBatch(CapsuleFieldBuffers const& capsules, int firstField, Vec3 const& position, float collisionRadius, Vec3* out_gravityVectors);
+int EvaluateCapsuleFieldBatchScalar(CapsuleFieldBuffers const& capsules, int firstField, Vec3 const& position, float collisionRadius, Vec3* out_gravityVectors);
+
+//ellipsoids, rounded cubes and tori only get their bounding sphere rejection batched, survivors still need the exact test
+int GetBoundingSphereOverlapBatch(BoundedFieldBuffers const& fields, int firstField, Vec3 const& position, float collisionRadius);
+int GetBoundingSphereOverlapBatchScalar(BoundedFieldBuffers const& fields, int firstField, Vec3 const& position, float collisionRadius);
+
+#if GRAVITY_KERNELS_USE_SSE
+int EvaluateSphereFieldBatchSSE(SphereFieldBuffers const& spheres, int firstField, Vec3 const& position, float collisionRadius, Vec3* out_gravityVectors);
+int EvaluateCapsuleFieldBatchSSE(CapsuleFieldBuffers const& capsules, int firstField, Vec3 const& position, float collisionRadius, Vec3* out_gravityVectors);
+int GetBoundingSphereOverlapBatchSSE(BoundedFieldBuffers const& fields, int firstField, Vec3 const& position, float collisionRadius);
+#endif
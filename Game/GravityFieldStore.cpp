@@ -0,0 +1,491 @@
+#include "Game/GravityFieldStore.hpp"
+#include "Game/GravityFieldKernels.hpp"
+#include "Game/GravityFields.hpp"
+#include "Game/Planetoids.hpp"
+#include "Game/Player.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include <algorithm>
+
+
+//
+//store building functions
+//
+void GravityFieldStore::Build(std::vector<Planetoid*> const& planetoids)
+{
+	Clear();
+
+	for (int pltdIndex = 0; pltdIndex < planetoids.size(); pltdIndex++)
+	{
+		Planetoid const* planetoid = planetoids[pltdIndex];
+		if (planetoid == nullptr || planetoid->m_field == nullptr)
+		{
+			continue;
+		}
+
+		GravityField const* field = planetoid->m_field;
+		int fieldIndex = static_cast<int>(m_fields.size());
+		m_fields.emplace_back(field);
+		m_planetoids.emplace_back(planetoid);
+
+		SphereField const*	  sphereField = dynamic_cast<SphereField const*>(field);
+		CapsuleField const*	  capsuleField = dynamic_cast<CapsuleField const*>(field);
+		PlaneField const*	  planeField = dynamic_cast<PlaneField const*>(field);
+		EllipsoidField const* ellipsoidField = dynamic_cast<EllipsoidField const*>(field);
+		RoundCubeField const* roundCubeField = dynamic_cast<RoundCubeField const*>(field);
+		TorusField const*	  torusField = dynamic_cast<TorusField const*>(field);
+		EllipsoidPLTD const*  pltdAsEllipsoid = dynamic_cast<EllipsoidPLTD const*>(planetoid);
+		RoundCubePLTD const*  pltdAsRoundCube = dynamic_cast<RoundCubePLTD const*>(planetoid);
+
+		if (sphereField != nullptr)
+		{
+			Vec3 fieldCenter = planetoid->m_position + sphereField->m_offset;
+			m_spheres.m_centerX.emplace_back(fieldCenter.x);
+			m_spheres.m_centerY.emplace_back(fieldCenter.y);
+			m_spheres.m_centerZ.emplace_back(fieldCenter.z);
+			m_spheres.m_radius.emplace_back(sphereField->m_radius);
+			m_spheres.m_force.emplace_back(sphereField->m_force);
+			m_spheres.m_fieldIndex.emplace_back(fieldIndex);
+		}
+		else if (capsuleField != nullptr)
+		{
+			m_capsules.m_startX.emplace_back(capsuleField->m_boneStart.x);
+			m_capsules.m_startY.emplace_back(capsuleField->m_boneStart.y);
+			m_capsules.m_startZ.emplace_back(capsuleField->m_boneStart.z);
+			m_capsules.m_endX.emplace_back(capsuleField->m_boneEnd.x);
+			m_capsules.m_endY.emplace_back(capsuleField->m_boneEnd.y);
+			m_capsules.m_endZ.emplace_back(capsuleField->m_boneEnd.z);
+			m_capsules.m_radius.emplace_back(capsuleField->m_radius);
+			m_capsules.m_force.emplace_back(capsuleField->m_force);
+			m_capsules.m_fieldIndex.emplace_back(fieldIndex);
+		}
+		else if (planeField != nullptr)
+		{
+			Mat44 const& modelMatrix = planetoid->GetModelMatrix();
+			Vec3 translation = modelMatrix.GetTranslation3D();
+			Vec3 iBasis = modelMatrix.GetIBasis3D();
+			Vec3 jBasis = modelMatrix.GetJBasis3D();
+			Vec3 kBasis = modelMatrix.GetKBasis3D();
+			m_planes.m_translationX.emplace_back(translation.x);
+			m_planes.m_translationY.emplace_back(translation.y);
+			m_planes.m_translationZ.emplace_back(translation.z);
+			m_planes.m_iBasisX.emplace_back(iBasis.x);
+			m_planes.m_iBasisY.emplace_back(iBasis.y);
+			m_planes.m_iBasisZ.emplace_back(iBasis.z);
+			m_planes.m_jBasisX.emplace_back(jBasis.x);
+			m_planes.m_jBasisY.emplace_back(jBasis.y);
+			m_planes.m_jBasisZ.emplace_back(jBasis.z);
+			m_planes.m_kBasisX.emplace_back(kBasis.x);
+			m_planes.m_kBasisY.emplace_back(kBasis.y);
+			m_planes.m_kBasisZ.emplace_back(kBasis.z);
+			m_planes.m_halfLength.emplace_back(planeField->m_halfLength);
+			m_planes.m_halfWidth.emplace_back(planeField->m_halfWidth);
+			m_planes.m_height.emplace_back(planeField->m_height);
+			m_planes.m_force.emplace_back(planeField->m_force);
+			m_planes.m_fieldIndex.emplace_back(fieldIndex);
+		}
+		else if (ellipsoidField != nullptr && pltdAsEllipsoid != nullptr)
+		{
+			float boundingRadius = std::max(ellipsoidField->m_xRadius, std::max(ellipsoidField->m_yRadius, ellipsoidField->m_zRadius));
+			m_ellipsoids.m_centerX.emplace_back(planetoid->m_position.x);
+			m_ellipsoids.m_centerY.emplace_back(planetoid->m_position.y);
+			m_ellipsoids.m_centerZ.emplace_back(planetoid->m_position.z);
+			m_ellipsoids.m_boundingRadius.emplace_back(boundingRadius);
+			m_ellipsoids.m_force.emplace_back(ellipsoidField->m_force);
+			m_ellipsoids.m_orientation.emplace_back(planetoid->m_orientation);
+			m_ellipsoids.m_fieldDimensions.emplace_back(Vec3(ellipsoidField->m_xRadius, ellipsoidField->m_yRadius, ellipsoidField->m_zRadius));
+			m_ellipsoids.m_planetoidDimensions.emplace_back(Vec3(pltdAsEllipsoid->m_xRadius, pltdAsEllipsoid->m_yRadius, pltdAsEllipsoid->m_zRadius));
+			m_ellipsoids.m_roundedness.emplace_back(0.0f);
+			m_ellipsoids.m_fieldIndex.emplace_back(fieldIndex);
+		}
+		else if (roundCubeField != nullptr && pltdAsRoundCube != nullptr)
+		{
+			Vec3 halfDimensions = Vec3(roundCubeField->m_length, roundCubeField->m_width, roundCubeField->m_height) * 0.5f;
+			m_roundCubes.m_centerX.emplace_back(planetoid->m_position.x);
+			m_roundCubes.m_centerY.emplace_back(planetoid->m_position.y);
+			m_roundCubes.m_centerZ.emplace_back(planetoid->m_position.z);
+			m_roundCubes.m_boundingRadius.emplace_back(halfDimensions.GetLength());
+			m_roundCubes.m_force.emplace_back(roundCubeField->m_force);
+			m_roundCubes.m_orientation.emplace_back(planetoid->m_orientation);
+			m_roundCubes.m_fieldDimensions.emplace_back(Vec3(roundCubeField->m_length, roundCubeField->m_width, roundCubeField->m_height));
+			m_roundCubes.m_planetoidDimensions.emplace_back(Vec3(pltdAsRoundCube->m_length, pltdAsRoundCube->m_width, pltdAsRoundCube->m_height));
+			m_roundCubes.m_roundedness.emplace_back(pltdAsRoundCube->m_roundedness);
+			m_roundCubes.m_fieldIndex.emplace_back(fieldIndex);
+		}
+		else if (torusField != nullptr)
+		{
+			Vec3 fieldCenter = planetoid->m_position + torusField->m_offset;
+			float boundingRadius = fabsf(torusField->m_holeRadius + torusField->m_tubeRadius) + fabsf(torusField->m_tubeRadius);
+			m_tori.m_centerX.emplace_back(fieldCenter.x);
+			m_tori.m_centerY.emplace_back(fieldCenter.y);
+			m_tori.m_centerZ.emplace_back(fieldCenter.z);
+			m_tori.m_boundingRadius.emplace_back(boundingRadius);
+			m_tori.m_force.emplace_back(torusField->m_force);
+			m_tori.m_orientation.emplace_back(planetoid->m_orientation);
+			m_tori.m_fieldDimensions.emplace_back(Vec3(torusField->m_tubeRadius, torusField->m_holeRadius, 0.0f));
+			m_tori.m_planetoidDimensions.emplace_back(Vec3());
+			m_tori.m_roundedness.emplace_back(0.0f);
+			m_tori.m_fieldIndex.emplace_back(fieldIndex);
+		}
+		else
+		{
+			m_virtualFieldIndexes.emplace_back(fieldIndex);
+		}
+	}
+}
+
+
+void GravityFieldStore::Clear()
+{
+	m_fields.clear();
+	m_planetoids.clear();
+	m_spheres = SphereFieldBuffers();
+	m_capsules = CapsuleFieldBuffers();
+	m_planes = PlaneFieldBuffers();
+	m_ellipsoids = BoundedFieldBuffers();
+	m_roundCubes = BoundedFieldBuffers();
+	m_tori = BoundedFieldBuffers();
+	m_virtualFieldIndexes.clear();
+	m_hits.clear();
+}
+
+
+//
+//gravity utilities
+//
+void GravityFieldStore::ApplyGravity(Player* player)
+{
+	if (player == nullptr)
+	{
+		return;
+	}
+
+	GravityBodyState playerState;
+	playerState.m_gravitySource = player->m_currentGravitySource;
+	playerState.m_gravityCenter = player->m_currentGravityCenter;
+	playerState.m_gravityVector = player->m_currentGravityVector;
+
+	ApplyGravityToBody(player->m_position, player->m_collisionRadius, playerState, *player, m_hits);
+
+	player->m_currentGravitySource = playerState.m_gravitySource;
+	player->m_currentGravityCenter = playerState.m_gravityCenter;
+	player->m_currentGravityVector = playerState.m_gravityVector;
+}
+
+
+void GravityFieldStore::ApplyGravityToBodies(Vec3 const* positions, float const* collisionRadii, int numBodies, GravityBodyState* inout_states)
+{
+	//only used to carry a body's state through fields that still go through the virtual call
+	Player virtualFieldPlayer = Player(nullptr);
+
+	for (int bodyIndex = 0; bodyIndex < numBodies; bodyIndex++)
+	{
+		ApplyGravityToBody(positions[bodyIndex], collisionRadii[bodyIndex], inout_states[bodyIndex], virtualFieldPlayer, m_hits);
+	}
+}
+
+
+void GravityFieldStore::ApplyGravityToBody(Vec3 const& position, float collisionRadius, GravityBodyState& inout_state, Player& virtualFieldPlayer,
+	std::vector<GravityFieldHit>& hits) const
+{
+	hits.clear();
+	GatherHits(position, collisionRadius, hits);
+
+	//Player::SetGravitySource depends on the order fields are seen in, so hits and virtual fields are merged back into spawn order
+	std::sort(hits.begin(), hits.end(), [](GravityFieldHit const& hitA, GravityFieldHit const& hitB) { return hitA.m_fieldIndex < hitB.m_fieldIndex; });
+
+	int hitIndex = 0;
+	for (int virtualIndex = 0; virtualIndex < m_virtualFieldIndexes.size(); virtualIndex++)
+	{
+		int fieldIndex = m_virtualFieldIndexes[virtualIndex];
+		for (; hitIndex < hits.size() && hits[hitIndex].m_fieldIndex < fieldIndex; hitIndex++)
+		{
+			SetBodyGravitySource(inout_state, position, hits[hitIndex].m_field, hits[hitIndex].m_gravityCenter, hits[hitIndex].m_gravityVector);
+		}
+
+		virtualFieldPlayer.m_position = position;
+		virtualFieldPlayer.m_collisionRadius = collisionRadius;
+		virtualFieldPlayer.m_currentGravitySource = inout_state.m_gravitySource;
+		virtualFieldPlayer.m_currentGravityCenter = inout_state.m_gravityCenter;
+		virtualFieldPlayer.m_currentGravityVector = inout_state.m_gravityVector;
+
+		m_fields[fieldIndex]->ApplyGravity(&virtualFieldPlayer);
+
+		inout_state.m_gravitySource = virtualFieldPlayer.m_currentGravitySource;
+		inout_state.m_gravityCenter = virtualFieldPlayer.m_currentGravityCenter;
+		inout_state.m_gravityVector = virtualFieldPlayer.m_currentGravityVector;
+	}
+
+	for (; hitIndex < hits.size(); hitIndex++)
+	{
+		SetBodyGravitySource(inout_state, position, hits[hitIndex].m_field, hits[hitIndex].m_gravityCenter, hits[hitIndex].m_gravityVector);
+	}
+}
+
+
+void GravityFieldStore::GatherHits(Vec3 const& position, float collisionRadius, std::vector<GravityFieldHit>& out_hits) const
+{
+	GatherSphereHits(position, collisionRadius, out_hits);
+	GatherCapsuleHits(position, collisionRadius, out_hits);
+	GatherPlaneHits(position, collisionRadius, out_hits);
+	GatherEllipsoidHits(position, collisionRadius, out_hits);
+	GatherRoundCubeHits(position, collisionRadius, out_hits);
+	GatherTorusHits(position, collisionRadius, out_hits);
+}
+
+
+//
+//per type gravity loops, each matches its GravityField subclass's ApplyGravity
+//
+void GravityFieldStore::GatherSphereHits(Vec3 const& position, float collisionRadius, std::vector<GravityFieldHit>& out_hits) const
+{
+	int numSpheres = static_cast<int>(m_spheres.m_fieldIndex.size());
+	Vec3 gravityVectors[GRAVITY_KERNEL_BATCH_WIDTH];
+
+	for (int firstSphere = 0; firstSphere < numSpheres; firstSphere += GRAVITY_KERNEL_BATCH_WIDTH)
+	{
+		int overlapMask = EvaluateSphereFieldBatch(m_spheres, firstSphere, position, collisionRadius, gravityVectors);
+		AddBatchHits(m_spheres.m_fieldIndex, firstSphere, overlapMask, gravityVectors, position, out_hits);
+	}
+}
+
+
+void GravityFieldStore::GatherCapsuleHits(Vec3 const& position, float collisionRadius, std::vector<GravityFieldHit>& out_hits) const
+{
+	int numCapsules = static_cast<int>(m_capsules.m_fieldIndex.size());
+	Vec3 gravityVectors[GRAVITY_KERNEL_BATCH_WIDTH];
+
+	for (int firstCapsule = 0; firstCapsule < numCapsules; firstCapsule += GRAVITY_KERNEL_BATCH_WIDTH)
+	{
+		int overlapMask = EvaluateCapsuleFieldBatch(m_capsules, firstCapsule, position, collisionRadius, gravityVectors);
+		AddBatchHits(m_capsules.m_fieldIndex, firstCapsule, overlapMask, gravityVectors, position, out_hits);
+	}
+}
+
+
+void GravityFieldStore::AddBatchHits(std::vector<int> const& fieldIndexes, int firstField, int overlapMask, Vec3 const* gravityVectors, Vec3 const& position,
+	std::vector<GravityFieldHit>& out_hits) const
+{
+	for (int laneIndex = 0; overlapMask != 0; laneIndex++, overlapMask >>= 1)
+	{
+		if ((overlapMask & 1) == 0)
+		{
+			continue;
+		}
+
+		GravityFieldHit hit;
+		hit.m_fieldIndex = fieldIndexes[firstField + laneIndex];
+		hit.m_field = m_fields[hit.m_fieldIndex];
+		hit.m_gravityCenter = m_planetoids[hit.m_fieldIndex]->GetNearestPointOnPlanetoid(position);
+		hit.m_gravityVector = gravityVectors[laneIndex];
+		out_hits.emplace_back(hit);
+	}
+}
+
+
+void GravityFieldStore::GatherPlaneHits(Vec3 const& position, float collisionRadius, std::vector<GravityFieldHit>& out_hits) const
+{
+	PlaneFieldBuffers const& planes = m_planes;
+	int numPlanes = static_cast<int>(planes.m_fieldIndex.size());
+
+	//PlaneField treats the field as a thin shell, so the player only has to come within this of its box
+	float reach = collisionRadius + 0.01f;
+
+	for (int planeIndex = 0; planeIndex < numPlanes; planeIndex++)
+	{
+		float fromOriginX = position.x - planes.m_translationX[planeIndex];
+		float fromOriginY = position.y - planes.m_translationY[planeIndex];
+		float fromOriginZ = position.z - planes.m_translationZ[planeIndex];
+
+		//the distance to the box is the same in local space, since the transform is rigid
+		float localX = (fromOriginX * planes.m_iBasisX[planeIndex]) + (fromOriginY * planes.m_iBasisY[planeIndex]) + (fromOriginZ * planes.m_iBasisZ[planeIndex]);
+		float localY = (fromOriginX * planes.m_jBasisX[planeIndex]) + (fromOriginY * planes.m_jBasisY[planeIndex]) + (fromOriginZ * planes.m_jBasisZ[planeIndex]);
+		float localZ = (fromOriginX * planes.m_kBasisX[planeIndex]) + (fromOriginY * planes.m_kBasisY[planeIndex]) + (fromOriginZ * planes.m_kBasisZ[planeIndex]);
+
+		float clampedX = GetClamped(localX, -planes.m_halfLength[planeIndex], planes.m_halfLength[planeIndex]);
+		float clampedY = GetClamped(localY, -planes.m_halfWidth[planeIndex], planes.m_halfWidth[planeIndex]);
+		float clampedZ = GetClamped(localZ, 0.0f, planes.m_height[planeIndex]);
+
+		float toBoxX = clampedX - localX;
+		float toBoxY = clampedY - localY;
+		float toBoxZ = clampedZ - localZ;
+		if ((toBoxX * toBoxX) + (toBoxY * toBoxY) + (toBoxZ * toBoxZ) >= reach * reach)
+		{
+			continue;
+		}
+
+		Vec3 iBasis = Vec3(planes.m_iBasisX[planeIndex], planes.m_iBasisY[planeIndex], planes.m_iBasisZ[planeIndex]);
+		Vec3 jBasis = Vec3(planes.m_jBasisX[planeIndex], planes.m_jBasisY[planeIndex], planes.m_jBasisZ[planeIndex]);
+		Vec3 kBasis = Vec3(planes.m_kBasisX[planeIndex], planes.m_kBasisY[planeIndex], planes.m_kBasisZ[planeIndex]);
+		Vec3 translation = Vec3(planes.m_translationX[planeIndex], planes.m_translationY[planeIndex], planes.m_translationZ[planeIndex]);
+
+		Vec3 directionOfGravity = -kBasis;
+		directionOfGravity.Normalize();
+
+		GravityFieldHit hit;
+		hit.m_fieldIndex = planes.m_fieldIndex[planeIndex];
+		hit.m_field = m_fields[hit.m_fieldIndex];
+		hit.m_gravityCenter = translation + (iBasis * clampedX) + (jBasis * clampedY);
+		hit.m_gravityVector = directionOfGravity * planes.m_force[planeIndex];
+		out_hits.emplace_back(hit);
+	}
+}
+
+
+void GravityFieldStore::GatherEllipsoidHits(Vec3 const& position, float collisionRadius, std::vector<GravityFieldHit>& out_hits) const
+{
+	BoundedFieldBuffers const& ellipsoids = m_ellipsoids;
+	int numEllipsoids = static_cast<int>(ellipsoids.m_fieldIndex.size());
+
+	int boundsMask = 0;
+	for (int ellipsoidIndex = 0; ellipsoidIndex < numEllipsoids; ellipsoidIndex++)
+	{
+		//bounding spheres are rejected a batch at a time before the exact test
+		int laneIndex = ellipsoidIndex % GRAVITY_KERNEL_BATCH_WIDTH;
+		if (laneIndex == 0)
+		{
+			boundsMask = GetBoundingSphereOverlapBatch(ellipsoids, ellipsoidIndex, position, collisionRadius);
+		}
+
+		if ((boundsMask & (1 << laneIndex)) == 0)
+		{
+			continue;
+		}
+
+		Vec3 center = Vec3(ellipsoids.m_centerX[ellipsoidIndex], ellipsoids.m_centerY[ellipsoidIndex], ellipsoids.m_centerZ[ellipsoidIndex]);
+		Vec3 const& fieldRadii = ellipsoids.m_fieldDimensions[ellipsoidIndex];
+		EulerAngles const& orientation = ellipsoids.m_orientation[ellipsoidIndex];
+		Vec3 nearestPointOnField = GetNearestPointOnEllipsoid3D(position, center, fieldRadii.x, fieldRadii.y, fieldRadii.z, orientation);
+		if (!IsSphereInFixedPoint3D(position, collisionRadius, nearestPointOnField))
+		{
+			continue;
+		}
+
+		Vec3 const& planetoidRadii = ellipsoids.m_planetoidDimensions[ellipsoidIndex];
+		Vec3 nearestPointOnPlanetoid = GetNearestPointOnEllipsoid3D(position, center, planetoidRadii.x, planetoidRadii.y, planetoidRadii.z, orientation);
+		Vec3 directionOfGravity = nearestPointOnPlanetoid - position;
+		directionOfGravity.Normalize();
+
+		GravityFieldHit hit;
+		hit.m_fieldIndex = ellipsoids.m_fieldIndex[ellipsoidIndex];
+		hit.m_field = m_fields[hit.m_fieldIndex];
+		hit.m_gravityCenter = nearestPointOnPlanetoid;
+		hit.m_gravityVector = directionOfGravity * ellipsoids.m_force[ellipsoidIndex];
+		out_hits.emplace_back(hit);
+	}
+}
+
+
+void GravityFieldStore::GatherRoundCubeHits(Vec3 const& position, float collisionRadius, std::vector<GravityFieldHit>& out_hits) const
+{
+	BoundedFieldBuffers const& roundCubes = m_roundCubes;
+	int numRoundCubes = static_cast<int>(roundCubes.m_fieldIndex.size());
+
+	int boundsMask = 0;
+	for (int roundCubeIndex = 0; roundCubeIndex < numRoundCubes; roundCubeIndex++)
+	{
+		//bounding spheres are rejected a batch at a time before the exact test
+		int laneIndex = roundCubeIndex % GRAVITY_KERNEL_BATCH_WIDTH;
+		if (laneIndex == 0)
+		{
+			boundsMask = GetBoundingSphereOverlapBatch(roundCubes, roundCubeIndex, position, collisionRadius);
+		}
+
+		if ((boundsMask & (1 << laneIndex)) == 0)
+		{
+			continue;
+		}
+
+		Vec3 center = Vec3(roundCubes.m_centerX[roundCubeIndex], roundCubes.m_centerY[roundCubeIndex], roundCubes.m_centerZ[roundCubeIndex]);
+		Vec3 const& fieldDimensions = roundCubes.m_fieldDimensions[roundCubeIndex];
+		float roundedness = roundCubes.m_roundedness[roundCubeIndex];
+		EulerAngles const& orientation = roundCubes.m_orientation[roundCubeIndex];
+		Vec3 nearestPointOnField = GetNearestPointOnRoundedCube3D(position, center, fieldDimensions.x, fieldDimensions.y, fieldDimensions.z, roundedness, orientation);
+		if (!IsSphereInFixedPoint3D(position, collisionRadius, nearestPointOnField))
+		{
+			continue;
+		}
+
+		Vec3 const& planetoidDimensions = roundCubes.m_planetoidDimensions[roundCubeIndex];
+		Vec3 nearestPointOnPlanetoid = GetNearestPointOnRoundedCube3D(position, center, planetoidDimensions.x, planetoidDimensions.y, planetoidDimensions.z, roundedness, orientation);
+		Vec3 directionOfGravity = nearestPointOnPlanetoid - position;
+		directionOfGravity.Normalize();
+
+		GravityFieldHit hit;
+		hit.m_fieldIndex = roundCubes.m_fieldIndex[roundCubeIndex];
+		hit.m_field = m_fields[hit.m_fieldIndex];
+		hit.m_gravityCenter = nearestPointOnPlanetoid;
+		hit.m_gravityVector = directionOfGravity * roundCubes.m_force[roundCubeIndex];
+		out_hits.emplace_back(hit);
+	}
+}
+
+
+void GravityFieldStore::GatherTorusHits(Vec3 const& position, float collisionRadius, std::vector<GravityFieldHit>& out_hits) const
+{
+	BoundedFieldBuffers const& tori = m_tori;
+	int numTori = static_cast<int>(tori.m_fieldIndex.size());
+
+	int boundsMask = 0;
+	for (int torusIndex = 0; torusIndex < numTori; torusIndex++)
+	{
+		//bounding spheres are rejected a batch at a time before the exact test
+		int laneIndex = torusIndex % GRAVITY_KERNEL_BATCH_WIDTH;
+		if (laneIndex == 0)
+		{
+			boundsMask = GetBoundingSphereOverlapBatch(tori, torusIndex, position, collisionRadius);
+		}
+
+		if ((boundsMask & (1 << laneIndex)) == 0)
+		{
+			continue;
+		}
+
+		//field dimensions are tube radius then hole radius
+		Vec3 center = Vec3(tori.m_centerX[torusIndex], tori.m_centerY[torusIndex], tori.m_centerZ[torusIndex]);
+		float tubeRadius = tori.m_fieldDimensions[torusIndex].x;
+		float holeRadius = tori.m_fieldDimensions[torusIndex].y;
+		EulerAngles const& orientation = tori.m_orientation[torusIndex];
+		Vec3 nearestPointOnField = GetNearestPointOnTorus3D(position, center, tubeRadius, holeRadius, orientation);
+		if (!IsSphereInFixedPoint3D(position, collisionRadius, nearestPointOnField))
+		{
+			continue;
+		}
+
+		Vec3 nearestPointOnCenterWire = GetNearestPointOnTorus3D(position, center, 0.0f, holeRadius + tubeRadius, orientation);
+		Vec3 directionOfGravity = nearestPointOnCenterWire - position;
+		directionOfGravity.Normalize();
+
+		GravityFieldHit hit;
+		hit.m_fieldIndex = tori.m_fieldIndex[torusIndex];
+		hit.m_field = m_fields[hit.m_fieldIndex];
+		hit.m_gravityCenter = m_planetoids[hit.m_fieldIndex]->GetNearestPointOnPlanetoid(position);
+		hit.m_gravityVector = directionOfGravity * tori.m_force[torusIndex];
+		out_hits.emplace_back(hit);
+	}
+}
+
+
+//
+//static gravity utilities
+//
+void GravityFieldStore::SetBodyGravitySource(GravityBodyState& inout_state, Vec3 const& position, GravityField const* gravitySource, Vec3 const& gravityCenter,
+	Vec3 const& gravityVector)
+{
+	if (inout_state.m_gravitySource == nullptr)
+	{
+		inout_state.m_gravitySource = gravitySource;
+		inout_state.m_gravityCenter = gravityCenter;
+		inout_state.m_gravityVector = gravityVector;
+	}
+	else if (inout_state.m_gravitySource == gravitySource)
+	{
+		inout_state.m_gravityVector = gravityVector;
+		inout_state.m_gravityCenter = gravityCenter;
+	}
+	else if (GetDistanceSquared3D(position, gravityCenter) < GetDistanceSquared3D(position, inout_state.m_gravityCenter))
+	{
+		inout_state.m_gravitySource = gravitySource;
+		inout_state.m_gravityCenter = gravityCenter;
+		inout_state.m_gravityVector = gravityVector;
+	}
+}
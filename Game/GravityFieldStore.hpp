@@ -0,0 +1,148 @@
+#pragma once
+#include "Engine/Math/Vec3.hpp"
+#include "Engine/Math/EulerAngles.hpp"
+#include <vector>
+
+
+//forward declarations
+class GravityField;
+class Planetoid;
+class Player;
+
+
+//a field that contains the player, waiting to be handed to Player::SetGravitySource in spawn order
+struct GravityFieldHit
+{
+	int					m_fieldIndex = 0;
+	GravityField const* m_field = nullptr;
+	Vec3				m_gravityCenter = Vec3();
+	Vec3				m_gravityVector = Vec3();
+};
+
+
+//gravity source a body is currently under, kept between frames the same way Player keeps its current source
+struct GravityBodyState
+{
+	GravityField const* m_gravitySource = nullptr;
+	Vec3				m_gravityCenter = Vec3();
+	Vec3				m_gravityVector = Vec3();
+};
+
+
+//per type buffers, one entry per field, each holding the index of its field in the store
+struct SphereFieldBuffers
+{
+	std::vector<float> m_centerX;
+	std::vector<float> m_centerY;
+	std::vector<float> m_centerZ;
+	std::vector<float> m_radius;
+	std::vector<float> m_force;
+	std::vector<int>   m_fieldIndex;
+};
+
+
+struct CapsuleFieldBuffers
+{
+	std::vector<float> m_startX;
+	std::vector<float> m_startY;
+	std::vector<float> m_startZ;
+	std::vector<float> m_endX;
+	std::vector<float> m_endY;
+	std::vector<float> m_endZ;
+	std::vector<float> m_radius;
+	std::vector<float> m_force;
+	std::vector<int>   m_fieldIndex;
+};
+
+
+//planes are rigid, so the inverse transform is kept as the basis and translation and applied as a transposed rotation
+struct PlaneFieldBuffers
+{
+	std::vector<float> m_translationX;
+	std::vector<float> m_translationY;
+	std::vector<float> m_translationZ;
+	std::vector<float> m_iBasisX;
+	std::vector<float> m_iBasisY;
+	std::vector<float> m_iBasisZ;
+	std::vector<float> m_jBasisX;
+	std::vector<float> m_jBasisY;
+	std::vector<float> m_jBasisZ;
+	std::vector<float> m_kBasisX;
+	std::vector<float> m_kBasisY;
+	std::vector<float> m_kBasisZ;
+	std::vector<float> m_halfLength;
+	std::vector<float> m_halfWidth;
+	std::vector<float> m_height;
+	std::vector<float> m_force;
+	std::vector<int>   m_fieldIndex;
+};
+
+
+//ellipsoids, rounded cubes and tori go through the engine's nearest point functions, so the loop first rejects them against a bounding sphere
+struct BoundedFieldBuffers
+{
+	std::vector<float>		 m_centerX;
+	std::vector<float>		 m_centerY;
+	std::vector<float>		 m_centerZ;
+	std::vector<float>		 m_boundingRadius;
+	std::vector<float>		 m_force;
+	std::vector<EulerAngles> m_orientation;
+	std::vector<Vec3>		 m_fieldDimensions;
+	std::vector<Vec3>		 m_planetoidDimensions;
+	std::vector<float>		 m_roundedness;
+	std::vector<int>		 m_fieldIndex;
+};
+
+
+//data oriented copy of every gravity field in a level, grouped by type
+//the GravityField classes are still how fields are authored, this is rebuilt from them when the level changes
+class GravityFieldStore
+{
+//public member functions
+public:
+	//store building
+	void Build(std::vector<Planetoid*> const& planetoids);
+	void Clear();
+
+	//gravity utilities
+	void ApplyGravity(Player* player);
+	void ApplyGravityToBodies(Vec3 const* positions, float const* collisionRadii, int numBodies, GravityBodyState* inout_states);
+	void ApplyGravityToBody(Vec3 const& position, float collisionRadius, GravityBodyState& inout_state, Player& virtualFieldPlayer, std::vector<GravityFieldHit>& hits) const;
+	void GatherHits(Vec3 const& position, float collisionRadius, std::vector<GravityFieldHit>& out_hits) const;
+
+	//same arbitration as Player::SetGravitySource
+	static void SetBodyGravitySource(GravityBodyState& inout_state, Vec3 const& position, GravityField const* gravitySource, Vec3 const& gravityCenter, Vec3 const& gravityVector);
+
+	int  GetNumFields() const { return static_cast<int>(m_fields.size()); }
+	int  GetNumVirtualFields() const { return static_cast<int>(m_virtualFieldIndexes.size()); }
+
+//private member functions
+private:
+	void GatherSphereHits(Vec3 const& position, float collisionRadius, std::vector<GravityFieldHit>& out_hits) const;
+	void GatherCapsuleHits(Vec3 const& position, float collisionRadius, std::vector<GravityFieldHit>& out_hits) const;
+	void GatherPlaneHits(Vec3 const& position, float collisionRadius, std::vector<GravityFieldHit>& out_hits) const;
+	void GatherEllipsoidHits(Vec3 const& position, float collisionRadius, std::vector<GravityFieldHit>& out_hits) const;
+	void GatherRoundCubeHits(Vec3 const& position, float collisionRadius, std::vector<GravityFieldHit>& out_hits) const;
+	void GatherTorusHits(Vec3 const& position, float collisionRadius, std::vector<GravityFieldHit>& out_hits) const;
+	void AddBatchHits(std::vector<int> const& fieldIndexes, int firstField, int overlapMask, Vec3 const* gravityVectors, Vec3 const& position,
+		std::vector<GravityFieldHit>& out_hits) const;
+
+//public member variables
+public:
+	//every field in spawn order, which is the order Player::SetGravitySource has to see them in
+	std::vector<GravityField const*> m_fields;
+	std::vector<Planetoid const*>	 m_planetoids;
+
+	SphereFieldBuffers	m_spheres;
+	CapsuleFieldBuffers m_capsules;
+	PlaneFieldBuffers	m_planes;
+	BoundedFieldBuffers m_ellipsoids;
+	BoundedFieldBuffers m_roundCubes;
+	BoundedFieldBuffers m_tori;
+
+	//bowls, wires, cylinders, wedges and mobius strips still go through the virtual call
+	std::vector<int> m_virtualFieldIndexes;
+
+	//scratch space so a frame doesn't allocate
+	std::vector<GravityFieldHit> m_hits;
+};
@@ -1,12 +1,8 @@
 #include "Game/GravityFields.hpp"
 #include "Game/Planetoids.hpp"
 #include "Game/Player.hpp"
-#include "Game/GameCommon.hpp"
-#include "Engine/Renderer/DebugRenderSystem.hpp"
 #include "Engine/Math/MathUtils.hpp"
-#include "Engine/Renderer/Renderer.hpp"
-#include "Engine/Core/Vertex_PCU.hpp"
-#include "Engine/Core/VertexUtils.hpp"
+#include "Game/BoundingVolumeHierarchy.hpp"
 
 
 //
@@ -19,52 +15,39 @@ void PlaneField::ApplyGravity(Player* player) const
 		return;
 	}
 
-	Vec3 playerInPltdSpace = m_planetoid->GetModelMatrix().GetOrthonormalInverse().TransformPosition3D(player->m_position);
+	Mat44 const& modelMatrix = m_planetoid->GetModelMatrix();
+	Vec3 playerInPltdSpace = m_planetoid->GetInverseModelMatrix().TransformPosition3D(player->m_position);
 
 	//#TODO: offset stuff
 	playerInPltdSpace.z = GetClamped(playerInPltdSpace.z, 0.0f, m_height);
 	playerInPltdSpace.x = GetClamped(playerInPltdSpace.x, -m_halfLength, m_halfLength);
 	playerInPltdSpace.y = GetClamped(playerInPltdSpace.y, -m_halfWidth, m_halfWidth);
 
-	Vec3 nearestPointInField = m_planetoid->GetModelMatrix().TransformPosition3D(playerInPltdSpace);
+	Vec3 nearestPointInField = modelMatrix.TransformPosition3D(playerInPltdSpace);
 
 	if (DoSpheresOverlap(player->m_position, player->m_collisionRadius, nearestPointInField, 0.01f))
 	{
-		Vec3 directionOfGravity = -m_planetoid->GetModelMatrix().GetKBasis3D();
+		Vec3 directionOfGravity = -modelMatrix.GetKBasis3D();
 		
 		directionOfGravity.Normalize();
 		directionOfGravity *= m_force;
 
 		playerInPltdSpace.z = 0.0f;
 
-		Vec3 nearestPointOnPlane = m_planetoid->GetModelMatrix().TransformPosition3D(playerInPltdSpace);
+		Vec3 nearestPointOnPlane = modelMatrix.TransformPosition3D(playerInPltdSpace);
 
 		player->SetGravitySource(this, nearestPointOnPlane, directionOfGravity);
 	}
 }
 
 
-void PlaneField::DebugRender() const
+AABB3 PlaneField::GetWorldBounds() const
 {
-	std::vector<Vertex_PCU> verts;
+	//pad by the radius of the point the player is tested against in ApplyGravity
+	Vec3 localMins = Vec3(-m_halfLength - 0.01f, -m_halfWidth - 0.01f, -0.01f);
+	Vec3 localMaxs = Vec3(m_halfLength + 0.01f, m_halfWidth + 0.01f, m_height + 0.01f);
 
-	//#TODO: offset stuff
-	Vec3 fbl = Vec3(m_halfLength, m_halfWidth, 0.0f);
-	Vec3 fbr = Vec3(m_halfLength, -m_halfWidth, 0.0f);
-	Vec3 bbl = Vec3(-m_halfLength, m_halfWidth, 0.0f);
-	Vec3 bbr = Vec3(-m_halfLength, -m_halfWidth, 0.0f);
-	Vec3 ftl = Vec3(m_halfLength, m_halfWidth, m_height);
-	Vec3 ftr = Vec3(m_halfLength, -m_halfWidth, m_height);
-	Vec3 btl = Vec3(-m_halfLength, m_halfWidth, m_height);
-	Vec3 btr = Vec3(-m_halfLength, -m_halfWidth, m_height);
-
-	AddVertsForCube3D(verts, fbl, fbr, ftl, ftr, bbl, bbr, btl, btr);
-
-	g_theRenderer->BindShader(nullptr);
-	g_theRenderer->BindTexture(nullptr);
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-	g_theRenderer->SetModelConstants(m_planetoid->GetModelMatrix(), g_gravFieldColor);
-	g_theRenderer->DrawVertexArray(verts);
+	return BoundingVolumeHierarchy::GetBoundsOfLocalBox3D(m_planetoid->GetModelMatrix(), localMins, localMaxs);
 }
 
 
@@ -92,17 +75,11 @@ void SphereField::ApplyGravity(Player* player) const
 }
 
 
-void SphereField::DebugRender() const
+AABB3 SphereField::GetWorldBounds() const
 {
-	std::vector<Vertex_PCU> verts;
-
-	AddVertsForSphere3D(verts, m_offset, m_radius, 32, 16);
+	Vec3 fieldCenter = m_planetoid->m_position + m_offset;
 
-	g_theRenderer->BindShader(nullptr);
-	g_theRenderer->BindTexture(nullptr);
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-	g_theRenderer->SetModelConstants(m_planetoid->GetModelMatrix(), g_gravFieldColor);
-	g_theRenderer->DrawVertexArray(verts);
+	return BoundingVolumeHierarchy::GetBoundsOfCapsule3D(fieldCenter, fieldCenter, m_radius);
 }
 
 
@@ -132,18 +109,9 @@ void CapsuleField::ApplyGravity(Player* player) const
 }
 
 
-void CapsuleField::DebugRender() const
+AABB3 CapsuleField::GetWorldBounds() const
 {
-	std::vector<Vertex_PCU> verts;
-
-	//#ToDo: Add offset stuff
-	AddVertsForCapsule3D(verts, Vec3(), m_boneEnd - m_planetoid->m_position, m_radius, 32, 16);
-
-	g_theRenderer->BindShader(nullptr);
-	g_theRenderer->BindTexture(nullptr);
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-	g_theRenderer->SetModelConstants(m_planetoid->GetModelMatrix(), g_gravFieldColor);
-	g_theRenderer->DrawVertexArray(verts);
+	return BoundingVolumeHierarchy::GetBoundsOfCapsule3D(m_boneStart, m_boneEnd, m_radius);
 }
 
 
@@ -175,18 +143,9 @@ void EllipsoidField::ApplyGravity(Player* player) const
 }
 
 
-void EllipsoidField::DebugRender() const
+AABB3 EllipsoidField::GetWorldBounds() const
 {
-	std::vector<Vertex_PCU> verts;
-
-	//#ToDo: Add offset stuff
-	AddVertsForEllipsoid3D(verts, Vec3(), m_xRadius, m_yRadius, m_zRadius, 32, 16);
-
-	g_theRenderer->BindShader(nullptr);
-	g_theRenderer->BindTexture(nullptr);
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-	g_theRenderer->SetModelConstants(m_planetoid->GetModelMatrix(), g_gravFieldColor);
-	g_theRenderer->DrawVertexArray(verts);
+	return BoundingVolumeHierarchy::GetBoundsOfEllipsoid3D(m_planetoid->m_position, m_xRadius, m_yRadius, m_zRadius, m_planetoid->GetModelMatrix());
 }
 
 
@@ -219,21 +178,11 @@ void RoundCubeField::ApplyGravity(Player* player) const
 }
 
 
-void RoundCubeField::DebugRender() const
+AABB3 RoundCubeField::GetWorldBounds() const
 {
-	std::vector<Vertex_PCU> verts;
-
-	//#TODO: Decouple planetoid type from field type
-	//#ToDo: Add offset stuff
-	RoundCubePLTD* pltdAsRoundCube = dynamic_cast<RoundCubePLTD*>(m_planetoid);
+	Vec3 halfDimensions = Vec3(m_length * 0.5f, m_width * 0.5f, m_height * 0.5f);
 
-	AddVertsForRoundedCube3D(verts, Vec3(), m_length * 0.5f, m_width * 0.5f, m_height * 0.5f, pltdAsRoundCube->m_roundedness);
-
-	g_theRenderer->BindShader(nullptr);
-	g_theRenderer->BindTexture(nullptr);
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-	g_theRenderer->SetModelConstants(m_planetoid->GetModelMatrix(), g_gravFieldColor);
-	g_theRenderer->DrawVertexArray(verts);
+	return BoundingVolumeHierarchy::GetBoundsOfLocalBox3D(m_planetoid->GetModelMatrix(), -halfDimensions, halfDimensions);
 }
 
 
@@ -263,17 +212,13 @@ void TorusField::ApplyGravity(Player* player) const
 }
 
 
-void TorusField::DebugRender() const
+AABB3 TorusField::GetWorldBounds() const
 {
-	std::vector<Vertex_PCU> verts;
-
-	AddVertsForTorus3D(verts, m_offset, m_tubeRadius, m_holeRadius);
+	//the center wire sits at hole + tube from the center, so the outer edge is one more tube radius out
+	float outerRadius = fabsf(m_holeRadius + m_tubeRadius) + fabsf(m_tubeRadius);
+	Vec3 fieldCenter = m_planetoid->m_position + m_offset;
 
-	g_theRenderer->BindShader(nullptr);
-	g_theRenderer->BindTexture(nullptr);
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-	g_theRenderer->SetModelConstants(m_planetoid->GetModelMatrix(), g_gravFieldColor);
-	g_theRenderer->DrawVertexArray(verts);
+	return BoundingVolumeHierarchy::GetBoundsOfCapsule3D(fieldCenter, fieldCenter, outerRadius);
 }
 
 
@@ -285,10 +230,8 @@ void BowlField::ApplyGravity(Player* player) const
 		return;
 	}
 
-	Mat44 bowlModelMat = m_planetoid->m_orientation.GetAsMatrix_XFwd_YLeft_ZUp();
-	bowlModelMat.SetTranslation3D(m_planetoid->m_position);
-	Mat44 bowlWorldToLocalMat = bowlModelMat.GetOrthonormalInverse();
-	Vec3 playerPosInLocalSpace = bowlWorldToLocalMat.TransformPosition3D(player->m_position);
+	Mat44 const& bowlModelMat = m_planetoid->GetModelMatrix();
+	Vec3 playerPosInLocalSpace = m_planetoid->GetInverseModelMatrix().TransformPosition3D(player->m_position);
 
 	//get nearest point on hemisphere part
 	Vec3 nearestPointOnHemisphereLocal = GetNearestPointOnSphere3D(playerPosInLocalSpace, Vec3(), m_radius);
@@ -335,65 +278,13 @@ void BowlField::ApplyGravity(Player* player) const
 	}
 }
 
-void BowlField::DebugRender() const
+AABB3 BowlField::GetWorldBounds() const
 {
-	std::vector<Vertex_PCU> verts;
-
-	float degreesPerSlice = 360.0f / static_cast<float>(32);
-	float degreesPerStack = 180.0f / static_cast<float>(8);
-
-	for (int stackIndex = 0; stackIndex < 8; stackIndex++)
-	{
-		float topDegreesLat = -90.0f + (static_cast<float>(stackIndex) * degreesPerStack * 0.5f);
-		float bottomDegreesLat = -90.0f + (static_cast<float>(stackIndex + 1) * degreesPerStack * 0.5f);
-
-		for (int sliceIndex = 0; sliceIndex < 32; sliceIndex++)
-		{
-			float leftDegreesLong = static_cast<float>(sliceIndex) * degreesPerSlice;
-			float rightDegreesLong = static_cast<float>(sliceIndex + 1) * degreesPerSlice;
-
-			Vec3 bottomLeftCoords = Vec3::MakeFromPolarDegrees(bottomDegreesLat, leftDegreesLong, m_radius);
-			Vec3 bottomRightCoords = Vec3::MakeFromPolarDegrees(bottomDegreesLat, rightDegreesLong, m_radius);
-			Vec3 topLeftCoords = Vec3::MakeFromPolarDegrees(topDegreesLat, leftDegreesLong, m_radius);
-			Vec3 topRightCoords = Vec3::MakeFromPolarDegrees(topDegreesLat, rightDegreesLong, m_radius);
-
-			verts.emplace_back(Vertex_PCU(bottomLeftCoords, Rgba8(), Vec2()));
-			verts.emplace_back(Vertex_PCU(topRightCoords, Rgba8(), Vec2()));
-			verts.emplace_back(Vertex_PCU(bottomRightCoords, Rgba8(), Vec2()));
-			
-			verts.emplace_back(Vertex_PCU(bottomLeftCoords, Rgba8(), Vec2()));
-			verts.emplace_back(Vertex_PCU(topLeftCoords, Rgba8(), Vec2()));
-			verts.emplace_back(Vertex_PCU(topRightCoords, Rgba8(), Vec2()));
-		}
-	}
-
-	Vec3 topCenter = Vec3(0.0f, 0.0f, m_height);
-
-	for (int edgeIndex = 0; edgeIndex < 32; edgeIndex++)
-	{
-		float startDegrees = static_cast<float>(edgeIndex) * degreesPerSlice;
-		float endDegrees = static_cast<float>(edgeIndex + 1) * degreesPerSlice;
+	//hemisphere below the rim plus the cylinder above it
+	Vec3 localMins = Vec3(-m_radius, -m_radius, -m_radius);
+	Vec3 localMaxs = Vec3(m_radius, m_radius, m_height);
 
-		Vec3 baseEdgeStart = Vec3::MakeFromPolarDegrees(0.0f, startDegrees, m_radius);
-		Vec3 baseEdgeEnd = Vec3::MakeFromPolarDegrees(0.0f, endDegrees, m_radius);
-
-		Vec3 topEdgeStart = topCenter + Vec3::MakeFromPolarDegrees(0.0f, startDegrees, m_radius);
-		Vec3 topEdgeEnd = topCenter + Vec3::MakeFromPolarDegrees(0.0f, endDegrees, m_radius);
-
-		//draw triangle at top
-		verts.push_back(Vertex_PCU(topCenter, Rgba8(), Vec2()));
-		verts.push_back(Vertex_PCU(topEdgeStart, Rgba8(), Vec2()));
-		verts.push_back(Vertex_PCU(topEdgeEnd, Rgba8(), Vec2()));
-
-		//draw side quad
-		AddVertsForQuad3D(verts, baseEdgeStart, baseEdgeEnd, topEdgeStart, topEdgeEnd);
-	}
-
-	g_theRenderer->BindShader(nullptr);
-	g_theRenderer->BindTexture(nullptr);
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-	g_theRenderer->SetModelConstants(m_planetoid->GetModelMatrix(), g_gravFieldColor);
-	g_theRenderer->DrawVertexArray(verts);
+	return BoundingVolumeHierarchy::GetBoundsOfLocalBox3D(m_planetoid->GetModelMatrix(), localMins, localMaxs);
 }
 
 
@@ -412,17 +303,10 @@ void MobiusField::ApplyGravity(Player* player) const
 
 
 
-void MobiusField::DebugRender() const
+AABB3 MobiusField::GetWorldBounds() const
 {
-	std::vector<Vertex_PCU> verts;
-
-	//add verts for field
-
-	g_theRenderer->BindShader(nullptr);
-	g_theRenderer->BindTexture(nullptr);
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-	g_theRenderer->SetModelConstants(m_planetoid->GetModelMatrix(), g_gravFieldColor);
-	g_theRenderer->DrawVertexArray(verts);
+	//field is not implemented yet, so it never applies gravity
+	return AABB3(m_planetoid->m_position, m_planetoid->m_position);
 }
 
 
@@ -440,68 +324,33 @@ void WireField::ApplyGravity(Player* player) const
 	//#ToDo: Add offset stuff
 	WirePLTD* pltdAsWire = dynamic_cast<WirePLTD*>(m_planetoid);
 
-	Vec3 nearestPointOnField = Vec3();
-	bool playerIsInField = false;
-
-	for (int segIndex = 0; segIndex < pltdAsWire->m_wirePositions.size() - 1; segIndex++)
+	if (!pltdAsWire->IsSphereTouchingWire(player->m_position, player->m_collisionRadius, m_radius))
 	{
-		Vec3 wireStart = pltdAsWire->m_wirePositions[segIndex];
-		wireStart = pltdAsWire->GetModelMatrix().TransformPosition3D(wireStart);
-		Vec3 wireEnd = pltdAsWire->m_wirePositions[segIndex + 1];
-		wireEnd = pltdAsWire->GetModelMatrix().TransformPosition3D(wireEnd);
-
-		nearestPointOnField = GetNearestPointOnCapsule3D(player->m_position, wireStart, wireEnd, m_radius);
-		if (IsSphereInFixedPoint3D(player->m_position, player->m_collisionRadius, nearestPointOnField))
-		{
-			playerIsInField = true;
-			break;
-		}
+		return;
 	}
 
-	if (playerIsInField)
-	{
-		Vec3 nearestPointOnPlanetoid = Vec3(FLT_MAX, FLT_MAX, FLT_MAX);
-
-		for (int segIndex = 0; segIndex < pltdAsWire->m_wirePositions.size() - 1; segIndex++)
-		{
-			Vec3 wireStart = pltdAsWire->m_wirePositions[segIndex];
-			wireStart = pltdAsWire->GetModelMatrix().TransformPosition3D(wireStart);
-			Vec3 wireEnd = pltdAsWire->m_wirePositions[segIndex + 1];
-			wireEnd = pltdAsWire->GetModelMatrix().TransformPosition3D(wireEnd);
+	//SetGravitySource keeps updating the same source in place, so only the nearest point over the whole wire matters
+	Vec3 nearestPointOnPlanetoid = pltdAsWire->GetNearestPointOnPlanetoid(player->m_position);
 
-			Vec3 nearestPointOnSegment = GetNearestPointOnCapsule3D(player->m_position, wireStart, wireEnd, pltdAsWire->m_radius);
-			if (GetDistanceSquared3D(player->m_position, nearestPointOnSegment) < GetDistanceSquared3D(player->m_position, nearestPointOnPlanetoid))
-			{
-				nearestPointOnPlanetoid = nearestPointOnSegment;
-			}
-
-			Vec3 directionOfGravity = nearestPointOnPlanetoid - player->m_position;
-			directionOfGravity.Normalize();
-			directionOfGravity *= m_force;
-			player->SetGravitySource(this, nearestPointOnPlanetoid, directionOfGravity);
-		}
-	}
+	Vec3 directionOfGravity = nearestPointOnPlanetoid - player->m_position;
+	directionOfGravity.Normalize();
+	directionOfGravity *= m_force;
+	player->SetGravitySource(this, nearestPointOnPlanetoid, directionOfGravity);
 }
 
 
-void WireField::DebugRender() const
+AABB3 WireField::GetWorldBounds() const
 {
-	std::vector<Vertex_PCU> verts;
-
-	//this is the only field type that will be allowed to be coupled with the planetoid type in the final version, due to the nature of the wire planetoid
-	//#ToDo: Add offset stuff
 	WirePLTD* pltdAsWire = dynamic_cast<WirePLTD*>(m_planetoid);
+	std::vector<Vec3> const& worldWirePositions = pltdAsWire->m_worldWirePositions;
 
-	for (int segIndex = 0; segIndex < pltdAsWire->m_wirePositions.size() - 1; segIndex++)
+	AABB3 worldBounds = BoundingVolumeHierarchy::GetBoundsOfCapsule3D(worldWirePositions[0], worldWirePositions[0], m_radius);
+	for (int posIndex = 1; posIndex < worldWirePositions.size(); posIndex++)
 	{
-		AddVertsForCapsule3D(verts, pltdAsWire->m_wirePositions[segIndex], pltdAsWire->m_wirePositions[segIndex + 1], m_radius);
+		BoundingVolumeHierarchy::StretchToIncludeAABB3D(worldBounds, BoundingVolumeHierarchy::GetBoundsOfCapsule3D(worldWirePositions[posIndex], worldWirePositions[posIndex], m_radius));
 	}
 
-	g_theRenderer->BindShader(nullptr);
-	g_theRenderer->BindTexture(nullptr);
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-	g_theRenderer->SetModelConstants(m_planetoid->GetModelMatrix(), g_gravFieldColor);
-	g_theRenderer->DrawVertexArray(verts);
+	return worldBounds;
 }
 
 
@@ -519,9 +368,9 @@ void CylinderField::ApplyGravity(Player* player) const
 }
 
 
-void CylinderField::DebugRender() const
+AABB3 CylinderField::GetWorldBounds() const
 {
-
+	return BoundingVolumeHierarchy::GetBoundsOfCapsule3D(m_start, m_end, m_outerRadius);
 }
 
 
@@ -550,16 +399,8 @@ void WedgeField::ApplyGravity(Player* player) const
 }
 
 
-void WedgeField::DebugRender() const
+AABB3 WedgeField::GetWorldBounds() const
 {
-	std::vector<Vertex_PCU> verts;
-
-	AddVertsForSector3D(verts, m_radius, m_start, m_end, m_forwardDegrees, m_apertureDegrees);
-	//AddVertsForCylinder3D(verts, m_start, m_end, m_radius);
-
-	g_theRenderer->BindShader(nullptr);
-	g_theRenderer->BindTexture(nullptr);
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-	g_theRenderer->SetModelConstants(Mat44(), g_gravFieldColor);
-	g_theRenderer->DrawVertexArray(verts);
+	//the wedge is a slice of the cylinder around the bone, so the capsule around it is conservative
+	return BoundingVolumeHierarchy::GetBoundsOfCapsule3D(m_start, m_end, m_radius);
 }
@@ -2,6 +2,10 @@
 #include "Engine/Math/Vec3.hpp"
 #include "Engine/Math/EulerAngles.hpp"
 #include "Engine/Core/Rgba8.hpp"
+#include "Engine/Math/AABB3.hpp"
+#include "Engine/Math/Mat44.hpp"
+#include "Engine/Core/Vertex_PCU.hpp"
+#include <vector>
 
 
 //forward declarations
@@ -26,11 +30,20 @@ public:
 	
 	//gravity utilities
 	virtual void ApplyGravity(Player* player) const = 0;
-	virtual void DebugRender() const = 0;
+#if !defined(GAME_HEADLESS)
+	//debug shell functions, verts are built in the space GetDebugShellTransform maps to world
+	void		  AddWorldVertsForDebugShell(std::vector<Vertex_PCU>& verts) const;
+	virtual void  AddVertsForDebugShell(std::vector<Vertex_PCU>& verts) const = 0;
+	virtual Mat44 GetDebugShellTransform() const;
+#endif
+
+	//spatial utilities
+	virtual AABB3 GetWorldBounds() const = 0;
 
 //public member variables
 public:
 	Planetoid* m_planetoid = nullptr;
+	bool	   m_isDebugShellDirty = true;	//set when the shape or its planetoid's transform changes, the debug shell batch rebuilds it
 	
 	float m_force = GRAVITY_STANDARD;
 	Vec3 m_offset = Vec3();
@@ -48,7 +61,12 @@ public:
 
 	//gravity utilities
 	virtual void ApplyGravity(Player* player) const override;
-	virtual void DebugRender() const override;
+#if !defined(GAME_HEADLESS)
+	virtual void AddVertsForDebugShell(std::vector<Vertex_PCU>& verts) const override;
+#endif
+
+	//spatial utilities
+	virtual AABB3 GetWorldBounds() const override;
 
 //public member variables
 public:
@@ -67,7 +85,12 @@ public:
 
 	//gravity utilities
 	virtual void ApplyGravity(Player* player) const override;
-	virtual void DebugRender() const override;
+#if !defined(GAME_HEADLESS)
+	virtual void AddVertsForDebugShell(std::vector<Vertex_PCU>& verts) const override;
+#endif
+
+	//spatial utilities
+	virtual AABB3 GetWorldBounds() const override;
 
 //public member variables
 public:
@@ -85,7 +108,12 @@ public:
 
 	//gravity utilities
 	virtual void ApplyGravity(Player* player) const override;
-	virtual void DebugRender() const override;
+#if !defined(GAME_HEADLESS)
+	virtual void AddVertsForDebugShell(std::vector<Vertex_PCU>& verts) const override;
+#endif
+
+	//spatial utilities
+	virtual AABB3 GetWorldBounds() const override;
 
 //public member variables
 public:
@@ -109,7 +137,12 @@ public:
 
 	//gravity utilities
 	virtual void ApplyGravity(Player* player) const override;
-	virtual void DebugRender() const override;
+#if !defined(GAME_HEADLESS)
+	virtual void AddVertsForDebugShell(std::vector<Vertex_PCU>& verts) const override;
+#endif
+
+	//spatial utilities
+	virtual AABB3 GetWorldBounds() const override;
 
 //public member variables
 public:
@@ -133,7 +166,12 @@ public:
 
 	//gravity utilities
 	virtual void ApplyGravity(Player* player) const override;
-	virtual void DebugRender() const override;
+#if !defined(GAME_HEADLESS)
+	virtual void AddVertsForDebugShell(std::vector<Vertex_PCU>& verts) const override;
+#endif
+
+	//spatial utilities
+	virtual AABB3 GetWorldBounds() const override;
 
 //public member variables
 public:
@@ -156,7 +194,12 @@ public:
 
 	//gravity utilities
 	virtual void ApplyGravity(Player* player) const override;
-	virtual void DebugRender() const override;
+#if !defined(GAME_HEADLESS)
+	virtual void AddVertsForDebugShell(std::vector<Vertex_PCU>& verts) const override;
+#endif
+
+	//spatial utilities
+	virtual AABB3 GetWorldBounds() const override;
 
 //public member variables
 public:
@@ -175,7 +218,12 @@ public:
 
 	//gravity utilities
 	virtual void ApplyGravity(Player* player) const override;
-	virtual void DebugRender() const override;
+#if !defined(GAME_HEADLESS)
+	virtual void AddVertsForDebugShell(std::vector<Vertex_PCU>& verts) const override;
+#endif
+
+	//spatial utilities
+	virtual AABB3 GetWorldBounds() const override;
 
 //public member variables
 public:
@@ -194,7 +242,12 @@ public:
 
 	//gravity utilities
 	virtual void ApplyGravity(Player* player) const override;
-	virtual void DebugRender() const override;
+#if !defined(GAME_HEADLESS)
+	virtual void AddVertsForDebugShell(std::vector<Vertex_PCU>& verts) const override;
+#endif
+
+	//spatial utilities
+	virtual AABB3 GetWorldBounds() const override;
 
 //public member variables
 public:
@@ -214,7 +267,12 @@ public:
 
 	//gravity utilities
 	virtual void ApplyGravity(Player* player) const override;
-	virtual void DebugRender() const override;
+#if !defined(GAME_HEADLESS)
+	virtual void AddVertsForDebugShell(std::vector<Vertex_PCU>& verts) const override;
+#endif
+
+	//spatial utilities
+	virtual AABB3 GetWorldBounds() const override;
 
 //public member variables
 public:
@@ -238,7 +296,12 @@ public:
 
 	//gravity utilities
 	virtual void ApplyGravity(Player* player) const override;
-	virtual void DebugRender() const override;
+#if !defined(GAME_HEADLESS)
+	virtual void AddVertsForDebugShell(std::vector<Vertex_PCU>& verts) const override;
+#endif
+
+	//spatial utilities
+	virtual AABB3 GetWorldBounds() const override;
 
 //public member variables
 public:
@@ -265,7 +328,13 @@ public:
 
 	//gravity utilities
 	virtual void ApplyGravity(Player* player) const override;
-	virtual void DebugRender() const override;
+#if !defined(GAME_HEADLESS)
+	virtual void  AddVertsForDebugShell(std::vector<Vertex_PCU>& verts) const override;
+	virtual Mat44 GetDebugShellTransform() const override;
+#endif
+
+	//spatial utilities
+	virtual AABB3 GetWorldBounds() const override;
 
 //public member variables
 public:
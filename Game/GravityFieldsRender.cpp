@@ -0,0 +1,209 @@
+#include "Game/GravityFields.hpp"
+#include "Game/Planetoids.hpp"
+#include "Game/GameCommon.hpp"
+#include "Engine/Renderer/DebugRenderSystem.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Renderer/Renderer.hpp"
+#include "Engine/Core/Vertex_PCU.hpp"
+#include "Engine/Core/VertexUtils.hpp"
+
+
+//
+//generic gravity field functions
+//
+void GravityField::AddWorldVertsForDebugShell(std::vector<Vertex_PCU>& verts) const
+{
+	int firstVert = static_cast<int>(verts.size());
+	AddVertsForDebugShell(verts);
+
+	Mat44 transform = GetDebugShellTransform();
+	for (int vertIndex = firstVert; vertIndex < verts.size(); vertIndex++)
+	{
+		verts[vertIndex].m_position = transform.TransformPosition3D(verts[vertIndex].m_position);
+	}
+}
+
+
+Mat44 GravityField::GetDebugShellTransform() const
+{
+	return m_planetoid->GetModelMatrix();
+}
+
+
+//
+//plane gravity functions
+//
+void PlaneField::AddVertsForDebugShell(std::vector<Vertex_PCU>& verts) const
+{
+	//#TODO: offset stuff
+	Vec3 fbl = Vec3(m_halfLength, m_halfWidth, 0.0f);
+	Vec3 fbr = Vec3(m_halfLength, -m_halfWidth, 0.0f);
+	Vec3 bbl = Vec3(-m_halfLength, m_halfWidth, 0.0f);
+	Vec3 bbr = Vec3(-m_halfLength, -m_halfWidth, 0.0f);
+	Vec3 ftl = Vec3(m_halfLength, m_halfWidth, m_height);
+	Vec3 ftr = Vec3(m_halfLength, -m_halfWidth, m_height);
+	Vec3 btl = Vec3(-m_halfLength, m_halfWidth, m_height);
+	Vec3 btr = Vec3(-m_halfLength, -m_halfWidth, m_height);
+
+	AddVertsForCube3D(verts, fbl, fbr, ftl, ftr, bbl, bbr, btl, btr);
+}
+
+
+//
+//sphere gravity functions
+//
+void SphereField::AddVertsForDebugShell(std::vector<Vertex_PCU>& verts) const
+{
+	AddVertsForSphere3D(verts, m_offset, m_radius, 32, 16);
+}
+
+
+//
+//capsule gravity functions
+//
+void CapsuleField::AddVertsForDebugShell(std::vector<Vertex_PCU>& verts) const
+{
+	//#ToDo: Add offset stuff
+	AddVertsForCapsule3D(verts, Vec3(), m_boneEnd - m_planetoid->m_position, m_radius, 32, 16);
+}
+
+
+//
+//ellipsoid gravity functions
+//
+void EllipsoidField::AddVertsForDebugShell(std::vector<Vertex_PCU>& verts) const
+{
+	//#ToDo: Add offset stuff
+	AddVertsForEllipsoid3D(verts, Vec3(), m_xRadius, m_yRadius, m_zRadius, 32, 16);
+}
+
+
+//
+//rounded cube gravity functions
+//
+void RoundCubeField::AddVertsForDebugShell(std::vector<Vertex_PCU>& verts) const
+{
+	//#TODO: Decouple planetoid type from field type
+	//#ToDo: Add offset stuff
+	RoundCubePLTD* pltdAsRoundCube = dynamic_cast<RoundCubePLTD*>(m_planetoid);
+
+	AddVertsForRoundedCube3D(verts, Vec3(), m_length * 0.5f, m_width * 0.5f, m_height * 0.5f, pltdAsRoundCube->m_roundedness);
+}
+
+
+//
+//torus gravity functions
+//
+void TorusField::AddVertsForDebugShell(std::vector<Vertex_PCU>& verts) const
+{
+	AddVertsForTorus3D(verts, m_offset, m_tubeRadius, m_holeRadius);
+}
+
+
+//
+//bowl gravity functions
+//
+void BowlField::AddVertsForDebugShell(std::vector<Vertex_PCU>& verts) const
+{
+	float degreesPerSlice = 360.0f / static_cast<float>(32);
+	float degreesPerStack = 180.0f / static_cast<float>(8);
+
+	for (int stackIndex = 0; stackIndex < 8; stackIndex++)
+	{
+		float topDegreesLat = -90.0f + (static_cast<float>(stackIndex) * degreesPerStack * 0.5f);
+		float bottomDegreesLat = -90.0f + (static_cast<float>(stackIndex + 1) * degreesPerStack * 0.5f);
+
+		for (int sliceIndex = 0; sliceIndex < 32; sliceIndex++)
+		{
+			float leftDegreesLong = static_cast<float>(sliceIndex) * degreesPerSlice;
+			float rightDegreesLong = static_cast<float>(sliceIndex + 1) * degreesPerSlice;
+
+			Vec3 bottomLeftCoords = Vec3::MakeFromPolarDegrees(bottomDegreesLat, leftDegreesLong, m_radius);
+			Vec3 bottomRightCoords = Vec3::MakeFromPolarDegrees(bottomDegreesLat, rightDegreesLong, m_radius);
+			Vec3 topLeftCoords = Vec3::MakeFromPolarDegrees(topDegreesLat, leftDegreesLong, m_radius);
+			Vec3 topRightCoords = Vec3::MakeFromPolarDegrees(topDegreesLat, rightDegreesLong, m_radius);
+
+			verts.emplace_back(Vertex_PCU(bottomLeftCoords, Rgba8(), Vec2()));
+			verts.emplace_back(Vertex_PCU(topRightCoords, Rgba8(), Vec2()));
+			verts.emplace_back(Vertex_PCU(bottomRightCoords, Rgba8(), Vec2()));
+			
+			verts.emplace_back(Vertex_PCU(bottomLeftCoords, Rgba8(), Vec2()));
+			verts.emplace_back(Vertex_PCU(topLeftCoords, Rgba8(), Vec2()));
+			verts.emplace_back(Vertex_PCU(topRightCoords, Rgba8(), Vec2()));
+		}
+	}
+
+	Vec3 topCenter = Vec3(0.0f, 0.0f, m_height);
+
+	for (int edgeIndex = 0; edgeIndex < 32; edgeIndex++)
+	{
+		float startDegrees = static_cast<float>(edgeIndex) * degreesPerSlice;
+		float endDegrees = static_cast<float>(edgeIndex + 1) * degreesPerSlice;
+
+		Vec3 baseEdgeStart = Vec3::MakeFromPolarDegrees(0.0f, startDegrees, m_radius);
+		Vec3 baseEdgeEnd = Vec3::MakeFromPolarDegrees(0.0f, endDegrees, m_radius);
+
+		Vec3 topEdgeStart = topCenter + Vec3::MakeFromPolarDegrees(0.0f, startDegrees, m_radius);
+		Vec3 topEdgeEnd = topCenter + Vec3::MakeFromPolarDegrees(0.0f, endDegrees, m_radius);
+
+		//draw triangle at top
+		verts.push_back(Vertex_PCU(topCenter, Rgba8(), Vec2()));
+		verts.push_back(Vertex_PCU(topEdgeStart, Rgba8(), Vec2()));
+		verts.push_back(Vertex_PCU(topEdgeEnd, Rgba8(), Vec2()));
+
+		//draw side quad
+		AddVertsForQuad3D(verts, baseEdgeStart, baseEdgeEnd, topEdgeStart, topEdgeEnd);
+	}
+}
+
+
+//
+//mobius strip gravity functions
+//
+void MobiusField::AddVertsForDebugShell(std::vector<Vertex_PCU>& verts) const
+{
+	//add verts for field
+	UNUSED(verts);
+}
+
+
+//
+//wire gravity functions
+//
+void WireField::AddVertsForDebugShell(std::vector<Vertex_PCU>& verts) const
+{
+	//this is the only field type that will be allowed to be coupled with the planetoid type in the final version, due to the nature of the wire planetoid
+	//#ToDo: Add offset stuff
+	WirePLTD* pltdAsWire = dynamic_cast<WirePLTD*>(m_planetoid);
+
+	for (int segIndex = 0; segIndex < pltdAsWire->m_wirePositions.size() - 1; segIndex++)
+	{
+		AddVertsForCapsule3D(verts, pltdAsWire->m_wirePositions[segIndex], pltdAsWire->m_wirePositions[segIndex + 1], m_radius);
+	}
+}
+
+
+//
+//cylinder field functions
+//
+void CylinderField::AddVertsForDebugShell(std::vector<Vertex_PCU>& verts) const
+{
+	UNUSED(verts);
+}
+
+
+//
+//wedge field functions
+//
+Mat44 WedgeField::GetDebugShellTransform() const
+{
+	//wedges are built in world space already
+	return Mat44();
+}
+
+
+void WedgeField::AddVertsForDebugShell(std::vector<Vertex_PCU>& verts) const
+{
+	AddVertsForSector3D(verts, m_radius, m_start, m_end, m_forwardDegrees, m_apertureDegrees);
+	//AddVertsForCylinder3D(verts, m_start, m_end, m_radius);
+}
@@ -0,0 +1,293 @@
+#include "Game/InputRecording.hpp"
+#include "Game/Planetoids.hpp"
+#include "Game/BinaryFileUtils.hpp"
+#include "Engine/Core/FileUtils.hpp"
+#include <string.h>
+
+
+//
+//local constants and helpers
+//
+static char const		  INPUT_RECORDING_MAGIC[4] = { 'G', 'F', 'I', 'R' };
+
+//one bit per command field, fields that are zero for the tick aren't written
+static unsigned char const COMMAND_CROUCH = 1 << 0;
+static unsigned char const COMMAND_SPEED_UP = 1 << 1;
+static unsigned char const COMMAND_JUMP = 1 << 2;
+static unsigned char const COMMAND_RESPAWN = 1 << 3;
+static unsigned char const COMMAND_MOVEMENT = 1 << 4;
+static unsigned char const COMMAND_STEER = 1 << 5;
+static unsigned char const COMMAND_YAW = 1 << 6;
+
+
+static void HashVec3(unsigned int& hash, Vec3 const& vector)
+{
+	hash = HashBytes32(&vector.x, sizeof(float), hash);
+	hash = HashBytes32(&vector.y, sizeof(float), hash);
+	hash = HashBytes32(&vector.z, sizeof(float), hash);
+}
+
+
+static void AppendVec3(std::vector<uint8_t>& buffer, Vec3 const& vector)
+{
+	AppendBytes(buffer, &vector.x, sizeof(float));
+	AppendBytes(buffer, &vector.y, sizeof(float));
+	AppendBytes(buffer, &vector.z, sizeof(float));
+}
+
+
+//reads from a buffer front to back, once a read runs past the end every later read fails too
+struct RecordingReader
+{
+	std::vector<uint8_t> const& m_buffer;
+	size_t						m_offset = 0;
+	bool						m_isValid = true;
+
+	explicit RecordingReader(std::vector<uint8_t> const& buffer) : m_buffer(buffer) {}
+
+	void ParseBytes(void* out_data, size_t numBytes)
+	{
+		if (!m_isValid || m_offset + numBytes > m_buffer.size())
+		{
+			m_isValid = false;
+			memset(out_data, 0, numBytes);
+			return;
+		}
+
+		memcpy(out_data, m_buffer.data() + m_offset, numBytes);
+		m_offset += numBytes;
+	}
+
+	void ParseVec3(Vec3& out_vector)
+	{
+		ParseBytes(&out_vector.x, sizeof(float));
+		ParseBytes(&out_vector.y, sizeof(float));
+		ParseBytes(&out_vector.z, sizeof(float));
+	}
+};
+
+
+//
+//recording utilities
+//
+PlayerSnapshot TakePlayerSnapshot(Player const& player)
+{
+	PlayerSnapshot snapshot;
+	snapshot.m_position = player.m_position;
+	snapshot.m_velocity = player.m_velocity;
+	snapshot.m_orientation = player.m_orientation;
+	snapshot.m_respawnPosition = player.m_respawnPosition;
+	snapshot.m_isTankTurn = player.m_isTankTurn;
+	snapshot.m_isFreeFlyMode = player.m_isFreeFlyMode;
+	return snapshot;
+}
+
+
+void RestorePlayerSnapshot(Player& player, PlayerSnapshot const& snapshot)
+{
+	player.ResetMovementState();
+	player.m_position = snapshot.m_position;
+	player.m_velocity = snapshot.m_velocity;
+	player.m_orientation = snapshot.m_orientation;
+	player.m_respawnPosition = snapshot.m_respawnPosition;
+	player.m_isTankTurn = snapshot.m_isTankTurn;
+	player.m_isFreeFlyMode = snapshot.m_isFreeFlyMode;
+	player.SnapRenderState();
+}
+
+
+unsigned int GetPlayerStateChecksum(Player const& player)
+{
+	unsigned int hash = FNV32_OFFSET_BASIS;
+	HashVec3(hash, player.m_position);
+	HashVec3(hash, player.m_velocity);
+	hash = HashBytes32(player.m_orientation.m_values, sizeof(player.m_orientation.m_values), hash);
+	HashVec3(hash, player.m_currentGravityVector);
+	hash = HashBytes32(&player.m_jumpNumber, sizeof(player.m_jumpNumber), hash);
+
+	unsigned char flags = (player.m_isGrounded ? 1 : 0) | (player.m_isWallSliding ? 2 : 0) | (player.m_isCrouching ? 4 : 0);
+	hash = HashBytes32(&flags, sizeof(flags), hash);
+	return hash;
+}
+
+
+unsigned int GetSceneChecksum(std::vector<Planetoid*> const& planetoids)
+{
+	unsigned int hash = FNV32_OFFSET_BASIS;
+	for (int pltdIndex = 0; pltdIndex < planetoids.size(); pltdIndex++)
+	{
+		Planetoid const* planetoid = planetoids[pltdIndex];
+		if (planetoid == nullptr)
+		{
+			continue;
+		}
+
+		HashVec3(hash, planetoid->m_worldBounds.m_mins);
+		HashVec3(hash, planetoid->m_worldBounds.m_maxs);
+		unsigned char hasField = (planetoid->m_field != nullptr) ? 1 : 0;
+		hash = HashBytes32(&hasField, sizeof(hasField), hash);
+	}
+
+	return hash;
+}
+
+
+int GetNumPlanetoids(std::vector<Planetoid*> const& planetoids)
+{
+	int numPlanetoids = 0;
+	for (int pltdIndex = 0; pltdIndex < planetoids.size(); pltdIndex++)
+	{
+		if (planetoids[pltdIndex] != nullptr)
+		{
+			numPlanetoids++;
+		}
+	}
+
+	return numPlanetoids;
+}
+
+
+//
+//file functions
+//
+bool WriteInputRecording(InputRecording const& recording, std::string const& filePath)
+{
+	std::vector<uint8_t> buffer;
+	buffer.reserve(64 + recording.m_commands.size() * 9);
+
+	//header and starting state
+	AppendBytes(buffer, INPUT_RECORDING_MAGIC, sizeof(INPUT_RECORDING_MAGIC));
+	AppendBytes(buffer, &INPUT_RECORDING_VERSION, sizeof(INPUT_RECORDING_VERSION));
+	AppendBytes(buffer, &recording.m_tickSeconds, sizeof(float));
+
+	PlayerSnapshot const& start = recording.m_playerStart;
+	AppendVec3(buffer, start.m_position);
+	AppendVec3(buffer, start.m_velocity);
+	AppendBytes(buffer, start.m_orientation.m_values, sizeof(start.m_orientation.m_values));
+	AppendVec3(buffer, start.m_respawnPosition);
+	uint8_t playerModes = (start.m_isTankTurn ? 1 : 0) | (start.m_isFreeFlyMode ? 2 : 0);
+	AppendBytes(buffer, &playerModes, sizeof(playerModes));
+
+	//the scene is the binary level format behind its byte count
+	std::vector<uint8_t> sceneBytes;
+	AppendLevelDescriptionBytes(sceneBytes, recording.m_scene);
+	unsigned int numSceneBytes = static_cast<unsigned int>(sceneBytes.size());
+	AppendBytes(buffer, &numSceneBytes, sizeof(numSceneBytes));
+	AppendBytes(buffer, sceneBytes.data(), sceneBytes.size());
+
+	AppendBytes(buffer, &recording.m_numPlanetoids, sizeof(int));
+	AppendBytes(buffer, &recording.m_sceneChecksum, sizeof(unsigned int));
+	uint8_t courseModes = (recording.m_inPlaytestCourse ? 1 : 0) | (recording.m_isSteppingPlaytestTriggers ? 2 : 0);
+	AppendBytes(buffer, &courseModes, sizeof(courseModes));
+	AppendBytes(buffer, &recording.m_checkpointIndex, sizeof(int));
+
+	//ticks, a flag byte then only the fields that were set, then the checksum
+	unsigned int numTicks = static_cast<unsigned int>(recording.m_commands.size());
+	AppendBytes(buffer, &numTicks, sizeof(numTicks));
+	for (unsigned int tickIndex = 0; tickIndex < numTicks; tickIndex++)
+	{
+		PlayerCommand const& command = recording.m_commands[tickIndex];
+		uint8_t fields = 0;
+		if (command.m_isCrouchHeld) fields |= COMMAND_CROUCH;
+		if (command.m_isSpeedUpHeld) fields |= COMMAND_SPEED_UP;
+		if (command.m_jumpPressed) fields |= COMMAND_JUMP;
+		if (command.m_respawnPressed) fields |= COMMAND_RESPAWN;
+		if (command.m_movementIntentions != Vec3()) fields |= COMMAND_MOVEMENT;
+		if (command.m_steerDirection != Vec3()) fields |= COMMAND_STEER;
+		if (command.m_yawIntentions != 0.0f) fields |= COMMAND_YAW;
+
+		AppendBytes(buffer, &fields, sizeof(fields));
+		if (fields & COMMAND_MOVEMENT) AppendVec3(buffer, command.m_movementIntentions);
+		if (fields & COMMAND_STEER)	   AppendVec3(buffer, command.m_steerDirection);
+		if (fields & COMMAND_YAW)	   AppendBytes(buffer, &command.m_yawIntentions, sizeof(float));
+
+		unsigned int checksum = (tickIndex < recording.m_checksums.size()) ? recording.m_checksums[tickIndex] : 0;
+		AppendBytes(buffer, &checksum, sizeof(checksum));
+	}
+
+	return FileWriteFromBuffer(buffer, filePath) > 0;
+}
+
+
+bool ReadInputRecording(InputRecording& out_recording, std::string const& filePath)
+{
+	std::vector<uint8_t> buffer;
+	if (FileReadToBuffer(buffer, filePath) <= 0)
+	{
+		return false;
+	}
+
+	RecordingReader reader = RecordingReader(buffer);
+	char magic[4] = {};
+	unsigned int version = 0;
+	reader.ParseBytes(magic, sizeof(magic));
+	reader.ParseBytes(&version, sizeof(version));
+	if (!reader.m_isValid || memcmp(magic, INPUT_RECORDING_MAGIC, sizeof(magic)) != 0 || version != INPUT_RECORDING_VERSION)
+	{
+		return false;
+	}
+
+	InputRecording recording;
+	reader.ParseBytes(&recording.m_tickSeconds, sizeof(float));
+
+	PlayerSnapshot& start = recording.m_playerStart;
+	reader.ParseVec3(start.m_position);
+	reader.ParseVec3(start.m_velocity);
+	reader.ParseBytes(start.m_orientation.m_values, sizeof(start.m_orientation.m_values));
+	reader.ParseVec3(start.m_respawnPosition);
+	uint8_t playerModes = 0;
+	reader.ParseBytes(&playerModes, sizeof(playerModes));
+	start.m_isTankTurn = (playerModes & 1) != 0;
+	start.m_isFreeFlyMode = (playerModes & 2) != 0;
+
+	unsigned int numSceneBytes = 0;
+	reader.ParseBytes(&numSceneBytes, sizeof(numSceneBytes));
+	if (!reader.m_isValid || numSceneBytes > buffer.size() - reader.m_offset || !ReadLevelDescriptionBytes(recording.m_scene, buffer.data() + reader.m_offset, numSceneBytes))
+	{
+		return false;
+	}
+	reader.m_offset += numSceneBytes;
+
+	reader.ParseBytes(&recording.m_numPlanetoids, sizeof(int));
+	reader.ParseBytes(&recording.m_sceneChecksum, sizeof(unsigned int));
+	uint8_t courseModes = 0;
+	reader.ParseBytes(&courseModes, sizeof(courseModes));
+	recording.m_inPlaytestCourse = (courseModes & 1) != 0;
+	recording.m_isSteppingPlaytestTriggers = (courseModes & 2) != 0;
+	reader.ParseBytes(&recording.m_checkpointIndex, sizeof(int));
+
+	unsigned int numTicks = 0;
+	reader.ParseBytes(&numTicks, sizeof(numTicks));
+
+	//every tick is at least a flag byte and a checksum, so a bad count can't make us reserve more than the file holds
+	if (!reader.m_isValid || numTicks > (buffer.size() - reader.m_offset) / 5)
+	{
+		return false;
+	}
+
+	recording.m_commands.resize(numTicks);
+	recording.m_checksums.resize(numTicks);
+	for (unsigned int tickIndex = 0; tickIndex < numTicks; tickIndex++)
+	{
+		PlayerCommand& command = recording.m_commands[tickIndex];
+		uint8_t fields = 0;
+		reader.ParseBytes(&fields, sizeof(fields));
+		command.m_isCrouchHeld = (fields & COMMAND_CROUCH) != 0;
+		command.m_isSpeedUpHeld = (fields & COMMAND_SPEED_UP) != 0;
+		command.m_jumpPressed = (fields & COMMAND_JUMP) != 0;
+		command.m_respawnPressed = (fields & COMMAND_RESPAWN) != 0;
+		if (fields & COMMAND_MOVEMENT) reader.ParseVec3(command.m_movementIntentions);
+		if (fields & COMMAND_STEER)	   reader.ParseVec3(command.m_steerDirection);
+		if (fields & COMMAND_YAW)	   reader.ParseBytes(&command.m_yawIntentions, sizeof(float));
+
+		reader.ParseBytes(&recording.m_checksums[tickIndex], sizeof(unsigned int));
+	}
+
+	if (!reader.m_isValid)
+	{
+		return false;
+	}
+
+	out_recording = recording;
+	return true;
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include "Game/Player.hpp"
+#include "Game/LevelFile.hpp"
+#include <string>
+#include <vector>
+
+
+//forward declarations
+class Planetoid;
+
+
+//constants
+constexpr unsigned int INPUT_RECORDING_VERSION = 2;
+
+
+//player state a recording starts from, the rest of the movement state is reset so replays begin from the same tick
+struct PlayerSnapshot
+{
+	Vec3  m_position = Vec3();
+	Vec3  m_velocity = Vec3();
+	Mat44 m_orientation = Mat44();
+	Vec3  m_respawnPosition = Vec3();
+	bool  m_isTankTurn = true;
+	bool  m_isFreeFlyMode = false;
+};
+
+
+//every command the player's ticks consumed, plus a checksum of the player's state after each one
+struct InputRecording
+{
+	float		   m_tickSeconds = 0.0f;
+	PlayerSnapshot m_playerStart;
+
+	//scene the recording was made in, replays rebuild it from m_scene when the one they're in doesn't match the checksum
+	LevelDescription m_scene;
+	int				 m_numPlanetoids = 0;
+	unsigned int	 m_sceneChecksum = 0;
+	bool			 m_inPlaytestCourse = false;
+	int				 m_checkpointIndex = -1;
+	bool			 m_isSteppingPlaytestTriggers = true;	//the game steps the course triggers after every tick, the scripted headless run doesn't
+
+	std::vector<PlayerCommand> m_commands;
+	std::vector<unsigned int>  m_checksums;
+};
+
+
+//recording utilities
+PlayerSnapshot TakePlayerSnapshot(Player const& player);
+void		   RestorePlayerSnapshot(Player& player, PlayerSnapshot const& snapshot);
+unsigned int   GetPlayerStateChecksum(Player const& player);
+unsigned int   GetSceneChecksum(std::vector<Planetoid*> const& planetoids);
+int			   GetNumPlanetoids(std::vector<Planetoid*> const& planetoids);
+
+//file functions, reading fails on a missing file, a different version, or a truncated recording or scene
+bool WriteInputRecording(InputRecording const& recording, std::string const& filePath);
+bool ReadInputRecording(InputRecording& out_recording, std::string const& filePath);
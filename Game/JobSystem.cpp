@@ -0,0 +1,230 @@
+#include "Game/JobSystem.hpp"
+#include "Game/Profiler.hpp"
+#include <algorithm>
+
+
+//
+//game flow functions
+//
+void JobSystem::Startup()
+{
+	int numThreads = m_config.m_numThreads;
+	if (numThreads <= 0)
+	{
+		numThreads = static_cast<int>(std::thread::hardware_concurrency());
+	}
+	numThreads = std::max(numThreads, 1);
+
+	for (int threadIndex = 0; threadIndex < numThreads; threadIndex++)
+	{
+		m_queues.emplace_back(new ChunkQueue());
+	}
+
+	m_numActiveThreads = numThreads;
+	m_isQuitting = false;
+
+	//the calling thread works too, so it doesn't get a worker of its own
+	for (int threadIndex = 1; threadIndex < numThreads; threadIndex++)
+	{
+		m_workerThreads.emplace_back(&JobSystem::WorkerThreadMain, this, threadIndex);
+	}
+}
+
+
+void JobSystem::Shutdown()
+{
+	//workers finish any queued background jobs before they exit
+	{
+		std::lock_guard<std::mutex> wakeLock(m_wakeMutex);
+		m_isQuitting = true;
+	}
+	m_wakeCondition.notify_all();
+
+	for (int threadIndex = 0; threadIndex < m_workerThreads.size(); threadIndex++)
+	{
+		m_workerThreads[threadIndex].join();
+	}
+	m_workerThreads.clear();
+	m_backgroundJobs.clear();
+
+	for (int queueIndex = 0; queueIndex < m_queues.size(); queueIndex++)
+	{
+		delete m_queues[queueIndex];
+	}
+	m_queues.clear();
+}
+
+
+//
+//job utilities
+//
+void JobSystem::ParallelFor(int numItems, int itemsPerChunk, JobFunction const& function)
+{
+	if (numItems <= 0)
+	{
+		return;
+	}
+
+	itemsPerChunk = std::max(itemsPerChunk, 1);
+	int numChunks = (numItems + itemsPerChunk - 1) / itemsPerChunk;
+
+	//not worth waking anyone for a single chunk
+	if (m_numActiveThreads <= 1 || numChunks <= 1)
+	{
+		function(0, numItems, 0);
+		return;
+	}
+
+	//the function has to be in place before any chunk can be stolen
+	m_currentFunction = &function;
+	m_numChunksRemaining = numChunks;
+
+	//deal chunks out in contiguous runs, so each thread starts on neighboring items and only steals when it runs dry
+	for (int chunkIndex = 0; chunkIndex < numChunks; chunkIndex++)
+	{
+		JobChunk chunk;
+		chunk.m_firstItem = chunkIndex * itemsPerChunk;
+		chunk.m_numItems = std::min(itemsPerChunk, numItems - chunk.m_firstItem);
+
+		int threadIndex = (chunkIndex * m_numActiveThreads) / numChunks;
+		std::lock_guard<std::mutex> queueLock(m_queues[threadIndex]->m_mutex);
+		m_queues[threadIndex]->m_chunks.emplace_back(chunk);
+	}
+
+	{
+		std::lock_guard<std::mutex> wakeLock(m_wakeMutex);
+		m_jobGeneration++;
+	}
+	m_wakeCondition.notify_all();
+
+	RunChunksUntilDone(0);
+	m_currentFunction = nullptr;
+}
+
+
+void JobSystem::SetNumActiveThreads(int numActiveThreads)
+{
+	std::lock_guard<std::mutex> wakeLock(m_wakeMutex);
+	m_numActiveThreads = std::max(1, std::min(numActiveThreads, GetNumThreads()));
+}
+
+
+void JobSystem::SubmitBackgroundJob(BackgroundJobFunction const& job)
+{
+	//with no workers there's nobody to hand it to
+	if (m_workerThreads.empty())
+	{
+		job();
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> wakeLock(m_wakeMutex);
+		m_backgroundJobs.emplace_back(job);
+	}
+	m_wakeCondition.notify_one();
+}
+
+
+//
+//private job functions
+//
+void JobSystem::WorkerThreadMain(int threadIndex)
+{
+	int lastGeneration = 0;
+
+	while (true)
+	{
+		BackgroundJobFunction backgroundJob;
+		bool hasNewChunks = false;
+		{
+			std::unique_lock<std::mutex> wakeLock(m_wakeMutex);
+			m_wakeCondition.wait(wakeLock, [this, threadIndex, &lastGeneration]()
+				{
+					return m_isQuitting || (m_jobGeneration != lastGeneration && threadIndex < m_numActiveThreads) || !m_backgroundJobs.empty();
+				});
+
+			//parallel for chunks come first, the main thread is waiting on those
+			if (m_jobGeneration != lastGeneration && threadIndex < m_numActiveThreads && !m_isQuitting)
+			{
+				lastGeneration = m_jobGeneration;
+				hasNewChunks = true;
+			}
+			else if (!m_backgroundJobs.empty())
+			{
+				backgroundJob = m_backgroundJobs.front();
+				m_backgroundJobs.pop_front();
+			}
+			else
+			{
+				return;
+			}
+		}
+
+		if (hasNewChunks)
+		{
+			RunChunksUntilDone(threadIndex);
+		}
+		else
+		{
+			PROFILE_SCOPE("JobSystem::RunBackgroundJob");
+			backgroundJob();
+		}
+	}
+}
+
+
+bool JobSystem::RunOneChunk(int threadIndex)
+{
+	JobChunk chunk;
+	bool hasChunk = false;
+
+	//own queue first, newest chunk so it's still warm in cache
+	{
+		ChunkQueue* ownQueue = m_queues[threadIndex];
+		std::lock_guard<std::mutex> queueLock(ownQueue->m_mutex);
+		if (!ownQueue->m_chunks.empty())
+		{
+			chunk = ownQueue->m_chunks.back();
+			ownQueue->m_chunks.pop_back();
+			hasChunk = true;
+		}
+	}
+
+	//then steal the oldest chunk from whoever has one
+	for (int victimOffset = 1; !hasChunk && victimOffset < m_numActiveThreads; victimOffset++)
+	{
+		ChunkQueue* victimQueue = m_queues[(threadIndex + victimOffset) % m_numActiveThreads];
+		std::lock_guard<std::mutex> queueLock(victimQueue->m_mutex);
+		if (!victimQueue->m_chunks.empty())
+		{
+			chunk = victimQueue->m_chunks.front();
+			victimQueue->m_chunks.pop_front();
+			hasChunk = true;
+		}
+	}
+
+	if (!hasChunk)
+	{
+		return false;
+	}
+
+	{
+		PROFILE_SCOPE("JobSystem::RunOneChunk");
+		(*m_currentFunction)(chunk.m_firstItem, chunk.m_numItems, threadIndex);
+	}
+	m_numChunksRemaining--;
+	return true;
+}
+
+
+void JobSystem::RunChunksUntilDone(int threadIndex)
+{
+	while (m_numChunksRemaining > 0)
+	{
+		if (!RunOneChunk(threadIndex))
+		{
+			std::this_thread::yield();
+		}
+	}
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+//function run on one chunk of a ParallelFor, threadIndex is below GetNumThreads() so callers can keep per thread scratch space
+typedef std::function<void(int firstItem, int numItems, int threadIndex)> JobFunction;
+
+//one off work that runs on whichever worker is free, nothing waits on it
+typedef std::function<void()> BackgroundJobFunction;
+
+
+//a contiguous range of items handed to one thread at a time
+struct JobChunk
+{
+	int m_firstItem = 0;
+	int m_numItems = 0;
+};
+
+
+struct JobSystemConfig
+{
+	int m_numThreads = 0;	//counts the calling thread, 0 uses every hardware thread
+};
+
+
+//work stealing job system for splitting independent items across cores
+//each thread owns a queue of chunks, works from the back of its own and steals from the front of the others
+//workers also run background jobs between ParallelFor calls, any chunks they would have run get stolen meanwhile
+class JobSystem
+{
+//public member functions
+public:
+	//constructor and destructor
+	explicit JobSystem(JobSystemConfig const& config) : m_config(config) {}
+	~JobSystem() {}
+
+	//game flow functions
+	void Startup();
+	void Shutdown();
+
+	//job utilities
+	void ParallelFor(int numItems, int itemsPerChunk, JobFunction const& function);
+	int  GetNumThreads() const { return static_cast<int>(m_queues.size()); }
+	int  GetNumActiveThreads() const { return m_numActiveThreads; }
+	void SetNumActiveThreads(int numActiveThreads);
+	void SubmitBackgroundJob(BackgroundJobFunction const& job);
+
+//private member functions
+private:
+	void WorkerThreadMain(int threadIndex);
+	bool RunOneChunk(int threadIndex);
+	void RunChunksUntilDone(int threadIndex);
+
+//private member variables
+private:
+	//one queue per thread, the calling thread is always index 0
+	struct ChunkQueue
+	{
+		std::mutex			 m_mutex;
+		std::deque<JobChunk> m_chunks;
+	};
+
+	JobSystemConfig			 m_config;
+	std::vector<std::thread> m_workerThreads;
+	std::vector<ChunkQueue*> m_queues;
+	std::atomic<int>		 m_numActiveThreads{1};
+
+	//current ParallelFor, only ever started from the calling thread
+	JobFunction const*		 m_currentFunction = nullptr;
+	std::atomic<int>		 m_numChunksRemaining{0};
+
+	//workers sleep on this between ParallelFor calls, background jobs are guarded by it too
+	std::mutex				 m_wakeMutex;
+	std::condition_variable	 m_wakeCondition;
+	int						 m_jobGeneration = 0;
+	bool					 m_isQuitting = false;
+	std::deque<BackgroundJobFunction> m_backgroundJobs;
+};
@@ -0,0 +1,756 @@
+#include "Game/LevelFile.hpp"
+#include "Game/PlaytestCourse.hpp"
+#include "Game/Planetoids.hpp"
+#include "Game/BinaryFileUtils.hpp"
+#include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/XmlUtils.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string.h>
+#include <vector>
+
+
+//
+//local constants and helpers
+//
+static char const LEVEL_FILE_MAGIC[4] = { 'G', 'F', 'L', 'V' };
+constexpr size_t  LEVEL_STREAM_CHUNK_BYTES = 64 * 1024;
+
+
+//the constructor arguments past position, orientation and color, in the order the type's record stores them
+struct LevelPlanetoidTypeInfo
+{
+	char const*	 m_name = nullptr;
+	int			 m_numParams = 0;
+	char const*	 m_paramNames[LEVEL_MAX_PLANETOID_PARAMS] = {};
+	unsigned int m_intParamMask = 0;	//params that are ints rather than floats
+};
+
+
+static LevelPlanetoidTypeInfo const LEVEL_PLANETOID_TYPES[NUM_LEVEL_PLANETOID_TYPES] =
+{
+	{ "Plane",		3, { "halfLength", "halfWidth", "gravityHeight" } },
+	{ "Sphere",		2, { "radius", "gravityRadius" } },
+	{ "Capsule",	6, { "radius", "boneLength", "boneDirectionX", "boneDirectionY", "boneDirectionZ", "gravityRadius" } },
+	{ "Ellipsoid",	6, { "xRadius", "yRadius", "zRadius", "gravityXRadius", "gravityYRadius", "gravityZRadius" } },
+	{ "RoundCube",	7, { "length", "width", "height", "roundedness", "gravityLength", "gravityWidth", "gravityHeight" } },
+	{ "Torus",		3, { "tubeRadius", "holeRadius", "gravityRadius" } },
+	{ "Bowl",		3, { "radius", "thickness", "gravityRadius" } },
+	{ "Mobius",		3, { "radius", "halfWidth", "gravityHeight" } },
+	{ "Wire",		17, { "radius", "gravityRadius", "rngSeed", "minSegments", "maxSegments", "segMinLength", "segMaxLength", "maxYawChange", "maxPitchChange",
+		"perlinScaleYaw", "perlinOctavesYaw", "perlinOctavePersistYaw", "perlinOctaveScaleYaw", "perlinScalePitch", "perlinOctavesPitch", "perlinOctavePersistPitch",
+		"perlinOctaveScalePitch" }, (1 << 2) | (1 << 3) | (1 << 4) | (1 << 10) | (1 << 14) },
+	{ "Teapot",		2, { "scale", "gravityRadius" } },
+	{ "SkyStation", 2, { "scale", "gravityRadius" } },
+	{ "Mountain",	2, { "scale", "gravityRadius" } },
+	{ "Fortress",	2, { "scale", "gravityHeight" } },
+};
+
+
+//fixed size front of the binary file, the planetoids, checkpoints and signs follow in that order
+struct LevelFileHeader
+{
+	char		 m_magic[4] = {};
+	unsigned int m_version = 0;
+	unsigned int m_recordHeaderBytes = 0;
+	unsigned int m_numPlanetoids = 0;
+	unsigned int m_numCheckpoints = 0;
+	unsigned int m_numSigns = 0;
+};
+
+
+//fixed size front of each binary planetoid record, m_numParams 4 byte params follow it
+struct LevelRecordHeader
+{
+	uint8_t		m_type = 0;
+	uint8_t		m_hasField = 0;
+	uint16_t	m_numParams = 0;
+	Vec3		m_position;
+	EulerAngles m_orientation;
+	Rgba8		m_color;
+	float		m_gravityForce = 0.0f;
+};
+
+
+//reads the binary variant front to back through a fixed size chunk, once a read runs past the end every later read fails too
+struct LevelStreamReader
+{
+	std::istream&		 m_file;
+	std::vector<uint8_t> m_chunk;
+	size_t				 m_chunkSize = 0;
+	size_t				 m_offset = 0;
+	size_t				 m_numBytesLeft = 0;	//in the whole file, so counts read from it can be checked before anything is allocated for them
+	bool				 m_isValid = true;
+
+	explicit LevelStreamReader(std::istream& file) : m_file(file), m_chunk(LEVEL_STREAM_CHUNK_BYTES)
+	{
+		m_file.seekg(0, std::ios::end);
+		std::streamoff fileBytes = m_file.tellg();
+		m_file.seekg(0, std::ios::beg);
+		m_numBytesLeft = (fileBytes > 0) ? static_cast<size_t>(fileBytes) : 0;
+	}
+
+	void ParseBytes(void* out_data, size_t numBytes)
+	{
+		m_numBytesLeft -= std::min(numBytes, m_numBytesLeft);
+		uint8_t* outBytes = static_cast<uint8_t*>(out_data);
+		while (numBytes > 0)
+		{
+			if (m_offset == m_chunkSize)
+			{
+				if (m_isValid)
+				{
+					m_file.read(reinterpret_cast<char*>(m_chunk.data()), static_cast<std::streamsize>(m_chunk.size()));
+					m_chunkSize = static_cast<size_t>(m_file.gcount());
+					m_offset = 0;
+				}
+				if (!m_isValid || m_chunkSize == 0)
+				{
+					m_isValid = false;
+					memset(outBytes, 0, numBytes);
+					return;
+				}
+			}
+
+			size_t numCopied = std::min(numBytes, m_chunkSize - m_offset);
+			memcpy(outBytes, m_chunk.data() + m_offset, numCopied);
+			m_offset += numCopied;
+			outBytes += numCopied;
+			numBytes -= numCopied;
+		}
+	}
+};
+
+
+template <typename FieldType>
+static float GetFieldValue(Planetoid const& planetoid, float FieldType::* member)
+{
+	FieldType const* field = dynamic_cast<FieldType const*>(planetoid.m_field);
+	return (field != nullptr) ? field->*member : 0.0f;
+}
+
+
+//a partially read level is thrown away rather than handed back
+static bool FinishReadingLevel(LevelDescription& out_level, LevelDescription& level, bool isValid)
+{
+	if (!isValid)
+	{
+		return false;
+	}
+
+	out_level.m_planetoids.insert(out_level.m_planetoids.end(), level.m_planetoids.begin(), level.m_planetoids.end());
+	out_level.m_checkpoints.insert(out_level.m_checkpoints.end(), level.m_checkpoints.begin(), level.m_checkpoints.end());
+	out_level.m_signs.insert(out_level.m_signs.end(), level.m_signs.begin(), level.m_signs.end());
+	return true;
+}
+
+
+//
+//binary variant
+//
+static void AppendBinaryLevel(std::vector<uint8_t>& buffer, LevelDescription const& level)
+{
+	std::vector<LevelPlanetoidRecord> const& records = level.m_planetoids;
+
+	LevelFileHeader header;
+	memcpy(header.m_magic, LEVEL_FILE_MAGIC, sizeof(header.m_magic));
+	header.m_version = LEVEL_FILE_VERSION;
+	header.m_recordHeaderBytes = sizeof(LevelRecordHeader);
+	header.m_numPlanetoids = static_cast<unsigned int>(records.size());
+	header.m_numCheckpoints = static_cast<unsigned int>(level.m_checkpoints.size());
+	header.m_numSigns = static_cast<unsigned int>(level.m_signs.size());
+
+	buffer.reserve(buffer.size() + sizeof(header) + records.size() * (sizeof(LevelRecordHeader) + 4 * sizeof(LevelParam)));
+	AppendBytes(buffer, &header, sizeof(header));
+
+	//only as many params as the type has, most planetoids are a handful of floats
+	for (int recordIndex = 0; recordIndex < records.size(); recordIndex++)
+	{
+		LevelPlanetoidRecord const& record = records[recordIndex];
+		LevelRecordHeader recordHeader;
+		recordHeader.m_type = record.m_type;
+		recordHeader.m_hasField = record.m_hasField ? 1 : 0;
+		recordHeader.m_numParams = static_cast<uint16_t>(LEVEL_PLANETOID_TYPES[record.m_type].m_numParams);
+		recordHeader.m_position = record.m_position;
+		recordHeader.m_orientation = record.m_orientation;
+		recordHeader.m_color = record.m_color;
+		recordHeader.m_gravityForce = record.m_gravityForce;
+		AppendBytes(buffer, &recordHeader, sizeof(recordHeader));
+		AppendBytes(buffer, record.m_params, recordHeader.m_numParams * sizeof(LevelParam));
+	}
+
+	for (int cpIndex = 0; cpIndex < level.m_checkpoints.size(); cpIndex++)
+	{
+		AppendBytes(buffer, &level.m_checkpoints[cpIndex].m_mins, sizeof(Vec3));
+		AppendBytes(buffer, &level.m_checkpoints[cpIndex].m_maxs, sizeof(Vec3));
+	}
+
+	for (int signIndex = 0; signIndex < level.m_signs.size(); signIndex++)
+	{
+		CourseSign const& sign = level.m_signs[signIndex];
+		unsigned int textLength = static_cast<unsigned int>(sign.m_text.size());
+		AppendBytes(buffer, &textLength, sizeof(textLength));
+		AppendBytes(buffer, sign.m_text.data(), textLength);
+		AppendBytes(buffer, sign.m_transform.m_values, sizeof(sign.m_transform.m_values));
+	}
+}
+
+
+static bool WriteBinaryLevelFile(LevelDescription const& level, std::string const& filePath)
+{
+	std::vector<uint8_t> buffer;
+	AppendBinaryLevel(buffer, level);
+	return FileWriteFromBuffer(buffer, filePath) > 0;
+}
+
+
+static bool ReadBinaryLevel(LevelDescription& out_level, std::istream& stream)
+{
+	LevelStreamReader reader = LevelStreamReader(stream);
+	LevelFileHeader header;
+	reader.ParseBytes(&header, sizeof(header));
+	if (!reader.m_isValid || memcmp(header.m_magic, LEVEL_FILE_MAGIC, sizeof(header.m_magic)) != 0 || header.m_version != LEVEL_FILE_VERSION ||
+		header.m_recordHeaderBytes != sizeof(LevelRecordHeader))
+	{
+		return false;
+	}
+
+	//every planetoid, checkpoint and sign takes at least this much file, so a bad count can't make us reserve more than the file holds
+	uint64_t minBytesNeeded = (static_cast<uint64_t>(header.m_numPlanetoids) * sizeof(LevelRecordHeader)) + (static_cast<uint64_t>(header.m_numCheckpoints) * 2 * sizeof(Vec3)) +
+		(static_cast<uint64_t>(header.m_numSigns) * (sizeof(unsigned int) + sizeof(Mat44::m_values)));
+	if (minBytesNeeded > reader.m_numBytesLeft)
+	{
+		return false;
+	}
+
+	//the counts are known up front, so the lists are allocated once instead of growing record by record
+	LevelDescription level;
+	level.m_planetoids.reserve(header.m_numPlanetoids);
+	level.m_checkpoints.reserve(header.m_numCheckpoints);
+	level.m_signs.reserve(header.m_numSigns);
+
+	for (unsigned int recordIndex = 0; recordIndex < header.m_numPlanetoids && reader.m_isValid; recordIndex++)
+	{
+		LevelRecordHeader recordHeader;
+		reader.ParseBytes(&recordHeader, sizeof(recordHeader));
+
+		LevelPlanetoidRecord record;
+		record.m_type = static_cast<LevelPlanetoidType>(recordHeader.m_type);
+		record.m_hasField = recordHeader.m_hasField != 0;
+		record.m_position = recordHeader.m_position;
+		record.m_orientation = recordHeader.m_orientation;
+		record.m_color = recordHeader.m_color;
+		record.m_gravityForce = recordHeader.m_gravityForce;
+
+		//params past the ones this build knows about are skipped, not misread
+		for (int paramIndex = 0; paramIndex < recordHeader.m_numParams; paramIndex++)
+		{
+			LevelParam param;
+			reader.ParseBytes(&param, sizeof(param));
+			if (paramIndex < LEVEL_MAX_PLANETOID_PARAMS)
+			{
+				record.m_params[paramIndex] = param;
+			}
+		}
+
+		//types from a newer build are skipped the same as in the readable variant
+		if (reader.m_isValid && recordHeader.m_type < NUM_LEVEL_PLANETOID_TYPES)
+		{
+			level.m_planetoids.emplace_back(record);
+		}
+	}
+
+	for (unsigned int cpIndex = 0; cpIndex < header.m_numCheckpoints && reader.m_isValid; cpIndex++)
+	{
+		AABB3 checkpoint;
+		reader.ParseBytes(&checkpoint.m_mins, sizeof(Vec3));
+		reader.ParseBytes(&checkpoint.m_maxs, sizeof(Vec3));
+		level.m_checkpoints.emplace_back(checkpoint);
+	}
+
+	for (unsigned int signIndex = 0; signIndex < header.m_numSigns && reader.m_isValid; signIndex++)
+	{
+		CourseSign sign;
+		unsigned int textLength = 0;
+		reader.ParseBytes(&textLength, sizeof(textLength));
+		if (textLength > reader.m_numBytesLeft)
+		{
+			reader.m_isValid = false;
+			break;
+		}
+
+		sign.m_text.resize(reader.m_isValid ? textLength : 0);
+		if (textLength > 0 && reader.m_isValid)
+		{
+			reader.ParseBytes(&sign.m_text[0], textLength);
+		}
+		reader.ParseBytes(sign.m_transform.m_values, sizeof(sign.m_transform.m_values));
+		level.m_signs.emplace_back(sign);
+	}
+
+	return FinishReadingLevel(out_level, level, reader.m_isValid);
+}
+
+
+static bool ReadBinaryLevelFile(LevelDescription& out_level, std::string const& filePath)
+{
+	std::ifstream file(filePath, std::ios::binary);
+	if (!file.is_open())
+	{
+		return false;
+	}
+
+	return ReadBinaryLevel(out_level, file);
+}
+
+
+//
+//readable variant
+//
+static std::string EscapeXmlAttribute(std::string const& text)
+{
+	std::string escapedText;
+	escapedText.reserve(text.size());
+	for (int charIndex = 0; charIndex < text.size(); charIndex++)
+	{
+		char character = text[charIndex];
+		if (character == '&')		escapedText += "&amp;";
+		else if (character == '<')	escapedText += "&lt;";
+		else if (character == '>')	escapedText += "&gt;";
+		else if (character == '"')	escapedText += "&quot;";
+		else if (character == '\n') escapedText += "&#10;";
+		else						escapedText += character;
+	}
+	return escapedText;
+}
+
+
+static std::string GetVec3Text(Vec3 const& vector)
+{
+	//9 significant digits so a float makes it through the text and back unchanged
+	return Stringf("%.9g,%.9g,%.9g", vector.x, vector.y, vector.z);
+}
+
+
+static bool WriteReadableLevelFile(LevelDescription const& level, std::string const& filePath)
+{
+	std::vector<LevelPlanetoidRecord> const& records = level.m_planetoids;
+
+	std::string levelText = Stringf("<Level version=\"%u\">\n", LEVEL_FILE_VERSION);
+	for (int recordIndex = 0; recordIndex < records.size(); recordIndex++)
+	{
+		LevelPlanetoidRecord const& record = records[recordIndex];
+		LevelPlanetoidTypeInfo const& typeInfo = LEVEL_PLANETOID_TYPES[record.m_type];
+
+		levelText += Stringf("\t<Planetoid type=\"%s\" position=\"%s\" orientation=\"%.9g,%.9g,%.9g\" color=\"%u,%u,%u,%u\" field=\"%s\" gravityForce=\"%.9g\"", typeInfo.m_name,
+			GetVec3Text(record.m_position).c_str(), record.m_orientation.m_yawDegrees, record.m_orientation.m_pitchDegrees, record.m_orientation.m_rollDegrees, record.m_color.r,
+			record.m_color.g, record.m_color.b, record.m_color.a, record.m_hasField ? "true" : "false", record.m_gravityForce);
+
+		for (int paramIndex = 0; paramIndex < typeInfo.m_numParams; paramIndex++)
+		{
+			bool isIntParam = (typeInfo.m_intParamMask & (1u << paramIndex)) != 0;
+			levelText += isIntParam ? Stringf(" %s=\"%i\"", typeInfo.m_paramNames[paramIndex], record.m_params[paramIndex].m_int)
+									: Stringf(" %s=\"%.9g\"", typeInfo.m_paramNames[paramIndex], record.m_params[paramIndex].m_float);
+		}
+		levelText += "/>\n";
+	}
+
+	for (int cpIndex = 0; cpIndex < level.m_checkpoints.size(); cpIndex++)
+	{
+		AABB3 const& checkpoint = level.m_checkpoints[cpIndex];
+		levelText += Stringf("\t<Checkpoint mins=\"%s\" maxs=\"%s\"/>\n", GetVec3Text(checkpoint.m_mins).c_str(), GetVec3Text(checkpoint.m_maxs).c_str());
+	}
+
+	//same x, y, z and t basis attributes the model xml uses for its transform
+	for (int signIndex = 0; signIndex < level.m_signs.size(); signIndex++)
+	{
+		CourseSign const& sign = level.m_signs[signIndex];
+		levelText += "\t<Sign text=\"" + EscapeXmlAttribute(sign.m_text) + "\"";
+		levelText += Stringf(" x=\"%s\" y=\"%s\" z=\"%s\" t=\"%s\"/>\n", GetVec3Text(sign.m_transform.GetIBasis3D()).c_str(), GetVec3Text(sign.m_transform.GetJBasis3D()).c_str(),
+			GetVec3Text(sign.m_transform.GetKBasis3D()).c_str(), GetVec3Text(sign.m_transform.GetTranslation3D()).c_str());
+	}
+	levelText += "</Level>\n";
+
+	std::vector<uint8_t> buffer(levelText.begin(), levelText.end());
+	return FileWriteFromBuffer(buffer, filePath) > 0;
+}
+
+
+static bool ReadReadablePlanetoid(XmlElement const& element, LevelPlanetoidRecord& out_record)
+{
+	std::string typeName = ParseXmlAttribute(element, "type", "");
+	int typeIndex = 0;
+	while (typeIndex < NUM_LEVEL_PLANETOID_TYPES && typeName != LEVEL_PLANETOID_TYPES[typeIndex].m_name)
+	{
+		typeIndex++;
+	}
+	if (typeIndex == NUM_LEVEL_PLANETOID_TYPES)
+	{
+		return false;
+	}
+
+	out_record = LevelPlanetoidRecord();
+	out_record.m_type = static_cast<LevelPlanetoidType>(typeIndex);
+	out_record.m_position = ParseXmlAttribute(element, "position", Vec3());
+	out_record.m_orientation = ParseXmlAttribute(element, "orientation", EulerAngles());
+	out_record.m_color = ParseXmlAttribute(element, "color", Rgba8());
+	out_record.m_hasField = ParseXmlAttribute(element, "field", true);
+	out_record.m_gravityForce = ParseXmlAttribute(element, "gravityForce", GRAVITY_STANDARD);
+
+	//left out params read as 1, the same default the planetoid members have
+	LevelPlanetoidTypeInfo const& typeInfo = LEVEL_PLANETOID_TYPES[typeIndex];
+	for (int paramIndex = 0; paramIndex < typeInfo.m_numParams; paramIndex++)
+	{
+		bool isIntParam = (typeInfo.m_intParamMask & (1u << paramIndex)) != 0;
+		if (isIntParam)
+		{
+			out_record.m_params[paramIndex].m_int = ParseXmlAttribute(element, typeInfo.m_paramNames[paramIndex], 1);
+		}
+		else
+		{
+			out_record.m_params[paramIndex].m_float = ParseXmlAttribute(element, typeInfo.m_paramNames[paramIndex], 1.0f);
+		}
+	}
+	return true;
+}
+
+
+static bool ReadReadableLevelFile(LevelDescription& out_level, std::string const& filePath)
+{
+	XmlDocument levelXml;
+	if (levelXml.LoadFile(filePath.c_str()) != tinyxml2::XML_SUCCESS)
+	{
+		return false;
+	}
+
+	XmlElement* rootElement = levelXml.RootElement();
+	if (rootElement == nullptr || ParseXmlAttribute(*rootElement, "version", 0) != static_cast<int>(LEVEL_FILE_VERSION))
+	{
+		return false;
+	}
+
+	LevelDescription level;
+	for (XmlElement* element = rootElement->FirstChildElement(); element != nullptr; element = element->NextSiblingElement())
+	{
+		std::string elementName = element->Name();
+		if (elementName == "Planetoid")
+		{
+			LevelPlanetoidRecord record;
+			if (ReadReadablePlanetoid(*element, record))
+			{
+				level.m_planetoids.emplace_back(record);
+			}
+		}
+		else if (elementName == "Checkpoint")
+		{
+			level.m_checkpoints.emplace_back(AABB3(ParseXmlAttribute(*element, "mins", Vec3()), ParseXmlAttribute(*element, "maxs", Vec3())));
+		}
+		else if (elementName == "Sign")
+		{
+			CourseSign sign;
+			sign.m_text = ParseXmlAttribute(*element, "text", "");
+			sign.m_transform.SetIJKT3D(ParseXmlAttribute(*element, "x", Vec3(1.0f, 0.0f, 0.0f)), ParseXmlAttribute(*element, "y", Vec3(0.0f, 1.0f, 0.0f)),
+				ParseXmlAttribute(*element, "z", Vec3(0.0f, 0.0f, 1.0f)), ParseXmlAttribute(*element, "t", Vec3()));
+			level.m_signs.emplace_back(sign);
+		}
+	}
+
+	return FinishReadingLevel(out_level, level, true);
+}
+
+
+//
+//level record functions
+//
+bool MakeLevelPlanetoidRecord(Planetoid const& planetoid, LevelPlanetoidRecord& out_record)
+{
+	out_record = LevelPlanetoidRecord();
+	out_record.m_hasField = planetoid.m_field != nullptr;
+	out_record.m_position = planetoid.m_position;
+	out_record.m_orientation = planetoid.m_orientation;
+	out_record.m_color = planetoid.m_color;
+	out_record.m_gravityForce = out_record.m_hasField ? planetoid.m_field->m_force : GRAVITY_STANDARD;
+	LevelParam* params = out_record.m_params;
+
+	if (PlanePLTD const* plane = dynamic_cast<PlanePLTD const*>(&planetoid))
+	{
+		out_record.m_type = LEVEL_PLANETOID_PLANE;
+		params[0].m_float = plane->m_halfLength;
+		params[1].m_float = plane->m_halfWidth;
+		params[2].m_float = GetFieldValue(planetoid, &PlaneField::m_height);
+	}
+	else if (SpherePLTD const* sphere = dynamic_cast<SpherePLTD const*>(&planetoid))
+	{
+		out_record.m_type = LEVEL_PLANETOID_SPHERE;
+		params[0].m_float = sphere->m_radius;
+		params[1].m_float = GetFieldValue(planetoid, &SphereField::m_radius);
+	}
+	else if (CapsulePLTD const* capsule = dynamic_cast<CapsulePLTD const*>(&planetoid))
+	{
+		out_record.m_type = LEVEL_PLANETOID_CAPSULE;
+		params[0].m_float = capsule->m_radius;
+		params[1].m_float = capsule->m_boneLength;
+		params[2].m_float = capsule->m_boneDirection.x;
+		params[3].m_float = capsule->m_boneDirection.y;
+		params[4].m_float = capsule->m_boneDirection.z;
+		params[5].m_float = GetFieldValue(planetoid, &CapsuleField::m_radius);
+	}
+	else if (EllipsoidPLTD const* ellipsoid = dynamic_cast<EllipsoidPLTD const*>(&planetoid))
+	{
+		out_record.m_type = LEVEL_PLANETOID_ELLIPSOID;
+		params[0].m_float = ellipsoid->m_xRadius;
+		params[1].m_float = ellipsoid->m_yRadius;
+		params[2].m_float = ellipsoid->m_zRadius;
+		params[3].m_float = GetFieldValue(planetoid, &EllipsoidField::m_xRadius);
+		params[4].m_float = GetFieldValue(planetoid, &EllipsoidField::m_yRadius);
+		params[5].m_float = GetFieldValue(planetoid, &EllipsoidField::m_zRadius);
+	}
+	else if (RoundCubePLTD const* roundCube = dynamic_cast<RoundCubePLTD const*>(&planetoid))
+	{
+		out_record.m_type = LEVEL_PLANETOID_ROUND_CUBE;
+		params[0].m_float = roundCube->m_length;
+		params[1].m_float = roundCube->m_width;
+		params[2].m_float = roundCube->m_height;
+		params[3].m_float = roundCube->m_roundedness;
+		params[4].m_float = GetFieldValue(planetoid, &RoundCubeField::m_length);
+		params[5].m_float = GetFieldValue(planetoid, &RoundCubeField::m_width);
+		params[6].m_float = GetFieldValue(planetoid, &RoundCubeField::m_height);
+	}
+	else if (TorusPLTD const* torus = dynamic_cast<TorusPLTD const*>(&planetoid))
+	{
+		//the field's tube is the planetoid's tube grown by the gravity radius
+		out_record.m_type = LEVEL_PLANETOID_TORUS;
+		params[0].m_float = torus->m_tubeRadius;
+		params[1].m_float = torus->m_holeRadius;
+		params[2].m_float = out_record.m_hasField ? GetFieldValue(planetoid, &TorusField::m_tubeRadius) - torus->m_tubeRadius : 0.0f;
+	}
+	else if (BowlPLTD const* bowl = dynamic_cast<BowlPLTD const*>(&planetoid))
+	{
+		out_record.m_type = LEVEL_PLANETOID_BOWL;
+		params[0].m_float = bowl->m_radius;
+		params[1].m_float = bowl->m_thickness;
+		params[2].m_float = GetFieldValue(planetoid, &BowlField::m_height);
+	}
+	else if (MobiusPLTD const* mobius = dynamic_cast<MobiusPLTD const*>(&planetoid))
+	{
+		//mobius strips don't make a field yet, so there's no gravity height to keep
+		out_record.m_type = LEVEL_PLANETOID_MOBIUS;
+		params[0].m_float = mobius->m_radius;
+		params[1].m_float = mobius->m_halfWidth;
+		params[2].m_float = 0.0f;
+	}
+	else if (WirePLTD const* wire = dynamic_cast<WirePLTD const*>(&planetoid))
+	{
+		WirePerlinParameters const& ps = wire->m_perlinParameters;
+		out_record.m_type = LEVEL_PLANETOID_WIRE;
+		params[0].m_float = wire->m_radius;
+		params[1].m_float = GetFieldValue(planetoid, &WireField::m_radius);
+		params[2].m_int = ps.m_rngSeed;
+		params[3].m_int = ps.m_minSegments;
+		params[4].m_int = ps.m_maxSegments;
+		params[5].m_float = ps.m_segMinLength;
+		params[6].m_float = ps.m_segMaxLength;
+		params[7].m_float = ps.m_maxYawChange;
+		params[8].m_float = ps.m_maxPitchChange;
+		params[9].m_float = ps.m_perlinScaleYaw;
+		params[10].m_int = ps.m_perlinOctavesYaw;
+		params[11].m_float = ps.m_perlinOctavePersistYaw;
+		params[12].m_float = ps.m_perlinOctaveScaleYaw;
+		params[13].m_float = ps.m_perlinScalePitch;
+		params[14].m_int = ps.m_perlinOctavesPitch;
+		params[15].m_float = ps.m_perlinOctavePersistPitch;
+		params[16].m_float = ps.m_perlinOctaveScalePitch;
+	}
+	else if (TeapotPLTD const* teapot = dynamic_cast<TeapotPLTD const*>(&planetoid))
+	{
+		out_record.m_type = LEVEL_PLANETOID_TEAPOT;
+		params[0].m_float = teapot->m_scale;
+		params[1].m_float = GetFieldValue(planetoid, &SphereField::m_radius);
+	}
+	else if (SkyStationPLTD const* skyStation = dynamic_cast<SkyStationPLTD const*>(&planetoid))
+	{
+		out_record.m_type = LEVEL_PLANETOID_SKY_STATION;
+		params[0].m_float = skyStation->m_scale;
+		params[1].m_float = GetFieldValue(planetoid, &WedgeField::m_radius);
+	}
+	else if (MountainPLTD const* mountain = dynamic_cast<MountainPLTD const*>(&planetoid))
+	{
+		out_record.m_type = LEVEL_PLANETOID_MOUNTAIN;
+		params[0].m_float = mountain->m_scale;
+		params[1].m_float = GetFieldValue(planetoid, &SphereField::m_radius);
+	}
+	else if (FortressPLTD const* fortress = dynamic_cast<FortressPLTD const*>(&planetoid))
+	{
+		out_record.m_type = LEVEL_PLANETOID_FORTRESS;
+		params[0].m_float = fortress->m_scale;
+		params[1].m_float = GetFieldValue(planetoid, &PlaneField::m_height);
+	}
+	else
+	{
+		return false;
+	}
+
+	return true;
+}
+
+
+//prefabs queue their model the same way spawning them does, so a level with prefabs finishes loading in the background
+Planetoid* CreatePlanetoidFromRecord(LevelPlanetoidRecord const& record)
+{
+	LevelParam const* params = record.m_params;
+	bool hasField = record.m_hasField;
+	float force = record.m_gravityForce;
+
+	switch (record.m_type)
+	{
+		case LEVEL_PLANETOID_PLANE:
+			return new PlanePLTD(record.m_position, params[0].m_float, params[1].m_float, record.m_orientation, hasField, params[2].m_float, force, record.m_color);
+		case LEVEL_PLANETOID_SPHERE:
+			return new SpherePLTD(record.m_position, params[0].m_float, hasField, params[1].m_float, force, record.m_color);
+		case LEVEL_PLANETOID_CAPSULE:
+			return new CapsulePLTD(record.m_position, params[0].m_float, params[1].m_float, Vec3(params[2].m_float, params[3].m_float, params[4].m_float), hasField, params[5].m_float, force,
+				record.m_color);
+		case LEVEL_PLANETOID_ELLIPSOID:
+			return new EllipsoidPLTD(record.m_position, params[0].m_float, params[1].m_float, params[2].m_float, record.m_orientation, hasField, params[3].m_float, params[4].m_float,
+				params[5].m_float, force, record.m_color);
+		case LEVEL_PLANETOID_ROUND_CUBE:
+			return new RoundCubePLTD(record.m_position, params[0].m_float, params[1].m_float, params[2].m_float, params[3].m_float, record.m_orientation, hasField, params[4].m_float,
+				params[5].m_float, params[6].m_float, force, record.m_color);
+		case LEVEL_PLANETOID_TORUS:
+			return new TorusPLTD(record.m_position, params[0].m_float, params[1].m_float, record.m_orientation, hasField, params[2].m_float, force, record.m_color);
+		case LEVEL_PLANETOID_BOWL:
+			return new BowlPLTD(record.m_position, params[0].m_float, params[1].m_float, record.m_orientation, hasField, params[2].m_float, force, record.m_color);
+		case LEVEL_PLANETOID_MOBIUS:
+			return new MobiusPLTD(record.m_position, params[0].m_float, params[1].m_float, record.m_orientation, hasField, params[2].m_float, force, record.m_color);
+		case LEVEL_PLANETOID_WIRE:
+		{
+			WirePerlinParameters ps;
+			ps.m_rngSeed = params[2].m_int;
+			ps.m_minSegments = params[3].m_int;
+			ps.m_maxSegments = params[4].m_int;
+			ps.m_segMinLength = params[5].m_float;
+			ps.m_segMaxLength = params[6].m_float;
+			ps.m_maxYawChange = params[7].m_float;
+			ps.m_maxPitchChange = params[8].m_float;
+			ps.m_perlinScaleYaw = params[9].m_float;
+			ps.m_perlinOctavesYaw = params[10].m_int;
+			ps.m_perlinOctavePersistYaw = params[11].m_float;
+			ps.m_perlinOctaveScaleYaw = params[12].m_float;
+			ps.m_perlinScalePitch = params[13].m_float;
+			ps.m_perlinOctavesPitch = params[14].m_int;
+			ps.m_perlinOctavePersistPitch = params[15].m_float;
+			ps.m_perlinOctaveScalePitch = params[16].m_float;
+			return new WirePLTD(record.m_position, params[0].m_float, ps, record.m_orientation, hasField, params[1].m_float, force, record.m_color);
+		}
+		case LEVEL_PLANETOID_TEAPOT:
+			return new TeapotPLTD(record.m_position, params[0].m_float, record.m_orientation, record.m_color, hasField, params[1].m_float, force);
+		case LEVEL_PLANETOID_SKY_STATION:
+			return new SkyStationPLTD(record.m_position, params[0].m_float, record.m_orientation, record.m_color, hasField, params[1].m_float, force);
+		case LEVEL_PLANETOID_MOUNTAIN:
+			return new MountainPLTD(record.m_position, params[0].m_float, record.m_orientation, record.m_color, hasField, params[1].m_float, force);
+		case LEVEL_PLANETOID_FORTRESS:
+			return new FortressPLTD(record.m_position, params[0].m_float, record.m_orientation, record.m_color, hasField, params[1].m_float, force);
+		default:
+			return nullptr;
+	}
+}
+
+
+//
+//level file functions
+//
+bool IsReadableLevelFile(std::string const& filePath)
+{
+	size_t extensionLength = strlen(LEVEL_FILE_READABLE_EXTENSION);
+	return filePath.size() >= extensionLength && filePath.compare(filePath.size() - extensionLength, extensionLength, LEVEL_FILE_READABLE_EXTENSION) == 0;
+}
+
+
+bool WriteLevelDescription(LevelDescription const& level, std::string const& filePath)
+{
+	//Data/Levels isn't there until the first level is saved
+	std::filesystem::path folderPath = std::filesystem::path(filePath).parent_path();
+	if (!folderPath.empty())
+	{
+		std::error_code errorCode;
+		std::filesystem::create_directories(folderPath, errorCode);
+	}
+
+	return IsReadableLevelFile(filePath) ? WriteReadableLevelFile(level, filePath) : WriteBinaryLevelFile(level, filePath);
+}
+
+
+bool ReadLevelDescription(LevelDescription& out_level, std::string const& filePath)
+{
+	return IsReadableLevelFile(filePath) ? ReadReadableLevelFile(out_level, filePath) : ReadBinaryLevelFile(out_level, filePath);
+}
+
+
+void AppendLevelDescriptionBytes(std::vector<uint8_t>& buffer, LevelDescription const& level)
+{
+	AppendBinaryLevel(buffer, level);
+}
+
+
+bool ReadLevelDescriptionBytes(LevelDescription& out_level, uint8_t const* bytes, size_t numBytes)
+{
+	std::istringstream stream(std::string(reinterpret_cast<char const*>(bytes), numBytes), std::ios::binary);
+	return ReadBinaryLevel(out_level, stream);
+}
+
+
+void MakeLevelDescription(PlaytestCourse const& level, LevelDescription& out_description)
+{
+	out_description.m_planetoids.reserve(out_description.m_planetoids.size() + level.m_planetoids.size());
+	for (int pltdIndex = 0; pltdIndex < level.m_planetoids.size(); pltdIndex++)
+	{
+		LevelPlanetoidRecord record;
+		if (level.m_planetoids[pltdIndex] != nullptr && MakeLevelPlanetoidRecord(*level.m_planetoids[pltdIndex], record))
+		{
+			out_description.m_planetoids.emplace_back(record);
+		}
+	}
+	out_description.m_checkpoints.insert(out_description.m_checkpoints.end(), level.m_checkpoints.begin(), level.m_checkpoints.end());
+	out_description.m_signs.insert(out_description.m_signs.end(), level.m_signs.begin(), level.m_signs.end());
+}
+
+
+void CreateLevelFromDescription(LevelDescription const& description, PlaytestCourse& out_level)
+{
+	out_level.m_planetoids.reserve(out_level.m_planetoids.size() + description.m_planetoids.size());
+	for (int recordIndex = 0; recordIndex < description.m_planetoids.size(); recordIndex++)
+	{
+		Planetoid* planetoid = CreatePlanetoidFromRecord(description.m_planetoids[recordIndex]);
+		if (planetoid != nullptr)
+		{
+			planetoid->UpdateWorldBounds();
+			out_level.m_planetoids.emplace_back(planetoid);
+		}
+	}
+	out_level.m_checkpoints.insert(out_level.m_checkpoints.end(), description.m_checkpoints.begin(), description.m_checkpoints.end());
+	out_level.m_signs.insert(out_level.m_signs.end(), description.m_signs.begin(), description.m_signs.end());
+}
+
+
+bool WriteLevelFile(PlaytestCourse const& level, std::string const& filePath)
+{
+	LevelDescription description;
+	MakeLevelDescription(level, description);
+	return WriteLevelDescription(description, filePath);
+}
+
+
+bool ReadLevelFile(PlaytestCourse& out_level, std::string const& filePath)
+{
+	LevelDescription description;
+	if (!ReadLevelDescription(description, filePath))
+	{
+		return false;
+	}
+
+	CreateLevelFromDescription(description, out_level);
+	return true;
+}
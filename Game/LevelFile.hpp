@@ -0,0 +1,97 @@
+#pragma once
+#include "Game/GravityFields.hpp"
+#include "Game/PlaytestCourse.hpp"
+#include "Engine/Math/Vec3.hpp"
+#include "Engine/Math/EulerAngles.hpp"
+#include "Engine/Math/AABB3.hpp"
+#include "Engine/Core/Rgba8.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+//forward declarations
+class Planetoid;
+
+
+//constants
+constexpr unsigned int LEVEL_FILE_VERSION = 1;
+constexpr char const*  LEVEL_FILE_BINARY_EXTENSION = ".gflevel";
+constexpr char const*  LEVEL_FILE_READABLE_EXTENSION = ".xml";
+constexpr int		   LEVEL_MAX_PLANETOID_PARAMS = 17;
+
+
+//one per planetoid class the file can hold, the numbers are written to disk so new types only go on the end
+enum LevelPlanetoidType : uint8_t
+{
+	LEVEL_PLANETOID_PLANE,
+	LEVEL_PLANETOID_SPHERE,
+	LEVEL_PLANETOID_CAPSULE,
+	LEVEL_PLANETOID_ELLIPSOID,
+	LEVEL_PLANETOID_ROUND_CUBE,
+	LEVEL_PLANETOID_TORUS,
+	LEVEL_PLANETOID_BOWL,
+	LEVEL_PLANETOID_MOBIUS,
+	LEVEL_PLANETOID_WIRE,
+	LEVEL_PLANETOID_TEAPOT,
+	LEVEL_PLANETOID_SKY_STATION,
+	LEVEL_PLANETOID_MOUNTAIN,
+	LEVEL_PLANETOID_FORTRESS,
+	NUM_LEVEL_PLANETOID_TYPES
+};
+
+
+union LevelParam
+{
+	float m_float;
+	int	  m_int;
+};
+
+
+//everything needed to construct one planetoid again, what m_params means depends on m_type
+//a few dozen bytes, so a whole level of them can stay in memory while the planetoids themselves come and go
+struct LevelPlanetoidRecord
+{
+	LevelPlanetoidType m_type = LEVEL_PLANETOID_SPHERE;
+	bool			   m_hasField = false;
+	Vec3			   m_position;
+	EulerAngles		   m_orientation;
+	Rgba8			   m_color;
+	float			   m_gravityForce = GRAVITY_STANDARD;
+	LevelParam		   m_params[LEVEL_MAX_PLANETOID_PARAMS] = {};
+};
+
+
+//a level as records, nothing in it is built yet
+struct LevelDescription
+{
+	std::vector<LevelPlanetoidRecord> m_planetoids;
+	std::vector<AABB3>				  m_checkpoints;
+	std::vector<CourseSign>			  m_signs;
+};
+
+
+//level record functions, making a record fails for planetoid classes the file has no type for
+//prefab records acquire a model asset, so those can only be created on the main thread
+bool	   MakeLevelPlanetoidRecord(Planetoid const& planetoid, LevelPlanetoidRecord& out_record);
+Planetoid* CreatePlanetoidFromRecord(LevelPlanetoidRecord const& record);
+
+
+//a level is the same planetoids, checkpoints and signs the playtest course is made of
+//paths ending in .xml are the readable variant meant for hand editing, anything else is the compact binary one
+bool IsReadableLevelFile(std::string const& filePath);
+
+//file functions, reading appends to out_level and leaves it untouched on a missing, different version or truncated file
+//the binary reader streams planetoid records a chunk at a time, so a big file is never in memory all at once
+bool WriteLevelDescription(LevelDescription const& level, std::string const& filePath);
+bool ReadLevelDescription(LevelDescription& out_level, std::string const& filePath);
+bool WriteLevelFile(PlaytestCourse const& level, std::string const& filePath);
+bool ReadLevelFile(PlaytestCourse& out_level, std::string const& filePath);
+
+//the binary variant in memory, so a level can be carried inside another file
+void AppendLevelDescriptionBytes(std::vector<uint8_t>& buffer, LevelDescription const& level);
+bool ReadLevelDescriptionBytes(LevelDescription& out_level, uint8_t const* bytes, size_t numBytes);
+
+//conversions between a level's records and its planetoids, prefabs among them can only be created on the main thread
+void MakeLevelDescription(PlaytestCourse const& level, LevelDescription& out_description);
+void CreateLevelFromDescription(LevelDescription const& description, PlaytestCourse& out_level);
@@ -0,0 +1,424 @@
+#if defined(GAME_HEADLESS)
+#include "Game/Simulation.hpp"
+#include "Game/Player.hpp"
+#include "Game/Planetoids.hpp"
+#include "Game/PlaytestCourse.hpp"
+#include "Game/LevelFile.hpp"
+#include "Game/InputRecording.hpp"
+#include "Game/JobSystem.hpp"
+#include "Game/MeshUploader.hpp"
+#include "Game/MeshIndexing.hpp"
+#include "Game/ModelAsset.hpp"
+#include "Game/ModelMeshCache.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+//-----------------------------------------------------------------------------------------------
+//every allocation in the process goes through here, so a run can count the ones the simulation makes
+static std::atomic<long long> s_numAllocations{0};
+
+void* operator new(size_t numBytes)
+{
+	s_numAllocations++;
+	void* memory = malloc(numBytes > 0 ? numBytes : 1);
+	if (memory == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+	return memory;
+}
+
+void* operator new[](size_t numBytes)
+{
+	return operator new(numBytes);
+}
+
+void operator delete(void* memory) noexcept
+{
+	free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+	free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+	free(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept
+{
+	free(memory);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+//per tick samples of one run, turned into percentiles once the run is done
+struct BenchmarkRun
+{
+	std::string			m_name;
+	std::vector<double> m_stepSeconds;
+	std::vector<double> m_playerTickSeconds;
+	std::vector<double> m_applyGravitySeconds;
+	std::vector<double> m_collisionSeconds;
+	long long			m_numAllocations = 0;
+	long long			m_maxAllocationsPerTick = 0;
+	double				m_totalSeconds = 0.0;
+	unsigned int		m_finalChecksum = 0;
+	int					m_firstDivergentTick = -1;	//replays only
+};
+
+
+//scripted input for a section: run forward, weave left and right, jump twice a second, and long jump every four seconds
+static PlayerCommand GetScriptedCommand(int tickIndex, float tickSeconds)
+{
+	int ticksPerSecond = static_cast<int>(1.0f / tickSeconds + 0.5f);
+	int tickInSecond = tickIndex % ticksPerSecond;
+
+	PlayerCommand command;
+	command.m_movementIntentions = Vec3(1.0f, 0.0f, 0.0f);
+	command.m_yawIntentions = ((tickIndex / (ticksPerSecond * 2)) % 2 == 0) ? 0.2f : -0.2f;
+	command.m_jumpPressed = tickInSecond == 0 || tickInSecond == ticksPerSecond / 2;
+
+	bool isLongJumpSecond = (tickIndex / ticksPerSecond) % 4 == 3;
+	command.m_isCrouchHeld = isLongJumpSecond && tickInSecond < ticksPerSecond / 2;
+	return command;
+}
+
+
+//a replay of a game recording also steps the course triggers after each tick like the game does, so entering the course or touching a checkpoint replays the same
+static void RunTicks(Simulation& simulation, Player& player, BenchmarkRun& run, int numTicks, float tickSeconds, InputRecording const* recording,
+	std::vector<AABB3> const& checkpoints)
+{
+	PlaytestProgress progress;
+	if (recording != nullptr)
+	{
+		progress.m_inPlaytestCourse = recording->m_inPlaytestCourse;
+		progress.m_checkpointIndex = (recording->m_checkpointIndex >= 0 && recording->m_checkpointIndex < checkpoints.size()) ? recording->m_checkpointIndex : -1;
+	}
+
+	run.m_stepSeconds.reserve(numTicks);
+	run.m_playerTickSeconds.reserve(numTicks);
+	run.m_applyGravitySeconds.reserve(numTicks);
+	run.m_collisionSeconds.reserve(numTicks);
+
+	std::chrono::steady_clock::time_point runStartTime = std::chrono::steady_clock::now();
+	for (int tickIndex = 0; tickIndex < numTicks; tickIndex++)
+	{
+		PlayerCommand command = (recording != nullptr) ? recording->m_commands[tickIndex] : GetScriptedCommand(tickIndex, tickSeconds);
+
+		long long allocationsBefore = s_numAllocations.load();
+		std::chrono::steady_clock::time_point stepStartTime = std::chrono::steady_clock::now();
+		simulation.StepPlayer(tickSeconds, command);
+		double stepSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - stepStartTime).count();
+		long long tickAllocations = s_numAllocations.load() - allocationsBefore;
+
+		SimulationPhaseTimes const& phaseTimes = simulation.GetLastPhaseTimes();
+		run.m_stepSeconds.emplace_back(stepSeconds);
+		run.m_playerTickSeconds.emplace_back(phaseTimes.m_playerTickSeconds);
+		run.m_applyGravitySeconds.emplace_back(phaseTimes.m_applyGravitySeconds);
+		run.m_collisionSeconds.emplace_back(phaseTimes.m_collisionSeconds);
+		run.m_numAllocations += tickAllocations;
+		run.m_maxAllocationsPerTick = std::max(run.m_maxAllocationsPerTick, tickAllocations);
+
+		//kept out of the step timing, the game runs it outside Simulation::StepPlayer too
+		if (recording != nullptr && recording->m_isSteppingPlaytestTriggers)
+		{
+			StepPlaytestTriggers(player, checkpoints, progress);
+		}
+
+		if (recording != nullptr && run.m_firstDivergentTick < 0 && GetPlayerStateChecksum(player) != recording->m_checksums[tickIndex])
+		{
+			run.m_firstDivergentTick = tickIndex;
+		}
+	}
+	run.m_totalSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - runStartTime).count();
+	run.m_finalChecksum = GetPlayerStateChecksum(player);
+}
+
+
+static double GetPercentile(std::vector<double> const& sortedSamples, double percentile)
+{
+	if (sortedSamples.empty())
+	{
+		return 0.0;
+	}
+
+	size_t sampleIndex = static_cast<size_t>(percentile * static_cast<double>(sortedSamples.size() - 1) + 0.5);
+	return sortedSamples[sampleIndex];
+}
+
+
+static void WritePhaseJson(FILE* file, char const* phaseName, std::vector<double> samples, bool isLastPhase)
+{
+	double totalSeconds = 0.0;
+	for (size_t sampleIndex = 0; sampleIndex < samples.size(); sampleIndex++)
+	{
+		totalSeconds += samples[sampleIndex];
+	}
+	double meanSeconds = samples.empty() ? 0.0 : totalSeconds / static_cast<double>(samples.size());
+	std::sort(samples.begin(), samples.end());
+
+	fprintf(file, "        \"%s\": { \"meanUs\": %.3f, \"p50Us\": %.3f, \"p90Us\": %.3f, \"p99Us\": %.3f, \"maxUs\": %.3f }%s\n", phaseName, meanSeconds * 1e6,
+		GetPercentile(samples, 0.5) * 1e6, GetPercentile(samples, 0.9) * 1e6, GetPercentile(samples, 0.99) * 1e6, samples.empty() ? 0.0 : samples.back() * 1e6,
+		isLastPhase ? "" : ",");
+}
+
+
+static void WriteMeshStatsJson(FILE* file, std::vector<Planetoid*> const& planetoids, MeshUploader const& meshUploader)
+{
+	//every index was one triangle list vertex before welding
+	size_t numVertexes = 0;
+	size_t numIndexes = 0;
+	double weightedCacheMissRatio = 0.0;
+	for (int pltdIndex = 0; pltdIndex < planetoids.size(); pltdIndex++)
+	{
+		Planetoid const* planetoid = planetoids[pltdIndex];
+		if (planetoid == nullptr)
+		{
+			continue;
+		}
+
+		numVertexes += planetoid->m_verts.size();
+		numIndexes += planetoid->m_indexes.size();
+		weightedCacheMissRatio += static_cast<double>(GetAverageCacheMissRatio(planetoid->m_indexes)) * static_cast<double>(planetoid->m_indexes.size());
+	}
+
+	fprintf(file, "  \"meshVertexes\": %zu,\n", numVertexes);
+	fprintf(file, "  \"meshIndexes\": %zu,\n", numIndexes);
+	fprintf(file, "  \"meshAverageCacheMissRatio\": %.3f,\n", numIndexes > 0 ? weightedCacheMissRatio / static_cast<double>(numIndexes) : 0.0);
+	fprintf(file, "  \"staticMeshes\": %i,\n", meshUploader.m_numMeshesCreated);
+	fprintf(file, "  \"sharedMeshHits\": %i,\n", meshUploader.m_numSharedMeshHits);
+	fprintf(file, "  \"staticMeshBytes\": %zu,\n", meshUploader.m_numBytesUploaded);
+}
+
+
+static void WriteResultsJson(FILE* file, std::vector<BenchmarkRun> const& runs, float tickSeconds, std::vector<Planetoid*> const& planetoids, MeshUploader const& meshUploader, bool useGravityFieldStore,
+	double courseLoadSeconds, double courseReadySeconds)
+{
+	ModelMeshCacheStats meshCacheStats = GetModelMeshCacheStats();
+	ModelAssetStats modelAssetStats = GetModelAssetStats();
+
+	fprintf(file, "{\n");
+	fprintf(file, "  \"benchmark\": \"playtest_course\",\n");
+	fprintf(file, "  \"tickSeconds\": %.9f,\n", tickSeconds);
+	fprintf(file, "  \"planetoids\": %i,\n", GetNumPlanetoids(planetoids));
+	fprintf(file, "  \"courseLoadMs\": %.3f,\n", courseLoadSeconds * 1000.0);
+	fprintf(file, "  \"courseReadyMs\": %.3f,\n", courseReadySeconds * 1000.0);
+	fprintf(file, "  \"modelMeshCache\": %s,\n", IsModelMeshCacheEnabled() ? "true" : "false");
+	fprintf(file, "  \"modelMeshCacheHits\": %i,\n", meshCacheStats.m_numHits);
+	fprintf(file, "  \"modelMeshCacheMisses\": %i,\n", meshCacheStats.m_numMisses);
+	fprintf(file, "  \"modelAssets\": %i,\n", modelAssetStats.m_numAssets);
+	fprintf(file, "  \"modelAssetHits\": %i,\n", modelAssetStats.m_numHits);
+	WriteMeshStatsJson(file, planetoids, meshUploader);
+	fprintf(file, "  \"gravityFieldStore\": %s,\n", useGravityFieldStore ? "true" : "false");
+	fprintf(file, "  \"runs\": [\n");
+	for (size_t runIndex = 0; runIndex < runs.size(); runIndex++)
+	{
+		BenchmarkRun const& run = runs[runIndex];
+		int numTicks = static_cast<int>(run.m_stepSeconds.size());
+		fprintf(file, "    {\n");
+		fprintf(file, "      \"name\": \"%s\",\n", run.m_name.c_str());
+		fprintf(file, "      \"ticks\": %i,\n", numTicks);
+		fprintf(file, "      \"seconds\": %.6f,\n", run.m_totalSeconds);
+		fprintf(file, "      \"ticksPerSecond\": %.1f,\n", run.m_totalSeconds > 0.0 ? static_cast<double>(numTicks) / run.m_totalSeconds : 0.0);
+		fprintf(file, "      \"allocations\": %lld,\n", run.m_numAllocations);
+		fprintf(file, "      \"allocationsPerTick\": %.3f,\n", numTicks > 0 ? static_cast<double>(run.m_numAllocations) / static_cast<double>(numTicks) : 0.0);
+		fprintf(file, "      \"maxAllocationsPerTick\": %lld,\n", run.m_maxAllocationsPerTick);
+		fprintf(file, "      \"finalChecksum\": %u,\n", run.m_finalChecksum);
+		fprintf(file, "      \"firstDivergentTick\": %i,\n", run.m_firstDivergentTick);
+		fprintf(file, "      \"phases\": {\n");
+		WritePhaseJson(file, "StepPlayer", run.m_stepSeconds, false);
+		WritePhaseJson(file, "UpdateTick", run.m_playerTickSeconds, false);
+		WritePhaseJson(file, "ApplyGravity", run.m_applyGravitySeconds, false);
+		WritePhaseJson(file, "CollidePlayerWithAllPlanetoids", run.m_collisionSeconds, true);
+		fprintf(file, "      }\n");
+		fprintf(file, "    }%s\n", (runIndex + 1 < runs.size()) ? "," : "");
+	}
+	fprintf(file, "  ]\n");
+	fprintf(file, "}\n");
+}
+
+
+//-----------------------------------------------------------------------------------------------
+//loads the playtest course with no renderer and times the player's physics through each of its sections
+//usage: GravitySimBenchmark [--ticks 2400] [--replay file.gfir] [--store] [--no-mesh-cache] [--async-models] [--level file.gflevel] [--out results.json]
+//each section starts the player at rest on its checkpoint and feeds the same scripted input, a replay also runs the recording from its own start
+//--async-models loads prefabs on a job system the way the game does, courseLoadMs is then how long building the course blocks and courseReadyMs when the models are in
+//--level runs a saved level's checkpoints instead of the playtest course's, courseLoadMs is then the level file's load time
+//a replay recorded on some other scene runs on the scene saved in the recording instead, courseLoadMs is then how long rebuilding it took
+int main(int argc, char* argv[])
+{
+	int numTicksPerSection = 2400;
+	char const* replayPath = nullptr;
+	char const* outputPath = nullptr;
+	bool useGravityFieldStore = false;
+	bool loadModelsInBackground = false;
+	char const* levelPath = nullptr;
+	for (int argIndex = 1; argIndex < argc; argIndex++)
+	{
+		bool hasValue = argIndex + 1 < argc;
+		if (strcmp(argv[argIndex], "--ticks") == 0 && hasValue)		  numTicksPerSection = atoi(argv[++argIndex]);
+		else if (strcmp(argv[argIndex], "--replay") == 0 && hasValue) replayPath = argv[++argIndex];
+		else if (strcmp(argv[argIndex], "--out") == 0 && hasValue)	  outputPath = argv[++argIndex];
+		else if (strcmp(argv[argIndex], "--store") == 0)			  useGravityFieldStore = true;
+		else if (strcmp(argv[argIndex], "--no-mesh-cache") == 0)	  SetModelMeshCacheEnabled(false);
+		else if (strcmp(argv[argIndex], "--async-models") == 0)	  loadModelsInBackground = true;
+		else if (strcmp(argv[argIndex], "--level") == 0 && hasValue)  levelPath = argv[++argIndex];
+		else
+		{
+			fprintf(stderr, "usage: GravitySimBenchmark [--ticks 2400] [--replay file.gfir] [--store] [--no-mesh-cache] [--async-models] [--level file.gflevel] [--out results.json]\n");
+			return 1;
+		}
+	}
+
+	InputRecording recording;
+	if (replayPath != nullptr && !ReadInputRecording(recording, replayPath))
+	{
+		fprintf(stderr, "could not read input recording %s\n", replayPath);
+		return 1;
+	}
+
+	JobSystem* loadJobSystem = nullptr;
+	if (loadModelsInBackground)
+	{
+		loadJobSystem = new JobSystem(JobSystemConfig());
+		loadJobSystem->Startup();
+		SetModelAssetJobSystem(loadJobSystem);
+	}
+
+	//prefab models load from their obj or their binary mesh cache here, which is most of startup
+	std::chrono::steady_clock::time_point courseLoadStartTime = std::chrono::steady_clock::now();
+	PlaytestCourse course;
+	if (levelPath == nullptr)
+	{
+		LoadPlaytestCourse(course);
+	}
+	else if (!ReadLevelFile(course, levelPath))
+	{
+		fprintf(stderr, "could not read level %s\n", levelPath);
+		return 1;
+	}
+	double courseLoadSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - courseLoadStartTime).count();
+
+	//prefab bounds are only a point until their model is in, the simulation needs the real ones
+	WaitForModelAssetLoads();
+	for (int pltdIndex = 0; pltdIndex < course.m_planetoids.size(); pltdIndex++)
+	{
+		course.m_planetoids[pltdIndex]->UpdateWorldBounds();
+	}
+	double courseReadySeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - courseLoadStartTime).count();
+
+	SetModelAssetJobSystem(nullptr);
+	if (loadJobSystem != nullptr)
+	{
+		loadJobSystem->Shutdown();
+		delete loadJobSystem;
+	}
+
+	//a recording made somewhere else brings its scene along, which replaces the course so the sections and the replay both run on it
+	if (replayPath != nullptr && (recording.m_numPlanetoids != GetNumPlanetoids(course.m_planetoids) || recording.m_sceneChecksum != GetSceneChecksum(course.m_planetoids)))
+	{
+		fprintf(stderr, "%s was not recorded on %s, running on the scene saved with it\n", replayPath, (levelPath != nullptr) ? levelPath : "the playtest course");
+		for (int pltdIndex = 0; pltdIndex < course.m_planetoids.size(); pltdIndex++)
+		{
+			delete course.m_planetoids[pltdIndex];
+		}
+		course = PlaytestCourse();
+
+		courseLoadStartTime = std::chrono::steady_clock::now();
+		CreateLevelFromDescription(recording.m_scene, course);
+		courseLoadSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - courseLoadStartTime).count();
+		WaitForModelAssetLoads();
+		for (int pltdIndex = 0; pltdIndex < course.m_planetoids.size(); pltdIndex++)
+		{
+			course.m_planetoids[pltdIndex]->UpdateWorldBounds();
+		}
+		courseReadySeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - courseLoadStartTime).count();
+
+		if (recording.m_numPlanetoids != GetNumPlanetoids(course.m_planetoids) || recording.m_sceneChecksum != GetSceneChecksum(course.m_planetoids))
+		{
+			fprintf(stderr, "the scene saved with %s did not rebuild the same as when it was recorded\n", replayPath);
+			return 1;
+		}
+	}
+
+	//the game uploads every distinct planetoid mesh once at spawn, count what that would cost
+	NullMeshUploader meshUploader;
+	for (int pltdIndex = 0; pltdIndex < course.m_planetoids.size(); pltdIndex++)
+	{
+		course.m_planetoids[pltdIndex]->CreateGPUMesh(meshUploader);
+	}
+
+	Player* player = new Player(nullptr);
+	SimulationConfig simulationConfig;
+	simulationConfig.m_planetoids = &course.m_planetoids;
+	simulationConfig.m_player = player;
+	Simulation* simulation = new Simulation(simulationConfig);
+	simulation->m_useGravityFieldStore = useGravityFieldStore;
+	simulation->m_isTimingPhases = true;
+
+	//the first step builds both bvhs, keep that out of the first section's numbers
+	float tickSeconds = 1.0f / 120.0f;
+	simulation->StepPlayer(tickSeconds, PlayerCommand());
+
+	std::vector<BenchmarkRun> runs;
+	runs.reserve(course.m_checkpoints.size() + 1);
+	for (int sectionIndex = 0; sectionIndex < course.m_checkpoints.size(); sectionIndex++)
+	{
+		PlayerSnapshot sectionStart;
+		sectionStart.m_position = course.m_checkpoints[sectionIndex].GetCenter();
+		sectionStart.m_respawnPosition = sectionStart.m_position;
+		RestorePlayerSnapshot(*player, sectionStart);
+
+		runs.emplace_back(BenchmarkRun());
+		runs.back().m_name = "section" + std::to_string(sectionIndex + 1);
+		RunTicks(*simulation, *player, runs.back(), numTicksPerSection, tickSeconds, nullptr, course.m_checkpoints);
+	}
+
+	if (replayPath != nullptr)
+	{
+		RestorePlayerSnapshot(*player, recording.m_playerStart);
+
+		runs.emplace_back(BenchmarkRun());
+		runs.back().m_name = "replay";
+		RunTicks(*simulation, *player, runs.back(), static_cast<int>(recording.m_commands.size()), recording.m_tickSeconds, &recording, course.m_checkpoints);
+	}
+
+	FILE* outputFile = stdout;
+	if (outputPath != nullptr)
+	{
+		outputFile = fopen(outputPath, "w");
+		if (outputFile == nullptr)
+		{
+			fprintf(stderr, "could not open %s\n", outputPath);
+			return 1;
+		}
+	}
+
+	WriteResultsJson(outputFile, runs, tickSeconds, course.m_planetoids, meshUploader, useGravityFieldStore, courseLoadSeconds, courseReadySeconds);
+	if (outputFile != stdout)
+	{
+		fclose(outputFile);
+	}
+
+	delete simulation;
+	delete player;
+	for (int pltdIndex = 0; pltdIndex < course.m_planetoids.size(); pltdIndex++)
+	{
+		delete course.m_planetoids[pltdIndex];
+	}
+
+	//a replay that drifted from its recording fails the run, so scripts comparing commits notice
+	bool didReplayDiverge = replayPath != nullptr && runs.back().m_firstDivergentTick >= 0;
+	return didReplayDiverge ? 2 : 0;
+}
+#endif
@@ -0,0 +1,232 @@
+#if defined(GAME_HEADLESS)
+#include "Game/GravityFieldKernels.hpp"
+#include "Game/GravityFieldStore.hpp"
+#include "Game/GravityFields.hpp"
+#include "Game/Planetoids.hpp"
+#include "Game/Player.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+//constants
+constexpr float FIELD_CHECK_COLLISION_RADIUS = 0.5f;
+constexpr float FIELD_CHECK_MAX_RELATIVE_ERROR = 0.0001f;	//the store divides by the distance where the fields normalize then scale, so only the kernels are held to bit for bit
+
+
+//-----------------------------------------------------------------------------------------------
+//the batch kernels against their scalar versions, every mask and every gravity vector has to match bit for bit
+static int CheckKernelsAgainstScalar(RandomNumberGenerator& rng, int numFields, int numQueries)
+{
+	float worldHalfSize = 250.0f * cbrtf(static_cast<float>(numFields) / 100.0f);
+
+	SphereFieldBuffers spheres;
+	CapsuleFieldBuffers capsules;
+	for (int fieldIndex = 0; fieldIndex < numFields; fieldIndex++)
+	{
+		Vec3 center = Vec3(rng.RollRandomFloatInRange(-worldHalfSize, worldHalfSize), rng.RollRandomFloatInRange(-worldHalfSize, worldHalfSize),
+			rng.RollRandomFloatInRange(-worldHalfSize, worldHalfSize));
+		Vec3 boneEnd = center + Vec3(rng.RollRandomFloatInRange(-10.0f, 10.0f), rng.RollRandomFloatInRange(-10.0f, 10.0f), rng.RollRandomFloatInRange(-10.0f, 10.0f));
+		float radius = rng.RollRandomFloatInRange(8.0f, 35.0f);
+
+		spheres.m_centerX.emplace_back(center.x);
+		spheres.m_centerY.emplace_back(center.y);
+		spheres.m_centerZ.emplace_back(center.z);
+		spheres.m_radius.emplace_back(radius);
+		spheres.m_force.emplace_back(GRAVITY_STANDARD);
+		spheres.m_fieldIndex.emplace_back(fieldIndex);
+
+		capsules.m_startX.emplace_back(center.x);
+		capsules.m_startY.emplace_back(center.y);
+		capsules.m_startZ.emplace_back(center.z);
+		capsules.m_endX.emplace_back(boneEnd.x);
+		capsules.m_endY.emplace_back(boneEnd.y);
+		capsules.m_endZ.emplace_back(boneEnd.z);
+		capsules.m_radius.emplace_back(radius);
+		capsules.m_force.emplace_back(GRAVITY_STANDARD);
+		capsules.m_fieldIndex.emplace_back(fieldIndex);
+	}
+
+	int numOverlaps = 0;
+	int numMismatches = 0;
+	for (int queryIndex = 0; queryIndex < numQueries; queryIndex++)
+	{
+		Vec3 position = Vec3(rng.RollRandomFloatInRange(-worldHalfSize, worldHalfSize), rng.RollRandomFloatInRange(-worldHalfSize, worldHalfSize),
+			rng.RollRandomFloatInRange(-worldHalfSize, worldHalfSize));
+
+		for (int firstField = 0; firstField < numFields; firstField += GRAVITY_KERNEL_BATCH_WIDTH)
+		{
+			for (int fieldType = 0; fieldType < 2; fieldType++)
+			{
+				Vec3 scalarVectors[GRAVITY_KERNEL_BATCH_WIDTH];
+				Vec3 batchVectors[GRAVITY_KERNEL_BATCH_WIDTH];
+				int scalarMask = 0;
+				int batchMask = 0;
+				if (fieldType == 0)
+				{
+					scalarMask = EvaluateSphereFieldBatchScalar(spheres, firstField, position, FIELD_CHECK_COLLISION_RADIUS, scalarVectors);
+					batchMask = EvaluateSphereFieldBatch(spheres, firstField, position, FIELD_CHECK_COLLISION_RADIUS, batchVectors);
+				}
+				else
+				{
+					scalarMask = EvaluateCapsuleFieldBatchScalar(capsules, firstField, position, FIELD_CHECK_COLLISION_RADIUS, scalarVectors);
+					batchMask = EvaluateCapsuleFieldBatch(capsules, firstField, position, FIELD_CHECK_COLLISION_RADIUS, batchVectors);
+				}
+
+				if (scalarMask != batchMask)
+				{
+					numMismatches++;
+					continue;
+				}
+
+				for (int laneIndex = 0; laneIndex < GRAVITY_KERNEL_BATCH_WIDTH; laneIndex++)
+				{
+					if ((scalarMask & (1 << laneIndex)) == 0)
+					{
+						continue;
+					}
+
+					numOverlaps++;
+					if (memcmp(&scalarVectors[laneIndex], &batchVectors[laneIndex], sizeof(Vec3)) != 0)
+					{
+						numMismatches++;
+					}
+				}
+			}
+		}
+	}
+
+	printf("kernels (%s): %i overlaps checked, %i differ from the scalar kernels\n", GRAVITY_KERNELS_USE_SSE ? "sse" : "scalar fallback", numOverlaps, numMismatches);
+	return numMismatches;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static float GetRelativeError(Vec3 const& expected, Vec3 const& actual)
+{
+	return GetDistance3D(expected, actual) / ((expected.GetLength() > 1.0f) ? expected.GetLength() : 1.0f);
+}
+
+
+//the field store against each field's own virtual ApplyGravity, run in spawn order the way Simulation used to
+//the chosen source has to be the same field, and its center and vector have to agree to within rounding
+static int CheckStoreAgainstFields(RandomNumberGenerator& rng, int numPlanetoids, int numQueries)
+{
+	float worldHalfSize = 120.0f * cbrtf(static_cast<float>(numPlanetoids) / 100.0f);
+
+	//every field type the store has a loop for, spawned close enough together that fields overlap
+	std::vector<Planetoid*> planetoids;
+	planetoids.reserve(numPlanetoids);
+	for (int pltdIndex = 0; pltdIndex < numPlanetoids; pltdIndex++)
+	{
+		Vec3 position = Vec3(rng.RollRandomFloatInRange(-worldHalfSize, worldHalfSize), rng.RollRandomFloatInRange(-worldHalfSize, worldHalfSize),
+			rng.RollRandomFloatInRange(-worldHalfSize, worldHalfSize));
+		EulerAngles orientation = EulerAngles(rng.RollRandomFloatInRange(0.0f, 360.0f), rng.RollRandomFloatInRange(-90.0f, 90.0f), rng.RollRandomFloatInRange(0.0f, 360.0f));
+		float size = rng.RollRandomFloatInRange(3.0f, 12.0f);
+		float gravityExtra = rng.RollRandomFloatInRange(4.0f, 12.0f);
+
+		Planetoid* planetoid = nullptr;
+		switch (pltdIndex % 6)
+		{
+			case 0:	 planetoid = new SpherePLTD(position, size, true, size + gravityExtra); break;
+			case 1:	 planetoid = new CapsulePLTD(position, size * 0.5f, size, orientation.GetAsMatrix_XFwd_YLeft_ZUp().GetIBasis3D(), true, size * 0.5f + gravityExtra); break;
+			case 2:	 planetoid = new PlanePLTD(position, size * 2.0f, size * 2.0f, orientation, true, gravityExtra); break;
+			case 3:	 planetoid = new EllipsoidPLTD(position, size, size * 0.5f, size * 0.75f, orientation, true, size + gravityExtra, size * 0.5f + gravityExtra, size * 0.75f + gravityExtra); break;
+			case 4:	 planetoid = new RoundCubePLTD(position, size, size, size, 0.3f, orientation, true, size + gravityExtra, size + gravityExtra, size + gravityExtra); break;
+			default: planetoid = new TorusPLTD(position, size * 0.25f, size * 0.5f, orientation, true, size * 0.25f + gravityExtra); break;
+		}
+		planetoids.emplace_back(planetoid);
+	}
+
+	GravityFieldStore store;
+	store.Build(planetoids);
+
+	Player fieldPlayer = Player(nullptr);
+	Player storePlayer = Player(nullptr);
+	fieldPlayer.m_collisionRadius = FIELD_CHECK_COLLISION_RADIUS;
+	storePlayer.m_collisionRadius = FIELD_CHECK_COLLISION_RADIUS;
+
+	int numSourced = 0;
+	int numBitIdentical = 0;
+	int numMismatches = 0;
+	float maxRelativeError = 0.0f;
+	for (int queryIndex = 0; queryIndex < numQueries; queryIndex++)
+	{
+		//queries start near a planetoid so most of them land in at least one field
+		Vec3 position = planetoids[rng.RollRandomIntInRange(0, numPlanetoids - 1)]->m_position + Vec3(rng.RollRandomFloatInRange(-20.0f, 20.0f),
+			rng.RollRandomFloatInRange(-20.0f, 20.0f), rng.RollRandomFloatInRange(-20.0f, 20.0f));
+
+		fieldPlayer.m_position = position;
+		fieldPlayer.m_currentGravitySource = nullptr;
+		for (int pltdIndex = 0; pltdIndex < numPlanetoids; pltdIndex++)
+		{
+			planetoids[pltdIndex]->m_field->ApplyGravity(&fieldPlayer);
+		}
+
+		storePlayer.m_position = position;
+		storePlayer.m_currentGravitySource = nullptr;
+		store.ApplyGravity(&storePlayer);
+
+		if (fieldPlayer.m_currentGravitySource != storePlayer.m_currentGravitySource)
+		{
+			numMismatches++;
+			continue;
+		}
+
+		if (fieldPlayer.m_currentGravitySource == nullptr)
+		{
+			continue;
+		}
+
+		numSourced++;
+		float centerError = GetRelativeError(fieldPlayer.m_currentGravityCenter, storePlayer.m_currentGravityCenter);
+		float vectorError = GetRelativeError(fieldPlayer.m_currentGravityVector, storePlayer.m_currentGravityVector);
+		float error = (centerError > vectorError) ? centerError : vectorError;
+		maxRelativeError = (error > maxRelativeError) ? error : maxRelativeError;
+		if (error > FIELD_CHECK_MAX_RELATIVE_ERROR)
+		{
+			numMismatches++;
+		}
+		else if (memcmp(&fieldPlayer.m_currentGravityCenter, &storePlayer.m_currentGravityCenter, sizeof(Vec3)) == 0 &&
+			memcmp(&fieldPlayer.m_currentGravityVector, &storePlayer.m_currentGravityVector, sizeof(Vec3)) == 0)
+		{
+			numBitIdentical++;
+		}
+	}
+
+	printf("field store: %i queries in a field, %i bit identical to ApplyGravity, max relative error %g, %i mismatches\n", numSourced, numBitIdentical, maxRelativeError,
+		numMismatches);
+
+	for (int pltdIndex = 0; pltdIndex < planetoids.size(); pltdIndex++)
+	{
+		delete planetoids[pltdIndex];
+	}
+
+	return numMismatches;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+//checks the batched gravity code against the code it replaced, exits with 1 on any mismatch so it can gate a build
+//usage: GravityFieldCheck [numFields=1000] [numQueries=20000]
+int main(int argc, char* argv[])
+{
+	int numFields = (argc > 1) ? atoi(argv[1]) : 1000;
+	int numQueries = (argc > 2) ? atoi(argv[2]) : 20000;
+	if (numFields <= 0 || numQueries <= 0)
+	{
+		printf("numFields and numQueries must be greater than 0\n");
+		return 1;
+	}
+
+	RandomNumberGenerator rng;
+	rng.SeedRNG(numFields);
+
+	int numMismatches = CheckKernelsAgainstScalar(rng, numFields, numQueries);
+	numMismatches += CheckStoreAgainstFields(rng, numFields, numQueries);
+	return (numMismatches > 0) ? 1 : 0;
+}
+#endif
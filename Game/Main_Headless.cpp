@@ -0,0 +1,184 @@
+#if defined(GAME_HEADLESS)
+#include "Game/Simulation.hpp"
+#include "Game/Player.hpp"
+#include "Game/Planetoids.hpp"
+#include "Game/JobSystem.hpp"
+#include "Game/InputRecording.hpp"
+#include "Game/LevelFile.hpp"
+#include "Game/ModelAsset.hpp"
+#include "Game/PlaytestCourse.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+//-----------------------------------------------------------------------------------------------
+//runs the simulation with no window, renderer, or input, feeding the player a scripted command each tick
+//usage: GravitySimHeadless [numTicks=12000] [numBodies=0] [numThreads=0] [record|replay file]
+//record saves the scripted run as an input recording, replay runs a recording instead of the script and checks every tick against it
+//a recording made on another scene, like one from the game, is replayed on the scene saved in it instead of the scripted one
+int main(int argc, char* argv[])
+{
+	int numTicks = (argc > 1) ? atoi(argv[1]) : 12000;
+	int numBodies = (argc > 2) ? atoi(argv[2]) : 0;
+	int numThreads = (argc > 3) ? atoi(argv[3]) : 0;
+	bool isRecording = (argc > 5) && strcmp(argv[4], "record") == 0;
+	bool isReplaying = (argc > 5) && strcmp(argv[4], "replay") == 0;
+	float deltaSeconds = 1.0f / 120.0f;
+
+	InputRecording recording;
+	if (isReplaying)
+	{
+		if (!ReadInputRecording(recording, argv[5]))
+		{
+			printf("could not read input recording %s\n", argv[5]);
+			return 1;
+		}
+
+		numTicks = static_cast<int>(recording.m_commands.size());
+		deltaSeconds = recording.m_tickSeconds;
+	}
+
+	//small course with every kind of analytic field the player collides with most
+	std::vector<Planetoid*> planetoids;
+	planetoids.emplace_back(new PlanePLTD(Vec3(1.0f, -1.0f, -25.0f), 50.0f, 50.0f, EulerAngles(), true, 20.0f));
+	planetoids.emplace_back(new SpherePLTD(Vec3(28.0f, 0.0f, 0.0f), 7.0f, true, 20.0f));
+	planetoids.emplace_back(new CapsulePLTD(Vec3(2.5f, 28.0f, 0.0f), 3.0f, 5.0f, Vec3(0.0f, 0.5f, 0.5f), true, 7.0f));
+	planetoids.emplace_back(new TorusPLTD(Vec3(47.0f, 0.0f, 5.0f), 3.0f, 4.0f, EulerAngles(0.0f, -30.0f, -60.0f), true, 4.5f));
+
+	std::vector<AABB3> checkpoints;
+	PlaytestProgress   progress;
+
+	Player* player = new Player(nullptr);
+	player->m_position = player->m_playerStartPosition;
+	player->SnapRenderState();
+
+	JobSystemConfig jobSystemConfig;
+	jobSystemConfig.m_numThreads = numThreads;
+	JobSystem* jobSystem = new JobSystem(jobSystemConfig);
+	jobSystem->Startup();
+
+	SimulationConfig simulationConfig;
+	simulationConfig.m_planetoids = &planetoids;
+	simulationConfig.m_player = player;
+	simulationConfig.m_jobSystem = jobSystem;
+	Simulation* simulation = new Simulation(simulationConfig);
+
+	if (isRecording)
+	{
+		recording.m_tickSeconds = deltaSeconds;
+		recording.m_playerStart = TakePlayerSnapshot(*player);
+		PlaytestCourse scene;
+		scene.m_planetoids = planetoids;
+		MakeLevelDescription(scene, recording.m_scene);
+		recording.m_numPlanetoids = GetNumPlanetoids(planetoids);
+		recording.m_sceneChecksum = GetSceneChecksum(planetoids);
+		recording.m_isSteppingPlaytestTriggers = false;
+	}
+	else if (isReplaying)
+	{
+		if (recording.m_numPlanetoids != GetNumPlanetoids(planetoids) || recording.m_sceneChecksum != GetSceneChecksum(planetoids))
+		{
+			for (int pltdIndex = 0; pltdIndex < planetoids.size(); pltdIndex++)
+			{
+				delete planetoids[pltdIndex];
+			}
+
+			PlaytestCourse scene;
+			CreateLevelFromDescription(recording.m_scene, scene);
+			WaitForModelAssetLoads();
+			for (int pltdIndex = 0; pltdIndex < scene.m_planetoids.size(); pltdIndex++)
+			{
+				scene.m_planetoids[pltdIndex]->UpdateWorldBounds();
+			}
+			planetoids = scene.m_planetoids;
+			checkpoints = scene.m_checkpoints;
+			simulation->MarkPlanetoidsDirty();
+		}
+
+		if (recording.m_numPlanetoids != GetNumPlanetoids(planetoids) || recording.m_sceneChecksum != GetSceneChecksum(planetoids))
+		{
+			printf("the scene saved with the recording did not rebuild the same as when it was recorded\n");
+			return 1;
+		}
+
+		RestorePlayerSnapshot(*player, recording.m_playerStart);
+		progress.m_inPlaytestCourse = recording.m_inPlaytestCourse;
+		progress.m_checkpointIndex = (recording.m_checkpointIndex >= 0 && recording.m_checkpointIndex < checkpoints.size()) ? recording.m_checkpointIndex : -1;
+	}
+
+	//bodies on a fixed grid above the plane so every run starts the same
+	simulation->ReserveGravityBodies(numBodies);
+	for (int bodyIndex = 0; bodyIndex < numBodies; bodyIndex++)
+	{
+		simulation->AddGravityBody(Vec3(static_cast<float>(bodyIndex % 64) - 32.0f, static_cast<float>((bodyIndex / 64) % 64) - 32.0f, 5.0f + static_cast<float>(bodyIndex / 4096)), 0.25f);
+	}
+
+	int firstDivergentTick = -1;
+	auto startTime = std::chrono::steady_clock::now();
+	for (int tickIndex = 0; tickIndex < numTicks; tickIndex++)
+	{
+		//run forward, turning slowly, and jump twice a second
+		PlayerCommand command;
+		command.m_movementIntentions = Vec3(1.0f, 0.0f, 0.0f);
+		command.m_yawIntentions = ((tickIndex / 600) % 2 == 0) ? 0.25f : -0.25f;
+		command.m_jumpPressed = (tickIndex % 60) == 0;
+		command.m_respawnPressed = (tickIndex % 6000) == 5999;
+		if (isReplaying)
+		{
+			command = recording.m_commands[tickIndex];
+		}
+
+		simulation->StepPlayer(deltaSeconds, command);
+		if (isReplaying && recording.m_isSteppingPlaytestTriggers)
+		{
+			StepPlaytestTriggers(*player, checkpoints, progress);
+		}
+		simulation->StepBodies(deltaSeconds);
+
+		if (isRecording)
+		{
+			recording.m_commands.emplace_back(command);
+			recording.m_checksums.emplace_back(GetPlayerStateChecksum(*player));
+		}
+		else if (isReplaying && firstDivergentTick < 0 && GetPlayerStateChecksum(*player) != recording.m_checksums[tickIndex])
+		{
+			firstDivergentTick = tickIndex;
+		}
+	}
+	double elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+	printf("%i ticks, %i bodies on %i threads: %.3f s, %.0f ticks/s\n", numTicks, numBodies, jobSystem->GetNumThreads(), elapsedSeconds,
+		static_cast<double>(numTicks) / elapsedSeconds);
+	printf("player position: %.4f, %.4f, %.4f\n", player->m_position.x, player->m_position.y, player->m_position.z);
+
+	int exitCode = 0;
+	if (isRecording && !WriteInputRecording(recording, argv[5]))
+	{
+		printf("could not write input recording %s\n", argv[5]);
+		exitCode = 1;
+	}
+	else if (isReplaying && firstDivergentTick >= 0)
+	{
+		printf("replay diverged from the recording on tick %i\n", firstDivergentTick);
+		exitCode = 1;
+	}
+	else if (isReplaying)
+	{
+		printf("replay matched the recording on all %i ticks\n", numTicks);
+	}
+
+	delete simulation;
+	jobSystem->Shutdown();
+	delete jobSystem;
+	delete player;
+	for (int pltdIndex = 0; pltdIndex < planetoids.size(); pltdIndex++)
+	{
+		delete planetoids[pltdIndex];
+	}
+
+	return exitCode;
+}
+#endif
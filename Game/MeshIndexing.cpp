@@ -0,0 +1,290 @@
+#include "Game/MeshIndexing.hpp"
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+
+
+//
+//mesh indexing functions
+//
+void BuildIndexedMesh(std::vector<Vertex_PCUTBN>& vertexes, std::vector<unsigned int>& out_indexes)
+{
+	WeldVertexes(vertexes, out_indexes);
+	RemoveDegenerateTriangles(out_indexes);
+	OptimizeIndexesForVertexCache(out_indexes, static_cast<int>(vertexes.size()));
+	OptimizeVertexesForFetch(vertexes, out_indexes);
+}
+
+
+//merges vertexes that match in every attribute, so a seam with two normals or uvs keeps both copies
+void WeldVertexes(std::vector<Vertex_PCUTBN>& vertexes, std::vector<unsigned int>& out_indexes)
+{
+	int numVertexes = static_cast<int>(vertexes.size());
+	out_indexes.resize(numVertexes);
+	if (numVertexes == 0)
+	{
+		return;
+	}
+
+	//sorting by raw bytes puts identical vertexes next to each other without hashing floats
+	std::vector<unsigned int> sortedVertexes(numVertexes);
+	for (int vertIndex = 0; vertIndex < numVertexes; vertIndex++)
+	{
+		sortedVertexes[vertIndex] = vertIndex;
+	}
+	std::sort(sortedVertexes.begin(), sortedVertexes.end(), [&vertexes](unsigned int a, unsigned int b)
+		{
+			int comparison = memcmp(&vertexes[a], &vertexes[b], sizeof(Vertex_PCUTBN));
+			return (comparison != 0) ? (comparison < 0) : (a < b);
+		});
+
+	std::vector<Vertex_PCUTBN> weldedVertexes;
+	weldedVertexes.reserve(numVertexes / 4);
+	for (int sortedIndex = 0; sortedIndex < numVertexes; sortedIndex++)
+	{
+		unsigned int vertIndex = sortedVertexes[sortedIndex];
+		if (sortedIndex == 0 || memcmp(&vertexes[vertIndex], &vertexes[sortedVertexes[sortedIndex - 1]], sizeof(Vertex_PCUTBN)) != 0)
+		{
+			weldedVertexes.emplace_back(vertexes[vertIndex]);
+		}
+		out_indexes[vertIndex] = static_cast<unsigned int>(weldedVertexes.size() - 1);
+	}
+
+	weldedVertexes.shrink_to_fit();
+	vertexes.swap(weldedVertexes);
+}
+
+
+//drops triangles that welding collapsed onto two corners, triangles with distinct corners at the same spot are left alone
+void RemoveDegenerateTriangles(std::vector<unsigned int>& indexes)
+{
+	int numKeptIndexes = 0;
+	for (int firstIndex = 0; firstIndex + 2 < indexes.size(); firstIndex += 3)
+	{
+		unsigned int a = indexes[firstIndex];
+		unsigned int b = indexes[firstIndex + 1];
+		unsigned int c = indexes[firstIndex + 2];
+		if (a == b || b == c || a == c)
+		{
+			continue;
+		}
+
+		indexes[numKeptIndexes++] = a;
+		indexes[numKeptIndexes++] = b;
+		indexes[numKeptIndexes++] = c;
+	}
+
+	indexes.resize(numKeptIndexes);
+}
+
+
+//scores a vertex for the cache optimizer, high for vertexes already in the cache and for ones with few triangles left to draw
+static float GetVertexCacheScore(int cachePosition, int numTrianglesLeft)
+{
+	if (numTrianglesLeft == 0)
+	{
+		return -1.0f;
+	}
+
+	float score = 0.0f;
+	if (cachePosition >= 0)
+	{
+		//the last triangle's corners get a flat score so the optimizer doesn't just strip back and forth
+		if (cachePosition < 3)
+		{
+			score = 0.75f;
+		}
+		else
+		{
+			float cacheFraction = 1.0f - (static_cast<float>(cachePosition - 3) / static_cast<float>(MESH_VERTEX_CACHE_SIZE - 3));
+			score = powf(cacheFraction, 1.5f);
+		}
+	}
+
+	//finish off vertexes that are almost done so they can leave the cache
+	score += 2.0f / sqrtf(static_cast<float>(numTrianglesLeft));
+	return score;
+}
+
+
+//greedy triangle reordering after forsyth's linear speed vertex cache optimization
+void OptimizeIndexesForVertexCache(std::vector<unsigned int>& indexes, int numVertexes)
+{
+	int numTriangles = static_cast<int>(indexes.size()) / 3;
+	if (numTriangles < 2)
+	{
+		return;
+	}
+
+	//triangles touching each vertex, packed into one array
+	std::vector<int> numTrianglesLeft(numVertexes, 0);
+	for (int index = 0; index < numTriangles * 3; index++)
+	{
+		numTrianglesLeft[indexes[index]]++;
+	}
+
+	std::vector<int> firstAdjacency(numVertexes + 1, 0);
+	for (int vertIndex = 0; vertIndex < numVertexes; vertIndex++)
+	{
+		firstAdjacency[vertIndex + 1] = firstAdjacency[vertIndex] + numTrianglesLeft[vertIndex];
+	}
+
+	std::vector<int> adjacentTriangles(numTriangles * 3);
+	std::vector<int> numAdjacentFilled(numVertexes, 0);
+	for (int triIndex = 0; triIndex < numTriangles; triIndex++)
+	{
+		for (int corner = 0; corner < 3; corner++)
+		{
+			unsigned int vertIndex = indexes[triIndex * 3 + corner];
+			adjacentTriangles[firstAdjacency[vertIndex] + numAdjacentFilled[vertIndex]++] = triIndex;
+		}
+	}
+
+	std::vector<int> cachePositions(numVertexes, -1);
+	std::vector<float> vertexScores(numVertexes);
+	for (int vertIndex = 0; vertIndex < numVertexes; vertIndex++)
+	{
+		vertexScores[vertIndex] = GetVertexCacheScore(-1, numTrianglesLeft[vertIndex]);
+	}
+
+	std::vector<float> triangleScores(numTriangles);
+	std::vector<bool> isTriangleDrawn(numTriangles, false);
+	for (int triIndex = 0; triIndex < numTriangles; triIndex++)
+	{
+		triangleScores[triIndex] = vertexScores[indexes[triIndex * 3]] + vertexScores[indexes[triIndex * 3 + 1]] + vertexScores[indexes[triIndex * 3 + 2]];
+	}
+
+	std::vector<unsigned int> orderedIndexes;
+	orderedIndexes.reserve(indexes.size());
+	std::vector<int> cache;
+	std::vector<int> nextCache;
+	cache.reserve(MESH_VERTEX_CACHE_SIZE + 3);
+	nextCache.reserve(MESH_VERTEX_CACHE_SIZE + 3);
+
+	int bestTriangle = -1;
+	int nextUnscannedTriangle = 0;
+	for (int numDrawn = 0; numDrawn < numTriangles; numDrawn++)
+	{
+		//nothing in the cache is worth drawing, start again from the best triangle left anywhere
+		if (bestTriangle < 0)
+		{
+			float bestScore = -1.0f;
+			for (int triIndex = nextUnscannedTriangle; triIndex < numTriangles; triIndex++)
+			{
+				if (!isTriangleDrawn[triIndex] && triangleScores[triIndex] > bestScore)
+				{
+					bestScore = triangleScores[triIndex];
+					bestTriangle = triIndex;
+				}
+			}
+		}
+
+		isTriangleDrawn[bestTriangle] = true;
+		while (nextUnscannedTriangle < numTriangles && isTriangleDrawn[nextUnscannedTriangle])
+		{
+			nextUnscannedTriangle++;
+		}
+
+		//draw it, then move its corners to the front of the cache
+		nextCache.clear();
+		for (int corner = 0; corner < 3; corner++)
+		{
+			unsigned int vertIndex = indexes[bestTriangle * 3 + corner];
+			orderedIndexes.emplace_back(vertIndex);
+			nextCache.emplace_back(vertIndex);
+
+			numTrianglesLeft[vertIndex]--;
+			int* adjacencyBegin = &adjacentTriangles[firstAdjacency[vertIndex]];
+			int* adjacencyEnd = adjacencyBegin + numTrianglesLeft[vertIndex] + 1;
+			std::iter_swap(std::find(adjacencyBegin, adjacencyEnd, bestTriangle), adjacencyEnd - 1);
+		}
+
+		for (int cacheIndex = 0; cacheIndex < cache.size(); cacheIndex++)
+		{
+			if (std::find(nextCache.begin(), nextCache.end(), cache[cacheIndex]) == nextCache.end())
+			{
+				nextCache.emplace_back(cache[cacheIndex]);
+			}
+		}
+
+		//rescore everything that was in the cache, including the vertexes just pushed out of it
+		for (int cacheIndex = 0; cacheIndex < nextCache.size(); cacheIndex++)
+		{
+			int vertIndex = nextCache[cacheIndex];
+			cachePositions[vertIndex] = (cacheIndex < MESH_VERTEX_CACHE_SIZE) ? cacheIndex : -1;
+			vertexScores[vertIndex] = GetVertexCacheScore(cachePositions[vertIndex], numTrianglesLeft[vertIndex]);
+		}
+
+		bestTriangle = -1;
+		float bestScore = -1.0f;
+		for (int cacheIndex = 0; cacheIndex < nextCache.size(); cacheIndex++)
+		{
+			int vertIndex = nextCache[cacheIndex];
+			for (int adjacencyIndex = 0; adjacencyIndex < numTrianglesLeft[vertIndex]; adjacencyIndex++)
+			{
+				int triIndex = adjacentTriangles[firstAdjacency[vertIndex] + adjacencyIndex];
+				float score = vertexScores[indexes[triIndex * 3]] + vertexScores[indexes[triIndex * 3 + 1]] + vertexScores[indexes[triIndex * 3 + 2]];
+				triangleScores[triIndex] = score;
+				if (score > bestScore)
+				{
+					bestScore = score;
+					bestTriangle = triIndex;
+				}
+			}
+		}
+
+		nextCache.resize(std::min(static_cast<int>(nextCache.size()), MESH_VERTEX_CACHE_SIZE));
+		cache.swap(nextCache);
+	}
+
+	indexes.swap(orderedIndexes);
+}
+
+
+//renumbers vertexes in the order the indexes first use them, so the gpu reads the vertex buffer front to back
+void OptimizeVertexesForFetch(std::vector<Vertex_PCUTBN>& vertexes, std::vector<unsigned int>& indexes)
+{
+	std::vector<unsigned int> remappedIndexes(vertexes.size(), 0xffffffffu);
+	std::vector<Vertex_PCUTBN> orderedVertexes;
+	orderedVertexes.reserve(vertexes.size());
+
+	for (int index = 0; index < indexes.size(); index++)
+	{
+		unsigned int& remappedIndex = remappedIndexes[indexes[index]];
+		if (remappedIndex == 0xffffffffu)
+		{
+			remappedIndex = static_cast<unsigned int>(orderedVertexes.size());
+			orderedVertexes.emplace_back(vertexes[indexes[index]]);
+		}
+		indexes[index] = remappedIndex;
+	}
+
+	//vertexes no triangle uses anymore are dropped
+	vertexes.swap(orderedVertexes);
+}
+
+
+//vertex shader runs per triangle through a fifo cache, 3 means no reuse and a regular grid bottoms out around 0.5
+float GetAverageCacheMissRatio(std::vector<unsigned int> const& indexes, int cacheSize)
+{
+	int numTriangles = static_cast<int>(indexes.size()) / 3;
+	if (numTriangles == 0)
+	{
+		return 0.0f;
+	}
+
+	std::vector<unsigned int> cache(cacheSize, 0xffffffffu);
+	int nextCacheSlot = 0;
+	int numMisses = 0;
+	for (int index = 0; index < numTriangles * 3; index++)
+	{
+		if (std::find(cache.begin(), cache.end(), indexes[index]) == cache.end())
+		{
+			cache[nextCacheSlot] = indexes[index];
+			nextCacheSlot = (nextCacheSlot + 1) % cacheSize;
+			numMisses++;
+		}
+	}
+
+	return static_cast<float>(numMisses) / static_cast<float>(numTriangles);
+}
@@ -0,0 +1,16 @@
+#pragma once
+#include "Engine/Core/Vertex_PCUTBN.hpp"
+#include <vector>
+
+
+//constants
+constexpr int MESH_VERTEX_CACHE_SIZE = 32;
+
+
+//mesh indexing functions, the engine's AddVertsFor helpers build triangle lists with every shared corner repeated
+void  BuildIndexedMesh(std::vector<Vertex_PCUTBN>& vertexes, std::vector<unsigned int>& out_indexes);
+void  WeldVertexes(std::vector<Vertex_PCUTBN>& vertexes, std::vector<unsigned int>& out_indexes);
+void  RemoveDegenerateTriangles(std::vector<unsigned int>& indexes);
+void  OptimizeIndexesForVertexCache(std::vector<unsigned int>& indexes, int numVertexes);
+void  OptimizeVertexesForFetch(std::vector<Vertex_PCUTBN>& vertexes, std::vector<unsigned int>& indexes);
+float GetAverageCacheMissRatio(std::vector<unsigned int> const& indexes, int cacheSize = MESH_VERTEX_CACHE_SIZE);
@@ -0,0 +1,72 @@
+#include "Game/MeshUploader.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+
+
+//
+//shared mesh functions
+//
+GPUMesh* MeshUploader::AcquireSharedMesh(std::vector<Vertex_PCUTBN> const& vertexes, std::vector<unsigned int> const& indexes, uint64_t& out_meshKey)
+{
+	uint64_t meshKey = HashBytes64(vertexes.data(), vertexes.size() * sizeof(Vertex_PCUTBN));
+	meshKey = HashBytes64(indexes.data(), indexes.size() * sizeof(unsigned int), meshKey);
+
+	//a matching hash with different counts is a collision, step to the next key rather than share the wrong mesh
+	std::map<uint64_t, SharedMesh>::iterator found = m_sharedMeshes.find(meshKey);
+	while (found != m_sharedMeshes.end() && (found->second.m_numVertexes != vertexes.size() || found->second.m_numIndexes != indexes.size()))
+	{
+		meshKey++;
+		found = m_sharedMeshes.find(meshKey);
+	}
+
+	out_meshKey = meshKey;
+	if (found != m_sharedMeshes.end())
+	{
+		found->second.m_refCount++;
+		m_numSharedMeshHits++;
+		return found->second.m_mesh;
+	}
+
+	SharedMesh& sharedMesh = m_sharedMeshes[meshKey];
+	sharedMesh.m_mesh = CreateStaticMesh(vertexes, indexes);
+	sharedMesh.m_refCount = 1;
+	sharedMesh.m_numVertexes = vertexes.size();
+	sharedMesh.m_numIndexes = indexes.size();
+	return sharedMesh.m_mesh;
+}
+
+
+void MeshUploader::ReleaseSharedMesh(uint64_t meshKey)
+{
+	std::map<uint64_t, SharedMesh>::iterator found = m_sharedMeshes.find(meshKey);
+	if (found == m_sharedMeshes.end())
+	{
+		ERROR_RECOVERABLE("Released a shared mesh that was never acquired");
+		return;
+	}
+
+	found->second.m_refCount--;
+	if (found->second.m_refCount <= 0)
+	{
+		DestroyStaticMesh(found->second.m_mesh);
+		m_sharedMeshes.erase(found);
+	}
+}
+
+
+//
+//null mesh uploader functions
+//
+GPUMesh* NullMeshUploader::CreateStaticMesh(std::vector<Vertex_PCUTBN> const& vertexes, std::vector<unsigned int> const& indexes)
+{
+	m_numMeshesCreated++;
+	m_numBytesUploaded += (vertexes.size() * sizeof(Vertex_PCUTBN)) + (indexes.size() * sizeof(unsigned int));
+	return nullptr;
+}
+
+
+void NullMeshUploader::DestroyStaticMesh(GPUMesh* mesh)
+{
+	UNUSED(mesh);
+	m_numMeshesDestroyed++;
+}
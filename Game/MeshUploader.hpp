@@ -0,0 +1,72 @@
+#pragma once
+#include "Game/BinaryFileUtils.hpp"
+#include "Engine/Core/Vertex_PCUTBN.hpp"
+#include <cstdint>
+#include <map>
+#include <vector>
+
+
+//forward declarations
+class GPUMesh;
+
+
+//one gpu mesh used by every planetoid whose tessellation came out identical
+struct SharedMesh
+{
+	GPUMesh* m_mesh = nullptr;
+	int		 m_refCount = 0;
+	size_t	 m_numVertexes = 0;
+	size_t	 m_numIndexes = 0;
+};
+
+
+//creates gpu buffers once for meshes that don't change after they're built, the renderer sits behind this so headless builds can swap in a null one
+class MeshUploader
+{
+//public member functions
+public:
+	virtual ~MeshUploader() {}
+
+	//static mesh functions, indexes can be empty for a plain triangle list
+	virtual GPUMesh* CreateStaticMesh(std::vector<Vertex_PCUTBN> const& vertexes, std::vector<unsigned int> const& indexes) = 0;
+	virtual void	 DestroyStaticMesh(GPUMesh* mesh) = 0;
+
+	//shared mesh functions, meshes are keyed by their vertex and index data and only destroyed with their last user
+	GPUMesh* AcquireSharedMesh(std::vector<Vertex_PCUTBN> const& vertexes, std::vector<unsigned int> const& indexes, uint64_t& out_meshKey);
+	void	 ReleaseSharedMesh(uint64_t meshKey);
+	int		 GetNumSharedMeshes() const { return static_cast<int>(m_sharedMeshes.size()); }
+
+//public member variables
+public:
+	//running totals, so what gets uploaded can be checked without a gpu
+	int	   m_numMeshesCreated = 0;
+	int	   m_numMeshesDestroyed = 0;
+	int	   m_numSharedMeshHits = 0;
+	size_t m_numBytesUploaded = 0;
+
+//private member variables
+private:
+	std::map<uint64_t, SharedMesh> m_sharedMeshes;
+};
+
+
+//counts uploads without touching a device and hands back no mesh
+class NullMeshUploader : public MeshUploader
+{
+//public member functions
+public:
+	virtual GPUMesh* CreateStaticMesh(std::vector<Vertex_PCUTBN> const& vertexes, std::vector<unsigned int> const& indexes) override;
+	virtual void	 DestroyStaticMesh(GPUMesh* mesh) override;
+};
+
+
+#if !defined(GAME_HEADLESS)
+//copies meshes into immutable buffers on g_theRenderer
+class RendererMeshUploader : public MeshUploader
+{
+//public member functions
+public:
+	virtual GPUMesh* CreateStaticMesh(std::vector<Vertex_PCUTBN> const& vertexes, std::vector<unsigned int> const& indexes) override;
+	virtual void	 DestroyStaticMesh(GPUMesh* mesh) override;
+};
+#endif
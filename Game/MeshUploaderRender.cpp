@@ -0,0 +1,44 @@
+#include "Game/MeshUploader.hpp"
+#include "Game/GameCommon.hpp"
+#include "Engine/Renderer/GPUMesh.hpp"
+#include "Engine/Renderer/Renderer.hpp"
+
+
+//
+//renderer mesh uploader functions
+//
+GPUMesh* RendererMeshUploader::CreateStaticMesh(std::vector<Vertex_PCUTBN> const& vertexes, std::vector<unsigned int> const& indexes)
+{
+	if (vertexes.empty())
+	{
+		return nullptr;
+	}
+
+	size_t vertexBytes = vertexes.size() * sizeof(Vertex_PCUTBN);
+	GPUMesh* mesh = new GPUMesh();
+	mesh->m_vertexBuffer = g_theRenderer->CreateVertexBuffer(vertexBytes, sizeof(Vertex_PCUTBN));
+	g_theRenderer->CopyCPUToGPU(vertexes.data(), vertexBytes, mesh->m_vertexBuffer);
+
+	size_t indexBytes = indexes.size() * sizeof(unsigned int);
+	if (!indexes.empty())
+	{
+		mesh->m_indexBuffer = g_theRenderer->CreateIndexBuffer(indexBytes);
+		g_theRenderer->CopyCPUToGPU(indexes.data(), indexBytes, mesh->m_indexBuffer);
+	}
+
+	m_numMeshesCreated++;
+	m_numBytesUploaded += vertexBytes + indexBytes;
+	return mesh;
+}
+
+
+void RendererMeshUploader::DestroyStaticMesh(GPUMesh* mesh)
+{
+	if (mesh == nullptr)
+	{
+		return;
+	}
+
+	delete mesh;
+	m_numMeshesDestroyed++;
+}
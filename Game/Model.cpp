@@ -2,14 +2,9 @@
 #include "Game/GameCommon.hpp"
 #include "Game/Player.hpp"
 #include "Engine/Renderer/CPUMesh.hpp"
-#include "Engine/Renderer/GPUMesh.hpp"
-#include "Engine/Renderer/Shader.hpp"
-#include "Engine/Core/OBJLoader.hpp"
-#include "Engine/Renderer/Renderer.hpp"
-#include "Engine/Renderer/DebugRenderSystem.hpp"
-#include "Engine/Core/XmlUtils.hpp"
 #include "Engine/Math/Mat44.hpp"
 #include "Engine/Math/MathUtils.hpp"
+#include <algorithm>
 
 
 //
@@ -21,123 +16,137 @@ Model::Model(Vec3 position, float scale, EulerAngles orientation, Rgba8 color)
 	, m_orientation(orientation)
 	, m_color(color)
 {
-	m_cpuMesh = new CPUMesh();
-	m_gpuMesh = new GPUMesh();
+	UpdateModelMatrices();
 }
 
 
 Model::~Model()
 {
-	if (m_cpuMesh != nullptr)
-	{
-		delete m_cpuMesh;
-	}
-	if (m_gpuMesh != nullptr)
-	{
-		delete m_gpuMesh;
-	}
+	ReleaseModelAsset(m_asset);
 }
 
+
 //
-//model creation and rendering
+//model creation
 //
-bool Model::ParseXMLFileForOBJ(std::string const& fileName)
+bool Model::ParseXMLFileForOBJ(std::string const& fileName, bool loadInBackground)
 {
-	//parse xml for obj file name and fixup matrix
-	XmlDocument modelXml;
-	XmlError result = modelXml.LoadFile(fileName.c_str());
-	if (result != tinyxml2::XML_SUCCESS)
-	{
-		ERROR_RECOVERABLE("Failed to open model xml file!");
-		return false;
-	}
-	XmlElement* rootElement = modelXml.RootElement();
-	if (rootElement == nullptr)
-	{
-		ERROR_RECOVERABLE("Failed to read model xml root element!");
-		return false;
-	}
-	
-	std::string const& objFilePath = ParseXmlAttribute(*rootElement, "path", "invalid path");
-	std::string const& shaderName = ParseXmlAttribute(*rootElement, "shader", "invalid shader path");
-	if (shaderName == "invalid shader path")
-	{
-		ERROR_RECOVERABLE("Couldn't find shader in xml!");
-		return false;
-	}
-	m_shader = g_theRenderer->CreateShader(shaderName.c_str());
+	//a model only ever shows one prefab, so reparsing swaps which asset it points at
+	ModelAsset* previousAsset = m_asset;
+	m_asset = AcquireModelAsset(fileName, loadInBackground);
+	m_closestPointGrid = nullptr;
+	ReleaseModelAsset(previousAsset);
 
-	XmlElement* transformElement = rootElement->FirstChildElement();
-	Mat44 matrix = Mat44();
-	Vec3 iBasis = ParseXmlAttribute(*transformElement, "x", Vec3());
-	Vec3 jBasis = ParseXmlAttribute(*transformElement, "y", Vec3());
-	Vec3 kBasis = ParseXmlAttribute(*transformElement, "z", Vec3());
-	Vec3 translation = ParseXmlAttribute(*transformElement, "t", Vec3());
-	matrix.SetIJKT3D(iBasis, jBasis, kBasis, translation);
-	matrix.AppendScaleUniform3D(ParseXmlAttribute(*transformElement, "scale", 1.0f));
+	return m_asset->m_state != MODEL_ASSET_FAILED;
+}
 
-	//pass into obj loader along with vertex and index vectors from cpu mesh
-	OBJLoader::LoadObjFile(objFilePath, matrix, m_cpuMesh->m_vertexes, m_cpuMesh->m_indexes);
 
-	m_gpuMesh->m_vertexBuffer = g_theRenderer->CreateVertexBuffer(sizeof(Vertex_PCUTBN), sizeof(Vertex_PCUTBN));
-	g_theRenderer->CopyCPUToGPU(m_cpuMesh->m_vertexes.data(), static_cast<int>(m_cpuMesh->m_vertexes.size()) * sizeof(Vertex_PCUTBN), m_gpuMesh->m_vertexBuffer);
+//
+//game-centric model functions
+//
+void Model::SetPosition(Vec3 const& position)
+{
+	m_position = position;
+	UpdateModelMatrices();
+}
 
-	if (m_cpuMesh->m_indexes.size() > 0)
-	{
-		m_gpuMesh->m_indexBuffer = g_theRenderer->CreateIndexBuffer(sizeof(int));
-		g_theRenderer->CopyCPUToGPU(m_cpuMesh->m_indexes.data(), static_cast<int>(m_cpuMesh->m_indexes.size()) * sizeof(int), m_gpuMesh->m_indexBuffer);
-	}
 
-	return true;
+void Model::SetOrientation(EulerAngles const& orientation)
+{
+	m_orientation = orientation;
+	UpdateModelMatrices();
 }
 
 
-void Model::RenderGPUMesh(Vec3 sunDirection, float sunIntensity, float ambientIntensity) const
+Vec3 Model::GetNearestPointOnModel(Vec3 const& referencePoint, ModelQueryMode queryMode) const
 {
-	g_theRenderer->BindShader(m_shader);
-	g_theRenderer->BindTexture(nullptr);
-	g_theRenderer->SetModelConstants(GetModelMatrix(), m_color);
-	g_theRenderer->SetLightConstants(sunDirection, sunIntensity, ambientIntensity);
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
+	if (!IsReady())
+	{
+		return m_position;
+	}
 
-	if (m_cpuMesh->m_indexes.size() > 0)
+	Mat44 const& modelMatrix = GetModelMatrix();
+	Vec3 referencePointLocal = GetInverseModelMatrix().TransformPosition3D(referencePoint);
+
+	Vec3 gridLocalPoint;
+	bool isInGrid = (queryMode != MODEL_QUERY_EXACT) && m_closestPointGrid != nullptr && m_closestPointGrid->GetNearestLocalPoint(referencePointLocal, gridLocalPoint);
+	if (isInGrid && queryMode == MODEL_QUERY_GRID)
 	{
-		g_theRenderer->DrawVertexBufferIndexed(m_gpuMesh->m_vertexBuffer, m_gpuMesh->m_indexBuffer, static_cast<int>(m_cpuMesh->m_indexes.size()));
+		return modelMatrix.TransformPosition3D(gridLocalPoint);
 	}
-	else
+
+	Vec3 nearestLocalPoint = Vec3(FLT_MAX, FLT_MAX, FLT_MAX);
+	if (isInGrid)
 	{
-		g_theRenderer->DrawVertexBuffer(m_gpuMesh->m_vertexBuffer, static_cast<int>(m_cpuMesh->m_vertexes.size()));
+		//the true nearest point can't be much further than the grid's guess, so most of the tree is skipped
+		float searchDistance = GetDistance3D(referencePointLocal, gridLocalPoint) + m_closestPointGrid->m_maxDistanceError + m_closestPointGrid->m_cellSize;
+		if (m_asset->GetNearestLocalPointOnModel(referencePointLocal, nearestLocalPoint, searchDistance * searchDistance))
+		{
+			return modelMatrix.TransformPosition3D(nearestLocalPoint);
+		}
 	}
-}
 
+	m_asset->GetNearestLocalPointOnModel(referencePointLocal, nearestLocalPoint);
+	return modelMatrix.TransformPosition3D(nearestLocalPoint);
+}
 
 
-//
-//game-centric model functions
-//
-Mat44 Model::GetModelMatrix() const
+bool Model::PushPlayerOutOfAllTrisOnModel(Player* player, std::vector<int>& nearbyTriScratch, ModelQueryMode queryMode)
 {
-	Mat44 modelMatrix = m_orientation.GetAsMatrix_XFwd_YLeft_ZUp();
+	if (!IsReady())
+	{
+		return false;
+	}
+
+	Mat44 const& modelMatrix = GetModelMatrix();
+	Vec3 referencePointLocal = GetInverseModelMatrix().TransformPosition3D(player->m_position);
+
+	Vec3 gridLocalPoint;
+	bool isInGrid = (queryMode != MODEL_QUERY_EXACT) && m_closestPointGrid != nullptr && m_closestPointGrid->GetNearestLocalPoint(referencePointLocal, gridLocalPoint);
+	if (isInGrid && queryMode == MODEL_QUERY_GRID)
+	{
+		return PushPlayerOutOfGridPoint(player, modelMatrix, gridLocalPoint);
+	}
+
+	if (isInGrid)
+	{
+		//skip the exact test when the grid says the surface is clearly out of reach
+		float gridDistance = GetDistance3D(referencePointLocal, gridLocalPoint) * m_scale;
+		if (gridDistance > player->m_collisionRadius + ((m_closestPointGrid->m_maxDistanceError + m_closestPointGrid->m_cellSize) * m_scale))
+		{
+			return false;
+		}
+	}
 
-	modelMatrix.AppendScaleUniform3D(m_scale);
+	return PushPlayerOutOfTrisNearPoint(player, modelMatrix, referencePointLocal, nearbyTriScratch);
+}
 
-	modelMatrix.SetTranslation3D(m_position);
 
-	return modelMatrix;
+void Model::BakeClosestPointGrid(float cellSize, float bandWidth)
+{
+	if (IsReady())
+	{
+		m_closestPointGrid = m_asset->BakeClosestPointGrid(cellSize, bandWidth);
+	}
 }
 
 
-Vec3 Model::GetNearestPointOnModel(Vec3 const& referencePoint) const
+Vec3 Model::GetNearestPointOnModelBruteForce(Vec3 const& referencePoint) const
 {
-	Vec3 referencePointLocal = GetModelMatrix().GetOrthonormalInverse().TransformPosition3D(referencePoint);
+	if (!IsReady())
+	{
+		return m_position;
+	}
+
+	Vec3 referencePointLocal = GetInverseModelMatrix().TransformPosition3D(referencePoint);
 	
 	Vec3 currentNearestLocalPoint = Vec3(FLT_MAX, FLT_MAX, FLT_MAX);
 	float nearestLocalPointDistSq = GetDistanceSquared3D(currentNearestLocalPoint, referencePointLocal);
 	
-	for (int vertIndex = 0; vertIndex < m_cpuMesh->m_indexes.size(); vertIndex+=3)
+	for (int vertIndex = 0; vertIndex < m_asset->m_cpuMesh->m_indexes.size(); vertIndex+=3)
 	{
-		Vec3 triNearestLocalPoint = GetNearestPointOnTriangle3D(referencePointLocal, m_cpuMesh->m_vertexes[m_cpuMesh->m_indexes[vertIndex]].m_position, 
-			m_cpuMesh->m_vertexes[m_cpuMesh->m_indexes[vertIndex+1]].m_position, m_cpuMesh->m_vertexes[m_cpuMesh->m_indexes[vertIndex+2]].m_position);
+		Vec3 triNearestLocalPoint = GetNearestPointOnTriangle3D(referencePointLocal, m_asset->m_cpuMesh->m_vertexes[m_asset->m_cpuMesh->m_indexes[vertIndex]].m_position, 
+			m_asset->m_cpuMesh->m_vertexes[m_asset->m_cpuMesh->m_indexes[vertIndex+1]].m_position, m_asset->m_cpuMesh->m_vertexes[m_asset->m_cpuMesh->m_indexes[vertIndex+2]].m_position);
 
 		if (GetDistanceSquared3D(triNearestLocalPoint, referencePointLocal) < nearestLocalPointDistSq)
 		{
@@ -152,54 +161,138 @@ Vec3 Model::GetNearestPointOnModel(Vec3 const& referencePoint) const
 }
 
 
-bool Model::PushPlayerOutOfAllTrisOnModel(Player* player)
+bool Model::PushPlayerOutOfAllTrisOnModelBruteForce(Player* player)
 {
-	Vec3 referencePointLocal = GetModelMatrix().GetOrthonormalInverse().TransformPosition3D(player->m_position);
+	if (!IsReady())
+	{
+		return false;
+	}
+
+	Mat44 const& modelMatrix = GetModelMatrix();
+	Vec3 referencePointLocal = GetInverseModelMatrix().TransformPosition3D(player->m_position);
 
 	bool wasPlayerPushed = false;
-	for (int vertIndex = 0; vertIndex < m_cpuMesh->m_indexes.size(); vertIndex += 3)
+	for (int vertIndex = 0; vertIndex < m_asset->m_cpuMesh->m_indexes.size(); vertIndex += 3)
 	{
-		Vec3 pointALocal = m_cpuMesh->m_vertexes[m_cpuMesh->m_indexes[vertIndex]].m_position;
-		Vec3 pointBLocal = m_cpuMesh->m_vertexes[m_cpuMesh->m_indexes[vertIndex + 1]].m_position;
-		Vec3 pointCLocal = m_cpuMesh->m_vertexes[m_cpuMesh->m_indexes[vertIndex + 2]].m_position;
-
-		if (pointALocal == pointBLocal || pointALocal == pointCLocal || pointBLocal == pointCLocal)
+		if (PushPlayerOutOfTri(player, modelMatrix, referencePointLocal, vertIndex))
 		{
-			continue;
+			wasPlayerPushed = true;
 		}
-		
-		Vec3 triNearestLocalPoint = GetNearestPointOnTriangle3D(referencePointLocal, m_cpuMesh->m_vertexes[m_cpuMesh->m_indexes[vertIndex]].m_position,
-			m_cpuMesh->m_vertexes[m_cpuMesh->m_indexes[vertIndex + 1]].m_position, m_cpuMesh->m_vertexes[m_cpuMesh->m_indexes[vertIndex + 2]].m_position);
+	}
 
-		if (triNearestLocalPoint.x != triNearestLocalPoint.x)
-		{
-			continue;
-		}
+	return wasPlayerPushed;
+}
+
+
+//
+//private model functions
+//
+void Model::UpdateModelMatrices()
+{
+	m_modelMatrix = m_orientation.GetAsMatrix_XFwd_YLeft_ZUp();
+	m_modelMatrix.AppendScaleUniform3D(m_scale);
+	m_modelMatrix.SetTranslation3D(m_position);
+
+	//matches the inverse the collision code always used, which assumes the prefab isn't scaled
+	m_inverseModelMatrix = m_modelMatrix.GetOrthonormalInverse();
+}
 
-		Vec3 triNearestPoint = GetModelMatrix().TransformPosition3D(triNearestLocalPoint);
 
-		bool wasPlayerPushedByTri = PushSphereOutOfFixedPoint3D(player->m_position, player->m_collisionRadius, triNearestPoint);
-		if (wasPlayerPushedByTri)
+bool Model::PushPlayerOutOfTri(Player* player, Mat44 const& modelMatrix, Vec3 const& referencePointLocal, int firstIndex)
+{
+	Vec3 pointALocal = m_asset->m_cpuMesh->m_vertexes[m_asset->m_cpuMesh->m_indexes[firstIndex]].m_position;
+	Vec3 pointBLocal = m_asset->m_cpuMesh->m_vertexes[m_asset->m_cpuMesh->m_indexes[firstIndex + 1]].m_position;
+	Vec3 pointCLocal = m_asset->m_cpuMesh->m_vertexes[m_asset->m_cpuMesh->m_indexes[firstIndex + 2]].m_position;
+
+	if (pointALocal == pointBLocal || pointALocal == pointCLocal || pointBLocal == pointCLocal)
+	{
+		return false;
+	}
+
+	Vec3 triNearestLocalPoint = GetNearestPointOnTriangle3D(referencePointLocal, pointALocal, pointBLocal, pointCLocal);
+
+	if (triNearestLocalPoint.x != triNearestLocalPoint.x)
+	{
+		return false;
+	}
+
+	Vec3 triNearestPoint = modelMatrix.TransformPosition3D(triNearestLocalPoint);
+
+	bool wasPlayerPushedByTri = PushSphereOutOfFixedPoint3D(player->m_position, player->m_collisionRadius, triNearestPoint);
+	if (wasPlayerPushedByTri)
+	{
+		Vec3 pointA = modelMatrix.TransformPosition3D(pointALocal);
+		Vec3 pointB = modelMatrix.TransformPosition3D(pointBLocal);
+		Vec3 pointC = modelMatrix.TransformPosition3D(pointCLocal);
+		ReactToPush(player, triNearestPoint, CrossProduct3D(pointB - pointA, pointC - pointA));
+	}
+
+	return wasPlayerPushedByTri;
+}
+
+
+bool Model::PushPlayerOutOfTrisNearPoint(Player* player, Mat44 const& modelMatrix, Vec3 const& referencePointLocal, std::vector<int>& nearbyTriScratch)
+{
+	//each tri's nearest point is taken from the reference point, but the player is pushed away from it from wherever earlier pushes left them
+	//so tris are searched for one extra collision radius around the reference point, and the search is widened whenever the pushes carry the player further than that
+	//tris are resolved in index order, the same order as the brute force loop, so this touches exactly the tris that loop would
+	Vec3 startPosition = player->m_position;
+	float searchMargin = player->m_collisionRadius;
+	nearbyTriScratch.clear();
+	m_asset->m_triangleBVH.QuerySphere(referencePointLocal, (player->m_collisionRadius + searchMargin) / m_scale, nearbyTriScratch);
+	std::sort(nearbyTriScratch.begin(), nearbyTriScratch.end());
+
+	bool wasPlayerPushed = false;
+	for (int nearbyIndex = 0; nearbyIndex < nearbyTriScratch.size(); nearbyIndex++)
+	{
+		int triIndex = nearbyTriScratch[nearbyIndex];
+		if (PushPlayerOutOfTri(player, modelMatrix, referencePointLocal, m_asset->m_triangleFirstIndexes[triIndex]))
 		{
 			wasPlayerPushed = true;
-			Vec3 pushDirection = triNearestPoint - player->m_position;
-			pushDirection.Normalize();
-			//if surface is ground, player becomes grounded
-			if (DotProduct3D(pushDirection, -player->m_orientation.GetKBasis3D()) > GROUNDED_THRESHOLD)
-			{
-				player->BecomeGrounded();
-			}
-			//if surface is wall, player begins wall slide
-			else if (DotProduct3D(pushDirection, player->m_orientation.GetIBasis3D()) > WALL_THRESHOLD && !player->m_isGrounded)
+
+			float pushDistance = GetDistance3D(startPosition, player->m_position);
+			if (pushDistance > searchMargin)
 			{
-				Vec3 pointA = GetModelMatrix().TransformPosition3D(pointALocal);
-				Vec3 pointB = GetModelMatrix().TransformPosition3D(pointBLocal);
-				Vec3 pointC = GetModelMatrix().TransformPosition3D(pointCLocal);
-				Vec3 triNormal = CrossProduct3D(pointB - pointA, pointC - pointA);
-				player->StartWallSlide(triNormal);
+				searchMargin = pushDistance + player->m_collisionRadius;
+				nearbyTriScratch.clear();
+				m_asset->m_triangleBVH.QuerySphere(referencePointLocal, (player->m_collisionRadius + searchMargin) / m_scale, nearbyTriScratch);
+				std::sort(nearbyTriScratch.begin(), nearbyTriScratch.end());
+				nearbyIndex = static_cast<int>(std::upper_bound(nearbyTriScratch.begin(), nearbyTriScratch.end(), triIndex) - nearbyTriScratch.begin()) - 1;
 			}
 		}
 	}
 
 	return wasPlayerPushed;
 }
+
+
+bool Model::PushPlayerOutOfGridPoint(Player* player, Mat44 const& modelMatrix, Vec3 const& nearestLocalPoint)
+{
+	Vec3 nearestPoint = modelMatrix.TransformPosition3D(nearestLocalPoint);
+
+	bool wasPlayerPushed = PushSphereOutOfFixedPoint3D(player->m_position, player->m_collisionRadius, nearestPoint);
+	if (wasPlayerPushed)
+	{
+		//the grid has no triangles, so the surface normal is taken as pointing from the surface back to the player
+		ReactToPush(player, nearestPoint, player->m_position - nearestPoint);
+	}
+
+	return wasPlayerPushed;
+}
+
+
+void Model::ReactToPush(Player* player, Vec3 const& pushPoint, Vec3 const& wallNormal)
+{
+	Vec3 pushDirection = pushPoint - player->m_position;
+	pushDirection.Normalize();
+	//if surface is ground, player becomes grounded
+	if (DotProduct3D(pushDirection, -player->m_orientation.GetKBasis3D()) > GROUNDED_THRESHOLD)
+	{
+		player->BecomeGrounded();
+	}
+	//if surface is wall, player begins wall slide
+	else if (DotProduct3D(pushDirection, player->m_orientation.GetIBasis3D()) > WALL_THRESHOLD && !player->m_isGrounded)
+	{
+		player->StartWallSlide(wallNormal);
+	}
+}
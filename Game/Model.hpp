@@ -2,17 +2,26 @@
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Core/Rgba8.hpp"
 #include "Engine/Math/EulerAngles.hpp"
+#include "Engine/Math/AABB3.hpp"
+#include "Engine/Math/Mat44.hpp"
+#include "Game/ModelAsset.hpp"
 
 
 //forward declarations
-class CPUMesh;
-class GPUMesh;
-class Shader;
-struct Mat44;
 struct Vec3;
 class Player;
 
 
+//enums
+enum ModelQueryMode
+{
+	MODEL_QUERY_EXACT = 0,	//triangle bvh
+	MODEL_QUERY_GRID,		//closest point grid lookup, exact outside the grid's band
+	MODEL_QUERY_HYBRID,		//grid lookup to bound the exact triangle bvh search
+	NUM_MODEL_QUERY_MODES
+};
+
+
 class Model
 {
 //public member functions
@@ -20,23 +29,49 @@ public:
 	Model(Vec3 position, float scale, EulerAngles orientation, Rgba8 color);
 	~Model();
 	
-	//model creation and rendering
-	bool ParseXMLFileForOBJ(std::string const& fileName);
+	//model creation and rendering, models loading the same xml share one asset
+	//a background load returns straight away, and the model neither renders nor collides until IsReady
+	bool ParseXMLFileForOBJ(std::string const& fileName, bool loadInBackground = false);
+	bool IsReady() const { return m_asset != nullptr && m_asset->IsReady(); }
+#if !defined(GAME_HEADLESS)
 	void RenderGPUMesh(Vec3 sunDirection, float sunIntensity, float ambientIntensity) const;
+#endif
 
 	//game-centric model functions
-	Mat44 GetModelMatrix() const;
-	Vec3 GetNearestPointOnModel(Vec3 const& referencePoint) const;
-	bool PushPlayerOutOfAllTrisOnModel(Player* player);
+	Mat44 const& GetModelMatrix() const { return m_modelMatrix; }
+	Mat44 const& GetInverseModelMatrix() const { return m_inverseModelMatrix; }
+	void		 SetPosition(Vec3 const& position);
+	void		 SetOrientation(EulerAngles const& orientation);
+	Vec3 GetNearestPointOnModel(Vec3 const& referencePoint, ModelQueryMode queryMode = MODEL_QUERY_EXACT) const;
+	bool PushPlayerOutOfAllTrisOnModel(Player* player, std::vector<int>& nearbyTriScratch, ModelQueryMode queryMode = MODEL_QUERY_EXACT);
+	void BakeClosestPointGrid(float cellSize = CLOSEST_POINT_GRID_DEFAULT_CELL_SIZE, float bandWidth = CLOSEST_POINT_GRID_DEFAULT_BAND_WIDTH);	//only bakes if the asset has no grid at this resolution yet
+
+	//reference versions that check every triangle, kept for benchmarking the triangle bvh
+	Vec3 GetNearestPointOnModelBruteForce(Vec3 const& referencePoint) const;
+	bool PushPlayerOutOfAllTrisOnModelBruteForce(Player* player);
+
+//private member functions
+private:
+	void UpdateModelMatrices();
+	bool PushPlayerOutOfTri(Player* player, Mat44 const& modelMatrix, Vec3 const& referencePointLocal, int firstIndex);
+	bool PushPlayerOutOfTrisNearPoint(Player* player, Mat44 const& modelMatrix, Vec3 const& referencePointLocal, std::vector<int>& nearbyTriScratch);
+	bool PushPlayerOutOfGridPoint(Player* player, Mat44 const& modelMatrix, Vec3 const& nearestLocalPoint);
+	void ReactToPush(Player* player, Vec3 const& pushPoint, Vec3 const& wallNormal);
 
 //public member variables
 public:
-	CPUMesh* m_cpuMesh = nullptr;
-	GPUMesh* m_gpuMesh = nullptr;
-	Shader*  m_shader = nullptr;
+	//shared mesh, triangle bvh and closest point grids, null until an xml is parsed and still loading until IsReady
+	ModelAsset* m_asset = nullptr;
+	ClosestPointGrid const* m_closestPointGrid = nullptr;	//the asset's grid at this model's resolution, grid and hybrid queries fall back to exact without one
 
+	//change through SetPosition and SetOrientation so the cached matrices stay in sync
 	Vec3	 m_position = Vec3();
 	float	 m_scale = 1.0f;
 	Rgba8	 m_color = Rgba8();
 	EulerAngles m_orientation = EulerAngles();
+
+//private member variables
+private:
+	Mat44 m_modelMatrix;
+	Mat44 m_inverseModelMatrix;
 };
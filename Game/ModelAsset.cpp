@@ -0,0 +1,370 @@
+#include "Game/ModelAsset.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/ModelMeshCache.hpp"
+#include "Game/JobSystem.hpp"
+#include "Engine/Renderer/CPUMesh.hpp"
+#include "Engine/Core/OBJLoader.hpp"
+#include "Engine/Core/XmlUtils.hpp"
+#include "Engine/Math/Mat44.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <thread>
+
+
+//
+//local registry state
+//
+//the mutex covers the map, the upload list and every state change a worker can race with
+static std::mutex						   s_registryMutex;
+static std::map<std::string, ModelAsset*> s_modelAssets;
+static std::vector<ModelAsset*>			   s_assetsAwaitingUpload;
+static JobSystem*						   s_assetJobSystem = nullptr;
+static int s_numAssetLoads = 0;
+static int s_numAssetHits = 0;
+
+
+//runs on a worker for background loads, an asset released while it was loading is deleted here since nothing else can reach it
+static void LoadModelAsset(ModelAsset* asset)
+{
+	bool wasLoaded = asset->LoadFromXML(asset->m_xmlFilePath);
+
+	std::lock_guard<std::mutex> registryLock(s_registryMutex);
+	if (asset->m_refCount <= 0)
+	{
+		delete asset;
+		return;
+	}
+
+	asset->m_state = wasLoaded ? MODEL_ASSET_LOADED : MODEL_ASSET_FAILED;
+	if (wasLoaded)
+	{
+		s_assetsAwaitingUpload.emplace_back(asset);
+	}
+}
+
+
+//
+//constructor and destructor
+//
+ModelAsset::ModelAsset()
+{
+	m_cpuMesh = new CPUMesh();
+}
+
+
+ModelAsset::~ModelAsset()
+{
+	if (m_cpuMesh != nullptr)
+	{
+		delete m_cpuMesh;
+	}
+
+#if !defined(GAME_HEADLESS)
+	DestroyGPUMesh();
+#endif
+}
+
+
+//
+//asset creation
+//
+bool ModelAsset::LoadFromXML(std::string const& fileName)
+{
+	//parse xml for obj file name and fixup matrix
+	XmlDocument modelXml;
+	XmlError result = modelXml.LoadFile(fileName.c_str());
+	if (result != tinyxml2::XML_SUCCESS)
+	{
+		ERROR_RECOVERABLE("Failed to open model xml file!");
+		return false;
+	}
+	XmlElement* rootElement = modelXml.RootElement();
+	if (rootElement == nullptr)
+	{
+		ERROR_RECOVERABLE("Failed to read model xml root element!");
+		return false;
+	}
+	
+	std::string const& objFilePath = ParseXmlAttribute(*rootElement, "path", "invalid path");
+	m_shaderName = ParseXmlAttribute(*rootElement, "shader", "invalid shader path");
+	if (m_shaderName == "invalid shader path")
+	{
+		ERROR_RECOVERABLE("Couldn't find shader in xml!");
+		return false;
+	}
+
+	XmlElement* transformElement = rootElement->FirstChildElement();
+	Mat44 matrix = Mat44();
+	Vec3 iBasis = ParseXmlAttribute(*transformElement, "x", Vec3());
+	Vec3 jBasis = ParseXmlAttribute(*transformElement, "y", Vec3());
+	Vec3 kBasis = ParseXmlAttribute(*transformElement, "z", Vec3());
+	Vec3 translation = ParseXmlAttribute(*transformElement, "t", Vec3());
+	matrix.SetIJKT3D(iBasis, jBasis, kBasis, translation);
+	matrix.AppendScaleUniform3D(ParseXmlAttribute(*transformElement, "scale", 1.0f));
+
+	//the binary cache already holds the transformed mesh, bounds and triangle bvh, so the obj is only parsed when it's missing or stale
+	std::string cacheFilePath = GetModelMeshCachePath(fileName);
+	uint64_t cacheSourceKey = GetModelMeshCacheSourceKey(fileName, objFilePath);
+	if (!ReadModelMeshCache(*this, cacheFilePath, cacheSourceKey))
+	{
+		//pass into obj loader along with vertex and index vectors from cpu mesh
+		OBJLoader::LoadObjFile(objFilePath, matrix, m_cpuMesh->m_vertexes, m_cpuMesh->m_indexes);
+
+		//local bounds for broad phase culling
+		if (m_cpuMesh->m_vertexes.size() > 0)
+		{
+			m_localBounds = AABB3(m_cpuMesh->m_vertexes[0].m_position, m_cpuMesh->m_vertexes[0].m_position);
+			for (int vertIndex = 1; vertIndex < m_cpuMesh->m_vertexes.size(); vertIndex++)
+			{
+				BoundingVolumeHierarchy::StretchToIncludePoint3D(m_localBounds, m_cpuMesh->m_vertexes[vertIndex].m_position);
+			}
+		}
+
+		BuildTriangleBVH();
+		WriteModelMeshCache(*this, cacheFilePath, cacheSourceKey);
+	}
+
+	return true;
+}
+
+
+//
+//local space queries
+//
+bool ModelAsset::GetNearestLocalPointOnModel(Vec3 const& referencePointLocal, Vec3& out_nearestLocalPoint, float maxDistanceSquared) const
+{
+	float nearestLocalPointDistSq = maxDistanceSquared;
+	int nearestTri = m_triangleBVH.QueryNearest(referencePointLocal, [this, &referencePointLocal](int triIndex)
+		{
+			int firstIndex = m_triangleFirstIndexes[triIndex];
+			Vec3 triNearestLocalPoint = GetNearestPointOnTriangle3D(referencePointLocal, m_cpuMesh->m_vertexes[m_cpuMesh->m_indexes[firstIndex]].m_position,
+				m_cpuMesh->m_vertexes[m_cpuMesh->m_indexes[firstIndex + 1]].m_position, m_cpuMesh->m_vertexes[m_cpuMesh->m_indexes[firstIndex + 2]].m_position);
+			return GetDistanceSquared3D(triNearestLocalPoint, referencePointLocal);
+		}, nearestLocalPointDistSq);
+
+	if (nearestTri < 0)
+	{
+		return false;
+	}
+
+	int firstIndex = m_triangleFirstIndexes[nearestTri];
+	out_nearestLocalPoint = GetNearestPointOnTriangle3D(referencePointLocal, m_cpuMesh->m_vertexes[m_cpuMesh->m_indexes[firstIndex]].m_position,
+		m_cpuMesh->m_vertexes[m_cpuMesh->m_indexes[firstIndex + 1]].m_position, m_cpuMesh->m_vertexes[m_cpuMesh->m_indexes[firstIndex + 2]].m_position);
+
+	return true;
+}
+
+
+ClosestPointGrid const* ModelAsset::GetClosestPointGrid(float cellSize, float bandWidth) const
+{
+	std::map<std::pair<float, float>, ClosestPointGrid>::const_iterator found = m_closestPointGrids.find(std::make_pair(cellSize, bandWidth));
+	return (found != m_closestPointGrids.end()) ? &found->second : nullptr;
+}
+
+
+ClosestPointGrid const* ModelAsset::BakeClosestPointGrid(float cellSize, float bandWidth)
+{
+	ClosestPointGrid const* bakedGrid = GetClosestPointGrid(cellSize, bandWidth);
+	if (bakedGrid != nullptr)
+	{
+		return bakedGrid;
+	}
+
+	//map entries never move, so models can hold on to the grid
+	ClosestPointGrid& grid = m_closestPointGrids[std::make_pair(cellSize, bandWidth)];
+	grid.Bake(*this, cellSize, bandWidth);
+	return &grid;
+}
+
+
+//
+//private asset functions
+//
+void ModelAsset::BuildTriangleBVH()
+{
+	m_triangleFirstIndexes.clear();
+
+	std::vector<AABB3> triBounds;
+	triBounds.reserve(m_cpuMesh->m_indexes.size() / 3);
+	m_triangleFirstIndexes.reserve(m_cpuMesh->m_indexes.size() / 3);
+	for (int vertIndex = 0; vertIndex + 2 < m_cpuMesh->m_indexes.size(); vertIndex += 3)
+	{
+		Vec3 pointALocal = m_cpuMesh->m_vertexes[m_cpuMesh->m_indexes[vertIndex]].m_position;
+		Vec3 pointBLocal = m_cpuMesh->m_vertexes[m_cpuMesh->m_indexes[vertIndex + 1]].m_position;
+		Vec3 pointCLocal = m_cpuMesh->m_vertexes[m_cpuMesh->m_indexes[vertIndex + 2]].m_position;
+
+		//degenerate tris never push the player, so leave them out of the tree
+		if (pointALocal == pointBLocal || pointALocal == pointCLocal || pointBLocal == pointCLocal)
+		{
+			continue;
+		}
+
+		AABB3 bounds = AABB3(pointALocal, pointALocal);
+		BoundingVolumeHierarchy::StretchToIncludePoint3D(bounds, pointBLocal);
+		BoundingVolumeHierarchy::StretchToIncludePoint3D(bounds, pointCLocal);
+		triBounds.emplace_back(bounds);
+		m_triangleFirstIndexes.emplace_back(vertIndex);
+	}
+
+	m_triangleBVH.Build(triBounds);
+}
+
+
+//
+//registry functions
+//
+ModelAsset* AcquireModelAsset(std::string const& xmlFilePath, bool loadInBackground)
+{
+	//headless tools never set a job system, so their prefabs are ready as soon as they're constructed
+	loadInBackground = loadInBackground && s_assetJobSystem != nullptr;
+
+	ModelAsset* asset = nullptr;
+	bool isNewAsset = false;
+	{
+		std::lock_guard<std::mutex> registryLock(s_registryMutex);
+		auto found = s_modelAssets.find(xmlFilePath);
+		if (found != s_modelAssets.end())
+		{
+			asset = found->second;
+			asset->m_refCount++;
+			s_numAssetHits++;
+		}
+		else
+		{
+			//a file that fails to load still gets an empty asset, so the models using it collide with nothing instead of crashing
+			asset = new ModelAsset();
+			asset->m_xmlFilePath = xmlFilePath;
+			asset->m_refCount = 1;
+			s_modelAssets[xmlFilePath] = asset;
+			s_numAssetLoads++;
+			isNewAsset = true;
+		}
+	}
+
+	if (isNewAsset)
+	{
+		if (loadInBackground)
+		{
+			s_assetJobSystem->SubmitBackgroundJob([asset]() { LoadModelAsset(asset); });
+		}
+		else
+		{
+			LoadModelAsset(asset);
+		}
+	}
+
+	//the asset might already be loading in the background for someone else, so this can wait on a worker
+	while (!loadInBackground && !asset->IsDoneLoading())
+	{
+		if (FinishModelAssetLoads() == 0)
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	return asset;
+}
+
+
+void ReleaseModelAsset(ModelAsset* asset)
+{
+	if (asset == nullptr)
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> registryLock(s_registryMutex);
+		auto found = s_modelAssets.find(asset->m_xmlFilePath);
+		if (found == s_modelAssets.end() || found->second != asset)
+		{
+			ERROR_RECOVERABLE("Released a model asset that isn't in the registry!");
+			return;
+		}
+
+		asset->m_refCount--;
+		if (asset->m_refCount > 0)
+		{
+			return;
+		}
+
+		s_modelAssets.erase(found);
+		s_assetsAwaitingUpload.erase(std::remove(s_assetsAwaitingUpload.begin(), s_assetsAwaitingUpload.end(), asset), s_assetsAwaitingUpload.end());
+
+		//the worker loading it deletes it once it's done
+		if (asset->m_state == MODEL_ASSET_LOADING)
+		{
+			return;
+		}
+	}
+
+	delete asset;
+}
+
+
+ModelAssetStats GetModelAssetStats()
+{
+	std::lock_guard<std::mutex> registryLock(s_registryMutex);
+
+	ModelAssetStats stats;
+	stats.m_numAssets = static_cast<int>(s_modelAssets.size());
+	stats.m_numLoads = s_numAssetLoads;
+	stats.m_numHits = s_numAssetHits;
+	for (auto assetIter = s_modelAssets.begin(); assetIter != s_modelAssets.end(); assetIter++)
+	{
+		if (!assetIter->second->IsDoneLoading())
+		{
+			stats.m_numLoading++;
+		}
+	}
+
+	return stats;
+}
+
+
+//
+//background loading functions
+//
+void SetModelAssetJobSystem(JobSystem* jobSystem)
+{
+	s_assetJobSystem = jobSystem;
+}
+
+
+int FinishModelAssetLoads()
+{
+	std::vector<ModelAsset*> finishedAssets;
+	{
+		std::lock_guard<std::mutex> registryLock(s_registryMutex);
+		finishedAssets.swap(s_assetsAwaitingUpload);
+	}
+
+	//the renderer is only touched here on the main thread, assets can't be released while this runs since that's main thread only too
+	for (int assetIndex = 0; assetIndex < finishedAssets.size(); assetIndex++)
+	{
+#if !defined(GAME_HEADLESS)
+		finishedAssets[assetIndex]->CreateGPUMesh();
+#endif
+		finishedAssets[assetIndex]->m_state = MODEL_ASSET_READY;
+	}
+
+	return static_cast<int>(finishedAssets.size());
+}
+
+
+int WaitForModelAssetLoads()
+{
+	int numFinished = 0;
+	while (true)
+	{
+		numFinished += FinishModelAssetLoads();
+		if (GetModelAssetStats().m_numLoading == 0)
+		{
+			return numFinished;
+		}
+
+		std::this_thread::yield();
+	}
+}
@@ -0,0 +1,103 @@
+#pragma once
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Math/AABB3.hpp"
+#include "Game/BoundingVolumeHierarchy.hpp"
+#include "Game/ClosestPointGrid.hpp"
+#include <atomic>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+//forward declarations
+class CPUMesh;
+class GPUMesh;
+class Shader;
+class JobSystem;
+
+
+//enums
+enum ModelAssetState
+{
+	MODEL_ASSET_LOADING = 0,	//parsing and building the bvh, on a worker when loaded in the background
+	MODEL_ASSET_LOADED,			//cpu side done, waiting for the main thread to upload it
+	MODEL_ASSET_READY,
+	MODEL_ASSET_FAILED,			//stays empty, so models using it never render or collide
+	NUM_MODEL_ASSET_STATES
+};
+
+
+//everything about a prefab that doesn't depend on where it's placed, loaded once per xml and shared by every model using it
+//treated as read only once loaded, except the closest point grids which are each baked the first time a model asks for their resolution
+class ModelAsset
+{
+//public member functions
+public:
+	ModelAsset();
+	~ModelAsset();
+
+	//asset creation, loading only touches the cpu side so it can run on any thread
+	bool LoadFromXML(std::string const& fileName);
+#if !defined(GAME_HEADLESS)
+	void CreateGPUMesh();
+	void DestroyGPUMesh();
+#endif
+
+	//only read the mesh, bvh and grid once this is true
+	bool IsReady() const { return m_state == MODEL_ASSET_READY; }
+	bool IsDoneLoading() const { return m_state == MODEL_ASSET_READY || m_state == MODEL_ASSET_FAILED; }
+
+	//local space queries
+	bool GetNearestLocalPointOnModel(Vec3 const& referencePointLocal, Vec3& out_nearestLocalPoint, float maxDistanceSquared = FLT_MAX) const;
+
+	//grids are kept per resolution, so baking one for a model never changes the grid another model queries through
+	ClosestPointGrid const* GetClosestPointGrid(float cellSize, float bandWidth) const;
+	ClosestPointGrid const* BakeClosestPointGrid(float cellSize = CLOSEST_POINT_GRID_DEFAULT_CELL_SIZE, float bandWidth = CLOSEST_POINT_GRID_DEFAULT_BAND_WIDTH);
+
+//private member functions
+private:
+	void BuildTriangleBVH();
+
+//public member variables
+public:
+	std::string m_xmlFilePath;
+	int			m_refCount = 0;
+	std::atomic<ModelAssetState> m_state{ MODEL_ASSET_LOADING };
+
+	CPUMesh* m_cpuMesh = nullptr;
+	GPUMesh* m_gpuMesh = nullptr;	//only created outside headless builds
+	Shader*  m_shader = nullptr;
+	std::string m_shaderName;
+	AABB3	 m_localBounds = AABB3(Vec3(), Vec3());
+
+	//local space triangle tree, item i is the triangle starting at m_cpuMesh->m_indexes[m_triangleFirstIndexes[i]]
+	BoundingVolumeHierarchy m_triangleBVH;
+	std::vector<int>		m_triangleFirstIndexes;
+
+	//optional, only baked for prefabs that query in grid or hybrid mode, keyed by cell size then band width and kept until the asset is deleted
+	std::map<std::pair<float, float>, ClosestPointGrid> m_closestPointGrids;
+};
+
+
+//assets currently registered, how many of them are still loading, and how many acquires loaded a file versus reused one
+struct ModelAssetStats
+{
+	int m_numAssets = 0;
+	int m_numLoading = 0;
+	int m_numLoads = 0;
+	int m_numHits = 0;
+};
+
+
+//registry functions, assets are keyed by xml path and deleted when their last model releases them
+//acquiring in the background returns straight away with the asset still loading, otherwise it waits until the asset is ready
+//acquire, release, finish and wait are all main thread only
+ModelAsset*		AcquireModelAsset(std::string const& xmlFilePath, bool loadInBackground = false);
+void			ReleaseModelAsset(ModelAsset* asset);
+ModelAssetStats GetModelAssetStats();
+
+//background loading, without a job system every acquire waits for its load
+void SetModelAssetJobSystem(JobSystem* jobSystem);
+int	 FinishModelAssetLoads();
+int	 WaitForModelAssetLoads();
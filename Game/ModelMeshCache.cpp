@@ -0,0 +1,400 @@
+#include "Game/ModelMeshCache.hpp"
+#include "Game/ModelAsset.hpp"
+#include "Game/MeshUploader.hpp"
+#include "Game/BinaryFileUtils.hpp"
+#include "Engine/Renderer/CPUMesh.hpp"
+#include "Engine/Core/FileUtils.hpp"
+#include <atomic>
+#include <filesystem>
+#include <string.h>
+#include <vector>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+//
+//local constants and helpers
+//
+static char const MODEL_MESH_CACHE_MAGIC[4] = { 'G', 'F', 'M', 'C' };
+
+static std::atomic<bool> s_isModelMeshCacheEnabled = true;
+static std::atomic<int>	 s_numCacheHits = 0;
+static std::atomic<int>	 s_numCacheMisses = 0;
+static std::atomic<int>	 s_numCacheWrites = 0;
+
+
+//fixed size front of every cache file, the arrays follow in the order of their counts
+struct ModelMeshCacheHeader
+{
+	char		 m_magic[4] = {};
+	unsigned int m_version = 0;
+	uint64_t	 m_sourceKey = 0;
+
+	//layouts are copied as is, so a changed struct has to miss the cache
+	unsigned int m_vertexBytes = 0;
+	unsigned int m_nodeBytes = 0;
+
+	unsigned int m_numVertexes = 0;
+	unsigned int m_numIndexes = 0;
+	unsigned int m_numNodes = 0;
+	unsigned int m_numItemIndexes = 0;
+	unsigned int m_numItemBounds = 0;
+	unsigned int m_numTriangleFirstIndexes = 0;
+	AABB3		 m_localBounds = AABB3(Vec3(), Vec3());
+};
+
+
+//read only view of a whole file, unmapped when it goes out of scope
+class MappedFile
+{
+public:
+	explicit MappedFile(std::string const& filePath);
+	~MappedFile();
+
+	uint8_t const* m_data = nullptr;
+	size_t		   m_numBytes = 0;
+
+private:
+#if defined(_WIN32)
+	HANDLE m_fileHandle = INVALID_HANDLE_VALUE;
+	HANDLE m_mappingHandle = nullptr;
+#else
+	int m_fileDescriptor = -1;
+#endif
+};
+
+
+#if defined(_WIN32)
+MappedFile::MappedFile(std::string const& filePath)
+{
+	m_fileHandle = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (m_fileHandle == INVALID_HANDLE_VALUE)
+	{
+		return;
+	}
+
+	LARGE_INTEGER fileSize = {};
+	if (!GetFileSizeEx(m_fileHandle, &fileSize) || fileSize.QuadPart == 0)
+	{
+		return;
+	}
+
+	m_mappingHandle = CreateFileMappingA(m_fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (m_mappingHandle == nullptr)
+	{
+		return;
+	}
+
+	m_data = static_cast<uint8_t const*>(MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 0, 0, 0));
+	m_numBytes = (m_data != nullptr) ? static_cast<size_t>(fileSize.QuadPart) : 0;
+}
+
+
+MappedFile::~MappedFile()
+{
+	if (m_data != nullptr)		  UnmapViewOfFile(m_data);
+	if (m_mappingHandle != nullptr) CloseHandle(m_mappingHandle);
+	if (m_fileHandle != INVALID_HANDLE_VALUE) CloseHandle(m_fileHandle);
+}
+#else
+MappedFile::MappedFile(std::string const& filePath)
+{
+	m_fileDescriptor = open(filePath.c_str(), O_RDONLY);
+	if (m_fileDescriptor < 0)
+	{
+		return;
+	}
+
+	struct stat fileStats = {};
+	if (fstat(m_fileDescriptor, &fileStats) != 0 || fileStats.st_size == 0)
+	{
+		return;
+	}
+
+	void* mapping = mmap(nullptr, static_cast<size_t>(fileStats.st_size), PROT_READ, MAP_PRIVATE, m_fileDescriptor, 0);
+	if (mapping == MAP_FAILED)
+	{
+		return;
+	}
+
+	m_data = static_cast<uint8_t const*>(mapping);
+	m_numBytes = static_cast<size_t>(fileStats.st_size);
+}
+
+
+MappedFile::~MappedFile()
+{
+	if (m_data != nullptr)	   munmap(const_cast<uint8_t*>(m_data), m_numBytes);
+	if (m_fileDescriptor >= 0) close(m_fileDescriptor);
+}
+#endif
+
+
+//copies the next array out of the mapping, false once it would run past the end
+template <typename T>
+static bool ParseArray(MappedFile const& file, size_t& offset, std::vector<T>& out_array, unsigned int numElements)
+{
+	size_t numBytes = static_cast<size_t>(numElements) * sizeof(T);
+	if (numBytes > file.m_numBytes - offset)
+	{
+		return false;
+	}
+
+	out_array.resize(numElements);
+	if (numBytes > 0)
+	{
+		memcpy(out_array.data(), file.m_data + offset, numBytes);
+	}
+	offset += numBytes;
+	return true;
+}
+
+
+//a file with the right byte counts can still be damaged, so every index collision follows is range checked before it's trusted
+static bool AreMeshCacheContentsValid(std::vector<Vertex_PCUTBN> const& vertexes, std::vector<unsigned int> const& indexes, std::vector<BVHNode> const& nodes,
+	std::vector<int> const& itemIndexes, std::vector<AABB3> const& itemBounds, std::vector<int> const& triangleFirstIndexes)
+{
+	for (int indexIndex = 0; indexIndex < indexes.size(); indexIndex++)
+	{
+		if (indexes[indexIndex] >= vertexes.size())
+		{
+			return false;
+		}
+	}
+
+	//the bvh's items are the triangles, one box each
+	if (itemBounds.size() != triangleFirstIndexes.size() || itemIndexes.size() != itemBounds.size())
+	{
+		return false;
+	}
+
+	for (int triIndex = 0; triIndex < triangleFirstIndexes.size(); triIndex++)
+	{
+		int firstIndex = triangleFirstIndexes[triIndex];
+		if (firstIndex < 0 || static_cast<size_t>(firstIndex) + 3 > indexes.size())
+		{
+			return false;
+		}
+	}
+
+	for (int itemIndex = 0; itemIndex < itemIndexes.size(); itemIndex++)
+	{
+		if (itemIndexes[itemIndex] < 0 || itemIndexes[itemIndex] >= itemBounds.size())
+		{
+			return false;
+		}
+	}
+
+	//nodes are built parent first, so children always come later and the tree can't loop back on itself
+	//depth is checked too, the queries only have a fixed size stack to walk it with
+	std::vector<int> nodeDepths;
+	nodeDepths.resize(nodes.size(), 0);
+	for (int nodeIndex = 0; nodeIndex < nodes.size(); nodeIndex++)
+	{
+		BVHNode const& node = nodes[nodeIndex];
+		if (node.IsLeaf())
+		{
+			if (node.m_firstItem < 0 || node.m_numItems < 0 || static_cast<size_t>(node.m_firstItem) + static_cast<size_t>(node.m_numItems) > itemIndexes.size())
+			{
+				return false;
+			}
+			continue;
+		}
+
+		if (node.m_leftChild <= nodeIndex || node.m_leftChild >= nodes.size() || node.m_rightChild <= nodeIndex || node.m_rightChild >= nodes.size())
+		{
+			return false;
+		}
+
+		int childDepth = nodeDepths[nodeIndex] + 1;
+		if (childDepth >= BVH_MAX_TRAVERSAL_DEPTH / 2)
+		{
+			return false;
+		}
+		nodeDepths[node.m_leftChild] = childDepth;
+		nodeDepths[node.m_rightChild] = childDepth;
+	}
+
+	return true;
+}
+
+
+//
+//cache key functions
+//
+std::string GetModelMeshCachePath(std::string const& xmlFilePath)
+{
+	size_t extensionStart = xmlFilePath.find_last_of('.');
+	size_t folderEnd = xmlFilePath.find_last_of("/\\");
+	if (extensionStart == std::string::npos || (folderEnd != std::string::npos && extensionStart < folderEnd))
+	{
+		return xmlFilePath + ".meshcache";
+	}
+
+	return xmlFilePath.substr(0, extensionStart) + ".meshcache";
+}
+
+
+uint64_t GetModelMeshCacheSourceKey(std::string const& xmlFilePath, std::string const& objFilePath)
+{
+	//the xml is small and holds the fixup transform, so all of it goes into the key
+	std::vector<uint8_t> xmlBytes;
+	FileReadToBuffer(xmlBytes, xmlFilePath);
+	uint64_t sourceKey = HashBytes64(xmlBytes.data(), xmlBytes.size());
+
+	//the obj is what the cache saves parsing, so only its size and write time are checked
+	std::error_code error;
+	uint64_t objNumBytes = static_cast<uint64_t>(std::filesystem::file_size(objFilePath, error));
+	if (error)
+	{
+		objNumBytes = 0;
+	}
+	int64_t objWriteTime = static_cast<int64_t>(std::filesystem::last_write_time(objFilePath, error).time_since_epoch().count());
+	if (error)
+	{
+		objWriteTime = 0;
+	}
+
+	sourceKey = HashBytes64(&objNumBytes, sizeof(objNumBytes), sourceKey);
+	sourceKey = HashBytes64(&objWriteTime, sizeof(objWriteTime), sourceKey);
+	sourceKey = HashBytes64(&MODEL_MESH_CACHE_VERSION, sizeof(MODEL_MESH_CACHE_VERSION), sourceKey);
+	return sourceKey;
+}
+
+
+//
+//file functions
+//
+bool ReadModelMeshCache(ModelAsset& out_model, std::string const& cacheFilePath, uint64_t sourceKey)
+{
+	if (!s_isModelMeshCacheEnabled)
+	{
+		return false;
+	}
+
+	MappedFile file = MappedFile(cacheFilePath);
+	ModelMeshCacheHeader header;
+	if (file.m_data == nullptr || file.m_numBytes < sizeof(header))
+	{
+		s_numCacheMisses++;
+		return false;
+	}
+
+	memcpy(&header, file.m_data, sizeof(header));
+	if (memcmp(header.m_magic, MODEL_MESH_CACHE_MAGIC, sizeof(header.m_magic)) != 0 || header.m_version != MODEL_MESH_CACHE_VERSION || header.m_sourceKey != sourceKey ||
+		header.m_vertexBytes != sizeof(Vertex_PCUTBN) || header.m_nodeBytes != sizeof(BVHNode))
+	{
+		s_numCacheMisses++;
+		return false;
+	}
+
+	//read into locals first, so a truncated or damaged file leaves the model as it was
+	std::vector<Vertex_PCUTBN> vertexes;
+	std::vector<unsigned int>  indexes;
+	std::vector<BVHNode>	   nodes;
+	std::vector<int>		   itemIndexes;
+	std::vector<AABB3>		   itemBounds;
+	std::vector<int>		   triangleFirstIndexes;
+
+	size_t offset = sizeof(header);
+	bool isValid = ParseArray(file, offset, vertexes, header.m_numVertexes) && ParseArray(file, offset, indexes, header.m_numIndexes) &&
+		ParseArray(file, offset, nodes, header.m_numNodes) && ParseArray(file, offset, itemIndexes, header.m_numItemIndexes) &&
+		ParseArray(file, offset, itemBounds, header.m_numItemBounds) && ParseArray(file, offset, triangleFirstIndexes, header.m_numTriangleFirstIndexes) &&
+		AreMeshCacheContentsValid(vertexes, indexes, nodes, itemIndexes, itemBounds, triangleFirstIndexes);
+	if (!isValid)
+	{
+		s_numCacheMisses++;
+		return false;
+	}
+
+	out_model.m_cpuMesh->m_vertexes.swap(vertexes);
+	out_model.m_cpuMesh->m_indexes.swap(indexes);
+	out_model.m_triangleBVH.m_nodes.swap(nodes);
+	out_model.m_triangleBVH.m_itemIndexes.swap(itemIndexes);
+	out_model.m_triangleBVH.m_itemBounds.swap(itemBounds);
+	out_model.m_triangleFirstIndexes.swap(triangleFirstIndexes);
+	out_model.m_localBounds = header.m_localBounds;
+
+	s_numCacheHits++;
+	return true;
+}
+
+
+bool WriteModelMeshCache(ModelAsset const& model, std::string const& cacheFilePath, uint64_t sourceKey)
+{
+	if (!s_isModelMeshCacheEnabled)
+	{
+		return false;
+	}
+
+	std::vector<Vertex_PCUTBN> const& vertexes = model.m_cpuMesh->m_vertexes;
+	std::vector<unsigned int> const&  indexes = model.m_cpuMesh->m_indexes;
+	BoundingVolumeHierarchy const&	  bvh = model.m_triangleBVH;
+
+	ModelMeshCacheHeader header;
+	memcpy(header.m_magic, MODEL_MESH_CACHE_MAGIC, sizeof(header.m_magic));
+	header.m_version = MODEL_MESH_CACHE_VERSION;
+	header.m_sourceKey = sourceKey;
+	header.m_vertexBytes = sizeof(Vertex_PCUTBN);
+	header.m_nodeBytes = sizeof(BVHNode);
+	header.m_numVertexes = static_cast<unsigned int>(vertexes.size());
+	header.m_numIndexes = static_cast<unsigned int>(indexes.size());
+	header.m_numNodes = static_cast<unsigned int>(bvh.m_nodes.size());
+	header.m_numItemIndexes = static_cast<unsigned int>(bvh.m_itemIndexes.size());
+	header.m_numItemBounds = static_cast<unsigned int>(bvh.m_itemBounds.size());
+	header.m_numTriangleFirstIndexes = static_cast<unsigned int>(model.m_triangleFirstIndexes.size());
+	header.m_localBounds = model.m_localBounds;
+
+	std::vector<uint8_t> buffer;
+	buffer.reserve(sizeof(header) + (vertexes.size() * sizeof(Vertex_PCUTBN)) + (indexes.size() * sizeof(unsigned int)) + (bvh.m_nodes.size() * sizeof(BVHNode)) +
+		(bvh.m_itemIndexes.size() * sizeof(int)) + (bvh.m_itemBounds.size() * sizeof(AABB3)) + (model.m_triangleFirstIndexes.size() * sizeof(int)));
+	AppendBytes(buffer, &header, sizeof(header));
+	AppendBytes(buffer, vertexes.data(), vertexes.size() * sizeof(Vertex_PCUTBN));
+	AppendBytes(buffer, indexes.data(), indexes.size() * sizeof(unsigned int));
+	AppendBytes(buffer, bvh.m_nodes.data(), bvh.m_nodes.size() * sizeof(BVHNode));
+	AppendBytes(buffer, bvh.m_itemIndexes.data(), bvh.m_itemIndexes.size() * sizeof(int));
+	AppendBytes(buffer, bvh.m_itemBounds.data(), bvh.m_itemBounds.size() * sizeof(AABB3));
+	AppendBytes(buffer, model.m_triangleFirstIndexes.data(), model.m_triangleFirstIndexes.size() * sizeof(int));
+
+	//a reader only ever sees a whole cache file, a crash or another process writing the same model leaves the old one or none
+	if (!WriteFileAtomically(buffer, cacheFilePath))
+	{
+		return false;
+	}
+
+	s_numCacheWrites++;
+	return true;
+}
+
+
+//
+//cache settings functions
+//
+void SetModelMeshCacheEnabled(bool isEnabled)
+{
+	s_isModelMeshCacheEnabled = isEnabled;
+}
+
+
+bool IsModelMeshCacheEnabled()
+{
+	return s_isModelMeshCacheEnabled;
+}
+
+
+ModelMeshCacheStats GetModelMeshCacheStats()
+{
+	ModelMeshCacheStats stats;
+	stats.m_numHits = s_numCacheHits;
+	stats.m_numMisses = s_numCacheMisses;
+	stats.m_numWrites = s_numCacheWrites;
+	return stats;
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+
+//forward declarations
+class ModelAsset;
+
+
+//constants
+constexpr unsigned int MODEL_MESH_CACHE_VERSION = 1;
+
+
+//hits and misses since startup, so load times can be read alongside them
+struct ModelMeshCacheStats
+{
+	int m_numHits = 0;
+	int m_numMisses = 0;
+	int m_numWrites = 0;
+};
+
+
+//binary copy of a model's transformed obj mesh and triangle bvh, written next to its xml the first time it's loaded
+//the cache is keyed on the xml's contents and the obj's size and write time, so editing either one rebuilds it
+std::string GetModelMeshCachePath(std::string const& xmlFilePath);
+uint64_t	GetModelMeshCacheSourceKey(std::string const& xmlFilePath, std::string const& objFilePath);
+
+//file functions, reading memory maps the file and fails on a missing file, a different version or source key, or a truncated cache
+bool ReadModelMeshCache(ModelAsset& out_model, std::string const& cacheFilePath, uint64_t sourceKey);
+bool WriteModelMeshCache(ModelAsset const& model, std::string const& cacheFilePath, uint64_t sourceKey);
+
+//turned off to time loading straight from the obj
+void				SetModelMeshCacheEnabled(bool isEnabled);
+bool				IsModelMeshCacheEnabled();
+ModelMeshCacheStats GetModelMeshCacheStats();
@@ -0,0 +1,68 @@
+#include "Game/Model.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/Profiler.hpp"
+#include "Engine/Renderer/CPUMesh.hpp"
+#include "Engine/Renderer/GPUMesh.hpp"
+#include "Engine/Renderer/Shader.hpp"
+#include "Engine/Renderer/Renderer.hpp"
+
+
+//
+//asset gpu mesh
+//
+void ModelAsset::CreateGPUMesh()
+{
+	m_shader = g_theRenderer->CreateShader(m_shaderName.c_str());
+
+	m_gpuMesh = new GPUMesh();
+	m_gpuMesh->m_vertexBuffer = g_theRenderer->CreateVertexBuffer(sizeof(Vertex_PCUTBN), sizeof(Vertex_PCUTBN));
+	g_theRenderer->CopyCPUToGPU(m_cpuMesh->m_vertexes.data(), static_cast<int>(m_cpuMesh->m_vertexes.size()) * sizeof(Vertex_PCUTBN), m_gpuMesh->m_vertexBuffer);
+
+	if (m_cpuMesh->m_indexes.size() > 0)
+	{
+		m_gpuMesh->m_indexBuffer = g_theRenderer->CreateIndexBuffer(sizeof(int));
+		g_theRenderer->CopyCPUToGPU(m_cpuMesh->m_indexes.data(), static_cast<int>(m_cpuMesh->m_indexes.size()) * sizeof(int), m_gpuMesh->m_indexBuffer);
+	}
+}
+
+
+void ModelAsset::DestroyGPUMesh()
+{
+	if (m_gpuMesh != nullptr)
+	{
+		delete m_gpuMesh;
+		m_gpuMesh = nullptr;
+	}
+}
+
+
+//
+//model rendering
+//
+void Model::RenderGPUMesh(Vec3 sunDirection, float sunIntensity, float ambientIntensity) const
+{
+	PROFILE_SCOPE("Model::RenderGPUMesh");
+
+	if (!IsReady() || m_asset->m_gpuMesh == nullptr)
+	{
+		return;
+	}
+
+	CPUMesh const* cpuMesh = m_asset->m_cpuMesh;
+	GPUMesh const* gpuMesh = m_asset->m_gpuMesh;
+
+	g_theRenderer->BindShader(m_asset->m_shader);
+	g_theRenderer->BindTexture(nullptr);
+	g_theRenderer->SetModelConstants(GetModelMatrix(), m_color);
+	g_theRenderer->SetLightConstants(sunDirection, sunIntensity, ambientIntensity);
+	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
+
+	if (cpuMesh->m_indexes.size() > 0)
+	{
+		g_theRenderer->DrawVertexBufferIndexed(gpuMesh->m_vertexBuffer, gpuMesh->m_indexBuffer, static_cast<int>(cpuMesh->m_indexes.size()));
+	}
+	else
+	{
+		g_theRenderer->DrawVertexBuffer(gpuMesh->m_vertexBuffer, static_cast<int>(cpuMesh->m_vertexes.size()));
+	}
+}
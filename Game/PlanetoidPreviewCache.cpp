@@ -0,0 +1,190 @@
+#include "Game/PlanetoidPreviewCache.hpp"
+#include "Game/Planetoids.hpp"
+#include "Game/GravityFields.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/Profiler.hpp"
+#include "Engine/Renderer/Renderer.hpp"
+#include "Engine/Renderer/VertexBuffer.hpp"
+
+
+//
+//preview key functions
+//
+uint64_t GetPreviewShapeKey(int shapeType, bool includeField, void const* parameters, size_t numBytes)
+{
+	uint64_t key = HashBytes64(&shapeType, sizeof(shapeType));
+	key = HashBytes64(&includeField, sizeof(includeField), key);
+	return HashBytes64(parameters, numBytes, key);
+}
+
+
+//
+//destructor
+//
+PlanetoidPreviewCache::~PlanetoidPreviewCache()
+{
+	Clear();
+
+	if (m_shapeBuffer != nullptr)
+	{
+		delete m_shapeBuffer;
+		m_shapeBuffer = nullptr;
+	}
+
+	if (m_fieldBuffer != nullptr)
+	{
+		delete m_fieldBuffer;
+		m_fieldBuffer = nullptr;
+	}
+}
+
+
+//
+//public preview functions
+//
+void PlanetoidPreviewCache::SetPlanetoid(uint64_t shapeKey, Planetoid* planetoid)
+{
+	PROFILE_SCOPE("PlanetoidPreviewCache::SetPlanetoid");
+
+	Clear();
+
+	m_shapeKey = shapeKey;
+	m_planetoid = planetoid;
+	m_numRebuilds++;
+
+	RebuildShapeVerts();
+	RebuildFieldVerts();
+}
+
+
+void PlanetoidPreviewCache::Render(Vec3 const& position, EulerAngles const& orientation, Rgba8 color)
+{
+	if (m_planetoid == nullptr)
+	{
+		return;
+	}
+
+	//moving the preview only changes its model matrix, the mesh stays as it is
+	if (m_planetoid->m_position != position)
+	{
+		m_planetoid->SetPosition(position);
+	}
+	EulerAngles const& currentOrientation = m_planetoid->m_orientation;
+	if (currentOrientation.m_yawDegrees != orientation.m_yawDegrees || currentOrientation.m_pitchDegrees != orientation.m_pitchDegrees ||
+		currentOrientation.m_rollDegrees != orientation.m_rollDegrees)
+	{
+		m_planetoid->SetOrientation(orientation);
+	}
+
+	Rgba8 previewColor = Rgba8(color.r, color.g, color.b, 127);
+
+	if (!m_shapeVerts.empty())
+	{
+		g_theRenderer->BindShader(nullptr);
+		g_theRenderer->BindTexture(nullptr);
+		g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
+		g_theRenderer->SetModelConstants(m_planetoid->GetModelMatrix(), previewColor);
+		g_theRenderer->DrawVertexBuffer(m_shapeBuffer, static_cast<int>(m_shapeVerts.size()));
+	}
+
+	GravityField* field = m_planetoid->m_field;
+	if (field == nullptr)
+	{
+		return;
+	}
+
+	//shells built in world space go stale when the preview moves
+	if (field->m_isDebugShellDirty)
+	{
+		RebuildFieldVerts();
+	}
+
+	if (!m_fieldVerts.empty())
+	{
+		g_theRenderer->BindShader(nullptr);
+		g_theRenderer->BindTexture(nullptr);
+		g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
+		g_theRenderer->SetModelConstants(field->GetDebugShellTransform(), g_previewGravFieldColor);
+		g_theRenderer->DrawVertexBuffer(m_fieldBuffer, static_cast<int>(m_fieldVerts.size()));
+	}
+}
+
+
+Planetoid* PlanetoidPreviewCache::TakePlanetoid()
+{
+	Planetoid* planetoid = m_planetoid;
+	m_planetoid = nullptr;
+	m_shapeVerts.clear();
+	m_fieldVerts.clear();
+	return planetoid;
+}
+
+
+void PlanetoidPreviewCache::Clear()
+{
+	if (m_planetoid != nullptr)
+	{
+		delete m_planetoid;
+		m_planetoid = nullptr;
+	}
+
+	m_shapeVerts.clear();
+	m_fieldVerts.clear();
+}
+
+
+//
+//private preview functions
+//
+void PlanetoidPreviewCache::RebuildShapeVerts()
+{
+	m_shapeVerts.clear();
+
+	//the planetoid's mesh is welded and lit, the preview draws it flat so the translucent color reads the same
+	std::vector<Vertex_PCUTBN> const& verts = m_planetoid->m_verts;
+	std::vector<unsigned int> const& indexes = m_planetoid->m_indexes;
+	m_shapeVerts.reserve(indexes.size());
+	for (int indexIndex = 0; indexIndex < indexes.size(); indexIndex++)
+	{
+		m_shapeVerts.emplace_back(Vertex_PCU(verts[indexes[indexIndex]].m_position, Rgba8(), Vec2()));
+	}
+
+	if (m_shapeVerts.empty())
+	{
+		return;
+	}
+
+	size_t numBytes = m_shapeVerts.size() * sizeof(Vertex_PCU);
+	if (m_shapeBuffer == nullptr)
+	{
+		m_shapeBuffer = g_theRenderer->CreateVertexBuffer(numBytes, sizeof(Vertex_PCU));
+	}
+	g_theRenderer->CopyCPUToGPU(m_shapeVerts.data(), numBytes, m_shapeBuffer);
+}
+
+
+void PlanetoidPreviewCache::RebuildFieldVerts()
+{
+	m_fieldVerts.clear();
+
+	GravityField* field = m_planetoid->m_field;
+	if (field == nullptr)
+	{
+		return;
+	}
+
+	field->AddVertsForDebugShell(m_fieldVerts);
+	field->m_isDebugShellDirty = false;
+
+	if (m_fieldVerts.empty())
+	{
+		return;
+	}
+
+	size_t numBytes = m_fieldVerts.size() * sizeof(Vertex_PCU);
+	if (m_fieldBuffer == nullptr)
+	{
+		m_fieldBuffer = g_theRenderer->CreateVertexBuffer(numBytes, sizeof(Vertex_PCU));
+	}
+	g_theRenderer->CopyCPUToGPU(m_fieldVerts.data(), numBytes, m_fieldBuffer);
+}
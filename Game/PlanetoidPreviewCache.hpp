@@ -0,0 +1,54 @@
+#pragma once
+#include "Game/MeshUploader.hpp"
+#include "Engine/Core/Vertex_PCU.hpp"
+#include "Engine/Core/Rgba8.hpp"
+#include "Engine/Math/Vec3.hpp"
+#include "Engine/Math/EulerAngles.hpp"
+#include <cstdint>
+#include <vector>
+
+
+//forward declarations
+class Planetoid;
+class VertexBuffer;
+
+
+//preview shape keys, more parameter blocks can be folded in with HashBytes64
+uint64_t GetPreviewShapeKey(int shapeType, bool includeField, void const* parameters, size_t numBytes);
+
+
+//the sandbox preview planetoid, only generated again when its shape parameters change
+//position, orientation, color and gravity force aren't part of the key since they don't change the mesh
+class PlanetoidPreviewCache
+{
+//public member functions
+public:
+	~PlanetoidPreviewCache();
+
+	//preview functions
+	bool	   IsCached(uint64_t shapeKey) const { return m_planetoid != nullptr && m_shapeKey == shapeKey; }
+	void	   SetPlanetoid(uint64_t shapeKey, Planetoid* planetoid);
+	void	   Render(Vec3 const& position, EulerAngles const& orientation, Rgba8 color);
+	Planetoid* TakePlanetoid();
+	void	   Clear();
+
+//private member functions
+private:
+	void RebuildShapeVerts();
+	void RebuildFieldVerts();
+
+//public member variables
+public:
+	int m_numRebuilds = 0;
+
+//private member variables
+private:
+	uint64_t   m_shapeKey = 0;
+	Planetoid* m_planetoid = nullptr;	//owned until it's taken for spawning
+
+	//unlit copies of the planetoid mesh and field shell, so the preview draws the same as before
+	std::vector<Vertex_PCU> m_shapeVerts;
+	std::vector<Vertex_PCU> m_fieldVerts;
+	VertexBuffer*			m_shapeBuffer = nullptr;
+	VertexBuffer*			m_fieldBuffer = nullptr;
+};
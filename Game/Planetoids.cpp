@@ -1,38 +1,83 @@
 #include "Game/Planetoids.hpp"
 #include "Game/Player.hpp"
-#include "Game/GameCommon.hpp"
-#include "Game/Game.hpp"
 #include "Game/Model.hpp"
+#include "Game/BoundingVolumeHierarchy.hpp"
+#include "Game/Profiler.hpp"
+#include "Game/MeshIndexing.hpp"
 #include "Engine/Core/Vertex_PCU.hpp"
-#include "Engine/Renderer/Renderer.hpp"
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Core/VertexUtils.hpp"
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Math/RandomNumberGenerator.hpp"
-#include "Engine/Renderer/Shader.hpp"
-#include "Engine/Renderer/DebugRenderSystem.hpp"
 #include "ThirdParty/Squirrel/SmoothNoise.hpp"
+#include <algorithm>
 
 
 //
 //generic planetoid functions
 //
-void Planetoid::DebugRender() const
+void Planetoid::SetPosition(Vec3 const& position)
 {
+	m_position = position;
+	UpdateModelMatrices();
+	OnTransformChanged();
+
 	if (m_field != nullptr)
 	{
-		m_field->DebugRender();
+		m_field->m_isDebugShellDirty = true;
 	}
 }
 
 
-Mat44 Planetoid::GetModelMatrix() const
+void Planetoid::SetOrientation(EulerAngles const& orientation)
 {
-	Mat44 modelMatrix = m_orientation.GetAsMatrix_XFwd_YLeft_ZUp();
+	m_orientation = orientation;
+	UpdateModelMatrices();
+	OnTransformChanged();
+
+	if (m_field != nullptr)
+	{
+		m_field->m_isDebugShellDirty = true;
+	}
+}
+
+
+void Planetoid::UpdateModelMatrices()
+{
+	m_modelMatrix = m_orientation.GetAsMatrix_XFwd_YLeft_ZUp();
+	m_modelMatrix.SetTranslation3D(m_position);
+
+	m_inverseModelMatrix = m_modelMatrix.GetOrthonormalInverse();
+}
+
+
+void Planetoid::UpdateWorldBounds()
+{
+	m_worldBounds = CalculateWorldBounds();
+}
+
+
+void Planetoid::CreateGPUMesh(MeshUploader& uploader)
+{
+	//prefabs draw through their model's mesh instead
+	if (m_gpuMesh != nullptr || m_verts.empty())
+	{
+		return;
+	}
+
+	m_gpuMesh = uploader.AcquireSharedMesh(m_verts, m_indexes, m_meshKey);
+	m_meshUploader = &uploader;
+}
 
-	modelMatrix.SetTranslation3D(m_position);
 
-	return modelMatrix;
+void Planetoid::DestroyGPUMesh()
+{
+	if (m_meshUploader != nullptr)
+	{
+		m_meshUploader->ReleaseSharedMesh(m_meshKey);
+		m_gpuMesh = nullptr;
+		m_meshUploader = nullptr;
+	}
 }
 
 
@@ -47,59 +92,16 @@ PlanePLTD::PlanePLTD(Vec3 position, float halfLength, float halfWidth, EulerAngl
 	if(includeField) m_field = new PlaneField(this, halfLength, halfWidth, gravityHeight, gravityForce);
 
 	AddVertsForQuad3D(m_verts, Vec3(-m_halfLength, m_halfWidth, 0.0f), Vec3(-m_halfLength, -m_halfWidth, 0.0f), Vec3(m_halfLength, m_halfWidth, 0.0f), Vec3(m_halfLength, -m_halfWidth, 0.0f));
+	BuildIndexedMesh(m_verts, m_indexes);
 }
 
 
-void PlanePLTD::Render() const
+bool PlanePLTD::CollideWithPlayer(Player* player, std::vector<int>& nearbyScratch)
 {
-	g_theRenderer->BindShader(g_theGame->m_lightingShader);
-	g_theRenderer->BindTexture(nullptr);
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-	g_theRenderer->SetModelConstants(GetModelMatrix(), m_color);
-	g_theRenderer->DrawVertexArray(m_verts);
-}
-
+	PROFILE_SCOPE("PlanePLTD::CollideWithPlayer");
+	UNUSED(nearbyScratch);
 
-void PlanePLTD::RenderPreview(Vec3 position, float halfLength, float halfWidth, EulerAngles orientation, float gravityHeight, Rgba8 color)
-{
-	std::vector<Vertex_PCU> verts;
-
-	AddVertsForQuad3D(verts, Vec3(-halfLength, halfWidth, 0.0f), Vec3(-halfLength, -halfWidth, 0.0f), Vec3(halfLength, halfWidth, 0.0f), Vec3(halfLength, -halfWidth, 0.0f));
-	AddVertsForQuad3D(verts, Vec3(-halfLength, -halfWidth, 0.0f), Vec3(-halfLength, halfWidth, 0.0f), Vec3(halfLength, -halfWidth, 0.0f), Vec3(halfLength, halfWidth, 0.0f));
-	Mat44 modelMatrix = orientation.GetAsMatrix_XFwd_YLeft_ZUp();
-	modelMatrix.SetTranslation3D(position);
-	Rgba8 previewColor = Rgba8(color.r, color.g, color.b, 127);
-
-	g_theRenderer->BindShader(nullptr);
-	g_theRenderer->BindTexture(nullptr);
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-	g_theRenderer->SetModelConstants(modelMatrix, previewColor);
-	g_theRenderer->DrawVertexArray(verts);
-
-	std::vector<Vertex_PCU> gravVerts;
-
-	Vec3 fbl = Vec3(halfLength, halfWidth, 0.0f);
-	Vec3 fbr = Vec3(halfLength, -halfWidth, 0.0f);
-	Vec3 bbl = Vec3(-halfLength, halfWidth, 0.0f);
-	Vec3 bbr = Vec3(-halfLength, -halfWidth, 0.0f);
-	Vec3 ftl = Vec3(halfLength, halfWidth, gravityHeight);
-	Vec3 ftr = Vec3(halfLength, -halfWidth, gravityHeight);
-	Vec3 btl = Vec3(-halfLength, halfWidth, gravityHeight);
-	Vec3 btr = Vec3(-halfLength, -halfWidth, gravityHeight);
-
-	AddVertsForCube3D(gravVerts, fbl, fbr, ftl, ftr, bbl, bbr, btl, btr);
-
-	g_theRenderer->BindShader(nullptr);
-	g_theRenderer->BindTexture(nullptr);
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-	g_theRenderer->SetModelConstants(modelMatrix, g_previewGravFieldColor);
-	g_theRenderer->DrawVertexArray(gravVerts);
-}
-
-
-bool PlanePLTD::CollideWithPlayer(Player* player)
-{
-	Vec3 playerInPltdSpace = GetModelMatrix().GetOrthonormalInverse().TransformPosition3D(player->m_position);
+	Vec3 playerInPltdSpace = GetInverseModelMatrix().TransformPosition3D(player->m_position);
 
 	playerInPltdSpace.z = 0.0f;
 	playerInPltdSpace.x = GetClamped(playerInPltdSpace.x, -m_halfLength, m_halfLength);
@@ -121,8 +123,7 @@ bool PlanePLTD::CollideWithPlayer(Player* player)
 		//if surface is wall, player begins wall slide
 		else if (DotProduct3D(pushDirection, player->m_orientation.GetIBasis3D()) > WALL_THRESHOLD && !player->m_isGrounded)
 		{
-			Mat44 orientationMat = m_orientation.GetAsMatrix_XFwd_YLeft_ZUp();
-			player->StartWallSlide(orientationMat.GetKBasis3D());
+			player->StartWallSlide(GetModelMatrix().GetKBasis3D());
 		}
 	}
 
@@ -137,6 +138,12 @@ Vec3 PlanePLTD::GetNearestPointOnPlanetoid(Vec3 playerPos) const
 }
 
 
+AABB3 PlanePLTD::CalculateWorldBounds() const
+{
+	return BoundingVolumeHierarchy::GetBoundsOfLocalBox3D(GetModelMatrix(), Vec3(-m_halfLength, -m_halfWidth, 0.0f), Vec3(m_halfLength, m_halfWidth, 0.0f));
+}
+
+
 //
 //sphere planetoid functions
 //
@@ -147,47 +154,15 @@ SpherePLTD::SpherePLTD(Vec3 position, float radius, bool includeField, float gra
 	if(includeField) m_field = new SphereField(this, gravityRadius, gravityForce);
 
 	AddVertsForSphere3D(m_verts, Vec3(), m_radius, 64, 32);
+	BuildIndexedMesh(m_verts, m_indexes);
 }
 
 
-void SpherePLTD::Render() const
-{
-	g_theRenderer->BindShader(g_theGame->m_lightingShader);
-	g_theRenderer->BindTexture(nullptr);
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-	g_theRenderer->SetModelConstants(GetModelMatrix(), m_color);
-	g_theRenderer->DrawVertexArray(m_verts);
-}
-
-
-void SpherePLTD::RenderPreview(Vec3 position, float radius, float gravityRadius, Rgba8 color)
+bool SpherePLTD::CollideWithPlayer(Player* player, std::vector<int>& nearbyScratch)
 {
-	std::vector<Vertex_PCU> verts;
-
-	AddVertsForSphere3D(verts, Vec3(), radius, 32, 16);
-	Mat44 modelMatrix = Mat44::CreateTranslation3D(position);
-	Rgba8 previewColor = Rgba8(color.r, color.g, color.b, 127);
-
-	g_theRenderer->BindShader(nullptr);
-	g_theRenderer->BindTexture(nullptr);
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-	g_theRenderer->SetModelConstants(modelMatrix, previewColor);
-	g_theRenderer->DrawVertexArray(verts);
+	PROFILE_SCOPE("SpherePLTD::CollideWithPlayer");
+	UNUSED(nearbyScratch);
 
-	std::vector<Vertex_PCU> gravVerts;
-
-	AddVertsForSphere3D(gravVerts, Vec3(), gravityRadius, 32, 16);
-
-	g_theRenderer->BindShader(nullptr);
-	g_theRenderer->BindTexture(nullptr);
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-	g_theRenderer->SetModelConstants(modelMatrix, g_previewGravFieldColor);
-	g_theRenderer->DrawVertexArray(gravVerts);
-}
-
-
-bool SpherePLTD::CollideWithPlayer(Player* player)
-{
 	bool pushed = PushSphereOutOfFixedSphere3D(player->m_position, player->m_collisionRadius, m_position, m_radius);
 
 	if (pushed)
@@ -211,6 +186,12 @@ Vec3 SpherePLTD::GetNearestPointOnPlanetoid(Vec3 playerPos) const
 }
 
 
+AABB3 SpherePLTD::CalculateWorldBounds() const
+{
+	return BoundingVolumeHierarchy::GetBoundsOfCapsule3D(m_position, m_position, m_radius);
+}
+
+
 //
 //capsule planetoid functions
 //
@@ -225,49 +206,15 @@ CapsulePLTD::CapsulePLTD(Vec3 position, float radius, float boneLength, Vec3 bon
 	if(includeField) m_field = new CapsuleField(this, gravityRadius, position, m_boneEnd, gravityForce);
 
 	AddVertsForCapsule3D(m_verts, Vec3(), m_boneEnd - m_position, m_radius, 32, 16);
+	BuildIndexedMesh(m_verts, m_indexes);
 }
 
 
-void CapsulePLTD::Render() const
+bool CapsulePLTD::CollideWithPlayer(Player* player, std::vector<int>& nearbyScratch)
 {
-	g_theRenderer->BindShader(g_theGame->m_lightingShader);
-	g_theRenderer->BindTexture(nullptr);
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-	g_theRenderer->SetModelConstants(GetModelMatrix(), m_color);
-	g_theRenderer->DrawVertexArray(m_verts);
-}
-
-
-void CapsulePLTD::RenderPreview(Vec3 position, float radius, float boneLength, Vec3 boneDirection, float gravityRadius, Rgba8 color)
-{
-	std::vector<Vertex_PCU> verts;
-
-	boneDirection.Normalize();
-	Vec3 boneEnd = position + (boneDirection * boneLength);
-	AddVertsForCapsule3D(verts, Vec3(), boneEnd - position, radius, 32, 16);
-	Mat44 modelMatrix = Mat44::CreateTranslation3D(position);
-	Rgba8 previewColor = Rgba8(color.r, color.g, color.b, 127);
-
-	g_theRenderer->BindShader(nullptr);
-	g_theRenderer->BindTexture(nullptr);
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-	g_theRenderer->SetModelConstants(modelMatrix, previewColor);
-	g_theRenderer->DrawVertexArray(verts);
-
-	std::vector<Vertex_PCU> gravVerts;
-
-	AddVertsForCapsule3D(gravVerts, Vec3(), boneEnd - position, gravityRadius, 32, 16);
-
-	g_theRenderer->BindShader(nullptr);
-	g_theRenderer->BindTexture(nullptr);
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-	g_theRenderer->SetModelConstants(modelMatrix, g_previewGravFieldColor);
-	g_theRenderer->DrawVertexArray(gravVerts);
-}
-
+	PROFILE_SCOPE("CapsulePLTD::CollideWithPlayer");
+	UNUSED(nearbyScratch);
 
-bool CapsulePLTD::CollideWithPlayer(Player* player)
-{
 	bool pushed = PushSphereOutOfFixedCapsule3D(player->m_position, player->m_collisionRadius, m_position, m_boneEnd, m_radius);
 	
 	if (pushed)
@@ -291,6 +238,27 @@ Vec3 CapsulePLTD::GetNearestPointOnPlanetoid(Vec3 playerPos) const
 }
 
 
+AABB3 CapsulePLTD::CalculateWorldBounds() const
+{
+	return BoundingVolumeHierarchy::GetBoundsOfCapsule3D(m_position, m_boneEnd, m_radius);
+}
+
+
+void CapsulePLTD::OnTransformChanged()
+{
+	//the bone and its field are kept in world space, so they follow the planetoid when it moves
+	m_boneEnd = m_position + (m_boneDirection * m_boneLength);
+	CapsuleField* capsuleField = dynamic_cast<CapsuleField*>(m_field);
+	if (capsuleField != nullptr)
+	{
+		capsuleField->m_boneStart = m_position;
+		capsuleField->m_boneEnd = m_boneEnd;
+	}
+
+	UpdateWorldBounds();
+}
+
+
 //
 //ellipsoid planetoid functions
 //
@@ -304,48 +272,15 @@ EllipsoidPLTD::EllipsoidPLTD(Vec3 position, float xRadius, float yRadius, float
 	if(includeField) m_field = new EllipsoidField(this, gravityXRadius, gravityYRadius, gravityZRadius, gravityForce);
 
 	AddVertsForEllipsoid3D(m_verts, Vec3(), m_xRadius, m_yRadius, m_zRadius, 32, 16);
+	BuildIndexedMesh(m_verts, m_indexes);
 }
 
 
-void EllipsoidPLTD::Render() const
-{
-	g_theRenderer->BindShader(g_theGame->m_lightingShader);
-	g_theRenderer->BindTexture(nullptr);
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-	g_theRenderer->SetModelConstants(GetModelMatrix(), m_color);
-	g_theRenderer->DrawVertexArray(m_verts);
-}
-
-
-void EllipsoidPLTD::RenderPreview(Vec3 position, float xRadius, float yRadius, float zRadius, EulerAngles orientation, float gravityXRadius, float gravityYRadius, float gravityZRadius, Rgba8 color)
+bool EllipsoidPLTD::CollideWithPlayer(Player* player, std::vector<int>& nearbyScratch)
 {
-	std::vector<Vertex_PCU> verts;
-
-	AddVertsForEllipsoid3D(verts, Vec3(), xRadius, yRadius, zRadius, 32, 16);
-	Mat44 modelMatrix = orientation.GetAsMatrix_XFwd_YLeft_ZUp();
-	modelMatrix.SetTranslation3D(position);
-	Rgba8 previewColor = Rgba8(color.r, color.g, color.b, 127);
-
-	g_theRenderer->BindShader(nullptr);
-	g_theRenderer->BindTexture(nullptr);
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-	g_theRenderer->SetModelConstants(modelMatrix, previewColor);
-	g_theRenderer->DrawVertexArray(verts);
-
-	std::vector<Vertex_PCU> gravVerts;
-
-	AddVertsForEllipsoid3D(gravVerts, Vec3(), gravityXRadius, gravityYRadius, gravityZRadius, 32, 16);
+	PROFILE_SCOPE("EllipsoidPLTD::CollideWithPlayer");
+	UNUSED(nearbyScratch);
 
-	g_theRenderer->BindShader(nullptr);
-	g_theRenderer->BindTexture(nullptr);
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-	g_theRenderer->SetModelConstants(modelMatrix, g_previewGravFieldColor);
-	g_theRenderer->DrawVertexArray(gravVerts);
-}
-
-
-bool EllipsoidPLTD::CollideWithPlayer(Player* player)
-{
 	bool pushed = PushSphereOutOfFixedEllipsoid3D(player->m_position, player->m_collisionRadius, m_position, m_xRadius, m_yRadius, m_zRadius, m_orientation);
 
 	if (pushed)
@@ -369,6 +304,12 @@ Vec3 EllipsoidPLTD::GetNearestPointOnPlanetoid(Vec3 playerPos) const
 }
 
 
+AABB3 EllipsoidPLTD::CalculateWorldBounds() const
+{
+	return BoundingVolumeHierarchy::GetBoundsOfEllipsoid3D(m_position, m_xRadius, m_yRadius, m_zRadius, GetModelMatrix());
+}
+
+
 //
 //rounded cube planetoid functions
 //
@@ -382,48 +323,15 @@ RoundCubePLTD::RoundCubePLTD(Vec3 position, float length, float width, float hei
 	if(includeField) m_field = new RoundCubeField(this, gravityLength, gravityWidth, gravityHeight, gravityForce);
 
 	AddVertsForRoundedCube3D(m_verts, Vec3(), m_length * 0.5f, m_width * 0.5f, m_height * 0.5f, m_roundedness);
+	BuildIndexedMesh(m_verts, m_indexes);
 }
 
 
-void RoundCubePLTD::Render() const
+bool RoundCubePLTD::CollideWithPlayer(Player* player, std::vector<int>& nearbyScratch)
 {
-	g_theRenderer->BindShader(g_theGame->m_lightingShader);
-	g_theRenderer->BindTexture(nullptr);
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-	g_theRenderer->SetModelConstants(GetModelMatrix(), m_color);
-	g_theRenderer->DrawVertexArray(m_verts);
-}
+	PROFILE_SCOPE("RoundCubePLTD::CollideWithPlayer");
+	UNUSED(nearbyScratch);
 
-
-void RoundCubePLTD::RenderPreview(Vec3 position, float length, float width, float height, float roundedness, EulerAngles orientation, float gravityLength, float gravityWidth, float gravityHeight, Rgba8 color)
-{
-	std::vector<Vertex_PCU> verts;
-
-	AddVertsForRoundedCube3D(verts, Vec3(), length * 0.5f, width * 0.5f, height * 0.5f, roundedness);
-	Mat44 modelMatrix = orientation.GetAsMatrix_XFwd_YLeft_ZUp();
-	modelMatrix.SetTranslation3D(position);
-	Rgba8 previewColor = Rgba8(color.r, color.g, color.b, 127);
-
-	g_theRenderer->BindShader(nullptr);
-	g_theRenderer->BindTexture(nullptr);
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-	g_theRenderer->SetModelConstants(modelMatrix, previewColor);
-	g_theRenderer->DrawVertexArray(verts);
-
-	std::vector<Vertex_PCU> gravVerts;
-
-	AddVertsForRoundedCube3D(gravVerts, Vec3(),gravityLength * 0.5f, gravityWidth * 0.5f, gravityHeight * 0.5f, roundedness);
-
-	g_theRenderer->BindShader(nullptr);
-	g_theRenderer->BindTexture(nullptr);
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-	g_theRenderer->SetModelConstants(modelMatrix, g_previewGravFieldColor);
-	g_theRenderer->DrawVertexArray(gravVerts);
-}
-
-
-bool RoundCubePLTD::CollideWithPlayer(Player* player)
-{
 	bool pushed = PushSphereOutOfFixedRoundedCube3D(player->m_position, player->m_collisionRadius, m_position, m_length, m_width, m_height, m_roundedness, m_orientation);
 
 	if (pushed)
@@ -453,6 +361,14 @@ Vec3 RoundCubePLTD::GetNearestPointOnPlanetoid(Vec3 playerPos) const
 }
 
 
+AABB3 RoundCubePLTD::CalculateWorldBounds() const
+{
+	Vec3 halfDimensions = Vec3(m_length * 0.5f, m_width * 0.5f, m_height * 0.5f);
+
+	return BoundingVolumeHierarchy::GetBoundsOfLocalBox3D(GetModelMatrix(), -halfDimensions, halfDimensions);
+}
+
+
 //
 //torus planetoid functions
 //
@@ -464,48 +380,15 @@ TorusPLTD::TorusPLTD(Vec3 position, float tubeRadius, float holeRadius, EulerAng
 	if(includeField) m_field = new TorusField(this, m_tubeRadius + gravityRadius, m_holeRadius - gravityRadius, gravityForce);
 
 	AddVertsForTorus3D(m_verts, Vec3(), m_tubeRadius, m_holeRadius, 16, 32);
+	BuildIndexedMesh(m_verts, m_indexes);
 }
 
 
-void TorusPLTD::Render() const
+bool TorusPLTD::CollideWithPlayer(Player* player, std::vector<int>& nearbyScratch)
 {
-	g_theRenderer->BindShader(g_theGame->m_lightingShader);
-	g_theRenderer->BindTexture(nullptr);
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-	g_theRenderer->SetModelConstants(GetModelMatrix(), m_color);
-	g_theRenderer->DrawVertexArray(m_verts);
-}
-
-
-void TorusPLTD::RenderPreview(Vec3 position, float tubeRadius, float holeRadius, EulerAngles orientation, float gravityRadius, Rgba8 color)
-{
-	std::vector<Vertex_PCU> verts;
-
-	AddVertsForTorus3D(verts, Vec3(), tubeRadius, holeRadius);
-	Mat44 modelMatrix = orientation.GetAsMatrix_XFwd_YLeft_ZUp();
-	modelMatrix.SetTranslation3D(position);
-	Rgba8 previewColor = Rgba8(color.r, color.g, color.b, 127);
-
-	g_theRenderer->BindShader(nullptr);
-	g_theRenderer->BindTexture(nullptr);
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-	g_theRenderer->SetModelConstants(modelMatrix, previewColor);
-	g_theRenderer->DrawVertexArray(verts);
-
-	std::vector<Vertex_PCU> gravVerts;
+	PROFILE_SCOPE("TorusPLTD::CollideWithPlayer");
+	UNUSED(nearbyScratch);
 
-	AddVertsForTorus3D(gravVerts, Vec3(), gravityRadius + tubeRadius, holeRadius - gravityRadius);
-
-	g_theRenderer->BindShader(nullptr);
-	g_theRenderer->BindTexture(nullptr);
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-	g_theRenderer->SetModelConstants(modelMatrix, g_previewGravFieldColor);
-	g_theRenderer->DrawVertexArray(gravVerts);
-}
-
-
-bool TorusPLTD::CollideWithPlayer(Player* player)
-{
 	bool pushed = PushSphereOutOfFixedTorus3D(player->m_position, player->m_collisionRadius, m_position, m_tubeRadius, m_holeRadius, m_orientation);
 
 	if (pushed)
@@ -529,6 +412,15 @@ Vec3 TorusPLTD::GetNearestPointOnPlanetoid(Vec3 playerPos) const
 }
 
 
+AABB3 TorusPLTD::CalculateWorldBounds() const
+{
+	//the center wire sits at hole + tube from the center, so the outer edge is one more tube radius out
+	float outerRadius = fabsf(m_holeRadius + m_tubeRadius) + fabsf(m_tubeRadius);
+
+	return BoundingVolumeHierarchy::GetBoundsOfCapsule3D(m_position, m_position, outerRadius);
+}
+
+
 //
 //bowl planetoid functions
 //
@@ -540,96 +432,15 @@ BowlPLTD::BowlPLTD(Vec3 position, float radius, float thickness, EulerAngles ori
 	if(includeField) m_field = new BowlField(this, radius + gravityRadius, gravityRadius, radius - thickness, gravityForce);
 
 	AddVertsForBowl();
+	BuildIndexedMesh(m_verts, m_indexes);
 }
 
 
-void BowlPLTD::Render() const
+bool BowlPLTD::CollideWithPlayer(Player* player, std::vector<int>& nearbyScratch)
 {
-	g_theRenderer->BindShader(g_theGame->m_lightingShader);
-	g_theRenderer->BindTexture(nullptr);
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-	g_theRenderer->SetModelConstants(GetModelMatrix(), m_color);
-	g_theRenderer->DrawVertexArray(m_verts);
-}
-
-
-void BowlPLTD::RenderPreview(Vec3 position, float radius, float thickness, EulerAngles orientation, float gravityRadius, Rgba8 color)
-{
-	std::vector<Vertex_PCU> verts;
-
-	AddVertsForBowl(verts, radius, thickness);
-	Mat44 modelMatrix = orientation.GetAsMatrix_XFwd_YLeft_ZUp();
-	modelMatrix.SetTranslation3D(position);
-	Rgba8 previewColor = Rgba8(color.r, color.g, color.b, 127);
-
-	g_theRenderer->BindShader(nullptr);
-	g_theRenderer->BindTexture(nullptr);
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-	g_theRenderer->SetModelConstants(modelMatrix, previewColor);
-	g_theRenderer->DrawVertexArray(verts);
-
-	std::vector<Vertex_PCU> gravVerts;
-
-	float degreesPerSlice = 360.0f / static_cast<float>(32);
-	float degreesPerStack = 180.0f / static_cast<float>(8);
-
-	for (int stackIndex = 0; stackIndex < 8; stackIndex++)
-	{
-		float topDegreesLat = -90.0f + (static_cast<float>(stackIndex) * degreesPerStack * 0.5f);
-		float bottomDegreesLat = -90.0f + (static_cast<float>(stackIndex + 1) * degreesPerStack * 0.5f);
-
-		for (int sliceIndex = 0; sliceIndex < 32; sliceIndex++)
-		{
-			float leftDegreesLong = static_cast<float>(sliceIndex) * degreesPerSlice;
-			float rightDegreesLong = static_cast<float>(sliceIndex + 1) * degreesPerSlice;
-
-			Vec3 bottomLeftCoords = Vec3::MakeFromPolarDegrees(bottomDegreesLat, leftDegreesLong, radius + gravityRadius);
-			Vec3 bottomRightCoords = Vec3::MakeFromPolarDegrees(bottomDegreesLat, rightDegreesLong, radius + gravityRadius);
-			Vec3 topLeftCoords = Vec3::MakeFromPolarDegrees(topDegreesLat, leftDegreesLong, radius + gravityRadius);
-			Vec3 topRightCoords = Vec3::MakeFromPolarDegrees(topDegreesLat, rightDegreesLong, radius + gravityRadius);
-
-			gravVerts.emplace_back(Vertex_PCU(bottomLeftCoords, Rgba8(), Vec2()));
-			gravVerts.emplace_back(Vertex_PCU(topRightCoords, Rgba8(), Vec2()));
-			gravVerts.emplace_back(Vertex_PCU(bottomRightCoords, Rgba8(), Vec2()));
-			
-			gravVerts.emplace_back(Vertex_PCU(bottomLeftCoords, Rgba8(), Vec2()));
-			gravVerts.emplace_back(Vertex_PCU(topLeftCoords, Rgba8(), Vec2()));
-			gravVerts.emplace_back(Vertex_PCU(topRightCoords, Rgba8(), Vec2()));
-		}
-	}
-
-	Vec3 topCenter = Vec3(0.0f, 0.0f, gravityRadius);
+	PROFILE_SCOPE("BowlPLTD::CollideWithPlayer");
+	UNUSED(nearbyScratch);
 
-	for (int edgeIndex = 0; edgeIndex < 32; edgeIndex++)
-	{
-		float startDegrees = static_cast<float>(edgeIndex) * degreesPerSlice;
-		float endDegrees = static_cast<float>(edgeIndex + 1) * degreesPerSlice;
-
-		Vec3 baseEdgeStart = Vec3::MakeFromPolarDegrees(0.0f, startDegrees, radius + gravityRadius);
-		Vec3 baseEdgeEnd = Vec3::MakeFromPolarDegrees(0.0f, endDegrees, radius + gravityRadius);
-
-		Vec3 topEdgeStart = topCenter + Vec3::MakeFromPolarDegrees(0.0f, startDegrees, radius + gravityRadius);
-		Vec3 topEdgeEnd = topCenter + Vec3::MakeFromPolarDegrees(0.0f, endDegrees, radius + gravityRadius);
-
-		//draw triangle at top
-		gravVerts.push_back(Vertex_PCU(topCenter, Rgba8(), Vec2()));
-		gravVerts.push_back(Vertex_PCU(topEdgeStart, Rgba8(), Vec2()));
-		gravVerts.push_back(Vertex_PCU(topEdgeEnd, Rgba8(), Vec2()));
-
-		//draw side quad
-		AddVertsForQuad3D(gravVerts, baseEdgeStart, baseEdgeEnd, topEdgeStart, topEdgeEnd);
-	}
-
-	g_theRenderer->BindShader(nullptr);
-	g_theRenderer->BindTexture(nullptr);
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-	g_theRenderer->SetModelConstants(modelMatrix, g_previewGravFieldColor);
-	g_theRenderer->DrawVertexArray(gravVerts);
-}
-
-
-bool BowlPLTD::CollideWithPlayer(Player* player)
-{
 	bool pushed = PushSphereOutOfPlanetoid(player->m_position, player->m_collisionRadius);
 
 	if (pushed)
@@ -655,10 +466,8 @@ bool BowlPLTD::CollideWithPlayer(Player* player)
 
 Vec3 BowlPLTD::GetNearestPointOnPlanetoid(Vec3 playerPos) const
 {
-	Mat44 bowlModelMat = m_orientation.GetAsMatrix_XFwd_YLeft_ZUp();
-	bowlModelMat.SetTranslation3D(m_position);
-	Mat44 bowlWorldToLocalMat = bowlModelMat.GetOrthonormalInverse();
-	Vec3 playerPosInLocalSpace = bowlWorldToLocalMat.TransformPosition3D(playerPos);
+	Mat44 const& bowlModelMat = GetModelMatrix();
+	Vec3 playerPosInLocalSpace = GetInverseModelMatrix().TransformPosition3D(playerPos);
 	
 	Vec3 nearestPointOnOutside = GetNearestPointOnSphereEdge3D(playerPosInLocalSpace, Vec3(), m_radius);
 	if (nearestPointOnOutside.z > 0.0f)
@@ -703,6 +512,13 @@ Vec3 BowlPLTD::GetNearestPointOnPlanetoid(Vec3 playerPos) const
 }
 
 
+AABB3 BowlPLTD::CalculateWorldBounds() const
+{
+	//hemisphere hangs below the rim, which sits on the local xy plane
+	return BoundingVolumeHierarchy::GetBoundsOfLocalBox3D(GetModelMatrix(), Vec3(-m_radius, -m_radius, -m_radius), Vec3(m_radius, m_radius, 0.0f));
+}
+
+
 bool BowlPLTD::PushSphereOutOfPlanetoid(Vec3& sphereCenter, float sphereRadius)
 {
 	Vec3 nearestPoint = GetNearestPointOnPlanetoid(sphereCenter);
@@ -792,87 +608,6 @@ void BowlPLTD::AddVertsForBowl()
 }
 
 
-void BowlPLTD::AddVertsForBowl(std::vector<Vertex_PCU>& verts, float radius, float thickness)
-{
-	//add exterior hemisphere
-	float degreesPerSlice = 360.0f / 32.0f;
-	float degreesPerStack = 90.0f / 8.0f;
-
-	for (int stackIndex = 0; stackIndex < 8; stackIndex++)
-	{
-		float topDegreesLat = -90.0f + (static_cast<float>(stackIndex) * degreesPerStack);
-		float bottomDegreesLat = topDegreesLat + degreesPerStack;
-
-		for (int sliceIndex = 0; sliceIndex < 32; sliceIndex++)
-		{
-			float leftDegreesLong = static_cast<float>(sliceIndex) * degreesPerSlice;
-			float rightDegreesLong = leftDegreesLong + degreesPerSlice;
-
-			Vec3 bottomLeftNormal = Vec3::MakeFromPolarDegrees(bottomDegreesLat, leftDegreesLong);
-			Vec3 bottomLeftCoords = bottomLeftNormal * radius;
-			Vec3 bottomRightNormal = Vec3::MakeFromPolarDegrees(bottomDegreesLat, rightDegreesLong);
-			Vec3 bottomRightCoords = bottomRightNormal * radius;
-			Vec3 topLeftNormal = Vec3::MakeFromPolarDegrees(topDegreesLat, leftDegreesLong);
-			Vec3 topLeftCoords = topLeftNormal * radius;
-			Vec3 topRightNormal = Vec3::MakeFromPolarDegrees(topDegreesLat, rightDegreesLong);
-			Vec3 topRightCoords = topRightNormal * radius;
-
-			verts.push_back(Vertex_PCU(bottomLeftCoords, Rgba8(), Vec2()));
-			verts.push_back(Vertex_PCU(topRightCoords, Rgba8(), Vec2()));
-			verts.push_back(Vertex_PCU(bottomRightCoords, Rgba8(), Vec2()));
-			
-			verts.push_back(Vertex_PCU(bottomLeftCoords, Rgba8(), Vec2()));
-			verts.push_back(Vertex_PCU(topLeftCoords, Rgba8(), Vec2()));
-			verts.push_back(Vertex_PCU(topRightCoords, Rgba8(), Vec2()));
-		}
-	}
-
-	//add interior hemisphere
-	for (int stackIndex = 0; stackIndex < 8; stackIndex++)
-	{
-		float topDegreesLat = -90.0f + (static_cast<float>(stackIndex) * degreesPerStack);
-		float bottomDegreesLat = topDegreesLat + degreesPerStack;
-
-		for (int sliceIndex = 0; sliceIndex < 32; sliceIndex++)
-		{
-			float leftDegreesLong = static_cast<float>(sliceIndex) * degreesPerSlice;
-			float rightDegreesLong = leftDegreesLong + degreesPerSlice;
-
-			Vec3 bottomLeftNormal = Vec3::MakeFromPolarDegrees(bottomDegreesLat, leftDegreesLong);
-			Vec3 bottomLeftCoords = bottomLeftNormal * (radius - thickness);
-			Vec3 bottomRightNormal = Vec3::MakeFromPolarDegrees(bottomDegreesLat, rightDegreesLong);
-			Vec3 bottomRightCoords = bottomRightNormal * (radius - thickness);
-			Vec3 topLeftNormal = Vec3::MakeFromPolarDegrees(topDegreesLat, leftDegreesLong);
-			Vec3 topLeftCoords = topLeftNormal * (radius - thickness);
-			Vec3 topRightNormal = Vec3::MakeFromPolarDegrees(topDegreesLat, rightDegreesLong);
-			Vec3 topRightCoords = topRightNormal * (radius - thickness);
-
-			verts.push_back(Vertex_PCU(topRightCoords, Rgba8(), Vec2()));
-			verts.push_back(Vertex_PCU(bottomLeftCoords, Rgba8(), Vec2()));
-			verts.push_back(Vertex_PCU(bottomRightCoords, Rgba8(), Vec2()));
-
-			verts.push_back(Vertex_PCU(topLeftCoords, Rgba8(), Vec2()));
-			verts.push_back(Vertex_PCU(bottomLeftCoords, Rgba8(), Vec2()));
-			verts.push_back(Vertex_PCU(topRightCoords, Rgba8(), Vec2()));
-		}
-	}
-
-	//add connecting rim
-	for (int sliceIndex = 0; sliceIndex < 32; sliceIndex++)
-	{
-		float leftDegrees = static_cast<float>(sliceIndex) * degreesPerSlice;
-		float rightDegrees = leftDegrees + degreesPerSlice;
-
-		Vec3 bottomLeft = Vec3::MakeFromPolarDegrees(0.0f, leftDegrees, radius);
-		Vec3 bottomRight = Vec3::MakeFromPolarDegrees(0.0f, rightDegrees, radius);
-		Vec3 topLeft = Vec3::MakeFromPolarDegrees(0.0f, leftDegrees, radius - thickness);
-		Vec3 topRight = Vec3::MakeFromPolarDegrees(0.0f, rightDegrees, radius - thickness);
-
-		AddVertsForQuad3D(verts, bottomLeft, bottomRight, topLeft, topRight);
-	}
-}
-
-
 //
 //mobius strip planetoid functions
 //
@@ -887,54 +622,29 @@ MobiusPLTD::MobiusPLTD(Vec3 position, float radius, float halfWidth, EulerAngles
 	UNUSED(gravityForce);
 
 	AddVertsForMobiusStrip3D(m_verts, Vec3(), m_radius, m_halfWidth, 256);
+	BuildIndexedMesh(m_verts, m_indexes);
 }
 
 
-void MobiusPLTD::Render() const
-{
-	g_theRenderer->BindShader(g_theGame->m_lightingShader);
-	g_theRenderer->BindTexture(nullptr);
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-	g_theRenderer->SetModelConstants(GetModelMatrix(), m_color);
-	g_theRenderer->DrawVertexArray(m_verts);
-}
-
-
-void MobiusPLTD::RenderPreview(Vec3 position, float radius, float halfWidth, EulerAngles orientation, float gravityHeight, Rgba8 color)
+bool MobiusPLTD::CollideWithPlayer(Player* player, std::vector<int>& nearbyScratch)
 {
-	std::vector<Vertex_PCU> verts;
+	PROFILE_SCOPE("MobiusPLTD::CollideWithPlayer");
+	UNUSED(nearbyScratch);
 
-	AddVertsForMobiusStrip3D(verts, Vec3(), radius, halfWidth, 256);
-	Mat44 modelMatrix = orientation.GetAsMatrix_XFwd_YLeft_ZUp();
-	modelMatrix.SetTranslation3D(position);
-	Rgba8 previewColor = Rgba8(color.r, color.g, color.b, 127);
-
-	g_theRenderer->BindShader(nullptr);
-	g_theRenderer->BindTexture(nullptr);
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-	g_theRenderer->SetModelConstants(modelMatrix, previewColor);
-	g_theRenderer->DrawVertexArray(verts);
-
-	std::vector<Vertex_PCU> gravVerts;
-
-	UNUSED(gravityHeight);
-}
-
-
-bool MobiusPLTD::CollideWithPlayer(Player* player)
-{
-	Vec3 referencePointLocal = GetModelMatrix().GetOrthonormalInverse().TransformPosition3D(player->m_position);
+	Vec3 referencePointLocal = GetInverseModelMatrix().TransformPosition3D(player->m_position);
 
 	bool wasPlayerPushed = false;
-	for (int vertIndex = 0; vertIndex < m_verts.size(); vertIndex += 3)
+	for (int firstIndex = 0; firstIndex < m_indexes.size(); firstIndex += 3)
 	{
-		if (m_verts[vertIndex].m_position == m_verts[vertIndex + 1].m_position || m_verts[vertIndex].m_position == m_verts[vertIndex + 2].m_position || m_verts[vertIndex + 1].m_position 
-			== m_verts[vertIndex + 2].m_position)
+		Vec3 const& cornerA = m_verts[m_indexes[firstIndex]].m_position;
+		Vec3 const& cornerB = m_verts[m_indexes[firstIndex + 1]].m_position;
+		Vec3 const& cornerC = m_verts[m_indexes[firstIndex + 2]].m_position;
+		if (cornerA == cornerB || cornerA == cornerC || cornerB == cornerC)
 		{
 			continue;
 		}
 
-		Vec3 triNearestLocalPoint = GetNearestPointOnTriangle3D(referencePointLocal, m_verts[vertIndex].m_position, m_verts[vertIndex + 1].m_position, m_verts[vertIndex + 2].m_position);
+		Vec3 triNearestLocalPoint = GetNearestPointOnTriangle3D(referencePointLocal, cornerA, cornerB, cornerC);
 
 		if (triNearestLocalPoint.x != triNearestLocalPoint.x)
 		{
@@ -967,12 +677,30 @@ Vec3 MobiusPLTD::GetNearestPointOnPlanetoid(Vec3 playerPos) const
 }
 
 
+AABB3 MobiusPLTD::CalculateWorldBounds() const
+{
+	if (m_verts.empty())
+	{
+		return AABB3(m_position, m_position);
+	}
+
+	AABB3 localBounds = AABB3(m_verts[0].m_position, m_verts[0].m_position);
+	for (int vertIndex = 1; vertIndex < m_verts.size(); vertIndex++)
+	{
+		BoundingVolumeHierarchy::StretchToIncludePoint3D(localBounds, m_verts[vertIndex].m_position);
+	}
+
+	return BoundingVolumeHierarchy::GetBoundsOfLocalBox3D(GetModelMatrix(), localBounds.m_mins, localBounds.m_maxs);
+}
+
+
 //
 //wire planetoid functions
 //
 WirePLTD::WirePLTD(Vec3 position, float radius, WirePerlinParameters perlinStruct, EulerAngles orientation, bool includeField, float gravityRadius, float gravityForce, Rgba8 color)
 	: Planetoid(position, orientation, color)
 	, m_radius(radius)
+	, m_perlinParameters(perlinStruct)
 {
 	WirePerlinParameters& ps = perlinStruct;
 	
@@ -1004,91 +732,36 @@ WirePLTD::WirePLTD(Vec3 position, float radius, WirePerlinParameters perlinStruc
 		segmentStart = segmentEnd;
 	}
 
+	BuildWorldSegments();
+
 	//create field
 	if(includeField) m_field = new WireField(this, gravityRadius, gravityForce);
 
 	AddVertsForWire(m_verts);
+	BuildIndexedMesh(m_verts, m_indexes);
 }
 
 
-void WirePLTD::Render() const
+bool WirePLTD::CollideWithPlayer(Player* player, std::vector<int>& nearbyScratch)
 {
-	g_theRenderer->BindShader(g_theGame->m_lightingShader);
-	g_theRenderer->BindTexture(nullptr);
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-	g_theRenderer->SetModelConstants(GetModelMatrix(), m_color);
-	g_theRenderer->DrawVertexArray(m_verts);
-}
-
-
-void WirePLTD::RenderPreview(Vec3 position, float radius, WirePerlinParameters perlinStruct, EulerAngles orientation, float gravityRadius, Rgba8 color)
-{
-	std::vector<Vec3> wirePositions;
-	WirePerlinParameters& ps = perlinStruct;
-
-	//worm setup
-	RandomNumberGenerator rng;
-	rng.SeedRNG(ps.m_rngSeed);
-	int numSegments = rng.RollRandomIntInRange(ps.m_minSegments, ps.m_maxSegments);
-	Vec3 segmentStart = Vec3();
-	wirePositions.emplace_back(segmentStart);
-	float horizontalDirectionDegrees = 0.0f;
+	PROFILE_SCOPE("WirePLTD::CollideWithPlayer");
 
-	//calculate each segment
-	for (int segIndex = 0; segIndex < numSegments; segIndex++)
-	{
-		float horizontalDirectionChange = ps.m_maxYawChange * Compute3dPerlinNoise(segmentStart.x + position.x, segmentStart.y + position.y, segmentStart.z + position.z,
-			ps.m_perlinScaleYaw, ps.m_perlinOctavesYaw, ps.m_perlinOctavePersistYaw, ps.m_perlinOctaveScaleYaw, true, ps.m_rngSeed);
-		//horizontalDirectionChange = RangeMap(horizontalDirectionChange, -1.0f, 1.0f, -ps.m_maxYawChange, ps.m_maxYawChange);
-		horizontalDirectionDegrees += horizontalDirectionChange;
-
-		float verticalDirectionDegrees = ps.m_maxPitchChange * Compute3dPerlinNoise(segmentStart.x + position.x, segmentStart.y + position.y, segmentStart.z + position.z,
-			ps.m_perlinScalePitch, ps.m_perlinOctavesPitch, ps.m_perlinOctavePersistPitch, ps.m_perlinOctaveScalePitch, true, ps.m_rngSeed);
-
-		float segmentLength = static_cast<float>(rng.RollRandomFloatInRange(ps.m_segMinLength, ps.m_segMaxLength));
-		Vec3 segmentVector = Vec3::MakeFromPolarDegrees(verticalDirectionDegrees, horizontalDirectionDegrees, segmentLength);
-		Vec3 segmentEnd = segmentStart + Vec3(segmentVector.x, segmentVector.y, segmentVector.z);
-
-		wirePositions.emplace_back(segmentEnd);
-
-		segmentStart = segmentEnd;
-	}
-	
-	std::vector<Vertex_PCU> verts;
-
-	AddVertsForWireStatic(verts, wirePositions, radius);
-	Mat44 modelMatrix = orientation.GetAsMatrix_XFwd_YLeft_ZUp();
-	modelMatrix.SetTranslation3D(position);
-	Rgba8 previewColor = Rgba8(color.r, color.g, color.b, 127);
-
-	g_theRenderer->BindShader(nullptr);
-	g_theRenderer->BindTexture(nullptr);
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-	g_theRenderer->SetModelConstants(modelMatrix, previewColor);
-	g_theRenderer->DrawVertexArray(verts);
-
-	std::vector<Vertex_PCU> gravVerts;
-
-	AddVertsForWireStatic(gravVerts, wirePositions, gravityRadius);
-
-	g_theRenderer->BindShader(nullptr);
-	g_theRenderer->BindTexture(nullptr);
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-	g_theRenderer->SetModelConstants(modelMatrix, g_previewGravFieldColor);
-	g_theRenderer->DrawVertexArray(gravVerts);
-}
+	bool pushOut = false;
 
+	//pushes move the player, so segments are searched for one extra collision radius around where the player starts
+	//if the pushes carry the player further than that the search is widened and picks up after the current segment, so nothing the full loop would touch is missed
+	//segments are resolved in wire order so long wires behave the same as before
+	Vec3 startPosition = player->m_position;
+	float searchMargin = player->m_collisionRadius;
+	nearbyScratch.clear();
+	m_segmentBVH.QuerySphere(startPosition, player->m_collisionRadius + searchMargin, nearbyScratch);
+	std::sort(nearbyScratch.begin(), nearbyScratch.end());
 
-bool WirePLTD::CollideWithPlayer(Player* player)
-{
-	bool pushOut = false;
-	
-	for (int segIndex = 0; segIndex < m_wirePositions.size() - 1; segIndex++)
+	for (int nearbyIndex = 0; nearbyIndex < nearbyScratch.size(); nearbyIndex++)
 	{
-		Vec3 wireStart = m_wirePositions[segIndex];
-		wireStart = GetModelMatrix().TransformPosition3D(wireStart);
-		Vec3 wireEnd = m_wirePositions[segIndex + 1];
-		wireEnd = GetModelMatrix().TransformPosition3D(wireEnd);
+		int segIndex = nearbyScratch[nearbyIndex];
+		Vec3 const& wireStart = m_worldWirePositions[segIndex];
+		Vec3 const& wireEnd = m_worldWirePositions[segIndex + 1];
 		
 		if (PushSphereOutOfFixedCapsule3D(player->m_position, player->m_collisionRadius, wireStart, wireEnd, m_radius))
 		{
@@ -1100,6 +773,16 @@ bool WirePLTD::CollideWithPlayer(Player* player)
 			{
 				player->BecomeGrounded();
 			}
+
+			float pushDistance = GetDistance3D(startPosition, player->m_position);
+			if (pushDistance > searchMargin)
+			{
+				searchMargin = pushDistance + player->m_collisionRadius;
+				nearbyScratch.clear();
+				m_segmentBVH.QuerySphere(startPosition, player->m_collisionRadius + searchMargin, nearbyScratch);
+				std::sort(nearbyScratch.begin(), nearbyScratch.end());
+				nearbyIndex = static_cast<int>(std::upper_bound(nearbyScratch.begin(), nearbyScratch.end(), segIndex) - nearbyScratch.begin()) - 1;
+			}
 		}
 	}
 
@@ -1109,26 +792,83 @@ bool WirePLTD::CollideWithPlayer(Player* player)
 
 Vec3 WirePLTD::GetNearestPointOnPlanetoid(Vec3 playerPos) const
 {
-	//INCOMPLETE
-	UNUSED(playerPos);
-	return Vec3();
+	float nearestDistSq = FLT_MAX;
+	int nearestSegment = m_segmentBVH.QueryNearest(playerPos, [this, &playerPos](int segIndex)
+		{
+			Vec3 nearestPointOnSegment = GetNearestPointOnCapsule3D(playerPos, m_worldWirePositions[segIndex], m_worldWirePositions[segIndex + 1], m_radius);
+			return GetDistanceSquared3D(playerPos, nearestPointOnSegment);
+		}, nearestDistSq);
+
+	if (nearestSegment < 0)
+	{
+		return Vec3(FLT_MAX, FLT_MAX, FLT_MAX);
+	}
+
+	return GetNearestPointOnCapsule3D(playerPos, m_worldWirePositions[nearestSegment], m_worldWirePositions[nearestSegment + 1], m_radius);
 }
 
 
-void WirePLTD::AddVertsForWire(std::vector<Vertex_PCUTBN>& verts) const
+AABB3 WirePLTD::CalculateWorldBounds() const
 {
-	for (int segIndex = 0; segIndex < m_wirePositions.size() - 1; segIndex++)
+	if (!m_segmentBVH.IsEmpty())
 	{
-		AddVertsForCapsule3D(verts, m_wirePositions[segIndex], m_wirePositions[segIndex + 1], m_radius);
+		return m_segmentBVH.m_nodes[0].m_bounds;
+	}
+
+	return BoundingVolumeHierarchy::GetBoundsOfCapsule3D(m_worldWirePositions[0], m_worldWirePositions[0], m_radius);
+}
+
+
+void WirePLTD::OnTransformChanged()
+{
+	BuildWorldSegments();
+	UpdateWorldBounds();
+}
+
+
+bool WirePLTD::IsSphereTouchingWire(Vec3 const& center, float sphereRadius, float wireRadius) const
+{
+	//the tree is built around m_radius, so a thicker wire needs the query grown by the difference
+	float extraWireRadius = wireRadius - m_radius;
+	if (extraWireRadius < 0.0f)
+	{
+		extraWireRadius = 0.0f;
+	}
+
+	//only whether any segment touches matters, so the tree is walked in place and stops at the first hit
+	return m_segmentBVH.QuerySphereAny(center, sphereRadius + extraWireRadius, [this, &center, sphereRadius, wireRadius](int segIndex)
+		{
+			Vec3 nearestPointOnWire = GetNearestPointOnCapsule3D(center, m_worldWirePositions[segIndex], m_worldWirePositions[segIndex + 1], wireRadius);
+			return IsSphereInFixedPoint3D(center, sphereRadius, nearestPointOnWire);
+		});
+}
+
+
+void WirePLTD::BuildWorldSegments()
+{
+	Mat44 const& modelMatrix = GetModelMatrix();
+
+	m_worldWirePositions.clear();
+	m_worldWirePositions.reserve(m_wirePositions.size());
+	for (int posIndex = 0; posIndex < m_wirePositions.size(); posIndex++)
+	{
+		m_worldWirePositions.emplace_back(modelMatrix.TransformPosition3D(m_wirePositions[posIndex]));
+	}
+
+	std::vector<AABB3> segmentBounds;
+	for (int segIndex = 0; segIndex + 1 < m_worldWirePositions.size(); segIndex++)
+	{
+		segmentBounds.emplace_back(BoundingVolumeHierarchy::GetBoundsOfCapsule3D(m_worldWirePositions[segIndex], m_worldWirePositions[segIndex + 1], m_radius));
 	}
+	m_segmentBVH.Build(segmentBounds);
 }
 
 
-void WirePLTD::AddVertsForWireStatic(std::vector<Vertex_PCU>& verts, std::vector<Vec3> const& wirePositions, float radius)
+void WirePLTD::AddVertsForWire(std::vector<Vertex_PCUTBN>& verts) const
 {
-	for (int segIndex = 0; segIndex < wirePositions.size() - 1; segIndex++)
+	for (int segIndex = 0; segIndex < m_wirePositions.size() - 1; segIndex++)
 	{
-		AddVertsForCapsule3D(verts, wirePositions[segIndex], wirePositions[segIndex + 1], radius);
+		AddVertsForCapsule3D(verts, m_wirePositions[segIndex], m_wirePositions[segIndex + 1], m_radius);
 	}
 }
 
@@ -1145,135 +885,58 @@ PrefabPLTD::~PrefabPLTD()
 }
 
 
-void PrefabPLTD::Render() const
+bool PrefabPLTD::CollideWithPlayer(Player* player, std::vector<int>& nearbyScratch)
 {
-	if (m_model != nullptr)
-	{
-		m_model->RenderGPUMesh(g_theGame->m_sunDirection, g_theGame->m_sunIntensity, g_theGame->m_ambientIntensity);
-	}
+	PROFILE_SCOPE("PrefabPLTD::CollideWithPlayer");
+
+	//far away prefabs are culled by the broad phase in Simulation::CollidePlayerWithAllPlanetoids
+	return m_model->PushPlayerOutOfAllTrisOnModel(player, nearbyScratch, m_queryMode);
 }
 
 
-void PrefabPLTD::RenderPreview(Model* model, Vec3 position, EulerAngles orientation, Rgba8 color, bool includeField, int modelType, float gravScale)
+Vec3 PrefabPLTD::GetNearestPointOnPlanetoid(Vec3 playerPos) const
 {
-	//#ToDo: Add gravity field to preview
+	return m_model->GetNearestPointOnModel(playerPos, m_queryMode);
+}
 
-	if (model != nullptr)
-	{
-		model->m_position = position;
-		model->m_orientation = orientation;
-		model->m_color = color;
-		model->RenderGPUMesh(g_theGame->m_sunDirection, g_theGame->m_sunIntensity, g_theGame->m_ambientIntensity);
 
-		if (includeField)
-		{
-			switch (modelType)
-			{
-				case 0:
-				{
-					std::vector<Vertex_PCU> gravVerts;
-
-					AddVertsForSphere3D(gravVerts, Vec3(), gravScale, 32, 16);
-
-					Mat44 modelMatrix = orientation.GetAsMatrix_XFwd_YLeft_ZUp();
-					modelMatrix.SetTranslation3D(position + modelMatrix.TransformVectorQuantity3D(Vec3(0.0f, 0.0f, 6.5f)));
-
-					g_theRenderer->BindShader(nullptr);
-					g_theRenderer->BindTexture(nullptr);
-					g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-					g_theRenderer->SetModelConstants(modelMatrix, g_previewGravFieldColor);
-					g_theRenderer->DrawVertexArray(gravVerts);
-
-					break;
-				}
-				case 1:
-				{
-					std::vector<Vertex_PCU> verts;
-
-					Mat44 modelMatrix = orientation.GetAsMatrix_XFwd_YLeft_ZUp();
-					modelMatrix.SetTranslation3D(position);
-					Vec3 boneStart = Vec3(-12.5f, -25.5f, -18.0f);
-					boneStart = modelMatrix.TransformPosition3D(boneStart);
-					Vec3 boneEnd = Vec3(-12.5f, 26.5f, -18.0f);
-					boneEnd = modelMatrix.TransformPosition3D(boneEnd);
-
-					AddVertsForSector3D(verts, gravScale, boneStart, boneEnd, orientation.m_pitchDegrees + 45.0f, 80.0f);
-
-					g_theRenderer->BindShader(nullptr);
-					g_theRenderer->BindTexture(nullptr);
-					g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-					g_theRenderer->SetModelConstants(Mat44(), g_gravFieldColor);
-					g_theRenderer->DrawVertexArray(verts);
-
-					break;
-				}
-				case 2:
-				{
-					std::vector<Vertex_PCU> gravVerts;
-
-					AddVertsForSphere3D(gravVerts, Vec3(), gravScale, 32, 16);
-
-					Mat44 modelMatrix = orientation.GetAsMatrix_XFwd_YLeft_ZUp();
-					modelMatrix.SetTranslation3D(position);
-
-					g_theRenderer->BindShader(nullptr);
-					g_theRenderer->BindTexture(nullptr);
-					g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-					g_theRenderer->SetModelConstants(modelMatrix, g_previewGravFieldColor);
-					g_theRenderer->DrawVertexArray(gravVerts);
-
-					break;
-				}
-				case 3:
-				{
-					std::vector<Vertex_PCU> gravVerts;
-
-					float halfLength = 49.0f;
-					float halfWidth = 49.0f;
-
-					Vec3 fbl = Vec3(halfLength, halfWidth, 0.0f);
-					Vec3 fbr = Vec3(halfLength, -halfWidth, 0.0f);
-					Vec3 bbl = Vec3(-halfLength, halfWidth, 0.0f);
-					Vec3 bbr = Vec3(-halfLength, -halfWidth, 0.0f);
-					Vec3 ftl = Vec3(halfLength, halfWidth, gravScale);
-					Vec3 ftr = Vec3(halfLength, -halfWidth, gravScale);
-					Vec3 btl = Vec3(-halfLength, halfWidth, gravScale);
-					Vec3 btr = Vec3(-halfLength, -halfWidth, gravScale);
-
-					AddVertsForCube3D(gravVerts, fbl, fbr, ftl, ftr, bbl, bbr, btl, btr);
-
-					Mat44 modelMatrix = orientation.GetAsMatrix_XFwd_YLeft_ZUp();
-					modelMatrix.SetTranslation3D(position);
-
-					g_theRenderer->BindShader(nullptr);
-					g_theRenderer->BindTexture(nullptr);
-					g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-					g_theRenderer->SetModelConstants(modelMatrix, g_previewGravFieldColor);
-					g_theRenderer->DrawVertexArray(gravVerts);
-
-					break;
-				}
-			}
-		}
+AABB3 PrefabPLTD::CalculateWorldBounds() const
+{
+	if (m_model == nullptr || !m_model->IsReady())
+	{
+		return AABB3(m_position, m_position);
 	}
+
+	AABB3 const& localBounds = m_model->m_asset->m_localBounds;
+	return BoundingVolumeHierarchy::GetBoundsOfLocalBox3D(m_model->GetModelMatrix(), localBounds.m_mins, localBounds.m_maxs);
 }
 
 
-bool PrefabPLTD::CollideWithPlayer(Player* player)
+void PrefabPLTD::SetQueryMode(ModelQueryMode queryMode, float gridCellSize)
 {
-	//early out if player is very far away
-	if (GetDistanceSquared3D(player->m_position, m_position) > 20000.0f)
+	m_queryMode = queryMode;
+	m_gridCellSize = gridCellSize;
+
+	//a model still loading gets its grid in OnModelLoaded
+	if (m_model == nullptr || !m_model->IsReady() || queryMode == MODEL_QUERY_EXACT)
 	{
-		return false;
+		return;
 	}
 
-	return m_model->PushPlayerOutOfAllTrisOnModel(player);
+	//grids live on the shared asset by resolution, prefabs asking for the same one share it and other prefabs keep theirs
+	ClosestPointGrid const* grid = m_model->m_closestPointGrid;
+	if (grid == nullptr || grid->m_cellSize != gridCellSize)
+	{
+		m_model->BakeClosestPointGrid(gridCellSize);
+	}
 }
 
 
-Vec3 PrefabPLTD::GetNearestPointOnPlanetoid(Vec3 playerPos) const
+void PrefabPLTD::OnModelLoaded()
 {
-	return m_model->GetNearestPointOnModel(playerPos);
+	//bounds were only a point while the model loaded, and the grid couldn't be baked yet
+	UpdateWorldBounds();
+	SetQueryMode(m_queryMode, m_gridCellSize);
 }
 
 
@@ -1284,7 +947,7 @@ TeapotPLTD::TeapotPLTD(Vec3 position, float scale, EulerAngles orientation, Rgba
 	: PrefabPLTD(position, scale, orientation, color)
 {
 	m_model = new Model(position, scale, orientation, color);
-	m_model->ParseXMLFileForOBJ("Data/Models/Teapot.xml");
+	m_model->ParseXMLFileForOBJ("Data/Models/Teapot.xml", true);
 
 	if(includeField) m_field = new SphereField(this, gravityRadius, gravityForce, Vec3(0.0f, 0.0f, 6.5f));
 }
@@ -1297,7 +960,7 @@ SkyStationPLTD::SkyStationPLTD(Vec3 position, float scale, EulerAngles orientati
 	: PrefabPLTD(position, scale, orientation, color)
 {
 	m_model = new Model(position, scale, orientation, color);
-	m_model->ParseXMLFileForOBJ("Data/Models/DrumSeparateRocketPlanet.xml");
+	m_model->ParseXMLFileForOBJ("Data/Models/DrumSeparateRocketPlanet.xml", true);
 
 	Mat44 modelMatrix = GetModelMatrix();
 	modelMatrix.AppendScaleUniform3D(scale);
@@ -1319,7 +982,7 @@ MountainPLTD::MountainPLTD(Vec3 position, float scale, EulerAngles orientation,
 	: PrefabPLTD(position, scale, orientation, color)
 {
 	m_model = new Model(position, scale, orientation, color);
-	m_model->ParseXMLFileForOBJ("Data/Models/MountainPlanet.xml");
+	m_model->ParseXMLFileForOBJ("Data/Models/MountainPlanet.xml", true);
 
 	if(includeField) m_field = new SphereField(this, gravityRadius, gravityForce);
 }
@@ -1332,7 +995,7 @@ FortressPLTD::FortressPLTD(Vec3 position, float scale, EulerAngles orientation,
 	: PrefabPLTD(position, scale, orientation, color)
 {
 	m_model = new Model(position, scale, orientation, color);
-	m_model->ParseXMLFileForOBJ("Data/Models/OldFortressPlanet.xml");
+	m_model->ParseXMLFileForOBJ("Data/Models/OldFortressPlanet.xml", true);
 
 	if(includeField) m_field = new PlaneField(this, 49.0f, 49.0f, gravityHeight, gravityForce);
 }
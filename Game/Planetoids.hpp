@@ -1,8 +1,12 @@
 #pragma once
 #include "Game/GravityFields.hpp"
+#include "Game/Model.hpp"
+#include "Game/BoundingVolumeHierarchy.hpp"
+#include "Game/MeshUploader.hpp"
 #include "Engine/Math/Vec3.hpp"
 #include "Engine/Core/Rgba8.hpp"
 #include "Engine/Math/Mat44.hpp"
+#include "Engine/Math/AABB3.hpp"
 #include "Engine/Math/EulerAngles.hpp"
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Core/Vertex_PCU.hpp"
@@ -11,7 +15,6 @@
 
 //forward declarations
 class Player;
-class Model;
 
 
 //abstract base class
@@ -20,32 +23,66 @@ class Planetoid
 //public member functions
 public:
 	//constructor and destructor
-	Planetoid(Vec3 position, EulerAngles orientation = EulerAngles(), Rgba8 color = Rgba8()) : m_position(position), m_orientation(orientation), m_color(color) {}
+	Planetoid(Vec3 position, EulerAngles orientation = EulerAngles(), Rgba8 color = Rgba8()) : m_position(position), m_orientation(orientation), m_color(color) 
+	{
+		UpdateModelMatrices();
+	}
 	virtual ~Planetoid() 
 	{
 		if (m_field != nullptr) delete m_field;
+		DestroyGPUMesh();
 	}
 
+#if !defined(GAME_HEADLESS)
 	//game flow functions
 	virtual void Render() const = 0;
-	virtual void DebugRender() const;
+	void		 DrawGPUMesh() const;
+#endif
 
-	//planetoid utilities
-	virtual bool CollideWithPlayer(Player* player) = 0;
+	//gpu mesh functions, the mesh is uploaded once after spawning and shared with any planetoid tessellated the same
+	void CreateGPUMesh(MeshUploader& uploader);
+	void DestroyGPUMesh();
+
+	//planetoid utilities, nearbyScratch is the caller's buffer for narrow phase queries so collision never allocates
+	virtual bool CollideWithPlayer(Player* player, std::vector<int>& nearbyScratch) = 0;
 	virtual Vec3 GetNearestPointOnPlanetoid(Vec3 playerPos) const = 0;
 
 	//math utilities
-	Mat44 GetModelMatrix() const;
+	Mat44 const& GetModelMatrix() const { return m_modelMatrix; }
+	Mat44 const& GetInverseModelMatrix() const { return m_inverseModelMatrix; }
+	void		 SetPosition(Vec3 const& position);
+	void		 SetOrientation(EulerAngles const& orientation);
+
+	//spatial utilities
+	virtual AABB3 CalculateWorldBounds() const = 0;
+	void		  UpdateWorldBounds();
+	virtual void  OnTransformChanged() {}
+
+//private member functions
+private:
+	void UpdateModelMatrices();
 
 //public member variables
 public:
+	//change through SetPosition and SetOrientation so the cached matrices stay in sync
 	Vec3 m_position;
 	EulerAngles m_orientation; //Shouldn't need to bother with quaternions for planetoids since they're stationary
 	Rgba8 m_color;
 
 	GravityField* m_field = nullptr;
+	AABB3 m_worldBounds;	//cached by UpdateWorldBounds, planetoids don't move after spawning
 
+	//welded by BuildIndexedMesh, so triangles are read through m_indexes
 	std::vector<Vertex_PCUTBN> m_verts;
+	std::vector<unsigned int>  m_indexes;
+	GPUMesh*				   m_gpuMesh = nullptr;
+	MeshUploader*			   m_meshUploader = nullptr;	//whoever created m_gpuMesh, so it can release it
+	uint64_t				   m_meshKey = 0;				//m_meshUploader's key for m_gpuMesh
+
+//private member variables
+private:
+	Mat44 m_modelMatrix;
+	Mat44 m_inverseModelMatrix;
 };
 
 
@@ -57,13 +94,15 @@ public:
 	//constructor
 	PlanePLTD(Vec3 position, float halfLength, float halfWidth, EulerAngles orientation, bool includeField, float gravityHeight, float gravityForce = GRAVITY_STANDARD, Rgba8 color = Rgba8());
 	
+#if !defined(GAME_HEADLESS)
 	//game flow functions
 	virtual void Render() const override;
-	static  void RenderPreview(Vec3 position, float halfLength, float halfWidth, EulerAngles orientation, float gravityHeight, Rgba8 color);
+#endif
 
 	//planetoid utilities
-	virtual bool CollideWithPlayer(Player* player) override;
+	virtual bool CollideWithPlayer(Player* player, std::vector<int>& nearbyScratch) override;
 	virtual Vec3 GetNearestPointOnPlanetoid(Vec3 playerPos) const override;
+	virtual AABB3 CalculateWorldBounds() const override;
 
 //public member variables
 public:
@@ -79,13 +118,15 @@ public:
 	//constructor
 	SpherePLTD(Vec3 position, float radius, bool includeField, float gravityRadius, float gravityForce = GRAVITY_STANDARD, Rgba8 color = Rgba8());
 
+#if !defined(GAME_HEADLESS)
 	//game flow functions
 	virtual void Render() const override;
-	static  void RenderPreview(Vec3 position, float radius, float gravityRadius, Rgba8 color);
+#endif
 
 	//planetoid utilities
-	virtual bool CollideWithPlayer(Player* player) override;
+	virtual bool CollideWithPlayer(Player* player, std::vector<int>& nearbyScratch) override;
 	virtual Vec3 GetNearestPointOnPlanetoid(Vec3 playerPos) const override;
+	virtual AABB3 CalculateWorldBounds() const override;
 
 //public member variables
 public:
@@ -100,13 +141,16 @@ public:
 	//constructor
 	CapsulePLTD(Vec3 position, float radius, float boneLength, Vec3 boneDirection, bool includeField, float gravityRadius, float gravityForce = GRAVITY_STANDARD, Rgba8 color = Rgba8());
 
+#if !defined(GAME_HEADLESS)
 	//game flow functions
 	virtual void Render() const override;
-	static void  RenderPreview(Vec3 position, float radius, float boneLength, Vec3 boneDirection, float gravityRadius, Rgba8 color);
+#endif
 
 	//planetoid utilities
-	virtual bool CollideWithPlayer(Player* player) override;
+	virtual bool CollideWithPlayer(Player* player, std::vector<int>& nearbyScratch) override;
 	virtual Vec3 GetNearestPointOnPlanetoid(Vec3 playerPos) const override;
+	virtual AABB3 CalculateWorldBounds() const override;
+	virtual void  OnTransformChanged() override;
 
 //public member variables
 public:
@@ -125,14 +169,15 @@ public:
 	EllipsoidPLTD(Vec3 position, float xRadius, float yRadius, float zRadius, EulerAngles orientation, bool includeField, float gravityXRadius, float gravityYRadius, float gravityZRadius,
 		float gravityForce = GRAVITY_STANDARD, Rgba8 color = Rgba8());
 
+#if !defined(GAME_HEADLESS)
 	//game flow functions
 	virtual void Render() const override;
-	static void  RenderPreview(Vec3 position, float xRadius, float yRadius, float zRadius, EulerAngles orientation, float gravityXRadius, float gravityYRadius, float gravityZRadius, 
-		Rgba8 color);
+#endif
 
 	//planetoid utilities
-	virtual bool CollideWithPlayer(Player* player) override;
+	virtual bool CollideWithPlayer(Player* player, std::vector<int>& nearbyScratch) override;
 	virtual Vec3 GetNearestPointOnPlanetoid(Vec3 playerPos) const override;
+	virtual AABB3 CalculateWorldBounds() const override;
 
 //public member variables
 public:
@@ -150,14 +195,15 @@ public:
 	RoundCubePLTD(Vec3 position, float length, float width, float height, float roundedness, EulerAngles orientation, bool includeField, float gravityLength, float gravityWidth, float gravityHeight,
 		float gravityForce = GRAVITY_STANDARD, Rgba8 color = Rgba8());
 
+#if !defined(GAME_HEADLESS)
 	//game flow functions
 	virtual void Render() const override;
-	static  void RenderPreview(Vec3 position, float length, float width, float height, float roundedness, EulerAngles orientation, float gravityLength, float gravityWidth, float gravityHeight,
-		Rgba8 color);
+#endif
 
 	//planetoid utilities
-	virtual bool CollideWithPlayer(Player* player) override;
+	virtual bool CollideWithPlayer(Player* player, std::vector<int>& nearbyScratch) override;
 	virtual Vec3 GetNearestPointOnPlanetoid(Vec3 playerPos) const override;
+	virtual AABB3 CalculateWorldBounds() const override;
 
 //public member variables
 public:
@@ -175,13 +221,15 @@ public:
 	//constructor
 	TorusPLTD(Vec3 position, float tubeRadius, float holeRadius, EulerAngles orientation, bool includeField, float gravityRadius, float gravityForce = GRAVITY_STANDARD, Rgba8 color = Rgba8());
 
+#if !defined(GAME_HEADLESS)
 	//game flow functions
 	virtual void Render() const override;
-	static  void RenderPreview(Vec3 position, float tubeRadius, float holeRadius, EulerAngles orientation, float gravityRadius, Rgba8 color);
+#endif
 
 	//planetoid utilities
-	virtual bool CollideWithPlayer(Player* player) override;
+	virtual bool CollideWithPlayer(Player* player, std::vector<int>& nearbyScratch) override;
 	virtual Vec3 GetNearestPointOnPlanetoid(Vec3 playerPos) const override;
+	virtual AABB3 CalculateWorldBounds() const override;
 
 //public member variables
 public:
@@ -197,20 +245,21 @@ public:
 	//constructor
 	BowlPLTD(Vec3 position, float radius, float thickness, EulerAngles orientation, bool includeField, float gravityRadius, float gravityForce = GRAVITY_STANDARD, Rgba8 color = Rgba8());
 
+#if !defined(GAME_HEADLESS)
 	//game flow functions
 	virtual void Render() const override;
-	static  void RenderPreview(Vec3 position, float radius, float thickness, EulerAngles orientation, float gravityRadius, Rgba8 color);
+#endif
 
 	//planetoid utilities
-	virtual bool CollideWithPlayer(Player* player) override;
+	virtual bool CollideWithPlayer(Player* player, std::vector<int>& nearbyScratch) override;
 	virtual Vec3 GetNearestPointOnPlanetoid(Vec3 playerPos) const override;
+	virtual AABB3 CalculateWorldBounds() const override;
 	bool		 PushSphereOutOfPlanetoid(Vec3& sphereCenter, float sphereRadius);
 
 //private member functions
 private:
 	//bowl-specific stuff
 	void AddVertsForBowl();
-	static void AddVertsForBowl(std::vector<Vertex_PCU>& verts, float radius, float thickness);
 
 //public member variables
 public:
@@ -226,13 +275,16 @@ public:
 	//constructor
 	MobiusPLTD(Vec3 position, float radius, float halfWidth, EulerAngles orientation, bool includeField, float gravityHeight, float gravityForce = GRAVITY_STANDARD, Rgba8 color = Rgba8());
 
+#if !defined(GAME_HEADLESS)
 	//game flow functions
 	virtual void Render() const override;
 	static void  RenderPreview(Vec3 position, float radius, float halfWidth, EulerAngles orientation, float gravityHeight, Rgba8 color);
+#endif
 
 	//planetoid utilities
-	virtual bool CollideWithPlayer(Player* player) override;
+	virtual bool CollideWithPlayer(Player* player, std::vector<int>& nearbyScratch) override;
 	virtual Vec3 GetNearestPointOnPlanetoid(Vec3 playerPos) const override;
+	virtual AABB3 CalculateWorldBounds() const override;
 
 //public member variables
 public:
@@ -271,20 +323,32 @@ public:
 	//constructor
 	WirePLTD(Vec3 position, float radius, WirePerlinParameters perlinStruct, EulerAngles orientation, bool includeField, float gravityRadius, float gravityForce, Rgba8 color);
 
+#if !defined(GAME_HEADLESS)
 	//game flow functions
 	virtual void Render() const override;
-	static  void RenderPreview(Vec3 position, float radius, WirePerlinParameters perlinStruct, EulerAngles orientation, float gravityRadius, Rgba8 color);
+#endif
 
 	//planetoid utilities
-	virtual bool CollideWithPlayer(Player* player) override;
+	virtual bool CollideWithPlayer(Player* player, std::vector<int>& nearbyScratch) override;
 	virtual Vec3 GetNearestPointOnPlanetoid(Vec3 playerPos) const override;
+	virtual AABB3 CalculateWorldBounds() const override;
+	virtual void  OnTransformChanged() override;
+	bool		 IsSphereTouchingWire(Vec3 const& center, float sphereRadius, float wireRadius) const;
 	void		 AddVertsForWire(std::vector<Vertex_PCUTBN>& verts) const;
-	static void  AddVertsForWireStatic(std::vector<Vertex_PCU>& verts, std::vector<Vec3> const& wirePositions, float radius);
+
+//private member functions
+private:
+	void BuildWorldSegments();
 
 //public member variables
 public:
 	float m_radius = 1.0f;
+	WirePerlinParameters m_perlinParameters;	//kept so the wire can be saved and grown again from the same seed
 	std::vector<Vec3> m_wirePositions;
+
+	//world space copy of m_wirePositions, so segments aren't transformed every frame
+	std::vector<Vec3>		m_worldWirePositions;
+	BoundingVolumeHierarchy m_segmentBVH;	//item i is the capsule from m_worldWirePositions[i] to m_worldWirePositions[i + 1]
 };
 
 
@@ -297,18 +361,25 @@ public:
 	PrefabPLTD(Vec3 position, float scale, EulerAngles orientation, Rgba8 color) : Planetoid(position, orientation, color), m_scale(scale) {}
 	~PrefabPLTD();
 
+#if !defined(GAME_HEADLESS)
 	//game flow functions
 	virtual void Render() const override;
 	static  void RenderPreview(Model* model, Vec3 position, EulerAngles orientation, Rgba8 color, bool includeField, int modelType, float gravScale);
+#endif
 
 	//planetoid utilities
-	virtual bool CollideWithPlayer(Player* player) override;
+	virtual bool CollideWithPlayer(Player* player, std::vector<int>& nearbyScratch) override;
 	virtual Vec3 GetNearestPointOnPlanetoid(Vec3 playerPos) const override;
+	virtual AABB3 CalculateWorldBounds() const override;
+	void SetQueryMode(ModelQueryMode queryMode, float gridCellSize = CLOSEST_POINT_GRID_DEFAULT_CELL_SIZE);
+	void OnModelLoaded();
 
 //public member variables
 public:
-	Model* m_model = nullptr;
+	Model* m_model = nullptr;	//loads in the background, the prefab is only a gravity field until it's ready
 	float  m_scale = 1.0f;
+	ModelQueryMode m_queryMode = MODEL_QUERY_EXACT;
+	float		   m_gridCellSize = CLOSEST_POINT_GRID_DEFAULT_CELL_SIZE;
 };
 
 
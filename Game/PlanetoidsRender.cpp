@@ -0,0 +1,291 @@
+#include "Game/Planetoids.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/Game.hpp"
+#include "Game/Model.hpp"
+#include "Engine/Core/Vertex_PCU.hpp"
+#include "Engine/Renderer/Renderer.hpp"
+#include "Engine/Renderer/GPUMesh.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/VertexUtils.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
+#include "Engine/Renderer/Shader.hpp"
+#include "Engine/Renderer/DebugRenderSystem.hpp"
+#include "ThirdParty/Squirrel/SmoothNoise.hpp"
+
+
+//
+//generic planetoid functions
+//
+void Planetoid::DrawGPUMesh() const
+{
+	//only planetoids added through Game::AddPlanetoid have a buffer
+	if (m_gpuMesh == nullptr)
+	{
+		return;
+	}
+
+	if (m_gpuMesh->m_indexBuffer != nullptr)
+	{
+		g_theRenderer->DrawVertexBufferIndexed(m_gpuMesh->m_vertexBuffer, m_gpuMesh->m_indexBuffer, static_cast<int>(m_indexes.size()));
+	}
+	else
+	{
+		g_theRenderer->DrawVertexBuffer(m_gpuMesh->m_vertexBuffer, static_cast<int>(m_verts.size()));
+	}
+}
+
+
+//
+//plane planetoid functions
+//
+void PlanePLTD::Render() const
+{
+	g_theRenderer->BindShader(g_theGame->m_lightingShader);
+	g_theRenderer->BindTexture(nullptr);
+	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
+	g_theRenderer->SetModelConstants(GetModelMatrix(), m_color);
+	DrawGPUMesh();
+}
+
+
+//
+//sphere planetoid functions
+//
+void SpherePLTD::Render() const
+{
+	g_theRenderer->BindShader(g_theGame->m_lightingShader);
+	g_theRenderer->BindTexture(nullptr);
+	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
+	g_theRenderer->SetModelConstants(GetModelMatrix(), m_color);
+	DrawGPUMesh();
+}
+
+
+//
+//capsule planetoid functions
+//
+void CapsulePLTD::Render() const
+{
+	g_theRenderer->BindShader(g_theGame->m_lightingShader);
+	g_theRenderer->BindTexture(nullptr);
+	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
+	g_theRenderer->SetModelConstants(GetModelMatrix(), m_color);
+	DrawGPUMesh();
+}
+
+
+//
+//ellipsoid planetoid functions
+//
+void EllipsoidPLTD::Render() const
+{
+	g_theRenderer->BindShader(g_theGame->m_lightingShader);
+	g_theRenderer->BindTexture(nullptr);
+	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
+	g_theRenderer->SetModelConstants(GetModelMatrix(), m_color);
+	DrawGPUMesh();
+}
+
+
+//
+//rounded cube planetoid functions
+//
+void RoundCubePLTD::Render() const
+{
+	g_theRenderer->BindShader(g_theGame->m_lightingShader);
+	g_theRenderer->BindTexture(nullptr);
+	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
+	g_theRenderer->SetModelConstants(GetModelMatrix(), m_color);
+	DrawGPUMesh();
+}
+
+
+//
+//torus planetoid functions
+//
+void TorusPLTD::Render() const
+{
+	g_theRenderer->BindShader(g_theGame->m_lightingShader);
+	g_theRenderer->BindTexture(nullptr);
+	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
+	g_theRenderer->SetModelConstants(GetModelMatrix(), m_color);
+	DrawGPUMesh();
+}
+
+
+//
+//bowl planetoid functions
+//
+void BowlPLTD::Render() const
+{
+	g_theRenderer->BindShader(g_theGame->m_lightingShader);
+	g_theRenderer->BindTexture(nullptr);
+	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
+	g_theRenderer->SetModelConstants(GetModelMatrix(), m_color);
+	DrawGPUMesh();
+}
+
+
+//
+//mobius strip planetoid functions
+//
+void MobiusPLTD::Render() const
+{
+	g_theRenderer->BindShader(g_theGame->m_lightingShader);
+	g_theRenderer->BindTexture(nullptr);
+	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
+	g_theRenderer->SetModelConstants(GetModelMatrix(), m_color);
+	DrawGPUMesh();
+}
+
+
+void MobiusPLTD::RenderPreview(Vec3 position, float radius, float halfWidth, EulerAngles orientation, float gravityHeight, Rgba8 color)
+{
+	std::vector<Vertex_PCU> verts;
+
+	AddVertsForMobiusStrip3D(verts, Vec3(), radius, halfWidth, 256);
+	Mat44 modelMatrix = orientation.GetAsMatrix_XFwd_YLeft_ZUp();
+	modelMatrix.SetTranslation3D(position);
+	Rgba8 previewColor = Rgba8(color.r, color.g, color.b, 127);
+
+	g_theRenderer->BindShader(nullptr);
+	g_theRenderer->BindTexture(nullptr);
+	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
+	g_theRenderer->SetModelConstants(modelMatrix, previewColor);
+	g_theRenderer->DrawVertexArray(verts);
+
+	std::vector<Vertex_PCU> gravVerts;
+
+	UNUSED(gravityHeight);
+}
+
+
+//
+//wire planetoid functions
+//
+void WirePLTD::Render() const
+{
+	g_theRenderer->BindShader(g_theGame->m_lightingShader);
+	g_theRenderer->BindTexture(nullptr);
+	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
+	g_theRenderer->SetModelConstants(GetModelMatrix(), m_color);
+	DrawGPUMesh();
+}
+
+
+//
+//prefab planetoid functions
+//
+void PrefabPLTD::Render() const
+{
+	if (m_model != nullptr)
+	{
+		m_model->RenderGPUMesh(g_theGame->m_sunDirection, g_theGame->m_sunIntensity, g_theGame->m_ambientIntensity);
+	}
+}
+
+
+void PrefabPLTD::RenderPreview(Model* model, Vec3 position, EulerAngles orientation, Rgba8 color, bool includeField, int modelType, float gravScale)
+{
+	//#ToDo: Add gravity field to preview
+
+	if (model != nullptr)
+	{
+		model->SetPosition(position);
+		model->SetOrientation(orientation);
+		model->m_color = color;
+		model->RenderGPUMesh(g_theGame->m_sunDirection, g_theGame->m_sunIntensity, g_theGame->m_ambientIntensity);
+
+		if (includeField)
+		{
+			switch (modelType)
+			{
+				case 0:
+				{
+					std::vector<Vertex_PCU> gravVerts;
+
+					AddVertsForSphere3D(gravVerts, Vec3(), gravScale, 32, 16);
+
+					Mat44 modelMatrix = orientation.GetAsMatrix_XFwd_YLeft_ZUp();
+					modelMatrix.SetTranslation3D(position + modelMatrix.TransformVectorQuantity3D(Vec3(0.0f, 0.0f, 6.5f)));
+
+					g_theRenderer->BindShader(nullptr);
+					g_theRenderer->BindTexture(nullptr);
+					g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
+					g_theRenderer->SetModelConstants(modelMatrix, g_previewGravFieldColor);
+					g_theRenderer->DrawVertexArray(gravVerts);
+
+					break;
+				}
+				case 1:
+				{
+					std::vector<Vertex_PCU> verts;
+
+					Mat44 modelMatrix = orientation.GetAsMatrix_XFwd_YLeft_ZUp();
+					modelMatrix.SetTranslation3D(position);
+					Vec3 boneStart = Vec3(-12.5f, -25.5f, -18.0f);
+					boneStart = modelMatrix.TransformPosition3D(boneStart);
+					Vec3 boneEnd = Vec3(-12.5f, 26.5f, -18.0f);
+					boneEnd = modelMatrix.TransformPosition3D(boneEnd);
+
+					AddVertsForSector3D(verts, gravScale, boneStart, boneEnd, orientation.m_pitchDegrees + 45.0f, 80.0f);
+
+					g_theRenderer->BindShader(nullptr);
+					g_theRenderer->BindTexture(nullptr);
+					g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
+					g_theRenderer->SetModelConstants(Mat44(), g_gravFieldColor);
+					g_theRenderer->DrawVertexArray(verts);
+
+					break;
+				}
+				case 2:
+				{
+					std::vector<Vertex_PCU> gravVerts;
+
+					AddVertsForSphere3D(gravVerts, Vec3(), gravScale, 32, 16);
+
+					Mat44 modelMatrix = orientation.GetAsMatrix_XFwd_YLeft_ZUp();
+					modelMatrix.SetTranslation3D(position);
+
+					g_theRenderer->BindShader(nullptr);
+					g_theRenderer->BindTexture(nullptr);
+					g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
+					g_theRenderer->SetModelConstants(modelMatrix, g_previewGravFieldColor);
+					g_theRenderer->DrawVertexArray(gravVerts);
+
+					break;
+				}
+				case 3:
+				{
+					std::vector<Vertex_PCU> gravVerts;
+
+					float halfLength = 49.0f;
+					float halfWidth = 49.0f;
+
+					Vec3 fbl = Vec3(halfLength, halfWidth, 0.0f);
+					Vec3 fbr = Vec3(halfLength, -halfWidth, 0.0f);
+					Vec3 bbl = Vec3(-halfLength, halfWidth, 0.0f);
+					Vec3 bbr = Vec3(-halfLength, -halfWidth, 0.0f);
+					Vec3 ftl = Vec3(halfLength, halfWidth, gravScale);
+					Vec3 ftr = Vec3(halfLength, -halfWidth, gravScale);
+					Vec3 btl = Vec3(-halfLength, halfWidth, gravScale);
+					Vec3 btr = Vec3(-halfLength, -halfWidth, gravScale);
+
+					AddVertsForCube3D(gravVerts, fbl, fbr, ftl, ftr, bbl, bbr, btl, btr);
+
+					Mat44 modelMatrix = orientation.GetAsMatrix_XFwd_YLeft_ZUp();
+					modelMatrix.SetTranslation3D(position);
+
+					g_theRenderer->BindShader(nullptr);
+					g_theRenderer->BindTexture(nullptr);
+					g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
+					g_theRenderer->SetModelConstants(modelMatrix, g_previewGravFieldColor);
+					g_theRenderer->DrawVertexArray(gravVerts);
+
+					break;
+				}
+			}
+		}
+	}
+}
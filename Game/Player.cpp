@@ -1,242 +1,62 @@
 #include "Game/Player.hpp"
-#include "Game/Game.hpp"
-#include "Game/GameCommon.hpp"
 #include "Game/Planetoids.hpp"
 #include "Game/GravityFields.hpp"
 #include "Engine/Core/EngineCommon.hpp"
-#include "Engine/Input/InputSystem.hpp"
-#include "Engine/Math/IntVec2.hpp"
 #include "Engine/Math/MathUtils.hpp"
-#include "Engine/Core/VertexUtils.hpp"
-#include "Engine/Renderer/Renderer.hpp"
-#include "Engine/Renderer/DebugRenderSystem.hpp"
 #include "Engine/Math/AABB3.hpp"
 
 
 //
 //public game flow functions
 //
-void Player::Update(float deltaSeconds)
+void Player::UpdateTick(float deltaSeconds, PlayerCommand const& command)
 {
-	//handle movement input
-	m_isSpeedUp = false;
-	m_movementIntentions = Vec3();
-	m_movementDirection = Vec2();
-	m_yawIntentions = 0;
+	m_actionsThisTick.clear();
 
-	if (g_theInput->IsKeyDown('W'))
-	{
-		if (m_isTankTurn) m_movementIntentions.x += 1.0f;
-		else m_movementDirection.x += 1.0f;
-	}
-	if (g_theInput->IsKeyDown('S'))
-	{
-		if (m_isTankTurn) m_movementIntentions.x -= 1.0f;
-		else m_movementDirection.x -= 1.0f;
-	}
-	if (g_theInput->IsKeyDown('A'))
-	{
-		if (m_isTankTurn) m_yawIntentions += 1.0f;
-		else m_movementDirection.y += 1.0f;
-	}
-	if (g_theInput->IsKeyDown('D'))
-	{
-		if (m_isTankTurn) m_yawIntentions -= 1.0f;
-		else m_movementDirection.y -= 1.0f;
-	}
-	if (g_theInput->IsKeyDown('Q'))
-	{
-		if (m_currentGravitySource == nullptr || m_isFreeFlyMode)
-		{
-			m_movementIntentions.z -= 1.0f;
-		}
-	}
-	if (g_theInput->IsKeyDown('E'))
-	{
-		if (m_currentGravitySource == nullptr || m_isFreeFlyMode)
-		{
-			m_movementIntentions.z += 1.0f;
-		}
-	}
-
-	if (g_theInput->WasKeyJustPressed('H'))
+	if (command.m_respawnPressed)
 	{
 		Respawn();
 	}
 
-	m_isCrouching = false;
-	if (g_theInput->IsKeyDown(KEYCODE_SHIFT) && m_isGrounded)
-	{
-		m_isCrouching = true;
-	}
-	if (g_theInput->IsKeyDown('R') && !m_isCrouching)
-	{
-		m_isSpeedUp = true;
-	}
-
-	if (g_theInput->WasKeyJustPressed(' '))
-	{
-		Jump();
-	}
+	//remember where this tick started so rendering can blend towards where it ends
+	m_previousPosition = m_position;
+	m_previousOrientation = m_orientation;
 
-	//debug keys
-	if (g_theInput->WasKeyJustPressed(KEYCODE_F2))
-	{
-		m_cameraMode = static_cast<CameraMode>(m_cameraMode + 1);
-		if (m_cameraMode >= NUM_MODES)
-		{
-			m_cameraMode = FIXED;
-		}
-		std::string cameraModeString = "";
-		switch (m_cameraMode)
-		{
-			case FIXED: cameraModeString = "Fixed Angle"; break;
-			case FREE: cameraModeString = "Free Control"; break;
-			case FOLLOW: cameraModeString = "Match Player Angle"; break;
-			case FIRST_PERSON: cameraModeString = "First Person"; break;
-		}
-		std::string changedCameraMessage = Stringf("Changed camera mode: %s", cameraModeString.c_str());
-		DebugAddMessage(changedCameraMessage, 4.0f);
+	m_isCrouching = command.m_isCrouchHeld && m_isGrounded;
+	m_isSpeedUp = command.m_isSpeedUpHeld && !m_isCrouching;
+	m_movementIntentions = command.m_movementIntentions;
 
-		if (m_cameraMode == FREE)
-		{
-			m_playerCamera.SetUseMatrixOrientationMode(false);
-		}
-		else
-		{
-			m_playerCamera.SetUseMatrixOrientationMode(true);
-		}
-	}
-	if (g_theInput->WasKeyJustPressed(KEYCODE_F3))
+	//turn towards the steering direction and run along it
+	if (command.m_steerDirection != Vec3())
 	{
-		m_invertFreeCamera = !m_invertFreeCamera;
-		if (m_invertFreeCamera)
-		{
-			std::string message = "Invert free camera: on";
-			DebugAddMessage(message, 4.0f);
-		}
-		else
-		{
-			std::string message = "Invert free camera: off";
-			DebugAddMessage(message, 4.0f);
-		}
-	}
-	if (g_theInput->WasKeyJustPressed(KEYCODE_F4))
-	{
-		m_rememberLastGravitySource = !m_rememberLastGravitySource;
-		if (m_rememberLastGravitySource)
-		{
-			std::string message = "No-gravity mode: Remember last gravity source";
-			DebugAddMessage(message, 4.0f);
-		}
-		else
-		{
-			std::string message = "No-gravity mode: Global gravity";
-			DebugAddMessage(message, 4.0f);
-		}
-	}
-	if (g_theInput->WasKeyJustPressed(KEYCODE_F5))
-	{
-		g_theGame->m_isDebugView = !g_theGame->m_isDebugView;
-	}
-	if (g_theInput->WasKeyJustPressed(KEYCODE_F7))
-	{
-		/*m_isTankTurn = !m_isTankTurn;
-		std::string turn = "Mimic Joystick";
-		if (m_isTankTurn) turn = "Tank Turn";
-		std::string message = Stringf("Keyboard turning mode: %s", turn.c_str());
-		DebugAddMessage(message, 4.0f);*/
+		Vec3 steerRight = CrossProduct3D(command.m_steerDirection, GetKBasis());
+		Mat44 goalOrientation = Mat44(command.m_steerDirection, -steerRight, GetKBasis(), Vec3());
 
-		m_isFreeFlyMode = !m_isFreeFlyMode;
+		Quaternion startRotQuat = m_orientation.GetAsQuaternion();
+		Quaternion endRotQuat = goalOrientation.GetAsQuaternion();
+		Quaternion finalRotQuat = Slerp(startRotQuat, endRotQuat, m_turnRate);
+		m_orientation = finalRotQuat.GetAsRotMatrix();
+		m_orientation.Orthonormalize_XFwd_YLeft_ZUp();
+		m_movementIntentions.x += 1.0f;
 
-		if (m_isFreeFlyMode)
-		{
-			DebugAddMessage("Free Fly: True", 5.0f);
-			m_orientation = Mat44();
-		}
-		else
+		//determine if player has suddenly changed direction, and can therefore side flip
+		if (DotProduct3D(command.m_steerDirection, m_velocity) < 0.0f && m_velocity.GetLength() > m_runThreshold)
 		{
-			DebugAddMessage("Free Fly: False", 5.0f);
+			m_canSideFlipTimer = m_canSideFlipTimerMax;
 		}
 	}
 
-	//handle mouse input
-	IntVec2 mouseDelta = g_theInput->GetCursorClientDelta();
-	m_freeCameraOrientation.m_yawDegrees -= (float)mouseDelta.x * m_mouseTurnRate;
-	if (m_invertFreeCamera)
-	{
-		m_freeCameraOrientation.m_pitchDegrees -= (float)mouseDelta.y * m_mouseTurnRate;
-	}
-	else
-	{
-		m_freeCameraOrientation.m_pitchDegrees += (float)mouseDelta.y * m_mouseTurnRate;
-	}
+	m_orientation.AppendZRotation(command.m_yawIntentions * m_tankTurnRate * deltaSeconds);
 
-	if (!m_isTankTurn && (m_movementDirection.x != 0.0f || m_movementDirection.y != 0.0f))
+	if (command.m_jumpPressed)
 	{
-		Vec2 leftStickVector = Vec2(-m_movementDirection.y, m_movementDirection.x);
-		Mat44 cameraModelMatrix = m_playerCamera.GetViewMatrix().GetOrthonormalInverse();
-		Vec3 moveForward = cameraModelMatrix.GetKBasis3D();
-		Vec3 moveForwardOnUpVector = GetProjectedOnto3D(moveForward, GetModelMatrix().GetKBasis3D());
-		Vec3 moveForwardOnSurfacePlane = (moveForward - moveForwardOnUpVector).GetNormalized();
-		/*if((moveForward-moveForwardOnUpVector).GetLength() < 0.15f)
-		{
-			moveForward = cameraModelMatrix.GetIBasis3D();
-			moveForwardOnUpVector = GetProjectedOnto3D(moveForward, GetModelMatrix().GetKBasis3D());
-			moveForwardOnSurfacePlane = (moveForward - moveForwardOnUpVector).GetNormalized();
-			std::string mes = "Change to IBasis";
-			DebugAddMessage(mes, 0.0f);
-		}*/
-		Vec3 moveForwardOnSurfacePlaneCorrected = moveForwardOnSurfacePlane;
-		if (DotProduct3D(GetModelMatrix().GetKBasis3D(), cameraModelMatrix.GetIBasis3D()) > 0.0f)
-		{
-			moveForwardOnSurfacePlaneCorrected = -moveForwardOnSurfacePlaneCorrected;
-			if (g_theGame->m_isDebugView)
-			{
-				std::string mes = "Reverse";
-				DebugAddMessage(mes, 0.0f);
-			}
-		}
-		//DebugAddWorldArrow(m_position, m_position + moveForwardOnSurfacePlane, 0.05f, 0.0f, Rgba8(255, 127, 0), Rgba8(255, 127, 0), DebugRenderMode::X_RAY);
-		//DebugAddWorldArrow(m_position, m_position + moveForwardOnSurfacePlaneCorrected, 0.05f, 0.0f, Rgba8(127, 0, 0), Rgba8(127, 0, 0), DebugRenderMode::X_RAY);
-		Vec3 moveRight = CrossProduct3D(moveForwardOnSurfacePlaneCorrected, GetModelMatrix().GetKBasis3D());
-		Vec3 moveRightOnUpVector = GetProjectedOnto3D(moveRight, GetModelMatrix().GetKBasis3D());
-		Vec3 moveRightOnSurfacePlane = (moveRight - moveRightOnUpVector).GetNormalized();
-		if (DotProduct3D(GetModelMatrix().GetKBasis3D(), cameraModelMatrix.GetIBasis3D()) > 0.0f)
-		{
-			moveRightOnSurfacePlane = -moveRightOnSurfacePlane;
-		}
-		//DebugAddWorldArrow(m_position, m_position + moveRightOnSurfacePlane, 0.05f, 0.0f, Rgba8(127, 0, 255), Rgba8(127, 0, 255), DebugRenderMode::X_RAY);
-		Vec3 movementDirection = ((moveForwardOnSurfacePlaneCorrected * leftStickVector.y) + (moveRightOnSurfacePlane * leftStickVector.x)).GetNormalized();
-		//DebugAddWorldArrow(m_position, m_position + movementDirection, 0.05f, 0.0f, Rgba8(0, 0, 0), Rgba8(0, 0, 0), DebugRenderMode::X_RAY);
-		Vec3 moveDirectionRight = CrossProduct3D(movementDirection, GetModelMatrix().GetKBasis3D());
-		//DebugAddWorldArrow(m_position, m_position + moveDirectionRight, 0.05f, 0.0f, Rgba8(), Rgba8(), DebugRenderMode::X_RAY);
-		Mat44 goalOrientation = Mat44(movementDirection, -moveDirectionRight, GetModelMatrix().GetKBasis3D(), Vec3());
-		//DebugAddWorldArrow(m_position, m_position + goalOrientation.GetIBasis3D(), 0.05f, 0.0f, Rgba8(0, 0, 0), Rgba8(0, 0, 0), DebugRenderMode::X_RAY);
-		//if (!m_stopMoving)
-		{
-			//m_orientation = goalOrientation;
-			Quaternion startRotQuat = m_orientation.GetAsQuaternion();
-			Quaternion endRotQuat = goalOrientation.GetAsQuaternion();
-			Quaternion finalRotQuat = Slerp(startRotQuat, endRotQuat, m_turnRate);
-			m_orientation = finalRotQuat.GetAsRotMatrix();
-			m_orientation.Orthonormalize_XFwd_YLeft_ZUp();
-			m_movementIntentions.x += 1.0f;
-		}
+		Jump();
 	}
 
-	UpdateFromController(deltaSeconds);
-
-	m_orientation.AppendZRotation(m_yawIntentions * m_tankTurnRate * deltaSeconds);
-
-	m_freeCameraOrientation.m_pitchDegrees = GetClamped(m_freeCameraOrientation.m_pitchDegrees, -85.0f, 85.0f);
-
 	if (m_movementIntentions != Vec3())
 	{
-		m_movementIntentions.Normalize();
-		m_movementIntentions = GetModelMatrix().TransformVectorQuantity3D(m_movementIntentions);
-
-		MoveInDirection(m_movementIntentions, m_movementSpeed);
+		Vec3 movementDirection = GetModelMatrix().TransformVectorQuantity3D(m_movementIntentions.GetNormalized());
+		MoveInDirection(movementDirection, m_movementSpeed);
 	}
 
 	if (m_isSpeedUp)
@@ -250,27 +70,6 @@ void Player::Update(float deltaSeconds)
 		AddForce(m_orientation.GetIBasis3D() * m_longJumpForce * deltaSeconds * m_drag);
 	}
 
-	/*if (g_theInput->WasKeyJustPressed(KEYCODE_COMMA))
-	{
-		m_isFixedTimeStep = !m_isFixedTimeStep;
-	}*/
-
-	/*if (m_isFixedTimeStep)
-	{
-		DebugAddMessage("Fixed", 0.0f);
-		m_fixedTimeStepTimer += deltaSeconds;
-		while (m_fixedTimeStepTimer >= m_fixedTimeStepAmount)
-		{
-			UpdatePhysics(m_fixedTimeStepAmount);
-			m_fixedTimeStepTimer -= m_fixedTimeStepAmount;
-		}
-	}
-	else
-	{
-		DebugAddMessage("Variable", 0.0f);
-		UpdatePhysics(deltaSeconds);
-	}*/
-
 	UpdatePhysics(deltaSeconds);
 
 	//handle jump logic
@@ -364,386 +163,31 @@ void Player::Update(float deltaSeconds)
 		}
 	}
 
-	//print jump debug info
-	if (g_theGame->m_isDebugView)
-	{
-		std::string jumpMessage = Stringf("Current jump: %i  -  Current jump timer: %.3f  -  IsGrounded: %s  -  WasGrounded: %s", m_jumpNumber, m_tripleJumpTimer, m_isGrounded ? "true" : "false", m_wasGroundedLastFrame ? "true" : "false");
-		DebugAddMessage(jumpMessage, 0.0f);
-		std::string wallSlideMessage = Stringf("IsWallSliding = %s, IsWallJumping = %s", m_isWallSliding ? "true" : "false", m_isWallJumping ? "true" : "false");
-		DebugAddMessage(wallSlideMessage, 0.0f);
-	}
-	/*std::string flipMessage = Stringf("Can Side Flip Timer: %.2f", m_canSideFlipTimer);
-	DebugAddMessage(flipMessage, 0.0f);*/
-
 	m_wasGroundedLastFrame = m_isGrounded;
 	m_isGrounded = false;
 	m_isWallSliding = false;
-
-	//handle camera modes
-	switch (m_cameraMode)
-	{
-		case FIXED: m_playerCamera.SetTransform(m_position + Vec3(m_cameraOffset, 0.0f, 0.0f), Mat44()); break;
-		case FREE:	
-		{
-			m_playerCamera.SetTransform(m_position, m_freeCameraOrientation);
-			Vec3 cameraForward = m_playerCamera.GetViewMatrix().GetOrthonormalInverse().GetIBasis3D();
-			m_playerCamera.SetTransform(m_position + (cameraForward * m_cameraOffset), m_freeCameraOrientation);
-			break;
-		}
-		case FOLLOW: m_playerCamera.SetTransform(m_position + (GetIBasis() * m_cameraOffset), m_orientation); break;
-		case FIRST_PERSON: m_playerCamera.SetTransform(m_position, m_orientation); break;
-	}
 }
 
 
-void Player::UpdateFromController(float deltaSeconds)
+void Player::UpdateRenderState(float alpha)
 {
-	XboxController const& controller = g_theInput->GetController(0);
-	AnalogJoystick const& leftStick = controller.GetLeftStick();
-	AnalogJoystick const& rightStick = controller.GetRightStick();
-
-	float leftStickMagnitude = leftStick.GetMagnitude();
-	float rightStickMagnitude = rightStick.GetMagnitude();
-
-	//camera controls
-	if (rightStickMagnitude > 0.0f)
-	{
-		Vec2 rightStickVector = Vec2::MakeFromPolarDegrees(rightStick.GetOrientationDegrees());
-		m_freeCameraOrientation.m_yawDegrees -= rightStickVector.x * m_controllerTurnRate * deltaSeconds;
-		if (m_invertFreeCamera)
-		{
-			m_freeCameraOrientation.m_pitchDegrees += rightStickVector.y * m_controllerTurnRate * deltaSeconds;
-		}
-		else
-		{
-			m_freeCameraOrientation.m_pitchDegrees -= rightStickVector.y * m_controllerTurnRate * deltaSeconds;
-		}
-	}
-
-
-	static bool forceIBasis = false;
-	/*if (controller.WasButtonJustPressed(XBOX_BUTTON_X))
-	{
-		forceIBasis = !forceIBasis;
-		if (forceIBasis)
-		{
-			DebugAddMessage("Force IBasis: True", 5.0f);
-		}
-		else
-		{
-			DebugAddMessage("Force IBasis: False", 5.0f);
-		}
-	}*/
-
-
-	//movement
-	constexpr float I_BASIS_THRESHOLD = 0.1f;
-	Mat44 cameraModelMatrix = m_playerCamera.GetViewMatrix().GetOrthonormalInverse();
-	if (leftStickMagnitude > 0.0f && !m_isBackFlipping && !m_isWallJumping)
-	{
-		bool usingIBasis = false;
-
-		Vec2 leftStickVector = Vec2::MakeFromPolarDegrees(leftStick.GetOrientationDegrees());
-		Vec3 moveForwardKBasis = cameraModelMatrix.GetKBasis3D();
-		Vec3 moveForwardOnUpVectorKBasis = GetProjectedOnto3D(moveForwardKBasis, GetModelMatrix().GetKBasis3D());
-		Vec3 moveForwardOnSurfacePlaneKBasis = (moveForwardKBasis - moveForwardOnUpVectorKBasis).GetNormalized();
+	m_renderPosition = m_previousPosition + (m_position - m_previousPosition) * alpha;
 
-		Vec3 moveForwardIBasis = (cameraModelMatrix.GetKBasis3D() - cameraModelMatrix.GetIBasis3D() * 0.1f).GetNormalized();
-		Vec3 moveForwardOnUpVectorIBasis = GetProjectedOnto3D(moveForwardIBasis, GetModelMatrix().GetKBasis3D());
-		Vec3 moveForwardOnSurfacePlaneIBasis = (moveForwardIBasis - moveForwardOnUpVectorIBasis).GetNormalized();
-
-		if ((moveForwardKBasis - moveForwardOnUpVectorKBasis).GetLength() < I_BASIS_THRESHOLD)
-		{
-			usingIBasis = true;
-
-			/*if (g_theGame->m_isDebugView)*/ //DebugAddMessage("Would change to IBasis here", 0.0f);
-		}
-
-		Vec3 moveForwardOnSurfacePlaneCorrectedKBasis = moveForwardOnSurfacePlaneKBasis;
-		Vec3 moveForwardOnSurfacePlaneCorrectedIBasis = moveForwardOnSurfacePlaneIBasis;
-		if (DotProduct3D(GetModelMatrix().GetKBasis3D(), cameraModelMatrix.GetIBasis3D()) > 0.0f)
-		{
-			moveForwardOnSurfacePlaneCorrectedKBasis = -moveForwardOnSurfacePlaneCorrectedKBasis;
-			//moveForwardOnSurfacePlaneCorrectedIBasis = -moveForwardOnSurfacePlaneCorrectedIBasis;
-
-			/*if (g_theGame->m_isDebugView)*/ //DebugAddMessage("Flip KBasis Direction", 0.0f);
-		}
-
-		if (DotProduct3D(GetModelMatrix().GetKBasis3D(), cameraModelMatrix.GetKBasis3D()) < 0.0f)
-		{
-			//moveForwardOnSurfacePlaneCorrectedIBasis = -moveForwardOnSurfacePlaneCorrectedIBasis;
-
-			/*if (g_theGame->m_isDebugView)*/ //DebugAddMessage("Flip IBasis Direction", 0.0f);
-		}
-
-		/*if (m_reverse)
-		{
-			moveForwardOnSurfacePlaneCorrected = -moveForwardOnSurfacePlaneCorrected;
-		}*/
-
-		Vec3 moveForwardOnSurfacePlaneCorrected = moveForwardOnSurfacePlaneCorrectedKBasis;
-		//Vec3 moveForwardOnSurfacePlaneCorrected = (moveForwardOnSurfacePlaneCorrectedKBasis + moveForwardOnSurfacePlaneCorrectedIBasis).GetNormalized();
-		if (usingIBasis || forceIBasis)
-		{
-			//moveForwardOnSurfacePlaneCorrected = moveForwardOnSurfacePlaneCorrectedIBasis;
-			//moveForwardOnSurfacePlaneCorrected = (moveForwardOnSurfacePlaneCorrectedKBasis + moveForwardOnSurfacePlaneCorrectedIBasis).GetNormalized();
-
-			/*if (g_theGame->m_isDebugView)*/ //DebugAddMessage("Change to IBasis", 0.0f);
-		}
-
-		if (moveForwardOnSurfacePlaneKBasis == moveForwardOnSurfacePlaneCorrectedKBasis)
-		{
-			/*if (g_theGame->m_isDebugView)*/ //DebugAddWorldArrow(m_position, m_position + moveForwardOnSurfacePlaneKBasis, 0.05f, 0.0f, Rgba8(255, 127, 0), Rgba8(255, 127, 0), DebugRenderMode::X_RAY);
-		}
-		else
-		{
-			/*if (g_theGame->m_isDebugView)*/ //DebugAddWorldArrow(m_position, m_position + moveForwardOnSurfacePlaneCorrectedKBasis, 0.05f, 0.0f, Rgba8(127, 0, 0), Rgba8(127, 0, 0), DebugRenderMode::X_RAY);
-		}
-		if (moveForwardOnSurfacePlaneIBasis == moveForwardOnSurfacePlaneCorrectedIBasis)
-		{
-			/*if (g_theGame->m_isDebugView)*/ //DebugAddWorldArrow(m_position, m_position + moveForwardOnSurfacePlaneIBasis, 0.05f, 0.0f, Rgba8(127, 255, 0), Rgba8(127, 255, 0), DebugRenderMode::X_RAY);
-		}
-		else
-		{
-			/*if (g_theGame->m_isDebugView)*/ //DebugAddWorldArrow(m_position, m_position + moveForwardOnSurfacePlaneCorrectedIBasis, 0.05f, 0.0f, Rgba8(0, 127, 0), Rgba8(0, 127, 0), DebugRenderMode::X_RAY);
-		}
-
-		/*Vec3 moveRightJBasis = -cameraModelMatrix.GetJBasis3D();
-		Vec3 moveRightOnUpVectorJBasis = GetProjectedOnto3D(moveRightJBasis, GetModelMatrix().GetKBasis3D());
-		Vec3 moveRightOnSurfacePlaneJBasis = (moveRightJBasis - moveRightOnUpVectorJBasis).GetNormalized();
-
-		Vec3 moveRightOnSurfacePlane = moveRightOnSurfacePlaneJBasis;
-		if ((moveRightJBasis - moveRightOnUpVectorJBasis).GetLength() < I_BASIS_THRESHOLD)
-		{
-			Vec3 moveRight = CrossProduct3D(moveForwardOnSurfacePlaneCorrected, GetModelMatrix().GetKBasis3D());
-			Vec3 moveRightOnUpVector = GetProjectedOnto3D(moveRight, GetModelMatrix().GetKBasis3D());
-			moveRightOnSurfacePlane = (moveRight - moveRightOnUpVector).GetNormalized();
-		}*/
-
-		Vec3 moveRight = CrossProduct3D(moveForwardOnSurfacePlaneCorrected, GetModelMatrix().GetKBasis3D());
-		Vec3 moveRightOnUpVector = GetProjectedOnto3D(moveRight, GetModelMatrix().GetKBasis3D());
-		Vec3 moveRightOnSurfacePlane = (moveRight - moveRightOnUpVector).GetNormalized();
-		
-		bool rightFlipped = false;
-		if (DotProduct3D(GetModelMatrix().GetKBasis3D(), cameraModelMatrix.GetIBasis3D()) > 0.0f)
-		{
-			moveRightOnSurfacePlane = -moveRightOnSurfacePlane;
-			rightFlipped = true;
-		}
-		/*if (m_reverse)
-		{
-			moveRightOnSurfacePlane = -moveRightOnSurfacePlane;
-		}*/
-
-		if (!rightFlipped)
-		{
-			/*if (g_theGame->m_isDebugView)*/ //DebugAddWorldArrow(m_position, m_position + moveRightOnSurfacePlane, 0.05f, 0.0f, Rgba8(127, 0, 255), Rgba8(127, 0, 255), DebugRenderMode::X_RAY);
-		}
-		else
-		{
-			/*if (g_theGame->m_isDebugView)*/ //DebugAddWorldArrow(m_position, m_position + moveRightOnSurfacePlane, 0.05f, 0.0f, Rgba8(0, 0, 127), Rgba8(0, 0, 127), DebugRenderMode::X_RAY);
-		}
-		
-		Vec3 movementDirection = ((moveForwardOnSurfacePlaneCorrected * leftStickVector.y) + (moveRightOnSurfacePlane * leftStickVector.x)).GetNormalized();
-		//DebugAddWorldArrow(m_position, m_position + movementDirection, 0.05f, 0.0f, Rgba8(0, 0, 0), Rgba8(0, 0, 0), DebugRenderMode::X_RAY);
-		Vec3 moveDirectionRight = CrossProduct3D(movementDirection, GetModelMatrix().GetKBasis3D());
-		//DebugAddWorldArrow(m_position, m_position + moveDirectionRight, 0.05f, 0.0f, Rgba8(), Rgba8(), DebugRenderMode::X_RAY);
-		Mat44 goalOrientation = Mat44(movementDirection, -moveDirectionRight, GetModelMatrix().GetKBasis3D(), Vec3());
-		//DebugAddWorldArrow(m_position, m_position + goalOrientation.GetIBasis3D(), 0.05f, 0.0f, Rgba8(0, 0, 0), Rgba8(0, 0, 0), DebugRenderMode::X_RAY);
-		
-		//m_orientation = goalOrientation;
-		Quaternion startRotQuat = m_orientation.GetAsQuaternion();
-		Quaternion endRotQuat = goalOrientation.GetAsQuaternion();
-		Quaternion finalRotQuat = Slerp(startRotQuat, endRotQuat, m_turnRate);
-		m_orientation = finalRotQuat.GetAsRotMatrix();
-		m_orientation.Orthonormalize_XFwd_YLeft_ZUp();
-		m_movementIntentions.x += 1.0f;
-
-		//determine if player has suddenly changed direction, and can therefore side flip
-		if (DotProduct3D(movementDirection, m_velocity) < 0.0f && m_velocity.GetLength() > m_runThreshold)
-		{
-			m_canSideFlipTimer = m_canSideFlipTimerMax;
-		}
-	}
-	//else if (leftStickMagnitude == 0.0f)
-	//{
-	//	bool usingIBasis = false;
-
-	//	Vec3 moveForwardKBasis = cameraModelMatrix.GetKBasis3D();
-	//	Vec3 moveForwardOnUpVectorKBasis = GetProjectedOnto3D(moveForwardKBasis, GetModelMatrix().GetKBasis3D());
-	//	Vec3 moveForwardOnSurfacePlaneKBasis = (moveForwardKBasis - moveForwardOnUpVectorKBasis).GetNormalized();
-
-	//	Vec3 moveForwardIBasis = cameraModelMatrix.GetIBasis3D();
-	//	Vec3 moveForwardOnUpVectorIBasis = GetProjectedOnto3D(moveForwardIBasis, GetModelMatrix().GetKBasis3D());
-	//	Vec3 moveForwardOnSurfacePlaneIBasis = (moveForwardIBasis - moveForwardOnUpVectorIBasis).GetNormalized();
-
-	//	if ((moveForwardKBasis - moveForwardOnUpVectorKBasis).GetLength() < I_BASIS_THRESHOLD)
-	//	{
-	//		//usingIBasis = true;
-
-	//		if (g_theGame->m_isDebugView) DebugAddMessage("Would change to IBasis here", 0.0f);
-	//	}
-
-	//	Vec3 moveForwardOnSurfacePlaneCorrectedKBasis = moveForwardOnSurfacePlaneKBasis;
-	//	Vec3 moveForwardOnSurfacePlaneCorrectedIBasis = moveForwardOnSurfacePlaneIBasis;
-	//	if (DotProduct3D(GetModelMatrix().GetKBasis3D(), cameraModelMatrix.GetIBasis3D()) > 0.0f)
-	//	{
-	//		moveForwardOnSurfacePlaneCorrectedKBasis = -moveForwardOnSurfacePlaneCorrectedKBasis;
-	//		moveForwardOnSurfacePlaneCorrectedIBasis = -moveForwardOnSurfacePlaneCorrectedIBasis;
-
-	//		if (g_theGame->m_isDebugView) DebugAddMessage("Flip Direction", 0.0f);
-	//	}
-	//	/*if (m_reverse)
-	//	{
-	//		moveForwardOnSurfacePlaneCorrected = -moveForwardOnSurfacePlaneCorrected;
-	//	}*/
-
-	//	Vec3 moveForwardOnSurfacePlaneCorrected = moveForwardOnSurfacePlaneCorrectedKBasis;
-	//	if (usingIBasis || forceIBasis)
-	//	{
-	//		moveForwardOnSurfacePlaneCorrected = moveForwardOnSurfacePlaneCorrectedIBasis;
-
-	//		if (g_theGame->m_isDebugView) DebugAddMessage("Change to IBasis", 0.0f);
-	//	}
-
-	//	if (moveForwardOnSurfacePlaneKBasis == moveForwardOnSurfacePlaneCorrectedKBasis)
-	//	{
-	//		if (g_theGame->m_isDebugView) DebugAddWorldArrow(m_position, m_position + moveForwardOnSurfacePlaneKBasis, 0.05f, 0.0f, Rgba8(255, 127, 0), Rgba8(255, 127, 0), DebugRenderMode::X_RAY);
-	//	}
-	//	else
-	//	{
-	//		if (g_theGame->m_isDebugView) DebugAddWorldArrow(m_position, m_position + moveForwardOnSurfacePlaneCorrectedKBasis, 0.05f, 0.0f, Rgba8(127, 0, 0), Rgba8(127, 0, 0), DebugRenderMode::X_RAY);
-	//	}
-	//	if (moveForwardOnSurfacePlaneIBasis == moveForwardOnSurfacePlaneCorrectedIBasis)
-	//	{
-	//		if (g_theGame->m_isDebugView) DebugAddWorldArrow(m_position, m_position + moveForwardOnSurfacePlaneIBasis, 0.05f, 0.0f, Rgba8(127, 255, 0), Rgba8(127, 255, 0), DebugRenderMode::X_RAY);
-	//	}
-	//	else
-	//	{
-	//		if (g_theGame->m_isDebugView) DebugAddWorldArrow(m_position, m_position + moveForwardOnSurfacePlaneCorrectedIBasis, 0.05f, 0.0f, Rgba8(0, 127, 0), Rgba8(0, 127, 0), DebugRenderMode::X_RAY);
-	//	}
-
-	//	Vec3 moveRight = CrossProduct3D(moveForwardOnSurfacePlaneCorrected, GetModelMatrix().GetKBasis3D());
-	//	Vec3 moveRightOnUpVector = GetProjectedOnto3D(moveRight, GetModelMatrix().GetKBasis3D());
-	//	Vec3 moveRightOnSurfacePlane = (moveRight - moveRightOnUpVector).GetNormalized();
-	//	bool rightFlipped = false;
-	//	if (DotProduct3D(GetModelMatrix().GetKBasis3D(), cameraModelMatrix.GetIBasis3D()) > 0.0f)
-	//	{
-	//		moveRightOnSurfacePlane = -moveRightOnSurfacePlane;
-	//		rightFlipped = true;
-	//	}
-	//	/*if (m_reverse)
-	//	{
-	//		moveRightOnSurfacePlane = -moveRightOnSurfacePlane;
-	//	}*/
-
-	//	if (!rightFlipped)
-	//	{
-	//		if (g_theGame->m_isDebugView) DebugAddWorldArrow(m_position, m_position + moveRightOnSurfacePlane, 0.05f, 0.0f, Rgba8(127, 0, 255), Rgba8(127, 0, 255), DebugRenderMode::X_RAY);
-	//	}
-	//	else
-	//	{
-	//		if (g_theGame->m_isDebugView) DebugAddWorldArrow(m_position, m_position + moveRightOnSurfacePlane, 0.05f, 0.0f, Rgba8(0, 0, 127), Rgba8(0, 0, 127), DebugRenderMode::X_RAY);
-	//	}
-
-	//	/*if (DotProduct3D(GetModelMatrix().GetKBasis3D(), cameraModelMatrix.GetIBasis3D()) > 0.0f)
-	//	{
-	//		m_reverse = true;
-	//	}
-	//	else
-	//	{
-	//		m_reverse = false;
-	//	}*/
-	//}
-	//if (m_reverse) DebugAddMessage("Reverse", 0.0f);
-
-
-
-
-
-
-	//buttons
-	if (controller.GetLeftTrigger() > 0.0f && m_isGrounded)
-	{
-		m_isCrouching = true;
-	}
-	if (controller.WasButtonJustPressed(XboxButtonID::XBOX_BUTTON_A))
-	{
-		Jump();
-	}
-	if (controller.IsButtonDown(XBOX_BUTTON_L))
-	{
-		m_movementIntentions.z -= 1.0f;
-	}
-	if (controller.IsButtonDown(XBOX_BUTTON_R))
-	{
-		m_movementIntentions.z += 1.0f;
-	}
-	
-	if (controller.WasButtonJustPressed(XboxButtonID::XBOX_BUTTON_SELECT))
-	{
-		Respawn();
-	}
+	Quaternion startRotQuat = m_previousOrientation.GetAsQuaternion();
+	Quaternion endRotQuat = m_orientation.GetAsQuaternion();
+	m_renderOrientation = Slerp(startRotQuat, endRotQuat, alpha).GetAsRotMatrix();
+	m_renderOrientation.Orthonormalize_XFwd_YLeft_ZUp();
 }
 
 
-void Player::Render() const
+PlayerCommand Player::TakePendingCommand()
 {
-	//render as capsule
-	std::vector<Vertex_PCUTBN> meshVerts;
-
-	if (m_isCrouching)
-	{
-		AddVertsForCapsule3D(meshVerts, Vec3(0.0f, 0.0f, -m_meshHeight * 0.5f), Vec3(0.0f, 0.0f, 0.0f), m_meshRadius + 0.1f);
-	}
-	else
-	{
-		AddVertsForCapsule3D(meshVerts, Vec3(0.0f, 0.0f, -m_meshHeight * 0.5f), Vec3(0.0f, 0.0f, m_meshHeight * 0.5f), m_meshRadius);
-	}
-
-	Mat44 scaledModelMatrix = GetModelMatrix();
-	float squashAmount = 1.0f / m_stretchAmount;
-	scaledModelMatrix.AppendScaleNonUniform3D(Vec3(squashAmount, squashAmount, m_stretchAmount));
-	if (m_doTripleJumpFlip)
-	{
-		scaledModelMatrix.AppendYRotation(m_tripleJumpFlipAngle);
-	}
-	else if (m_isBackFlipping)
-	{
-		scaledModelMatrix.AppendYRotation(m_backFlipAngle);
-	}
-	else if (m_isWallSliding)
-	{
-		scaledModelMatrix.AppendTranslation3D(Vec3(0.25f, 0.0f, 0.0f));
-		scaledModelMatrix.AppendYRotation(5.0f);
-	}
-	scaledModelMatrix.AppendTranslation3D(Vec3(0.0f, 0.0f, -squashAmount + 1.0f));
-
-	g_theRenderer->BindShader(g_theGame->m_lightingShader);
-	g_theRenderer->BindTexture(nullptr);
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-	g_theRenderer->SetModelConstants(scaledModelMatrix, m_color);
-	g_theRenderer->DrawVertexArray(meshVerts);
+	PlayerCommand command = m_pendingCommand;
 
-	//render collision bounds as wireframe sphere
-	if (g_theGame->m_isDebugView)
-	{
-		std::vector<Vertex_PCU> collisionVerts;
-
-		AddVertsForSphere3D(collisionVerts, Vec3(), m_collisionRadius);
-
-		g_theRenderer->BindShader(nullptr);
-		g_theRenderer->BindTexture(nullptr);
-		g_theRenderer->SetRasterizerMode(RasterizerMode::WIREFRAME_CULL_NONE);
-		g_theRenderer->SetModelConstants(GetModelMatrix(), m_debugWireframeColor);
-		g_theRenderer->DrawVertexArray(collisionVerts);
-
-		DebugAddWorldArrow(m_position, m_position + m_velocity * 0.1f, 0.05f, 0.0f, Rgba8(255, 255, 0), Rgba8(255, 0, 0), DebugRenderMode::X_RAY);
-	}
-
-	DebugAddWorldArrow(m_position, m_position + m_orientation.GetIBasis3D() * 1.5f, 0.05f, 0.0f, Rgba8(255, 0, 0), Rgba8(255, 0, 0));
-	DebugAddWorldArrow(m_position, m_position + m_orientation.GetJBasis3D() * 1.5f, 0.05f, 0.0f, Rgba8(0, 255, 0), Rgba8(0, 255, 0));
-	DebugAddWorldArrow(m_position, m_position + m_orientation.GetKBasis3D() * 1.5f, 0.05f, 0.0f, Rgba8(0, 0, 255), Rgba8(0, 0, 255));
+	//presses only apply to the first tick after them, held buttons stay until the next frame's input
+	m_pendingCommand.m_jumpPressed = false;
+	m_pendingCommand.m_respawnPressed = false;
+	return command;
 }
 
 
@@ -819,8 +263,6 @@ void Player::AddGravity(Vec3 gravityVector)
 
 	if (gravityVector != Vec3())
 	{
-		if (g_theGame->m_isDebugView) DebugAddWorldArrow(m_position, m_position + gravityVector * 0.01f, 0.05f, 0.0f, Rgba8(255, 0, 255), Rgba8(255, 0, 255), DebugRenderMode::X_RAY);
-		
 		//lerp orientation to match
 		Quaternion startRotQuat = m_orientation.GetAsQuaternion();
 
@@ -845,13 +287,7 @@ void Player::AddGravity(Vec3 gravityVector)
 		Vec3 startIBasis = startRotMat.GetIBasis3D();
 		//Vec3 finalIBasis = m_orientation.GetIBasis3D();
 		float degreesRotated = GetAngleDegreesBetweenVectors3D(startIBasis, iBasis);
-		if (g_theGame->m_isDebugView)
-		{
-			std::string mes = Stringf("Start velocity: %.2f, %.2f, %.2f", m_velocity.x, m_velocity.y, m_velocity.z);
-			DebugAddMessage(mes, 0.0f);
-			std::string mes1 = Stringf("Degrees rotated: %.2f", degreesRotated);
-			DebugAddMessage(mes1, 0.0f);
-		}
+		m_degreesRotatedToGravity = degreesRotated;
 		if (degreesRotated != 0.0f)
 		{
 			Vec3 newVelocity = m_velocity.GetRotatedAroundAxisByAngle(jBasis, degreesRotated);
@@ -860,11 +296,6 @@ void Player::AddGravity(Vec3 gravityVector)
 				m_velocity = newVelocity;
 			}
 		}
-		if (g_theGame->m_isDebugView)
-		{
-			std::string mes = Stringf("End velocity: %.2f, %.2f, %.2f", m_velocity.x, m_velocity.y, m_velocity.z);
-			DebugAddMessage(mes, 0.0f);
-		}
 	}
 	else
 	{
@@ -958,7 +389,7 @@ void Player::Jump()
 		m_jumpNumber = 0;
 		modifiedJumpForce *= m_longJumpHeightScale;
 		m_isLongJumping = true;
-		g_theGame->m_longJumpTimes.emplace_back(g_theGame->m_gameClock.GetTotalSeconds());
+		m_actionsThisTick.emplace_back(PLAYER_ACTION_LONG_JUMP);
 	}
 	//back flip logic
 	else if (m_isCrouching)
@@ -966,7 +397,7 @@ void Player::Jump()
 		m_jumpNumber = 0;
 		modifiedJumpForce *= m_backFlipJumpScale;
 		m_isBackFlipping = true;
-		g_theGame->m_backFlipTimes.emplace_back(g_theGame->m_gameClock.GetTotalSeconds());
+		m_actionsThisTick.emplace_back(PLAYER_ACTION_BACK_FLIP);
 	}
 	//side flip logic
 	else if (m_canSideFlipTimer > 0.0f)
@@ -974,15 +405,15 @@ void Player::Jump()
 		m_jumpNumber = 0;
 		modifiedJumpForce *= m_sideFlipJumpScale;
 		m_isSideFlipping = true;
-		g_theGame->m_sideFlipTimes.emplace_back(g_theGame->m_gameClock.GetTotalSeconds());
+		m_actionsThisTick.emplace_back(PLAYER_ACTION_SIDE_FLIP);
 	}
 
 	//decide how high to jump based on the jump number
 	switch (m_jumpNumber)
 	{
-		case 1: g_theGame->m_standardJumpTimes.emplace_back(g_theGame->m_gameClock.GetTotalSeconds()); break;
-		case 2: modifiedJumpForce *= m_doubleJumpScalar; modifiedStretch += (m_doubleJumpScalar * 0.25f); g_theGame->m_doubleJumpTimes.emplace_back(g_theGame->m_gameClock.GetTotalSeconds()); break;
-		case 3: modifiedJumpForce *= m_tripleJumpScalar; modifiedStretch += (m_tripleJumpScalar * 0.25f); m_doTripleJumpFlip = true; g_theGame->m_tripleJumpTimes.emplace_back(g_theGame->m_gameClock.GetTotalSeconds()); break;
+		case 1: m_actionsThisTick.emplace_back(PLAYER_ACTION_STANDARD_JUMP); break;
+		case 2: modifiedJumpForce *= m_doubleJumpScalar; modifiedStretch += (m_doubleJumpScalar * 0.25f); m_actionsThisTick.emplace_back(PLAYER_ACTION_DOUBLE_JUMP); break;
+		case 3: modifiedJumpForce *= m_tripleJumpScalar; modifiedStretch += (m_tripleJumpScalar * 0.25f); m_doTripleJumpFlip = true; m_actionsThisTick.emplace_back(PLAYER_ACTION_TRIPLE_JUMP); break;
 	}
 
 	//actually perform the jump
@@ -1011,7 +442,7 @@ void Player::WallJump()
 	m_isWallJumping = true;
 	m_wallJumpTimer = m_wallJumpTimerMax;
 	//m_numWallJumps++;
-	g_theGame->m_wallJumpTimes.emplace_back(g_theGame->m_gameClock.GetTotalSeconds());
+	m_actionsThisTick.emplace_back(PLAYER_ACTION_WALL_JUMP);
 
 	//flip orientation
 	m_orientation.SetIJK3D(m_wallSlideNormal, -m_orientation.GetJBasis3D(), m_orientation.GetKBasis3D());
@@ -1053,6 +484,23 @@ Mat44 Player::GetModelMatrix() const
 }
 
 
+Mat44 Player::GetRenderModelMatrix() const
+{
+	Mat44 modelMatrix = m_renderOrientation;
+	modelMatrix.SetTranslation3D(m_renderPosition);
+	return modelMatrix;
+}
+
+
+void Player::SnapRenderState()
+{
+	m_previousPosition = m_position;
+	m_previousOrientation = m_orientation;
+	m_renderPosition = m_position;
+	m_renderOrientation = m_orientation;
+}
+
+
 Vec3 Player::GetIBasis() const
 {
 	return GetModelMatrix().GetIBasis3D();
@@ -1073,26 +521,50 @@ Vec3 Player::GetKBasis() const
 
 void Player::Respawn()
 {
-	if (g_theGame->m_currentCheckpoint == nullptr)
-	{
-		m_position = m_playerStartPosition;
-	}
-	else
-	{
-		m_position = g_theGame->m_currentCheckpoint->GetCenter();
-	}
+	m_position = m_respawnPosition;
 	m_orientation = Mat44();
 	m_currentGravitySource = nullptr;
 	m_currentGravityCenter = Vec3();
 	m_currentGravityVector = Vec3();
 	m_acceleration = Vec3();
 	m_velocity = Vec3();
+	SnapRenderState();
 
-	switch (g_theGame->m_currentSection)
-	{
-		case 1: /*m_numSection1Respawns++;*/ g_theGame->m_section1RespawnTimes.emplace_back(g_theGame->m_gameClock.GetTotalSeconds()); break;
-		case 2: /*m_numSection2Respawns++;*/ g_theGame->m_section2RespawnTimes.emplace_back(g_theGame->m_gameClock.GetTotalSeconds()); break;
-		case 3: /*m_numSection3Respawns++;*/ g_theGame->m_section3RespawnTimes.emplace_back(g_theGame->m_gameClock.GetTotalSeconds()); break;
-		case 4: /*m_numSection4Respawns++;*/ g_theGame->m_section4RespawnTimes.emplace_back(g_theGame->m_gameClock.GetTotalSeconds()); break;
-	}
+	m_actionsThisTick.emplace_back(PLAYER_ACTION_RESPAWN);
+}
+
+
+void Player::ResetMovementState()
+{
+	m_pendingCommand = PlayerCommand();
+	m_actionsThisTick.clear();
+
+	m_acceleration = Vec3();
+	m_movementIntentions = Vec3();
+	m_isSpeedUp = false;
+	m_isCrouching = false;
+	m_isGrounded = false;
+	m_wasGroundedLastFrame = false;
+
+	m_jumpNumber = 0;
+	m_tripleJumpTimer = 0.0f;
+	m_tripleJumpFlipAngle = 0.0f;
+	m_doTripleJumpFlip = false;
+	m_isLongJumping = false;
+	m_longJumpDurationTimer = 0.0f;
+	m_isBackFlipping = false;
+	m_backFlipAngle = 0.0f;
+	m_canSideFlipTimer = 0.0f;
+	m_isSideFlipping = false;
+	m_isWallSliding = false;
+	m_isWallJumping = false;
+	m_wallSlideNormal = Vec3();
+	m_wallJumpTimer = 0.0f;
+
+	m_stretchAmount = 1.0f;
+	m_landingVelocity = Vec3();
+
+	m_currentGravitySource = nullptr;
+	m_currentGravityCenter = Vec3();
+	m_currentGravityVector = Vec3();
 }
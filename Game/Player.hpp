@@ -1,7 +1,14 @@
 #pragma once
-#include "Engine/Renderer/Camera.hpp"
 #include "Engine/Core/Rgba8.hpp"
 #include "Engine/Math/Quaternion.hpp"
+#include "Engine/Math/Mat44.hpp"
+#include "Engine/Math/EulerAngles.hpp"
+#include "Engine/Math/Vec2.hpp"
+#include "Engine/Math/Vec3.hpp"
+#if !defined(GAME_HEADLESS)
+#include "Engine/Renderer/Camera.hpp"
+#endif
+#include <vector>
 
 
 //forward declarations
@@ -25,6 +32,32 @@ enum CameraMode
 	NUM_MODES
 };
 
+enum PlayerAction
+{
+	PLAYER_ACTION_STANDARD_JUMP = 0,
+	PLAYER_ACTION_DOUBLE_JUMP,
+	PLAYER_ACTION_TRIPLE_JUMP,
+	PLAYER_ACTION_LONG_JUMP,
+	PLAYER_ACTION_WALL_JUMP,
+	PLAYER_ACTION_SIDE_FLIP,
+	PLAYER_ACTION_BACK_FLIP,
+	PLAYER_ACTION_RESPAWN,
+	NUM_PLAYER_ACTIONS
+};
+
+
+//one tick of player input, filled from the keyboard and controller in game or from a script when headless
+struct PlayerCommand
+{
+	Vec3  m_movementIntentions = Vec3();	//local space, x forward and z up
+	Vec3  m_steerDirection = Vec3();		//world space direction to turn towards and run along, zero when not steering
+	float m_yawIntentions = 0.0f;			//tank turning, positive turns left
+	bool  m_isCrouchHeld = false;
+	bool  m_isSpeedUpHeld = false;
+	bool  m_jumpPressed = false;
+	bool  m_respawnPressed = false;
+};
+
 
 class Player
 {
@@ -33,10 +66,18 @@ public:
 	//constructor
 	Player(Game* owner) : m_game(owner) {}
 
-	//game flow functions
-	void Update(float deltaSeconds);
+	//simulation functions
+	void UpdateTick(float deltaSeconds, PlayerCommand const& command);	//advances the simulation by one physics step
+	void UpdateRenderState(float alpha);								//blends the last two ticks for rendering
+	PlayerCommand TakePendingCommand();
+
+#if !defined(GAME_HEADLESS)
+	//game flow functions, left out of headless builds
+	void Update(float deltaSeconds);		//reads input into the pending command once per frame
 	void UpdateFromController(float deltaSeconds);
+	void UpdateCamera();
 	void Render() const;
+#endif
 
 	//physics functions
 	void UpdatePhysics(float deltaSeconds);
@@ -52,25 +93,35 @@ public:
 
 	//player utilities
 	Mat44 GetModelMatrix() const;
+	Mat44 GetRenderModelMatrix() const;
 	Vec3 GetIBasis() const;
 	Vec3 GetJBasis() const;
 	Vec3 GetKBasis() const;
 	void Respawn();
+	void SnapRenderState();					//skips interpolation after a teleport
+	void ResetMovementState();				//clears jumps, timers, and gravity so recordings start from a known state
 
 //public member variables
 public:
 	Game* m_game = nullptr;
 	Vec3  m_playerStartPosition = Vec3(-5.0f, 0.0f, 0.0f);
+	Vec3  m_respawnPosition = Vec3(-5.0f, 0.0f, 0.0f);	//moved to the current checkpoint by the game
+
+	PlayerCommand			  m_pendingCommand;		//built from input each frame, taken by the next tick
+	std::vector<PlayerAction> m_actionsThisTick;		//jumps and respawns the last tick performed
 
 	Vec3 m_position = Vec3();
 	Vec3 m_velocity = Vec3();
 	Vec3 m_acceleration = Vec3();
 	Mat44 m_orientation = Mat44();
+	Vec3  m_previousPosition = Vec3();		//state at the start of the latest tick
+	Mat44 m_previousOrientation = Mat44();
+	Vec3  m_renderPosition = Vec3();		//interpolated between the previous and current state
+	Mat44 m_renderOrientation = Mat44();
 	EulerAngles m_freeCameraOrientation = EulerAngles();
 
 	Vec3  m_movementIntentions = Vec3();
 	Vec2  m_movementDirection = Vec2();
-	float m_yawIntentions = 0.0f;
 	float m_movementSpeed = 11.0f;
 	float m_tankTurnRate = 170.0f;
 	float m_turnRate = 0.08f;
@@ -146,10 +197,13 @@ public:
 	Vec3 m_currentGravityCenter = Vec3();
 	Vec3 m_currentGravityVector = Vec3();
 	float m_orientationMatchRate = 0.1f;
+	float m_degreesRotatedToGravity = 0.0f;	//how far the last tick turned to match gravity, shown in debug view
 	//float m_rotationAlpha = 0.0f;	//CURRENTLY UNUSED
 	bool m_rememberLastGravitySource = true;
 
+#if !defined(GAME_HEADLESS)
 	Camera m_playerCamera;
+#endif
 	float  m_cameraOffset = -12.5f;
 	CameraMode m_cameraMode = FREE;
 	bool m_invertFreeCamera = false;
@@ -171,8 +225,4 @@ public:
 	int m_numSection2Respawns = 0;
 	int m_numSection3Respawns = 0;
 	int m_numSection4Respawns = 0;*/
-
-	/*bool m_isFixedTimeStep = false;
-	float m_fixedTimeStepAmount = 0.005f;
-	float m_fixedTimeStepTimer = 0.0f;*/
 };
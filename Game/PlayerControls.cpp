@@ -0,0 +1,580 @@
+#include "Game/Player.hpp"
+#include "Game/Game.hpp"
+#include "Game/GameCommon.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Input/InputSystem.hpp"
+#include "Engine/Math/IntVec2.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Core/VertexUtils.hpp"
+#include "Engine/Renderer/Renderer.hpp"
+#include "Engine/Renderer/DebugRenderSystem.hpp"
+
+
+//
+//public game flow functions
+//
+void Player::Update(float deltaSeconds)
+{
+	//handle movement input, once per frame; the simulation itself runs in UpdateTick
+	PlayerCommand& command = m_pendingCommand;
+	command.m_movementIntentions = Vec3();
+	command.m_steerDirection = Vec3();
+	command.m_yawIntentions = 0.0f;
+	m_movementDirection = Vec2();
+
+	if (g_theInput->IsKeyDown('W'))
+	{
+		if (m_isTankTurn) command.m_movementIntentions.x += 1.0f;
+		else m_movementDirection.x += 1.0f;
+	}
+	if (g_theInput->IsKeyDown('S'))
+	{
+		if (m_isTankTurn) command.m_movementIntentions.x -= 1.0f;
+		else m_movementDirection.x -= 1.0f;
+	}
+	if (g_theInput->IsKeyDown('A'))
+	{
+		if (m_isTankTurn) command.m_yawIntentions += 1.0f;
+		else m_movementDirection.y += 1.0f;
+	}
+	if (g_theInput->IsKeyDown('D'))
+	{
+		if (m_isTankTurn) command.m_yawIntentions -= 1.0f;
+		else m_movementDirection.y -= 1.0f;
+	}
+	if (g_theInput->IsKeyDown('Q'))
+	{
+		if (m_currentGravitySource == nullptr || m_isFreeFlyMode)
+		{
+			command.m_movementIntentions.z -= 1.0f;
+		}
+	}
+	if (g_theInput->IsKeyDown('E'))
+	{
+		if (m_currentGravitySource == nullptr || m_isFreeFlyMode)
+		{
+			command.m_movementIntentions.z += 1.0f;
+		}
+	}
+
+	if (g_theInput->WasKeyJustPressed('H'))
+	{
+		command.m_respawnPressed = true;
+	}
+
+	command.m_isCrouchHeld = g_theInput->IsKeyDown(KEYCODE_SHIFT);
+	command.m_isSpeedUpHeld = g_theInput->IsKeyDown('R');
+
+	if (g_theInput->WasKeyJustPressed(' '))
+	{
+		command.m_jumpPressed = true;
+	}
+
+	//debug keys
+	if (g_theInput->WasKeyJustPressed(KEYCODE_F2))
+	{
+		m_cameraMode = static_cast<CameraMode>(m_cameraMode + 1);
+		if (m_cameraMode >= NUM_MODES)
+		{
+			m_cameraMode = FIXED;
+		}
+		std::string cameraModeString = "";
+		switch (m_cameraMode)
+		{
+			case FIXED: cameraModeString = "Fixed Angle"; break;
+			case FREE: cameraModeString = "Free Control"; break;
+			case FOLLOW: cameraModeString = "Match Player Angle"; break;
+			case FIRST_PERSON: cameraModeString = "First Person"; break;
+		}
+		std::string changedCameraMessage = Stringf("Changed camera mode: %s", cameraModeString.c_str());
+		DebugAddMessage(changedCameraMessage, 4.0f);
+
+		if (m_cameraMode == FREE)
+		{
+			m_playerCamera.SetUseMatrixOrientationMode(false);
+		}
+		else
+		{
+			m_playerCamera.SetUseMatrixOrientationMode(true);
+		}
+	}
+	if (g_theInput->WasKeyJustPressed(KEYCODE_F3))
+	{
+		m_invertFreeCamera = !m_invertFreeCamera;
+		if (m_invertFreeCamera)
+		{
+			std::string message = "Invert free camera: on";
+			DebugAddMessage(message, 4.0f);
+		}
+		else
+		{
+			std::string message = "Invert free camera: off";
+			DebugAddMessage(message, 4.0f);
+		}
+	}
+	if (g_theInput->WasKeyJustPressed(KEYCODE_F4))
+	{
+		m_rememberLastGravitySource = !m_rememberLastGravitySource;
+		if (m_rememberLastGravitySource)
+		{
+			std::string message = "No-gravity mode: Remember last gravity source";
+			DebugAddMessage(message, 4.0f);
+		}
+		else
+		{
+			std::string message = "No-gravity mode: Global gravity";
+			DebugAddMessage(message, 4.0f);
+		}
+	}
+	if (g_theInput->WasKeyJustPressed(KEYCODE_F5))
+	{
+		g_theGame->m_isDebugView = !g_theGame->m_isDebugView;
+	}
+	if (g_theInput->WasKeyJustPressed(KEYCODE_F7))
+	{
+		/*m_isTankTurn = !m_isTankTurn;
+		std::string turn = "Mimic Joystick";
+		if (m_isTankTurn) turn = "Tank Turn";
+		std::string message = Stringf("Keyboard turning mode: %s", turn.c_str());
+		DebugAddMessage(message, 4.0f);*/
+
+		m_isFreeFlyMode = !m_isFreeFlyMode;
+
+		if (m_isFreeFlyMode)
+		{
+			DebugAddMessage("Free Fly: True", 5.0f);
+			m_orientation = Mat44();
+		}
+		else
+		{
+			DebugAddMessage("Free Fly: False", 5.0f);
+		}
+	}
+
+	//handle mouse input
+	IntVec2 mouseDelta = g_theInput->GetCursorClientDelta();
+	m_freeCameraOrientation.m_yawDegrees -= (float)mouseDelta.x * m_mouseTurnRate;
+	if (m_invertFreeCamera)
+	{
+		m_freeCameraOrientation.m_pitchDegrees -= (float)mouseDelta.y * m_mouseTurnRate;
+	}
+	else
+	{
+		m_freeCameraOrientation.m_pitchDegrees += (float)mouseDelta.y * m_mouseTurnRate;
+	}
+
+	if (!m_isTankTurn && (m_movementDirection.x != 0.0f || m_movementDirection.y != 0.0f))
+	{
+		Vec2 leftStickVector = Vec2(-m_movementDirection.y, m_movementDirection.x);
+		Mat44 cameraModelMatrix = m_playerCamera.GetViewMatrix().GetOrthonormalInverse();
+		Vec3 moveForward = cameraModelMatrix.GetKBasis3D();
+		Vec3 moveForwardOnUpVector = GetProjectedOnto3D(moveForward, GetModelMatrix().GetKBasis3D());
+		Vec3 moveForwardOnSurfacePlane = (moveForward - moveForwardOnUpVector).GetNormalized();
+		/*if((moveForward-moveForwardOnUpVector).GetLength() < 0.15f)
+		{
+			moveForward = cameraModelMatrix.GetIBasis3D();
+			moveForwardOnUpVector = GetProjectedOnto3D(moveForward, GetModelMatrix().GetKBasis3D());
+			moveForwardOnSurfacePlane = (moveForward - moveForwardOnUpVector).GetNormalized();
+			std::string mes = "Change to IBasis";
+			DebugAddMessage(mes, 0.0f);
+		}*/
+		Vec3 moveForwardOnSurfacePlaneCorrected = moveForwardOnSurfacePlane;
+		if (DotProduct3D(GetModelMatrix().GetKBasis3D(), cameraModelMatrix.GetIBasis3D()) > 0.0f)
+		{
+			moveForwardOnSurfacePlaneCorrected = -moveForwardOnSurfacePlaneCorrected;
+			if (g_theGame->m_isDebugView)
+			{
+				std::string mes = "Reverse";
+				DebugAddMessage(mes, 0.0f);
+			}
+		}
+		//DebugAddWorldArrow(m_position, m_position + moveForwardOnSurfacePlane, 0.05f, 0.0f, Rgba8(255, 127, 0), Rgba8(255, 127, 0), DebugRenderMode::X_RAY);
+		//DebugAddWorldArrow(m_position, m_position + moveForwardOnSurfacePlaneCorrected, 0.05f, 0.0f, Rgba8(127, 0, 0), Rgba8(127, 0, 0), DebugRenderMode::X_RAY);
+		Vec3 moveRight = CrossProduct3D(moveForwardOnSurfacePlaneCorrected, GetModelMatrix().GetKBasis3D());
+		Vec3 moveRightOnUpVector = GetProjectedOnto3D(moveRight, GetModelMatrix().GetKBasis3D());
+		Vec3 moveRightOnSurfacePlane = (moveRight - moveRightOnUpVector).GetNormalized();
+		if (DotProduct3D(GetModelMatrix().GetKBasis3D(), cameraModelMatrix.GetIBasis3D()) > 0.0f)
+		{
+			moveRightOnSurfacePlane = -moveRightOnSurfacePlane;
+		}
+		//DebugAddWorldArrow(m_position, m_position + moveRightOnSurfacePlane, 0.05f, 0.0f, Rgba8(127, 0, 255), Rgba8(127, 0, 255), DebugRenderMode::X_RAY);
+		Vec3 movementDirection = ((moveForwardOnSurfacePlaneCorrected * leftStickVector.y) + (moveRightOnSurfacePlane * leftStickVector.x)).GetNormalized();
+		//DebugAddWorldArrow(m_position, m_position + movementDirection, 0.05f, 0.0f, Rgba8(0, 0, 0), Rgba8(0, 0, 0), DebugRenderMode::X_RAY);
+		command.m_steerDirection = movementDirection;
+	}
+
+	UpdateFromController(deltaSeconds);
+
+	m_freeCameraOrientation.m_pitchDegrees = GetClamped(m_freeCameraOrientation.m_pitchDegrees, -85.0f, 85.0f);
+
+	//print jump debug info
+	if (g_theGame->m_isDebugView)
+	{
+		std::string jumpMessage = Stringf("Current jump: %i  -  Current jump timer: %.3f  -  IsGrounded: %s  -  WasGrounded: %s", m_jumpNumber, m_tripleJumpTimer, m_isGrounded ? "true" : "false", m_wasGroundedLastFrame ? "true" : "false");
+		DebugAddMessage(jumpMessage, 0.0f);
+		std::string wallSlideMessage = Stringf("IsWallSliding = %s, IsWallJumping = %s", m_isWallSliding ? "true" : "false", m_isWallJumping ? "true" : "false");
+		DebugAddMessage(wallSlideMessage, 0.0f);
+		std::string gravityMessage = Stringf("Degrees rotated to gravity: %.2f", m_degreesRotatedToGravity);
+		DebugAddMessage(gravityMessage, 0.0f);
+	}
+	/*std::string flipMessage = Stringf("Can Side Flip Timer: %.2f", m_canSideFlipTimer);
+	DebugAddMessage(flipMessage, 0.0f);*/
+}
+
+
+void Player::UpdateFromController(float deltaSeconds)
+{
+	PlayerCommand& command = m_pendingCommand;
+	XboxController const& controller = g_theInput->GetController(0);
+	AnalogJoystick const& leftStick = controller.GetLeftStick();
+	AnalogJoystick const& rightStick = controller.GetRightStick();
+
+	float leftStickMagnitude = leftStick.GetMagnitude();
+	float rightStickMagnitude = rightStick.GetMagnitude();
+
+	//camera controls
+	if (rightStickMagnitude > 0.0f)
+	{
+		Vec2 rightStickVector = Vec2::MakeFromPolarDegrees(rightStick.GetOrientationDegrees());
+		m_freeCameraOrientation.m_yawDegrees -= rightStickVector.x * m_controllerTurnRate * deltaSeconds;
+		if (m_invertFreeCamera)
+		{
+			m_freeCameraOrientation.m_pitchDegrees += rightStickVector.y * m_controllerTurnRate * deltaSeconds;
+		}
+		else
+		{
+			m_freeCameraOrientation.m_pitchDegrees -= rightStickVector.y * m_controllerTurnRate * deltaSeconds;
+		}
+	}
+
+
+	static bool forceIBasis = false;
+	/*if (controller.WasButtonJustPressed(XBOX_BUTTON_X))
+	{
+		forceIBasis = !forceIBasis;
+		if (forceIBasis)
+		{
+			DebugAddMessage("Force IBasis: True", 5.0f);
+		}
+		else
+		{
+			DebugAddMessage("Force IBasis: False", 5.0f);
+		}
+	}*/
+
+
+	//movement
+	constexpr float I_BASIS_THRESHOLD = 0.1f;
+	Mat44 cameraModelMatrix = m_playerCamera.GetViewMatrix().GetOrthonormalInverse();
+	if (leftStickMagnitude > 0.0f && !m_isBackFlipping && !m_isWallJumping)
+	{
+		bool usingIBasis = false;
+
+		Vec2 leftStickVector = Vec2::MakeFromPolarDegrees(leftStick.GetOrientationDegrees());
+		Vec3 moveForwardKBasis = cameraModelMatrix.GetKBasis3D();
+		Vec3 moveForwardOnUpVectorKBasis = GetProjectedOnto3D(moveForwardKBasis, GetModelMatrix().GetKBasis3D());
+		Vec3 moveForwardOnSurfacePlaneKBasis = (moveForwardKBasis - moveForwardOnUpVectorKBasis).GetNormalized();
+
+		Vec3 moveForwardIBasis = (cameraModelMatrix.GetKBasis3D() - cameraModelMatrix.GetIBasis3D() * 0.1f).GetNormalized();
+		Vec3 moveForwardOnUpVectorIBasis = GetProjectedOnto3D(moveForwardIBasis, GetModelMatrix().GetKBasis3D());
+		Vec3 moveForwardOnSurfacePlaneIBasis = (moveForwardIBasis - moveForwardOnUpVectorIBasis).GetNormalized();
+
+		if ((moveForwardKBasis - moveForwardOnUpVectorKBasis).GetLength() < I_BASIS_THRESHOLD)
+		{
+			usingIBasis = true;
+
+			/*if (g_theGame->m_isDebugView)*/ //DebugAddMessage("Would change to IBasis here", 0.0f);
+		}
+
+		Vec3 moveForwardOnSurfacePlaneCorrectedKBasis = moveForwardOnSurfacePlaneKBasis;
+		Vec3 moveForwardOnSurfacePlaneCorrectedIBasis = moveForwardOnSurfacePlaneIBasis;
+		if (DotProduct3D(GetModelMatrix().GetKBasis3D(), cameraModelMatrix.GetIBasis3D()) > 0.0f)
+		{
+			moveForwardOnSurfacePlaneCorrectedKBasis = -moveForwardOnSurfacePlaneCorrectedKBasis;
+			//moveForwardOnSurfacePlaneCorrectedIBasis = -moveForwardOnSurfacePlaneCorrectedIBasis;
+
+			/*if (g_theGame->m_isDebugView)*/ //DebugAddMessage("Flip KBasis Direction", 0.0f);
+		}
+
+		if (DotProduct3D(GetModelMatrix().GetKBasis3D(), cameraModelMatrix.GetKBasis3D()) < 0.0f)
+		{
+			//moveForwardOnSurfacePlaneCorrectedIBasis = -moveForwardOnSurfacePlaneCorrectedIBasis;
+
+			/*if (g_theGame->m_isDebugView)*/ //DebugAddMessage("Flip IBasis Direction", 0.0f);
+		}
+
+		/*if (m_reverse)
+		{
+			moveForwardOnSurfacePlaneCorrected = -moveForwardOnSurfacePlaneCorrected;
+		}*/
+
+		Vec3 moveForwardOnSurfacePlaneCorrected = moveForwardOnSurfacePlaneCorrectedKBasis;
+		//Vec3 moveForwardOnSurfacePlaneCorrected = (moveForwardOnSurfacePlaneCorrectedKBasis + moveForwardOnSurfacePlaneCorrectedIBasis).GetNormalized();
+		if (usingIBasis || forceIBasis)
+		{
+			//moveForwardOnSurfacePlaneCorrected = moveForwardOnSurfacePlaneCorrectedIBasis;
+			//moveForwardOnSurfacePlaneCorrected = (moveForwardOnSurfacePlaneCorrectedKBasis + moveForwardOnSurfacePlaneCorrectedIBasis).GetNormalized();
+
+			/*if (g_theGame->m_isDebugView)*/ //DebugAddMessage("Change to IBasis", 0.0f);
+		}
+
+		if (moveForwardOnSurfacePlaneKBasis == moveForwardOnSurfacePlaneCorrectedKBasis)
+		{
+			/*if (g_theGame->m_isDebugView)*/ //DebugAddWorldArrow(m_position, m_position + moveForwardOnSurfacePlaneKBasis, 0.05f, 0.0f, Rgba8(255, 127, 0), Rgba8(255, 127, 0), DebugRenderMode::X_RAY);
+		}
+		else
+		{
+			/*if (g_theGame->m_isDebugView)*/ //DebugAddWorldArrow(m_position, m_position + moveForwardOnSurfacePlaneCorrectedKBasis, 0.05f, 0.0f, Rgba8(127, 0, 0), Rgba8(127, 0, 0), DebugRenderMode::X_RAY);
+		}
+		if (moveForwardOnSurfacePlaneIBasis == moveForwardOnSurfacePlaneCorrectedIBasis)
+		{
+			/*if (g_theGame->m_isDebugView)*/ //DebugAddWorldArrow(m_position, m_position + moveForwardOnSurfacePlaneIBasis, 0.05f, 0.0f, Rgba8(127, 255, 0), Rgba8(127, 255, 0), DebugRenderMode::X_RAY);
+		}
+		else
+		{
+			/*if (g_theGame->m_isDebugView)*/ //DebugAddWorldArrow(m_position, m_position + moveForwardOnSurfacePlaneCorrectedIBasis, 0.05f, 0.0f, Rgba8(0, 127, 0), Rgba8(0, 127, 0), DebugRenderMode::X_RAY);
+		}
+
+		/*Vec3 moveRightJBasis = -cameraModelMatrix.GetJBasis3D();
+		Vec3 moveRightOnUpVectorJBasis = GetProjectedOnto3D(moveRightJBasis, GetModelMatrix().GetKBasis3D());
+		Vec3 moveRightOnSurfacePlaneJBasis = (moveRightJBasis - moveRightOnUpVectorJBasis).GetNormalized();
+
+		Vec3 moveRightOnSurfacePlane = moveRightOnSurfacePlaneJBasis;
+		if ((moveRightJBasis - moveRightOnUpVectorJBasis).GetLength() < I_BASIS_THRESHOLD)
+		{
+			Vec3 moveRight = CrossProduct3D(moveForwardOnSurfacePlaneCorrected, GetModelMatrix().GetKBasis3D());
+			Vec3 moveRightOnUpVector = GetProjectedOnto3D(moveRight, GetModelMatrix().GetKBasis3D());
+			moveRightOnSurfacePlane = (moveRight - moveRightOnUpVector).GetNormalized();
+		}*/
+
+		Vec3 moveRight = CrossProduct3D(moveForwardOnSurfacePlaneCorrected, GetModelMatrix().GetKBasis3D());
+		Vec3 moveRightOnUpVector = GetProjectedOnto3D(moveRight, GetModelMatrix().GetKBasis3D());
+		Vec3 moveRightOnSurfacePlane = (moveRight - moveRightOnUpVector).GetNormalized();
+		
+		bool rightFlipped = false;
+		if (DotProduct3D(GetModelMatrix().GetKBasis3D(), cameraModelMatrix.GetIBasis3D()) > 0.0f)
+		{
+			moveRightOnSurfacePlane = -moveRightOnSurfacePlane;
+			rightFlipped = true;
+		}
+		/*if (m_reverse)
+		{
+			moveRightOnSurfacePlane = -moveRightOnSurfacePlane;
+		}*/
+
+		if (!rightFlipped)
+		{
+			/*if (g_theGame->m_isDebugView)*/ //DebugAddWorldArrow(m_position, m_position + moveRightOnSurfacePlane, 0.05f, 0.0f, Rgba8(127, 0, 255), Rgba8(127, 0, 255), DebugRenderMode::X_RAY);
+		}
+		else
+		{
+			/*if (g_theGame->m_isDebugView)*/ //DebugAddWorldArrow(m_position, m_position + moveRightOnSurfacePlane, 0.05f, 0.0f, Rgba8(0, 0, 127), Rgba8(0, 0, 127), DebugRenderMode::X_RAY);
+		}
+		
+		Vec3 movementDirection = ((moveForwardOnSurfacePlaneCorrected * leftStickVector.y) + (moveRightOnSurfacePlane * leftStickVector.x)).GetNormalized();
+		//DebugAddWorldArrow(m_position, m_position + movementDirection, 0.05f, 0.0f, Rgba8(0, 0, 0), Rgba8(0, 0, 0), DebugRenderMode::X_RAY);
+		command.m_steerDirection = movementDirection;
+	}
+	//else if (leftStickMagnitude == 0.0f)
+	//{
+	//	bool usingIBasis = false;
+
+	//	Vec3 moveForwardKBasis = cameraModelMatrix.GetKBasis3D();
+	//	Vec3 moveForwardOnUpVectorKBasis = GetProjectedOnto3D(moveForwardKBasis, GetModelMatrix().GetKBasis3D());
+	//	Vec3 moveForwardOnSurfacePlaneKBasis = (moveForwardKBasis - moveForwardOnUpVectorKBasis).GetNormalized();
+
+	//	Vec3 moveForwardIBasis = cameraModelMatrix.GetIBasis3D();
+	//	Vec3 moveForwardOnUpVectorIBasis = GetProjectedOnto3D(moveForwardIBasis, GetModelMatrix().GetKBasis3D());
+	//	Vec3 moveForwardOnSurfacePlaneIBasis = (moveForwardIBasis - moveForwardOnUpVectorIBasis).GetNormalized();
+
+	//	if ((moveForwardKBasis - moveForwardOnUpVectorKBasis).GetLength() < I_BASIS_THRESHOLD)
+	//	{
+	//		//usingIBasis = true;
+
+	//		if (g_theGame->m_isDebugView) DebugAddMessage("Would change to IBasis here", 0.0f);
+	//	}
+
+	//	Vec3 moveForwardOnSurfacePlaneCorrectedKBasis = moveForwardOnSurfacePlaneKBasis;
+	//	Vec3 moveForwardOnSurfacePlaneCorrectedIBasis = moveForwardOnSurfacePlaneIBasis;
+	//	if (DotProduct3D(GetModelMatrix().GetKBasis3D(), cameraModelMatrix.GetIBasis3D()) > 0.0f)
+	//	{
+	//		moveForwardOnSurfacePlaneCorrectedKBasis = -moveForwardOnSurfacePlaneCorrectedKBasis;
+	//		moveForwardOnSurfacePlaneCorrectedIBasis = -moveForwardOnSurfacePlaneCorrectedIBasis;
+
+	//		if (g_theGame->m_isDebugView) DebugAddMessage("Flip Direction", 0.0f);
+	//	}
+	//	/*if (m_reverse)
+	//	{
+	//		moveForwardOnSurfacePlaneCorrected = -moveForwardOnSurfacePlaneCorrected;
+	//	}*/
+
+	//	Vec3 moveForwardOnSurfacePlaneCorrected = moveForwardOnSurfacePlaneCorrectedKBasis;
+	//	if (usingIBasis || forceIBasis)
+	//	{
+	//		moveForwardOnSurfacePlaneCorrected = moveForwardOnSurfacePlaneCorrectedIBasis;
+
+	//		if (g_theGame->m_isDebugView) DebugAddMessage("Change to IBasis", 0.0f);
+	//	}
+
+	//	if (moveForwardOnSurfacePlaneKBasis == moveForwardOnSurfacePlaneCorrectedKBasis)
+	//	{
+	//		if (g_theGame->m_isDebugView) DebugAddWorldArrow(m_position, m_position + moveForwardOnSurfacePlaneKBasis, 0.05f, 0.0f, Rgba8(255, 127, 0), Rgba8(255, 127, 0), DebugRenderMode::X_RAY);
+	//	}
+	//	else
+	//	{
+	//		if (g_theGame->m_isDebugView) DebugAddWorldArrow(m_position, m_position + moveForwardOnSurfacePlaneCorrectedKBasis, 0.05f, 0.0f, Rgba8(127, 0, 0), Rgba8(127, 0, 0), DebugRenderMode::X_RAY);
+	//	}
+	//	if (moveForwardOnSurfacePlaneIBasis == moveForwardOnSurfacePlaneCorrectedIBasis)
+	//	{
+	//		if (g_theGame->m_isDebugView) DebugAddWorldArrow(m_position, m_position + moveForwardOnSurfacePlaneIBasis, 0.05f, 0.0f, Rgba8(127, 255, 0), Rgba8(127, 255, 0), DebugRenderMode::X_RAY);
+	//	}
+	//	else
+	//	{
+	//		if (g_theGame->m_isDebugView) DebugAddWorldArrow(m_position, m_position + moveForwardOnSurfacePlaneCorrectedIBasis, 0.05f, 0.0f, Rgba8(0, 127, 0), Rgba8(0, 127, 0), DebugRenderMode::X_RAY);
+	//	}
+
+	//	Vec3 moveRight = CrossProduct3D(moveForwardOnSurfacePlaneCorrected, GetModelMatrix().GetKBasis3D());
+	//	Vec3 moveRightOnUpVector = GetProjectedOnto3D(moveRight, GetModelMatrix().GetKBasis3D());
+	//	Vec3 moveRightOnSurfacePlane = (moveRight - moveRightOnUpVector).GetNormalized();
+	//	bool rightFlipped = false;
+	//	if (DotProduct3D(GetModelMatrix().GetKBasis3D(), cameraModelMatrix.GetIBasis3D()) > 0.0f)
+	//	{
+	//		moveRightOnSurfacePlane = -moveRightOnSurfacePlane;
+	//		rightFlipped = true;
+	//	}
+	//	/*if (m_reverse)
+	//	{
+	//		moveRightOnSurfacePlane = -moveRightOnSurfacePlane;
+	//	}*/
+
+	//	if (!rightFlipped)
+	//	{
+	//		if (g_theGame->m_isDebugView) DebugAddWorldArrow(m_position, m_position + moveRightOnSurfacePlane, 0.05f, 0.0f, Rgba8(127, 0, 255), Rgba8(127, 0, 255), DebugRenderMode::X_RAY);
+	//	}
+	//	else
+	//	{
+	//		if (g_theGame->m_isDebugView) DebugAddWorldArrow(m_position, m_position + moveRightOnSurfacePlane, 0.05f, 0.0f, Rgba8(0, 0, 127), Rgba8(0, 0, 127), DebugRenderMode::X_RAY);
+	//	}
+
+	//	/*if (DotProduct3D(GetModelMatrix().GetKBasis3D(), cameraModelMatrix.GetIBasis3D()) > 0.0f)
+	//	{
+	//		m_reverse = true;
+	//	}
+	//	else
+	//	{
+	//		m_reverse = false;
+	//	}*/
+	//}
+	//if (m_reverse) DebugAddMessage("Reverse", 0.0f);
+
+
+
+
+
+
+	//buttons
+	if (controller.GetLeftTrigger() > 0.0f)
+	{
+		command.m_isCrouchHeld = true;
+	}
+	if (controller.WasButtonJustPressed(XboxButtonID::XBOX_BUTTON_A))
+	{
+		command.m_jumpPressed = true;
+	}
+	if (controller.IsButtonDown(XBOX_BUTTON_L))
+	{
+		command.m_movementIntentions.z -= 1.0f;
+	}
+	if (controller.IsButtonDown(XBOX_BUTTON_R))
+	{
+		command.m_movementIntentions.z += 1.0f;
+	}
+	
+	if (controller.WasButtonJustPressed(XboxButtonID::XBOX_BUTTON_SELECT))
+	{
+		command.m_respawnPressed = true;
+	}
+}
+
+
+void Player::UpdateCamera()
+{
+	//handle camera modes
+	switch (m_cameraMode)
+	{
+		case FIXED: m_playerCamera.SetTransform(m_renderPosition + Vec3(m_cameraOffset, 0.0f, 0.0f), Mat44()); break;
+		case FREE:	
+		{
+			m_playerCamera.SetTransform(m_renderPosition, m_freeCameraOrientation);
+			Vec3 cameraForward = m_playerCamera.GetViewMatrix().GetOrthonormalInverse().GetIBasis3D();
+			m_playerCamera.SetTransform(m_renderPosition + (cameraForward * m_cameraOffset), m_freeCameraOrientation);
+			break;
+		}
+		case FOLLOW: m_playerCamera.SetTransform(m_renderPosition + (m_renderOrientation.GetIBasis3D() * m_cameraOffset), m_renderOrientation); break;
+		case FIRST_PERSON: m_playerCamera.SetTransform(m_renderPosition, m_renderOrientation); break;
+	}
+}
+
+
+void Player::Render() const
+{
+	//render as capsule
+	std::vector<Vertex_PCUTBN> meshVerts;
+
+	if (m_isCrouching)
+	{
+		AddVertsForCapsule3D(meshVerts, Vec3(0.0f, 0.0f, -m_meshHeight * 0.5f), Vec3(0.0f, 0.0f, 0.0f), m_meshRadius + 0.1f);
+	}
+	else
+	{
+		AddVertsForCapsule3D(meshVerts, Vec3(0.0f, 0.0f, -m_meshHeight * 0.5f), Vec3(0.0f, 0.0f, m_meshHeight * 0.5f), m_meshRadius);
+	}
+
+	Mat44 scaledModelMatrix = GetRenderModelMatrix();
+	float squashAmount = 1.0f / m_stretchAmount;
+	scaledModelMatrix.AppendScaleNonUniform3D(Vec3(squashAmount, squashAmount, m_stretchAmount));
+	if (m_doTripleJumpFlip)
+	{
+		scaledModelMatrix.AppendYRotation(m_tripleJumpFlipAngle);
+	}
+	else if (m_isBackFlipping)
+	{
+		scaledModelMatrix.AppendYRotation(m_backFlipAngle);
+	}
+	else if (m_isWallSliding)
+	{
+		scaledModelMatrix.AppendTranslation3D(Vec3(0.25f, 0.0f, 0.0f));
+		scaledModelMatrix.AppendYRotation(5.0f);
+	}
+	scaledModelMatrix.AppendTranslation3D(Vec3(0.0f, 0.0f, -squashAmount + 1.0f));
+
+	g_theRenderer->BindShader(g_theGame->m_lightingShader);
+	g_theRenderer->BindTexture(nullptr);
+	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
+	g_theRenderer->SetModelConstants(scaledModelMatrix, m_color);
+	g_theRenderer->DrawVertexArray(meshVerts);
+
+	//render collision bounds as wireframe sphere
+	if (g_theGame->m_isDebugView)
+	{
+		std::vector<Vertex_PCU> collisionVerts;
+
+		AddVertsForSphere3D(collisionVerts, Vec3(), m_collisionRadius);
+
+		g_theRenderer->BindShader(nullptr);
+		g_theRenderer->BindTexture(nullptr);
+		g_theRenderer->SetRasterizerMode(RasterizerMode::WIREFRAME_CULL_NONE);
+		g_theRenderer->SetModelConstants(GetRenderModelMatrix(), m_debugWireframeColor);
+		g_theRenderer->DrawVertexArray(collisionVerts);
+
+		DebugAddWorldArrow(m_position, m_position + m_velocity * 0.1f, 0.05f, 0.0f, Rgba8(255, 255, 0), Rgba8(255, 0, 0), DebugRenderMode::X_RAY);
+		if (m_currentGravityVector != Vec3())
+		{
+			DebugAddWorldArrow(m_position, m_position + m_currentGravityVector * 0.01f, 0.05f, 0.0f, Rgba8(255, 0, 255), Rgba8(255, 0, 255), DebugRenderMode::X_RAY);
+		}
+	}
+
+	DebugAddWorldArrow(m_position, m_position + m_orientation.GetIBasis3D() * 1.5f, 0.05f, 0.0f, Rgba8(255, 0, 0), Rgba8(255, 0, 0));
+	DebugAddWorldArrow(m_position, m_position + m_orientation.GetJBasis3D() * 1.5f, 0.05f, 0.0f, Rgba8(0, 255, 0), Rgba8(0, 255, 0));
+	DebugAddWorldArrow(m_position, m_position + m_orientation.GetKBasis3D() * 1.5f, 0.05f, 0.0f, Rgba8(0, 0, 255), Rgba8(0, 0, 255));
+}
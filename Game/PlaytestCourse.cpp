@@ -0,0 +1,214 @@
+#include "Game/PlaytestCourse.hpp"
+#include "Game/Planetoids.hpp"
+#include "Game/LevelFile.hpp"
+#include "Game/Player.hpp"
+#include "Engine/Math/MathUtils.hpp"
+
+
+//
+//course building sub-functions
+//
+static void AddCoursePlanetoid(PlaytestCourse& course, Planetoid* planetoid)
+{
+	planetoid->UpdateWorldBounds();
+	course.m_planetoids.emplace_back(planetoid);
+}
+
+
+static void AddCourseSign(PlaytestCourse& course, char const* text, Mat44 const& transform)
+{
+	CourseSign sign;
+	sign.m_text = text;
+	sign.m_transform = transform;
+	course.m_signs.emplace_back(sign);
+}
+
+
+//
+//course building functions
+//
+void BuildPlaytestCourse(PlaytestCourse& out_course)
+{
+	//add planetoids for starting area before course
+	AddCoursePlanetoid(out_course, new SpherePLTD(Vec3(0.0f, 0.0f, -26.0f), 20.0f, true, 30.0f, GRAVITY_STANDARD, Rgba8(50, 150, 100)));
+	AddCoursePlanetoid(out_course, new TorusPLTD(Vec3(50.0f, 0.0f, 0.0f), 9.0f, 22.0f, EulerAngles(), true, 12.0f, GRAVITY_STANDARD, Rgba8(255, 255, 0)));
+	
+	AddCoursePlanetoid(out_course, new CapsulePLTD(Vec3(50.0f, 47.5f, 0.0f), 5.0f, 17.5f, Vec3(0.0f, 1.0f, 0.0f), true, 12.5f, GRAVITY_STANDARD, Rgba8(0, 175, 25)));
+	AddCoursePlanetoid(out_course, new MountainPLTD(Vec3(50.0f, 95.0f, -4.0f), 1.0f, EulerAngles(), Rgba8(25, 150, 220), true, 45.0f, GRAVITY_STANDARD));
+
+	AddCoursePlanetoid(out_course, new CapsulePLTD(Vec3(50.0f, -47.5f, 0.0f), 5.0f, 17.5f, Vec3(0.0f, -1.0f, 0.0f), true, 12.5f, GRAVITY_STANDARD, Rgba8(25, 0, 175)));
+	AddCoursePlanetoid(out_course, new RoundCubePLTD(Vec3(55.0f, -75.0f, 7.0f), 8.0f, 9.0f, 6.0f, 0.75f, EulerAngles(-20.0f, 0.0f, 0.0f), true, 18.0f, 19.0f, 16.0f, GRAVITY_STANDARD, Rgba8(200, 200, 200)));
+	AddCoursePlanetoid(out_course, new RoundCubePLTD(Vec3(65.0f, -80.0f, 14.0f), 9.0f, 8.0f, 6.0f, 0.5f, EulerAngles(15.0f, 15.0f, 15.0f), true, 19.0f, 18.0f, 16.0f, GRAVITY_STANDARD, Rgba8(150, 150, 150)));
+	AddCoursePlanetoid(out_course, new RoundCubePLTD(Vec3(76.0f, -76.0f, 19.0f), 10.0f, 9.0f, 12.0f, 0.25f, EulerAngles(0.0f, -5.0f, 45.0f), true, 20.0f, 19.0f, 22.0f, GRAVITY_STANDARD, Rgba8(100, 100, 100)));
+
+	AddCoursePlanetoid(out_course, new CapsulePLTD(Vec3(94.0f, 0.0f, 0.0f), 5.0f, 20.0f, Vec3(1.0f, 0.0f, 0.0f), true, 12.5f, GRAVITY_STANDARD, Rgba8(100, 0, 100)));
+	Mat44 textTransform = Mat44::CreateTranslation3D(Vec3(114.0f, 0.0f, 10.0f));
+	textTransform.AppendZRotation(180.0f);
+	AddCourseSign(out_course, "Enter Playtest Course Here", textTransform);
+	
+	//Section 1
+	out_course.m_checkpoints.emplace_back(AABB3(Vec3(247.0f, -5.0f, 0.0f), Vec3(253.0f, 5.0f, 15.0f)));
+	textTransform = Mat44::CreateTranslation3D(Vec3(253.0f, 0.0f, 15.0f));
+	textTransform.AppendZRotation(180.0f);
+	AddCourseSign(out_course, "Section 1", textTransform);
+
+	AddCoursePlanetoid(out_course, new SpherePLTD(Vec3(250.0f, 0.0f, 0.0f), 10.0f, true, 20.0f, GRAVITY_STANDARD, Rgba8(50, 100, 200)));
+	AddCoursePlanetoid(out_course, new SpherePLTD(Vec3(257.0f, -6.0f, 5.0f), 8.0f, true, 16.0f, GRAVITY_STANDARD, Rgba8(200, 100, 50)));
+	AddCoursePlanetoid(out_course, new SpherePLTD(Vec3(265.0f, 6.0f, 11.0f), 11.0f, true, 22.0f, GRAVITY_STANDARD, Rgba8(100, 200, 50)));
+	AddCoursePlanetoid(out_course, new SpherePLTD(Vec3(290.0f, -2.0f, 18.0f), 10.0f, true, 20.0f, GRAVITY_STANDARD, Rgba8(100, 50, 100)));
+	AddCoursePlanetoid(out_course, new EllipsoidPLTD(Vec3(305.0f, 0.0f, 30.0f), 6.0f, 6.0f, 3.5f, EulerAngles(), true, 24.0f, 24.0f, 14.0f, GRAVITY_STANDARD, Rgba8(150, 255, 0)));
+	AddCoursePlanetoid(out_course, new CapsulePLTD(Vec3(320.0f, 0.0f, 35.0f), 3.5f, 15.0f, Vec3(1.0f, 1.0f, 0.0f), true, 16.0f, GRAVITY_STANDARD, Rgba8(200, 75, 150)));
+	AddCoursePlanetoid(out_course, new CapsulePLTD(Vec3(340.0f, 10.0f, 35.0f), 3.5f, 15.0f, Vec3(1.0f, -1.0f, 0.0f), true, 16.0f, GRAVITY_STANDARD, Rgba8(125, 75, 175)));
+
+	AddCoursePlanetoid(out_course, new MountainPLTD(Vec3(377.0f, 0.0f, 35.0f), 1.0f, EulerAngles(315.0f, 0.0f, 0.0f), Rgba8(0, 200, 10), true, 45.0f, GRAVITY_STANDARD));
+	AddCoursePlanetoid(out_course, new SpherePLTD(Vec3(379.0f, 0.0f, 90.0f), 10.0f, true, 20.0f, GRAVITY_STANDARD, Rgba8(50, 255, 255)));
+	AddCoursePlanetoid(out_course, new BowlPLTD(Vec3(408.0f, 0.0f, 90.0f), 10.0f, 3.5f, EulerAngles(45.0f, 30.0f, 10.0f), true, 10.0f, GRAVITY_STANDARD, Rgba8(255, 0, 250)));
+	WirePerlinParameters wirePerlin;
+	wirePerlin.m_minSegments = 5;
+	wirePerlin.m_maxSegments = 5;
+	wirePerlin.m_maxYawChange = 90.0f;
+	wirePerlin.m_maxPitchChange = 45.0f;
+	wirePerlin.m_segMinLength = 10.0f;
+	wirePerlin.m_segMaxLength = 25.0f;
+	wirePerlin.m_rngSeed = 1234;
+	AddCoursePlanetoid(out_course, new WirePLTD(Vec3(427.0f, 0.0f, 87.5f), 5.0f, wirePerlin, EulerAngles(), true, 10.0f, GRAVITY_STANDARD, Rgba8(187, 108, 156)));
+	AddCoursePlanetoid(out_course, new RoundCubePLTD(Vec3(496.0f, 85.0f, 100.0f), 20.0f, 20.0f, 25.0f, 0.5f, EulerAngles(), true, 40.0f, 40.0f, 45.0f, GRAVITY_STANDARD, Rgba8(50, 160, 142)));
+
+	//Section 2
+	out_course.m_checkpoints.emplace_back(AABB3(Vec3(511.0f, 55.0f, 102.0f), Vec3(561.0f, 115.0f, 132.0f)));
+	textTransform = Mat44::CreateTranslation3D(Vec3(516.0f, 85.0f, 115.0f));
+	textTransform.AppendZRotation(180.0f);
+	AddCourseSign(out_course, "Section 2", textTransform);
+	AddCoursePlanetoid(out_course, new RoundCubePLTD(Vec3(536.0f, 85.0f, 102.0f), 50.0f, 50.0f, 15.0f, 0.25f, EulerAngles(), true, 75.0f, 75.0f, 40.0f, GRAVITY_STANDARD, Rgba8(50, 100, 50)));
+	textTransform = Mat44::CreateTranslation3D(Vec3(536.0f, 85.0f, 115.0f));
+	textTransform.AppendZRotation(180.0f);
+	AddCourseSign(out_course, "Jump against a wall to wall slide\n\nJump while sliding to wall jump", textTransform);
+	AddCoursePlanetoid(out_course, new PlanePLTD(Vec3(545.0f, 88.0f, 120.0f), 6.0f, 11.0f, EulerAngles(0.0f, 0.0f, 90.0f), false, 0.0f, 0.0f, Rgba8(200, 0, 0)));
+	AddCoursePlanetoid(out_course, new PlanePLTD(Vec3(545.0f, 88.1f, 120.0f), 6.0f, 11.0f, EulerAngles(0.0f, 0.0f, -90.0f), false, 0.0f, 0.0f, Rgba8(200, 0, 0)));
+	AddCoursePlanetoid(out_course, new PlanePLTD(Vec3(545.0f, 82.0f, 120.0f), 6.0f, 11.0f, EulerAngles(0.0f, 0.0f, -90.0f), false, 0.0f, 0.0f, Rgba8(200, 0, 0)));
+	AddCoursePlanetoid(out_course, new PlanePLTD(Vec3(545.0f, 81.9f, 120.0f), 6.0f, 11.0f, EulerAngles(0.0f, 0.0f, 90.0f), false, 0.0f, 0.0f, Rgba8(200, 0, 0)));
+	AddCoursePlanetoid(out_course, new SpherePLTD(Vec3(545.0f, 85.0f, 152.0f), 10.0f, true, 20.0f, GRAVITY_STANDARD, Rgba8(100, 50, 50)));
+	AddCoursePlanetoid(out_course, new SpherePLTD(Vec3(572.0f, 85.0f, 157.0f), 10.0f, true, 20.0f, GRAVITY_STANDARD, Rgba8(50, 50, 100)));
+	AddCoursePlanetoid(out_course, new SpherePLTD(Vec3(588.0f, 85.0f, 155.0f), 8.0f, true, 18.0f, GRAVITY_STANDARD, Rgba8(105, 110, 125)));
+
+	AddCoursePlanetoid(out_course, new RoundCubePLTD(Vec3(675.0f, 85.0f, 150.0f), 160.0f, 100.0f, 10.0f, 0.01f, EulerAngles(), true, 300.0f, 200.0f, 200.0f, GRAVITY_STANDARD, Rgba8(109, 179, 240)));
+	textTransform = Mat44::CreateTranslation3D(Vec3(625.0f, 85.0f, 162.0f));
+	textTransform.AppendZRotation(180.0f);
+	AddCourseSign(out_course, "Hold left trigger to crouch\n\nCrouch and jump while not moving to back flip", textTransform);
+	AddCoursePlanetoid(out_course, new RoundCubePLTD(Vec3(635.0f, 74.0f, 160.0f), 8.0f, 3.0f, 10.0f, 0.0f, EulerAngles(), false, 0.0f, 0.0f, 0.0f, 0.0f, Rgba8(200, 0, 0)));
+	AddCoursePlanetoid(out_course, new RoundCubePLTD(Vec3(635.0f, 77.0f, 170.0f), 8.0f, 3.0f, 10.0f, 0.0f, EulerAngles(), false, 0.0f, 0.0f, 0.0f, 0.0f, Rgba8(200, 0, 0)));
+	AddCoursePlanetoid(out_course, new RoundCubePLTD(Vec3(640.0f, 85.0f, 180.0f), 16.0f, 7.5f, 5.0f, 0.0f, EulerAngles(), false, 0.0f, 0.0f, 0.0f, 0.0f, Rgba8(200, 0, 0)));
+	textTransform = Mat44::CreateTranslation3D(Vec3(665.0f, 85.0f, 186.0f));
+	textTransform.AppendZRotation(180.0f);
+	AddCourseSign(out_course, "Run, crouch, and jump to long jump", textTransform);
+	AddCoursePlanetoid(out_course, new RoundCubePLTD(Vec3(670.0f, 85.0f, 180.0f), 16.0f, 10.0f, 5.0f, 0.0f, EulerAngles(), false, 0.0f, 0.0f, 0.0f, 0.0f, Rgba8(200, 0, 0)));
+	AddCoursePlanetoid(out_course, new RoundCubePLTD(Vec3(686.0f, 85.0f, 185.0f), 16.0f, 10.0f, 5.0f, 0.0f, EulerAngles(), false, 0.0f, 0.0f, 0.0f, 0.0f, Rgba8(200, 0, 0)));
+	AddCoursePlanetoid(out_course, new SkyStationPLTD(Vec3(730.0f, 85.0f, 189.0f), 1.0f, EulerAngles(-90.0f, -30.0f, 0.0f), Rgba8(0, 255, 125), true, 45.0f, GRAVITY_STANDARD));
+	AddCoursePlanetoid(out_course, new SpherePLTD(Vec3(745.0f, 85.0f, 225.0f), 10.0f, true, 25.0f, GRAVITY_STANDARD, Rgba8(194, 190, 5)));
+
+	//Section 3
+	out_course.m_checkpoints.emplace_back(AABB3(Vec3(760.0f, 55.0f, 200.0f), Vec3(795.0f, 115.0f, 285.0f)));
+	textTransform = Mat44::CreateTranslation3D(Vec3(773.0f, 85.0f, 240.0f));
+	textTransform.AppendZRotation(180.0f);
+	AddCourseSign(out_course, "Section 3", textTransform);
+	AddCoursePlanetoid(out_course, new CapsulePLTD(Vec3(770.0f, 85.0f, 225.0f), 10.0f, 20.0f, Vec3(1.0f, 0.0f, 0.0f), true, 25.0f, GRAVITY_STANDARD, Rgba8(30, 20, 250)));
+	AddCoursePlanetoid(out_course, new FortressPLTD(Vec3(870.0f, 84.0f, 225.0f), 1.0f, EulerAngles(225.0f, 0.0f, 0.0f), Rgba8(70, 215, 0), true, 40.0f, GRAVITY_STANDARD));
+	AddCoursePlanetoid(out_course, new PlanePLTD(Vec3(865.0f, 84.0f, 256.25f), 4.0f, 4.0f, EulerAngles(), false, 0.0f, 0.0f, Rgba8(70, 215, 0)));
+	AddCoursePlanetoid(out_course, new RoundCubePLTD(Vec3(874.0f, 80.0f, 269.0f), 6.0f, 2.0f, 20.0f, 0.0f, EulerAngles(), false, 0.0f, 0.0f, 0.0f, 0.0f, Rgba8(200, 0, 0)));
+	AddCoursePlanetoid(out_course, new RoundCubePLTD(Vec3(874.0f, 86.0f, 273.0f), 6.0f, 2.0f, 20.0f, 0.0f, EulerAngles(), false, 0.0f, 0.0f, 0.0f, 0.0f, Rgba8(200, 0, 0)));
+	AddCoursePlanetoid(out_course, new RoundCubePLTD(Vec3(874.0f, 70.0f, 277.5f), 10.0f, 18.0f, 3.0f, 0.0f, EulerAngles(), false, 0.0f, 0.0f, 0.0f, 0.0f, Rgba8(200, 0, 0)));
+	AddCoursePlanetoid(out_course, new SpherePLTD(Vec3(874.0f, 0.0f, 282.5f), 12.0f, true, 60.0f, GRAVITY_STANDARD, Rgba8(255, 255, 0)));
+	AddCoursePlanetoid(out_course, new BowlPLTD(Vec3(874.0f, 0.0f, 282.5f), 20.0f, 8.0f, EulerAngles(90.0f, 85.0f, 0.0f), false, 0.0f, 0.0f, Rgba8(255, 255, 0)));
+	AddCoursePlanetoid(out_course, new CapsulePLTD(Vec3(874.0f, -50.0f, 284.0f), 12.0f, 100.0f, Vec3(0.0f, -1.0f, 0.0f), true, 50.0f, GRAVITY_STANDARD, Rgba8(140, 120, 190)));
+	AddCoursePlanetoid(out_course, new RoundCubePLTD(Vec3(885.0f, -57.5f, 284.0f), 30.0f, 3.0f, 50.0f, 0.0f, EulerAngles(), false, 0.0f, 0.0f, 0.0f, 0.0f, Rgba8(200, 0, 0)));
+	AddCoursePlanetoid(out_course, new RoundCubePLTD(Vec3(865.0f, -82.5f, 284.0f), 30.0f, 3.0f, 50.0f, 0.0f, EulerAngles(), false, 0.0f, 0.0f, 0.0f, 0.0f, Rgba8(200, 0, 0)));
+	AddCoursePlanetoid(out_course, new RoundCubePLTD(Vec3(874.0f, -107.5f, 300.0f), 50.0f, 3.0f, 30.0f, 0.0f, EulerAngles(), false, 0.0f, 0.0f, 0.0f, 0.0f, Rgba8(200, 0, 0)));
+	AddCoursePlanetoid(out_course, new CapsulePLTD(Vec3(874.0f, -150.0f, 284.0f), 12.0f, 60.0f, Vec3(0.0f, 0.0f, 1.0f), true, 50.0f, GRAVITY_STANDARD, Rgba8(140, 120, 190)));
+	AddCoursePlanetoid(out_course, new CapsulePLTD(Vec3(874.0f, -150.0f, 344.0f), 12.0f, 60.0f, Vec3(0.0f, 1.0f, 1.0f), true, 50.0f, GRAVITY_STANDARD, Rgba8(140, 120, 190)));
+	
+	//Section 4
+	out_course.m_checkpoints.emplace_back(AABB3(Vec3(880.0f, -148.0f, 386.0f), Vec3(920.0f, -68.0f, 419.0f)));
+	textTransform = Mat44::CreateTranslation3D(Vec3(900.0f, -108.0f, 401.0f));
+	textTransform.AppendZRotation(180.0f);
+	AddCourseSign(out_course, "Section 4", textTransform);
+	textTransform = Mat44::CreateTranslation3D(Vec3(915.0f, -108.0f, 401.0f));
+	textTransform.AppendZRotation(180.0f);
+	AddCourseSign(out_course, "Jump three times in a row while running\nto triple jump", textTransform);
+	AddCoursePlanetoid(out_course, new RoundCubePLTD(Vec3(912.0f, -108.0f, 386.0f), 45.0f, 30.0f, 20.0f, 0.25f, EulerAngles(), true, 45.0f, 50.0f, 40.0f, GRAVITY_STANDARD, Rgba8(255, 170, 150)));
+	AddCoursePlanetoid(out_course, new RoundCubePLTD(Vec3(948.0f, -108.0f, 421.0f), 25.0f, 30.0f, 15.0f, 0.25f, EulerAngles(), true, 45.0f, 50.0f, 40.0f, GRAVITY_STANDARD, Rgba8(190, 170, 180)));
+	AddCoursePlanetoid(out_course, new TorusPLTD(Vec3(1045.0f, -108.0f, 450.0f), 12.0f, 50.0f, EulerAngles(0.0f, -25.0f, 0.0f), true, 42.0f, GRAVITY_STANDARD, Rgba8(60, 54, 206)));
+	AddCoursePlanetoid(out_course, new RoundCubePLTD(Vec3(1045.0f, -46.0f, 450.0f), 3.0f, 60.0f, 60.0f, 0.0f, EulerAngles(0.0f, -25.0f, 0.0f), false, 0.0f, 0.0f, 0.0f, 0.0f, Rgba8(200, 0, 0)));
+	AddCoursePlanetoid(out_course, new RoundCubePLTD(Vec3(1045.0f, -170.0f, 450.0f), 3.0f, 60.0f, 60.0f, 0.0f, EulerAngles(0.0f, -25.0f, 0.0f), false, 0.0f, 0.0f, 0.0f, 0.0f, Rgba8(200, 0, 0)));
+	AddCoursePlanetoid(out_course, new SpherePLTD(Vec3(1045.0f, -108.0f, 450.0f), 29.0f, true, 50.0f, GRAVITY_STANDARD, Rgba8(106, 187, 156)));
+	AddCoursePlanetoid(out_course, new SpherePLTD(Vec3(1140.0f, -108.0f, 490.0f), 10.0f, true, 40.0f, GRAVITY_STANDARD, Rgba8(255, 0, 0)));
+	AddCoursePlanetoid(out_course, new SpherePLTD(Vec3(1145.0f, -113.0f, 495.0f), 10.0f, true, 40.0f, GRAVITY_STANDARD, Rgba8(255, 85, 0)));
+	AddCoursePlanetoid(out_course, new SpherePLTD(Vec3(1150.0f, -116.0f, 502.0f), 10.0f, true, 40.0f, GRAVITY_STANDARD, Rgba8(255, 170, 0)));
+	AddCoursePlanetoid(out_course, new SpherePLTD(Vec3(1155.0f, -118.0f, 510.0f), 10.0f, true, 40.0f, GRAVITY_STANDARD, Rgba8(255, 255, 0)));
+	AddCoursePlanetoid(out_course, new SpherePLTD(Vec3(1160.0f, -119.0f, 519.0f), 10.0f, true, 40.0f, GRAVITY_STANDARD, Rgba8(170, 255, 0)));
+	AddCoursePlanetoid(out_course, new SpherePLTD(Vec3(1165.0f, -118.0f, 528.0f), 10.0f, true, 40.0f, GRAVITY_STANDARD, Rgba8(85, 255, 0)));
+	AddCoursePlanetoid(out_course, new SpherePLTD(Vec3(1170.0f, -116.0f, 536.0f), 10.0f, true, 40.0f, GRAVITY_STANDARD, Rgba8(0, 255, 0)));
+	AddCoursePlanetoid(out_course, new SpherePLTD(Vec3(1175.0f, -113.0f, 543.0f), 10.0f, true, 40.0f, GRAVITY_STANDARD, Rgba8(0, 255, 85)));
+	AddCoursePlanetoid(out_course, new SpherePLTD(Vec3(1180.0f, -108.0f, 548.0f), 10.0f, true, 40.0f, GRAVITY_STANDARD, Rgba8(0, 255, 170)));
+	AddCoursePlanetoid(out_course, new SpherePLTD(Vec3(1185.0f, -103.0f, 553.0f), 10.0f, true, 40.0f, GRAVITY_STANDARD, Rgba8(0, 255, 255)));
+	AddCoursePlanetoid(out_course, new SpherePLTD(Vec3(1190.0f, -100.0f, 560.0f), 10.0f, true, 40.0f, GRAVITY_STANDARD, Rgba8(0, 170, 255)));
+	AddCoursePlanetoid(out_course, new SpherePLTD(Vec3(1195.0f, -98.0f, 568.0f), 10.0f, true, 40.0f, GRAVITY_STANDARD, Rgba8(0, 85, 255)));
+	AddCoursePlanetoid(out_course, new SpherePLTD(Vec3(1200.0f, -97.0f, 577.0f), 10.0f, true, 40.0f, GRAVITY_STANDARD, Rgba8(0, 0, 255)));
+	AddCoursePlanetoid(out_course, new SpherePLTD(Vec3(1205.0f, -98.0f, 586.0f), 10.0f, true, 40.0f, GRAVITY_STANDARD, Rgba8(85, 0, 255)));
+	AddCoursePlanetoid(out_course, new SpherePLTD(Vec3(1210.0f, -100.0f, 594.0f), 10.0f, true, 40.0f, GRAVITY_STANDARD, Rgba8(170, 0, 255)));
+	AddCoursePlanetoid(out_course, new SpherePLTD(Vec3(1215.0f, -103.0f, 601.0f), 10.0f, true, 40.0f, GRAVITY_STANDARD, Rgba8(255, 0, 255)));
+	AddCoursePlanetoid(out_course, new SpherePLTD(Vec3(1220.0f, -108.0f, 606.0f), 10.0f, true, 40.0f, GRAVITY_STANDARD, Rgba8(255, 0, 170)));
+	AddCoursePlanetoid(out_course, new SpherePLTD(Vec3(1225.0f, -108.0f, 611.0f), 10.0f, true, 40.0f, GRAVITY_STANDARD, Rgba8(255, 0, 85)));
+	AddCoursePlanetoid(out_course, new SpherePLTD(Vec3(1325.0f, -108.0f, 711.0f), 110.0f, true, 160.0f, GRAVITY_STANDARD, Rgba8()));
+	textTransform = Mat44::CreateTranslation3D(Vec3(1325.0f, -108.0f, 826.0f));
+	textTransform.AppendZRotation(180.0f);
+	AddCourseSign(out_course, "You made it to the end! Congrats!", textTransform);
+}
+
+
+void LoadPlaytestCourse(PlaytestCourse& out_course)
+{
+	if (!ReadLevelFile(out_course, PLAYTEST_COURSE_LEVEL_PATH))
+	{
+		BuildPlaytestCourse(out_course);
+	}
+}
+
+
+//
+//trigger functions
+//
+bool StepPlaytestTriggers(Player& player, std::vector<AABB3> const& checkpoints, PlaytestProgress& inout_progress)
+{
+	Vec3& pos = player.m_position;
+
+	//teleport player to playtest course when they enter the starting area
+	if (!inout_progress.m_inPlaytestCourse && GetDistanceSquared3D(pos, PLAYTEST_ENTER_ZONE) < 5.0f)
+	{
+		inout_progress.m_inPlaytestCourse = true;
+		pos = PLAYTEST_STARTING_POINT;
+		player.m_orientation = Mat44();
+		player.SnapRenderState();
+	}
+
+	if (!inout_progress.m_inPlaytestCourse)
+	{
+		return false;
+	}
+
+	//for playtest course, update checkpoints
+	bool reachedCheckpoint = false;
+	for (int cpIndex = 0; cpIndex < checkpoints.size(); cpIndex++)
+	{
+		AABB3 const& cp = checkpoints[cpIndex];
+
+		Vec3 nearestPoint = GetNearestPointOnAABB3D(pos, cp);
+		if (IsPointInsideSphere3D(nearestPoint, pos, player.m_collisionRadius) && inout_progress.m_checkpointIndex != cpIndex)
+		{
+			inout_progress.m_checkpointIndex = cpIndex;
+			player.m_respawnPosition = cp.GetCenter();
+			reachedCheckpoint = true;
+		}
+	}
+
+	return reachedCheckpoint;
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include "Engine/Math/Mat44.hpp"
+#include "Engine/Math/AABB3.hpp"
+#include "Engine/Math/Vec3.hpp"
+#include <string>
+#include <vector>
+
+
+//forward declarations
+class Planetoid;
+class Player;
+
+
+//world text the course puts up, only drawn when there's a renderer
+struct CourseSign
+{
+	std::string m_text;
+	Mat44		m_transform = Mat44();
+};
+
+
+//everything the playtest course or a level file spawns, built without a renderer so benchmarks can load it headless
+struct PlaytestCourse
+{
+	std::vector<Planetoid*>  m_planetoids;		//in spawn order, whoever takes them owns them
+	std::vector<AABB3>		 m_checkpoints;		//one per section, in section order
+	std::vector<CourseSign>  m_signs;
+};
+
+
+//how far through the course the player is, kept by whoever steps the player
+struct PlaytestProgress
+{
+	bool m_inPlaytestCourse = false;
+	int	 m_checkpointIndex = -1;	//index into the course's checkpoints, -1 before the first one
+};
+
+
+//constants
+constexpr char const* PLAYTEST_COURSE_LEVEL_PATH = "Data/Levels/PlaytestCourse.xml";
+Vec3 const			  PLAYTEST_ENTER_ZONE = Vec3(115.0f, 0.0f, 5.0f);			//touching this in the starting area teleports the player into the course
+Vec3 const			  PLAYTEST_STARTING_POINT = Vec3(250.0f, 0.0f, 11.5f);
+
+
+//course building functions
+void BuildPlaytestCourse(PlaytestCourse& out_course);
+void LoadPlaytestCourse(PlaytestCourse& out_course);	//from PLAYTEST_COURSE_LEVEL_PATH when it's there, built in code otherwise
+
+//trigger functions, run after every physics step so the game and headless replays hit the same triggers on the same ticks
+//returns true if the player reached a new checkpoint this step
+bool StepPlaytestTriggers(Player& player, std::vector<AABB3> const& checkpoints, PlaytestProgress& inout_progress);
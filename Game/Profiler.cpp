@@ -0,0 +1,189 @@
+#include "Game/Profiler.hpp"
+#include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+
+//only the owning thread writes its buffer, readers copy the slots behind the published count
+//a reader racing a writer that laps the ring can see one torn event, which a debug view can live with
+struct ProfileThreadBuffer
+{
+	int						m_threadIndex = 0;
+	int						m_depth = 0;
+	std::atomic<long long>	m_numEventsWritten{ 0 };
+	ProfileEvent			m_events[PROFILER_EVENTS_PER_THREAD];
+};
+
+
+//buffers are never freed, scopes can still close on worker threads while the app shuts down
+static std::mutex						  s_threadBuffersMutex;
+static std::vector<ProfileThreadBuffer*> s_threadBuffers;
+static thread_local ProfileThreadBuffer* t_threadBuffer = nullptr;
+
+//frame markers, only touched by the thread running the frame
+static ProfileThreadBuffer* s_frameThreadBuffer = nullptr;
+static long long s_frameStartNanoseconds = 0;
+static long long s_frameStartEventIndex = 0;
+static long long s_lastFrameStartNanoseconds = 0;
+static long long s_lastFrameEndNanoseconds = 0;
+static long long s_lastFrameFirstEventIndex = 0;
+static long long s_lastFrameEndEventIndex = 0;
+static float	 s_frameMilliseconds[PROFILER_FRAME_HISTORY] = {};
+static int		 s_numFramesProfiled = 0;
+
+
+static ProfileThreadBuffer* GetThreadBuffer()
+{
+	if (t_threadBuffer == nullptr)
+	{
+		t_threadBuffer = new ProfileThreadBuffer();
+
+		std::lock_guard<std::mutex> buffersLock(s_threadBuffersMutex);
+		t_threadBuffer->m_threadIndex = static_cast<int>(s_threadBuffers.size());
+		s_threadBuffers.emplace_back(t_threadBuffer);
+	}
+
+	return t_threadBuffer;
+}
+
+
+//
+//profile scope functions
+//
+ProfileScope::ProfileScope(char const* name)
+	: m_name(name)
+{
+	GetThreadBuffer()->m_depth++;
+	m_startNanoseconds = GetProfilerTimeNanoseconds();
+}
+
+
+ProfileScope::~ProfileScope()
+{
+	long long endNanoseconds = GetProfilerTimeNanoseconds();
+
+	ProfileThreadBuffer* buffer = t_threadBuffer;
+	buffer->m_depth--;
+
+	long long eventIndex = buffer->m_numEventsWritten.load(std::memory_order_relaxed);
+	ProfileEvent& event = buffer->m_events[eventIndex % PROFILER_EVENTS_PER_THREAD];
+	event.m_name = m_name;
+	event.m_startNanoseconds = m_startNanoseconds;
+	event.m_endNanoseconds = endNanoseconds;
+	event.m_depth = buffer->m_depth;
+	buffer->m_numEventsWritten.store(eventIndex + 1, std::memory_order_release);
+}
+
+
+//
+//profiler functions
+//
+long long GetProfilerTimeNanoseconds()
+{
+	static std::chrono::steady_clock::time_point const startTime = std::chrono::steady_clock::now();
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+
+void ProfilerBeginFrame()
+{
+	s_frameThreadBuffer = GetThreadBuffer();
+	s_frameStartEventIndex = s_frameThreadBuffer->m_numEventsWritten.load(std::memory_order_relaxed);
+	s_frameStartNanoseconds = GetProfilerTimeNanoseconds();
+}
+
+
+void ProfilerEndFrame()
+{
+	if (s_frameThreadBuffer == nullptr)
+	{
+		return;
+	}
+
+	s_lastFrameStartNanoseconds = s_frameStartNanoseconds;
+	s_lastFrameEndNanoseconds = GetProfilerTimeNanoseconds();
+	s_lastFrameFirstEventIndex = s_frameStartEventIndex;
+	s_lastFrameEndEventIndex = s_frameThreadBuffer->m_numEventsWritten.load(std::memory_order_relaxed);
+
+	s_frameMilliseconds[s_numFramesProfiled % PROFILER_FRAME_HISTORY] = static_cast<float>(s_lastFrameEndNanoseconds - s_lastFrameStartNanoseconds) * 0.000001f;
+	s_numFramesProfiled++;
+}
+
+
+bool GetLastProfiledFrame(ProfiledFrame& out_frame)
+{
+	out_frame.m_events.clear();
+	if (s_frameThreadBuffer == nullptr || s_numFramesProfiled == 0)
+	{
+		return false;
+	}
+
+	out_frame.m_startNanoseconds = s_lastFrameStartNanoseconds;
+	out_frame.m_endNanoseconds = s_lastFrameEndNanoseconds;
+
+	//a frame that closed more scopes than the ring holds only keeps its newest ones
+	long long numEventsWritten = s_frameThreadBuffer->m_numEventsWritten.load(std::memory_order_acquire);
+	long long firstEventIndex = std::max(s_lastFrameFirstEventIndex, numEventsWritten - PROFILER_EVENTS_PER_THREAD);
+	for (long long eventIndex = firstEventIndex; eventIndex < s_lastFrameEndEventIndex; eventIndex++)
+	{
+		out_frame.m_events.emplace_back(s_frameThreadBuffer->m_events[eventIndex % PROFILER_EVENTS_PER_THREAD]);
+	}
+
+	//scopes are written as they close, sort them back into the order they opened
+	std::sort(out_frame.m_events.begin(), out_frame.m_events.end(), [](ProfileEvent const& a, ProfileEvent const& b)
+		{
+			if (a.m_startNanoseconds != b.m_startNanoseconds) return a.m_startNanoseconds < b.m_startNanoseconds;
+			return a.m_depth < b.m_depth;
+		});
+	return true;
+}
+
+
+void GetProfiledFrameHistory(std::vector<float>& out_frameMilliseconds)
+{
+	out_frameMilliseconds.clear();
+
+	//oldest first
+	int numFrames = std::min(s_numFramesProfiled, PROFILER_FRAME_HISTORY);
+	for (int frameIndex = s_numFramesProfiled - numFrames; frameIndex < s_numFramesProfiled; frameIndex++)
+	{
+		out_frameMilliseconds.emplace_back(s_frameMilliseconds[frameIndex % PROFILER_FRAME_HISTORY]);
+	}
+}
+
+
+//writes whatever each thread's ring still holds in the chrome trace event format, for chrome://tracing or perfetto
+bool WriteProfilerChromeTrace(std::string const& filePath)
+{
+	std::vector<ProfileThreadBuffer*> threadBuffers;
+	{
+		std::lock_guard<std::mutex> buffersLock(s_threadBuffersMutex);
+		threadBuffers = s_threadBuffers;
+	}
+
+	std::string trace = "{\"traceEvents\":[\n";
+	bool isFirstEvent = true;
+	for (int bufferIndex = 0; bufferIndex < threadBuffers.size(); bufferIndex++)
+	{
+		ProfileThreadBuffer const* buffer = threadBuffers[bufferIndex];
+		long long numEventsWritten = buffer->m_numEventsWritten.load(std::memory_order_acquire);
+		long long firstEventIndex = std::max(0LL, numEventsWritten - PROFILER_EVENTS_PER_THREAD);
+
+		for (long long eventIndex = firstEventIndex; eventIndex < numEventsWritten; eventIndex++)
+		{
+			ProfileEvent const& event = buffer->m_events[eventIndex % PROFILER_EVENTS_PER_THREAD];
+
+			//chrome wants microseconds
+			trace += Stringf("%s{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":0,\"tid\":%i}", isFirstEvent ? "" : ",\n",
+				event.m_name, static_cast<double>(event.m_startNanoseconds) * 0.001, static_cast<double>(event.m_endNanoseconds - event.m_startNanoseconds) * 0.001, buffer->m_threadIndex);
+			isFirstEvent = false;
+		}
+	}
+	trace += "\n]}\n";
+
+	std::vector<uint8_t> outBuffer(trace.begin(), trace.end());
+	return FileWriteFromBuffer(outBuffer, filePath) > 0;
+}
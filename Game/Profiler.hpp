@@ -0,0 +1,66 @@
+#pragma once
+#include <string>
+#include <vector>
+
+
+//builds define GAME_PROFILER_ENABLED as 0 to compile every PROFILE_SCOPE out
+#if !defined(GAME_PROFILER_ENABLED)
+#define GAME_PROFILER_ENABLED 1
+#endif
+
+
+//constants
+constexpr int PROFILER_EVENTS_PER_THREAD = 65536;
+constexpr int PROFILER_FRAME_HISTORY = 240;
+
+
+//one closed scope, names are string literals so recording never allocates
+struct ProfileEvent
+{
+	char const* m_name = nullptr;
+	long long	m_startNanoseconds = 0;
+	long long	m_endNanoseconds = 0;
+	int			m_depth = 0;
+};
+
+
+//every scope the frame thread closed between two frame markers
+struct ProfiledFrame
+{
+	long long				  m_startNanoseconds = 0;
+	long long				  m_endNanoseconds = 0;
+	std::vector<ProfileEvent> m_events;
+};
+
+
+//times the block it lives in and writes it to the calling thread's ring buffer on the way out
+class ProfileScope
+{
+//public member functions
+public:
+	explicit ProfileScope(char const* name);
+	~ProfileScope();
+
+//private member variables
+private:
+	char const* m_name = nullptr;
+	long long	m_startNanoseconds = 0;
+};
+
+
+#if GAME_PROFILER_ENABLED
+#define PROFILE_SCOPE_JOIN_INNER(a, b) a##b
+#define PROFILE_SCOPE_JOIN(a, b) PROFILE_SCOPE_JOIN_INNER(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_SCOPE_JOIN(profileScope_, __LINE__)(name)
+#else
+#define PROFILE_SCOPE(name)
+#endif
+
+
+//profiler functions
+long long GetProfilerTimeNanoseconds();
+void	  ProfilerBeginFrame();
+void	  ProfilerEndFrame();
+bool	  GetLastProfiledFrame(ProfiledFrame& out_frame);
+void	  GetProfiledFrameHistory(std::vector<float>& out_frameMilliseconds);
+bool	  WriteProfilerChromeTrace(std::string const& filePath);
@@ -0,0 +1,347 @@
+#include "Game/Simulation.hpp"
+#include "Game/Player.hpp"
+#include "Game/Planetoids.hpp"
+#include "Game/GravityFields.hpp"
+#include "Game/JobSystem.hpp"
+#include "Game/Profiler.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/AABB3.hpp"
+#include <algorithm>
+#include <chrono>
+
+
+//reads the time between calls to Lap, or nothing at all when it's off
+struct PhaseTimer
+{
+	bool								  m_isEnabled = false;
+	std::chrono::steady_clock::time_point m_lapStartTime;
+
+	explicit PhaseTimer(bool isEnabled) : m_isEnabled(isEnabled)
+	{
+		if (m_isEnabled) m_lapStartTime = std::chrono::steady_clock::now();
+	}
+
+	double Lap()
+	{
+		if (!m_isEnabled)
+		{
+			return 0.0;
+		}
+
+		std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		double seconds = std::chrono::duration<double>(now - m_lapStartTime).count();
+		m_lapStartTime = now;
+		return seconds;
+	}
+};
+
+
+//destructor
+Simulation::~Simulation()
+{
+	for (int scratchIndex = 0; scratchIndex < m_bodyScratch.size(); scratchIndex++)
+	{
+		delete m_bodyScratch[scratchIndex].m_standInPlayer;
+		m_bodyScratch[scratchIndex].m_standInPlayer = nullptr;
+	}
+}
+
+
+//
+//public simulation functions
+//
+void Simulation::StepPlayer(float deltaSeconds, PlayerCommand const& command)
+{
+	PROFILE_SCOPE("Simulation::StepPlayer");
+
+	Player* player = m_config.m_player;
+	PhaseTimer timer = PhaseTimer(m_isTimingPhases);
+
+	//update player
+	m_playerPositionLastStep = player->m_position;
+	player->UpdateTick(deltaSeconds, command);
+	m_lastPhaseTimes.m_playerTickSeconds = timer.Lap();
+
+	//update gravity fields
+	ApplyGravity();
+	m_lastPhaseTimes.m_applyGravitySeconds = timer.Lap();
+
+	//handle collision
+	CollidePlayerWithAllPlanetoids();
+	m_lastPhaseTimes.m_collisionSeconds = timer.Lap();
+}
+
+
+void Simulation::StepBodies(float deltaSeconds)
+{
+	PROFILE_SCOPE("Simulation::StepBodies");
+
+	if (m_bodyPositions.empty())
+	{
+		return;
+	}
+
+	if (m_isGravityFieldBVHDirty)
+	{
+		RebuildGravityFieldBVH();
+	}
+
+	if (m_isPlanetoidBVHDirty)
+	{
+		RebuildPlanetoidBVH();
+	}
+
+	JobSystem* jobSystem = m_config.m_jobSystem;
+	int numThreads = (jobSystem != nullptr) ? jobSystem->GetNumThreads() : 1;
+	while (m_bodyScratch.size() < numThreads)
+	{
+		m_bodyScratch.emplace_back(GravityBodyScratch());
+		m_bodyScratch.back().m_standInPlayer = new Player(nullptr);
+	}
+
+	//bodies only read the fields and planetoids and only write their own entries, so chunks can run on any thread in any order
+	int numBodies = static_cast<int>(m_bodyPositions.size());
+	if (jobSystem == nullptr)
+	{
+		StepGravityBodies(0, numBodies, deltaSeconds, m_bodyScratch[0]);
+		return;
+	}
+
+	jobSystem->ParallelFor(numBodies, GRAVITY_BODIES_PER_JOB, [this, deltaSeconds](int firstBody, int numBodiesInChunk, int threadIndex)
+		{
+			StepGravityBodies(firstBody, numBodiesInChunk, deltaSeconds, m_bodyScratch[threadIndex]);
+		});
+}
+
+
+void Simulation::MarkPlanetoidsDirty()
+{
+	m_isGravityFieldBVHDirty = true;
+	m_isPlanetoidBVHDirty = true;
+}
+
+
+void Simulation::ForgetGravitySource(GravityField const* field)
+{
+	if (field == nullptr)
+	{
+		return;
+	}
+
+	Player* player = m_config.m_player;
+	if (player != nullptr && player->m_currentGravitySource == field)
+	{
+		player->m_currentGravitySource = nullptr;
+	}
+
+	for (int bodyIndex = 0; bodyIndex < m_bodyStates.size(); bodyIndex++)
+	{
+		if (m_bodyStates[bodyIndex].m_gravitySource == field)
+		{
+			m_bodyStates[bodyIndex].m_gravitySource = nullptr;
+		}
+	}
+}
+
+
+//
+//public gravity body functions
+//
+void Simulation::ReserveGravityBodies(int numBodies)
+{
+	m_bodyPositions.reserve(numBodies);
+	m_bodyVelocities.reserve(numBodies);
+	m_bodyRadii.reserve(numBodies);
+	m_bodyStates.reserve(numBodies);
+}
+
+
+void Simulation::AddGravityBody(Vec3 const& position, float collisionRadius)
+{
+	m_bodyPositions.emplace_back(position);
+	m_bodyVelocities.emplace_back(Vec3());
+	m_bodyRadii.emplace_back(collisionRadius);
+	m_bodyStates.emplace_back(GravityBodyState());
+}
+
+
+void Simulation::ClearGravityBodies()
+{
+	m_bodyPositions.clear();
+	m_bodyVelocities.clear();
+	m_bodyRadii.clear();
+	m_bodyStates.clear();
+}
+
+
+//
+//gravity management functions
+//
+void Simulation::ApplyGravity()
+{
+	PROFILE_SCOPE("Simulation::ApplyGravity");
+
+	Player* player = m_config.m_player;
+	std::vector<Planetoid*> const& planetoids = *m_config.m_planetoids;
+
+	if (m_isGravityFieldBVHDirty)
+	{
+		RebuildGravityFieldBVH();
+	}
+
+	if (m_useGravityFieldStore)
+	{
+		m_gravityFieldStore.ApplyGravity(player);
+		m_numGravityFieldCandidates = m_gravityFieldStore.GetNumFields();
+		return;
+	}
+
+	//only fields whose bounds overlap the player can affect them
+	m_gravityFieldCandidates.clear();
+	m_gravityFieldBVH.QuerySphere(player->m_position, player->m_collisionRadius, m_gravityFieldCandidates);
+
+	//Player::SetGravitySource keeps the first of two equally close sources, so fields must still be applied in spawn order
+	std::sort(m_gravityFieldCandidates.begin(), m_gravityFieldCandidates.end());
+	m_numGravityFieldCandidates = static_cast<int>(m_gravityFieldCandidates.size());
+
+	for (int candidateIndex = 0; candidateIndex < m_gravityFieldCandidates.size(); candidateIndex++)
+	{
+		int pltdIndex = m_gravityFieldPltdIndexes[m_gravityFieldCandidates[candidateIndex]];
+		planetoids[pltdIndex]->m_field->ApplyGravity(player);
+	}
+}
+
+
+void Simulation::RebuildGravityFieldBVH()
+{
+	std::vector<Planetoid*> const& planetoids = *m_config.m_planetoids;
+	std::vector<AABB3> fieldBounds;
+	m_gravityFieldPltdIndexes.clear();
+
+	for (int pltdIndex = 0; pltdIndex < planetoids.size(); pltdIndex++)
+	{
+		if (planetoids[pltdIndex] != nullptr && planetoids[pltdIndex]->m_field != nullptr)
+		{
+			fieldBounds.emplace_back(planetoids[pltdIndex]->m_field->GetWorldBounds());
+			m_gravityFieldPltdIndexes.emplace_back(pltdIndex);
+		}
+	}
+
+	m_gravityFieldBVH.Build(fieldBounds);
+	m_gravityFieldStore.Build(planetoids);
+	m_isGravityFieldBVHDirty = false;
+}
+
+
+//
+//collision handling functions
+//
+void Simulation::CollidePlayerWithAllPlanetoids()
+{
+	PROFILE_SCOPE("Simulation::CollidePlayerWithAllPlanetoids");
+
+	Player* player = m_config.m_player;
+	std::vector<Planetoid*> const& planetoids = *m_config.m_planetoids;
+
+	if (m_isPlanetoidBVHDirty)
+	{
+		RebuildPlanetoidBVH();
+	}
+
+	//sweep the player's sphere from the last step's position so fast movement can't skip past a planetoid's bounds
+	float radius = player->m_collisionRadius;
+	Vec3 radiusVector = Vec3(radius, radius, radius);
+	AABB3 sweptBounds = AABB3(m_playerPositionLastStep - radiusVector, m_playerPositionLastStep + radiusVector);
+	BoundingVolumeHierarchy::StretchToIncludeAABB3D(sweptBounds, AABB3(player->m_position - radiusVector, player->m_position + radiusVector));
+
+	m_collisionCandidates.clear();
+	m_planetoidBVH.QueryAABB(sweptBounds, m_collisionCandidates);
+
+	//keep spawn order so overlapping planetoids push the player in the same order as before
+	std::sort(m_collisionCandidates.begin(), m_collisionCandidates.end());
+	m_numCollisionCandidates = static_cast<int>(m_collisionCandidates.size());
+
+	for (int candidateIndex = 0; candidateIndex < m_collisionCandidates.size(); candidateIndex++)
+	{
+		int pltdIndex = m_planetoidPltdIndexes[m_collisionCandidates[candidateIndex]];
+		planetoids[pltdIndex]->CollideWithPlayer(player, m_nearbyItems);
+	}
+}
+
+
+void Simulation::RebuildPlanetoidBVH()
+{
+	std::vector<Planetoid*> const& planetoids = *m_config.m_planetoids;
+	std::vector<AABB3> planetoidBounds;
+	m_planetoidPltdIndexes.clear();
+
+	for (int pltdIndex = 0; pltdIndex < planetoids.size(); pltdIndex++)
+	{
+		if (planetoids[pltdIndex] != nullptr)
+		{
+			planetoidBounds.emplace_back(planetoids[pltdIndex]->m_worldBounds);
+			m_planetoidPltdIndexes.emplace_back(pltdIndex);
+		}
+	}
+
+	m_planetoidBVH.Build(planetoidBounds);
+	m_isPlanetoidBVHDirty = false;
+}
+
+
+//
+//gravity body sub-functions
+//
+void Simulation::StepGravityBodies(int firstBody, int numBodies, float deltaSeconds, GravityBodyScratch& scratch)
+{
+	for (int bodyIndex = firstBody; bodyIndex < firstBody + numBodies; bodyIndex++)
+	{
+		m_gravityFieldStore.ApplyGravityToBody(m_bodyPositions[bodyIndex], m_bodyRadii[bodyIndex], m_bodyStates[bodyIndex], *scratch.m_standInPlayer, scratch.m_hits);
+
+		m_bodyVelocities[bodyIndex] += m_bodyStates[bodyIndex].m_gravityVector * deltaSeconds;
+		m_bodyPositions[bodyIndex] += m_bodyVelocities[bodyIndex] * deltaSeconds;
+
+		CollideBodyWithAllPlanetoids(bodyIndex, scratch);
+	}
+}
+
+
+void Simulation::CollideBodyWithAllPlanetoids(int bodyIndex, GravityBodyScratch& scratch)
+{
+	std::vector<Planetoid*> const& planetoids = *m_config.m_planetoids;
+	Vec3& bodyPosition = m_bodyPositions[bodyIndex];
+	float radius = m_bodyRadii[bodyIndex];
+	Vec3 radiusVector = Vec3(radius, radius, radius);
+
+	scratch.m_collisionCandidates.clear();
+	m_planetoidBVH.QueryAABB(AABB3(bodyPosition - radiusVector, bodyPosition + radiusVector), scratch.m_collisionCandidates);
+	if (scratch.m_collisionCandidates.empty())
+	{
+		return;
+	}
+
+	std::sort(scratch.m_collisionCandidates.begin(), scratch.m_collisionCandidates.end());
+
+	//CollideWithPlayer only moves the player it's given, so the body is pushed through a stand-in player
+	Player& bodyPlayer = *scratch.m_standInPlayer;
+	bodyPlayer.m_position = bodyPosition;
+	bodyPlayer.m_collisionRadius = radius;
+	for (int candidateIndex = 0; candidateIndex < scratch.m_collisionCandidates.size(); candidateIndex++)
+	{
+		int pltdIndex = m_planetoidPltdIndexes[scratch.m_collisionCandidates[candidateIndex]];
+		planetoids[pltdIndex]->CollideWithPlayer(&bodyPlayer, scratch.m_nearbyItems);
+	}
+
+	//stop moving into whatever pushed the body out
+	if (GetDistanceSquared3D(bodyPlayer.m_position, bodyPosition) > 0.0f)
+	{
+		Vec3 pushDirection = (bodyPlayer.m_position - bodyPosition).GetNormalized();
+		float speedIntoSurface = DotProduct3D(m_bodyVelocities[bodyIndex], pushDirection);
+		if (speedIntoSurface < 0.0f)
+		{
+			m_bodyVelocities[bodyIndex] -= pushDirection * speedIntoSurface;
+		}
+	}
+
+	bodyPosition = bodyPlayer.m_position;
+}
@@ -0,0 +1,124 @@
+#pragma once
+#include "Game/BoundingVolumeHierarchy.hpp"
+#include "Game/GravityFieldStore.hpp"
+#include "Engine/Math/Vec3.hpp"
+#include <vector>
+
+
+//forward declarations
+class  Planetoid;
+class  Player;
+class  JobSystem;
+struct PlayerCommand;
+
+
+//constants
+constexpr int GRAVITY_BODIES_PER_JOB = 256;
+
+
+//per thread scratch space for stepping gravity bodies, so chunks on different threads never share a buffer
+struct GravityBodyScratch
+{
+	std::vector<GravityFieldHit> m_hits;
+	std::vector<int>			 m_collisionCandidates;
+	std::vector<int>			 m_nearbyItems;				//narrow phase scratch passed to CollideWithPlayer
+	Player*						 m_standInPlayer = nullptr;	//carries a body through code that only takes a Player
+};
+
+
+//seconds each part of the last StepPlayer took, only measured while phase timing is on
+struct SimulationPhaseTimes
+{
+	double m_playerTickSeconds = 0.0;	//Player::UpdateTick, which runs UpdatePhysics
+	double m_applyGravitySeconds = 0.0;
+	double m_collisionSeconds = 0.0;
+};
+
+
+struct SimulationConfig
+{
+	std::vector<Planetoid*> const* m_planetoids = nullptr;	//owned by whoever spawns them, call MarkPlanetoidsDirty after changing it
+	Player*						   m_player = nullptr;
+	JobSystem*					   m_jobSystem = nullptr;	//bodies are stepped on the calling thread without one
+};
+
+
+//gravity, collision and gravity bodies for one world, with no renderer or input so it can also run headless
+class Simulation
+{
+//public member functions
+public:
+	//constructor and destructor
+	explicit Simulation(SimulationConfig const& config) : m_config(config) {}
+	~Simulation();
+
+	//simulation functions
+	void StepPlayer(float deltaSeconds, PlayerCommand const& command);
+	void StepBodies(float deltaSeconds);
+	void MarkPlanetoidsDirty();
+	void ForgetGravitySource(GravityField const* field);	//call before deleting a field, so a new field at the same address isn't taken for it
+
+	//gravity body functions
+	void ReserveGravityBodies(int numBodies);
+	void AddGravityBody(Vec3 const& position, float collisionRadius);
+	void ClearGravityBodies();
+	int  GetNumGravityBodies() const { return static_cast<int>(m_bodyPositions.size()); }
+
+	//broad phase utilities
+	int GetNumGravityFieldCandidates() const { return m_numGravityFieldCandidates; }
+	int GetNumGravityFields() const { return m_gravityFieldBVH.GetNumItems(); }
+	int GetNumCollisionCandidates() const { return m_numCollisionCandidates; }
+	int GetNumCollidablePlanetoids() const { return m_planetoidBVH.GetNumItems(); }
+	GravityFieldStore const& GetGravityFieldStore() const { return m_gravityFieldStore; }
+	SimulationPhaseTimes const& GetLastPhaseTimes() const { return m_lastPhaseTimes; }
+
+//public member variables
+public:
+	bool m_useGravityFieldStore = false;	//scan every field with the store instead of querying the bvh
+	bool m_isTimingPhases = false;			//fill GetLastPhaseTimes each StepPlayer, off by default since it reads the clock three extra times a step
+
+	//gravity bodies, spheres with no controller that fall through the same fields as the player
+	std::vector<Vec3>			  m_bodyPositions;
+	std::vector<Vec3>			  m_bodyVelocities;
+	std::vector<float>			  m_bodyRadii;
+	std::vector<GravityBodyState> m_bodyStates;
+
+//private member functions
+private:
+	//gravity management functions
+	void ApplyGravity();
+	void RebuildGravityFieldBVH();
+
+	//collision management functions
+	void CollidePlayerWithAllPlanetoids();
+	void RebuildPlanetoidBVH();
+
+	//gravity body sub-functions
+	void StepGravityBodies(int firstBody, int numBodies, float deltaSeconds, GravityBodyScratch& scratch);
+	void CollideBodyWithAllPlanetoids(int bodyIndex, GravityBodyScratch& scratch);
+
+//private member variables
+private:
+	SimulationConfig m_config;
+
+	//broad phase variables
+	BoundingVolumeHierarchy m_gravityFieldBVH;
+	std::vector<int>		m_gravityFieldPltdIndexes;	//bvh item index to index in the planetoid list
+	std::vector<int>		m_gravityFieldCandidates;
+	bool					m_isGravityFieldBVHDirty = true;
+	GravityFieldStore		m_gravityFieldStore;		//rebuilt alongside the gravity field bvh
+	BoundingVolumeHierarchy m_planetoidBVH;
+	std::vector<int>		m_planetoidPltdIndexes;		//bvh item index to index in the planetoid list
+	std::vector<int>		m_collisionCandidates;
+	std::vector<int>		m_nearbyItems;				//the player's narrow phase scratch, bodies use their own thread's
+	bool					m_isPlanetoidBVHDirty = true;
+	Vec3					m_playerPositionLastStep = Vec3();
+
+	//broad phase counters
+	int m_numGravityFieldCandidates = 0;
+	int m_numCollisionCandidates = 0;
+	SimulationPhaseTimes m_lastPhaseTimes;
+
+	//one per job system thread
+	std::vector<GravityBodyScratch> m_bodyScratch;
+};
@@ -0,0 +1,348 @@
+#include "Game/WorldStreamer.hpp"
+#include "Game/Planetoids.hpp"
+#include "Game/JobSystem.hpp"
+#include "Game/Profiler.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include <algorithm>
+#include <map>
+#include <math.h>
+#include <thread>
+#include <tuple>
+
+
+//
+//local constants and helpers
+//
+enum StreamingCellState
+{
+	STREAMING_CELL_UNLOADED,
+	STREAMING_CELL_BUILDING,	//a job is constructing the analytic planetoids
+	STREAMING_CELL_BUILT,		//the job is done, waiting for Update to add the prefabs and hand them all over
+	STREAMING_CELL_LOADED,
+	NUM_STREAMING_CELL_STATES
+};
+
+
+//one cube of the world and the records of every planetoid whose position is in it
+struct StreamingCell
+{
+	AABB3							  m_bounds = AABB3(Vec3(), Vec3());
+	std::vector<LevelPlanetoidRecord> m_records;
+	std::vector<Planetoid*>			  m_planetoids;			//one slot per record while building, owned by the caller once loaded
+	std::atomic<StreamingCellState>	  m_state = STREAMING_CELL_UNLOADED;
+	bool							  m_isUnloadWanted = false;	//went out of range while building, thrown away once built
+	size_t							  m_residentBytes = 0;		//estimated from the records until it first loads, measured after
+};
+
+
+//quads each type's mesh is tessellated into, matching the AddVertsFor calls in Planetoids.cpp
+//wires are per segment, prefabs share their model asset so only the planetoid itself is counted for them
+static int const ESTIMATED_QUADS_PER_TYPE[NUM_LEVEL_PLANETOID_TYPES] =
+{
+	1,					//plane
+	64 * 32,			//sphere
+	(32 * 16) + 32,		//capsule, two hemispheres and the side
+	32 * 16,			//ellipsoid
+	32 * 16,			//rounded cube, the engine picks its own tessellation so this is a guess
+	16 * 32,			//torus
+	(2 * 8 * 32) + 32,	//bowl, inside, outside and rim
+	2 * 256,			//mobius strip, both faces
+	(32 * 16) + 32,		//wire, a capsule per segment
+	0, 0, 0, 0			//prefabs
+};
+
+
+//what a record will cost once built, the same measure as GetPlanetoidResidentBytes so the estimate and the measurement can be swapped
+//the indexed mesh keeps roughly a vertex per quad and six indexes for it
+static size_t GetEstimatedRecordBytes(LevelPlanetoidRecord const& record)
+{
+	if (record.m_type >= NUM_LEVEL_PLANETOID_TYPES)
+	{
+		return 0;
+	}
+
+	//the segment count is rolled when the wire is built, so it's counted at the most it could roll
+	size_t numQuads = static_cast<size_t>(ESTIMATED_QUADS_PER_TYPE[record.m_type]);
+	if (record.m_type == LEVEL_PLANETOID_WIRE)
+	{
+		numQuads *= static_cast<size_t>(std::max(record.m_params[4].m_int, 1));
+	}
+
+	size_t meshBytes = numQuads * (sizeof(Vertex_PCUTBN) + (6 * sizeof(unsigned int)));
+	return sizeof(Planetoid) + (2 * meshBytes);
+}
+
+
+//what a planetoid holds while it's loaded, its cpu mesh and about the same again in vertex and index buffers
+//prefab models are shared assets and meshes shared between identical planetoids are counted for each of them, so this runs high
+static size_t GetPlanetoidResidentBytes(Planetoid const& planetoid)
+{
+	size_t meshBytes = (planetoid.m_verts.size() * sizeof(Vertex_PCUTBN)) + (planetoid.m_indexes.size() * sizeof(unsigned int));
+	return sizeof(planetoid) + (2 * meshBytes);
+}
+
+
+//prefabs acquire their model from the asset registry, which is main thread only, so they're left for Update to construct
+static bool IsPrefabRecord(LevelPlanetoidRecord const& record)
+{
+	return record.m_type >= LEVEL_PLANETOID_TEAPOT && record.m_type <= LEVEL_PLANETOID_FORTRESS;
+}
+
+
+//runs on a job, only the analytic planetoids are built here and each keeps its record's slot so spawn order survives
+static void BuildCellAnalyticPlanetoids(StreamingCell& cell)
+{
+	PROFILE_SCOPE("WorldStreamer::BuildCellAnalyticPlanetoids");
+	cell.m_planetoids.assign(cell.m_records.size(), nullptr);
+	for (int recordIndex = 0; recordIndex < cell.m_records.size(); recordIndex++)
+	{
+		if (IsPrefabRecord(cell.m_records[recordIndex]))
+		{
+			continue;
+		}
+
+		Planetoid* planetoid = CreatePlanetoidFromRecord(cell.m_records[recordIndex]);
+		if (planetoid != nullptr)
+		{
+			planetoid->UpdateWorldBounds();
+			cell.m_planetoids[recordIndex] = planetoid;
+		}
+	}
+}
+
+
+//main thread, fills the prefab slots the job skipped and drops the slots of records that built nothing
+static void FinishBuildingCell(StreamingCell& cell)
+{
+	PROFILE_SCOPE("WorldStreamer::FinishBuildingCell");
+	for (int recordIndex = 0; recordIndex < cell.m_records.size(); recordIndex++)
+	{
+		if (!IsPrefabRecord(cell.m_records[recordIndex]))
+		{
+			continue;
+		}
+
+		Planetoid* planetoid = CreatePlanetoidFromRecord(cell.m_records[recordIndex]);
+		if (planetoid != nullptr)
+		{
+			planetoid->UpdateWorldBounds();
+			cell.m_planetoids[recordIndex] = planetoid;
+		}
+	}
+
+	cell.m_planetoids.erase(std::remove(cell.m_planetoids.begin(), cell.m_planetoids.end(), nullptr), cell.m_planetoids.end());
+}
+
+
+//
+//constructor and destructor
+//
+WorldStreamer::WorldStreamer(WorldStreamerConfig const& config, LevelDescription const& level)
+	: m_config(config)
+{
+	m_config.m_cellSize = std::max(m_config.m_cellSize, 1.0f);
+	m_config.m_unloadRadius = std::max(m_config.m_unloadRadius, m_config.m_loadRadius);
+
+	//cells only exist where there are planetoids, so empty space costs nothing
+	std::map<std::tuple<int, int, int>, StreamingCell*> cellsByCoords;
+	for (int recordIndex = 0; recordIndex < level.m_planetoids.size(); recordIndex++)
+	{
+		LevelPlanetoidRecord const& record = level.m_planetoids[recordIndex];
+		int cellX = static_cast<int>(floorf(record.m_position.x / m_config.m_cellSize));
+		int cellY = static_cast<int>(floorf(record.m_position.y / m_config.m_cellSize));
+		int cellZ = static_cast<int>(floorf(record.m_position.z / m_config.m_cellSize));
+
+		StreamingCell*& cell = cellsByCoords[std::make_tuple(cellX, cellY, cellZ)];
+		if (cell == nullptr)
+		{
+			cell = new StreamingCell();
+			Vec3 cellMins = Vec3(static_cast<float>(cellX), static_cast<float>(cellY), static_cast<float>(cellZ)) * m_config.m_cellSize;
+			cell->m_bounds = AABB3(cellMins, cellMins + Vec3(m_config.m_cellSize, m_config.m_cellSize, m_config.m_cellSize));
+			m_cells.emplace_back(cell);
+		}
+		cell->m_records.emplace_back(record);
+		cell->m_residentBytes += GetEstimatedRecordBytes(record);
+	}
+}
+
+
+WorldStreamer::~WorldStreamer()
+{
+	//a job still building has to finish before its cell goes away
+	while (m_numCellsBuilding > 0)
+	{
+		std::this_thread::yield();
+	}
+
+	//loaded cells' planetoids were handed over, built ones never were
+	for (int cellIndex = 0; cellIndex < m_cells.size(); cellIndex++)
+	{
+		StreamingCell* cell = m_cells[cellIndex];
+		if (cell->m_state == STREAMING_CELL_BUILT)
+		{
+			for (int pltdIndex = 0; pltdIndex < cell->m_planetoids.size(); pltdIndex++)
+			{
+				delete cell->m_planetoids[pltdIndex];
+			}
+		}
+		delete cell;
+	}
+	m_cells.clear();
+}
+
+
+//
+//streaming functions
+//
+void WorldStreamer::Update(Vec3 const& focusPosition, WorldStreamingChanges& out_changes)
+{
+	PROFILE_SCOPE("WorldStreamer::Update");
+
+	std::vector<std::pair<float, StreamingCell*>> loadedCells;
+	std::vector<std::pair<float, StreamingCell*>> cellsToLoad;
+	size_t buildingBytes = 0;
+	for (int cellIndex = 0; cellIndex < m_cells.size(); cellIndex++)
+	{
+		StreamingCell* cell = m_cells[cellIndex];
+		float distance = GetDistanceToCell(*cell, focusPosition);
+		StreamingCellState state = cell->m_state;
+
+		if (state == STREAMING_CELL_LOADED)
+		{
+			if (distance > m_config.m_unloadRadius) UnloadCell(*cell, out_changes);
+			else									loadedCells.emplace_back(distance, cell);
+		}
+		else if (state == STREAMING_CELL_UNLOADED && distance <= m_config.m_loadRadius)
+		{
+			cellsToLoad.emplace_back(distance, cell);
+		}
+		else if (state == STREAMING_CELL_BUILDING || state == STREAMING_CELL_BUILT)
+		{
+			cell->m_isUnloadWanted = distance > m_config.m_unloadRadius;
+			buildingBytes += cell->m_residentBytes;
+		}
+	}
+
+	//over budget, let go of the farthest cells first, the one the focus is in always stays
+	std::sort(loadedCells.begin(), loadedCells.end(), [](std::pair<float, StreamingCell*> const& a, std::pair<float, StreamingCell*> const& b) { return a.first > b.first; });
+	for (int loadedIndex = 0; loadedIndex < loadedCells.size() && m_residentBytes > m_config.m_budgetBytes; loadedIndex++)
+	{
+		if (loadedCells[loadedIndex].first > 0.0f)
+		{
+			UnloadCell(*loadedCells[loadedIndex].second, out_changes);
+		}
+	}
+
+	//nearest first, and a cell waits until its estimated or last measured cost fits, so the budget limits what starts building rather than only what's evicted
+	std::sort(cellsToLoad.begin(), cellsToLoad.end(), [](std::pair<float, StreamingCell*> const& a, std::pair<float, StreamingCell*> const& b) { return a.first < b.first; });
+	for (int loadIndex = 0; loadIndex < cellsToLoad.size(); loadIndex++)
+	{
+		StreamingCell* cell = cellsToLoad[loadIndex].second;
+		if (cellsToLoad[loadIndex].first > 0.0f && m_residentBytes + buildingBytes + cell->m_residentBytes > m_config.m_budgetBytes)
+		{
+			break;
+		}
+
+		buildingBytes += cell->m_residentBytes;
+		StartLoadingCell(*cell);
+	}
+
+	CollectBuiltCells(out_changes);
+}
+
+
+WorldStreamingStats WorldStreamer::GetStats() const
+{
+	WorldStreamingStats stats;
+	stats.m_numCells = static_cast<int>(m_cells.size());
+	stats.m_residentBytes = m_residentBytes;
+	for (int cellIndex = 0; cellIndex < m_cells.size(); cellIndex++)
+	{
+		StreamingCell const* cell = m_cells[cellIndex];
+		if (cell->m_state == STREAMING_CELL_LOADED)
+		{
+			stats.m_numLoadedCells++;
+			stats.m_numLoadedPlanetoids += static_cast<int>(cell->m_planetoids.size());
+		}
+		else if (cell->m_state != STREAMING_CELL_UNLOADED)
+		{
+			stats.m_numLoadingCells++;
+		}
+	}
+	return stats;
+}
+
+
+//
+//private streaming functions
+//
+void WorldStreamer::StartLoadingCell(StreamingCell& cell)
+{
+	cell.m_state = STREAMING_CELL_BUILDING;
+	cell.m_isUnloadWanted = false;
+	m_numCellsBuilding++;
+
+	StreamingCell* cellToBuild = &cell;
+	std::atomic<int>* numCellsBuilding = &m_numCellsBuilding;
+	auto buildJob = [cellToBuild, numCellsBuilding]()
+		{
+			BuildCellAnalyticPlanetoids(*cellToBuild);
+			cellToBuild->m_state = STREAMING_CELL_BUILT;
+			(*numCellsBuilding)--;
+		};
+
+	if (m_config.m_jobSystem != nullptr) m_config.m_jobSystem->SubmitBackgroundJob(buildJob);
+	else								 buildJob();
+}
+
+
+void WorldStreamer::UnloadCell(StreamingCell& cell, WorldStreamingChanges& out_changes)
+{
+	out_changes.m_planetoidsToRemove.insert(out_changes.m_planetoidsToRemove.end(), cell.m_planetoids.begin(), cell.m_planetoids.end());
+	cell.m_planetoids.clear();
+	m_residentBytes -= std::min(m_residentBytes, cell.m_residentBytes);
+	cell.m_state = STREAMING_CELL_UNLOADED;
+}
+
+
+void WorldStreamer::CollectBuiltCells(WorldStreamingChanges& out_changes)
+{
+	for (int cellIndex = 0; cellIndex < m_cells.size(); cellIndex++)
+	{
+		StreamingCell* cell = m_cells[cellIndex];
+		if (cell->m_state != STREAMING_CELL_BUILT)
+		{
+			continue;
+		}
+
+		//the focus moved away while it was building, nobody else has seen these so they can just go
+		if (cell->m_isUnloadWanted)
+		{
+			for (int pltdIndex = 0; pltdIndex < cell->m_planetoids.size(); pltdIndex++)
+			{
+				delete cell->m_planetoids[pltdIndex];
+			}
+			cell->m_planetoids.clear();
+			cell->m_isUnloadWanted = false;
+			cell->m_state = STREAMING_CELL_UNLOADED;
+			continue;
+		}
+
+		FinishBuildingCell(*cell);
+		cell->m_residentBytes = 0;
+		for (int pltdIndex = 0; pltdIndex < cell->m_planetoids.size(); pltdIndex++)
+		{
+			cell->m_residentBytes += GetPlanetoidResidentBytes(*cell->m_planetoids[pltdIndex]);
+		}
+		m_residentBytes += cell->m_residentBytes;
+
+		out_changes.m_planetoidsToAdd.insert(out_changes.m_planetoidsToAdd.end(), cell->m_planetoids.begin(), cell->m_planetoids.end());
+		cell->m_state = STREAMING_CELL_LOADED;
+	}
+}
+
+
+float WorldStreamer::GetDistanceToCell(StreamingCell const& cell, Vec3 const& position) const
+{
+	return GetDistance3D(position, GetNearestPointOnAABB3D(position, cell.m_bounds));
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include "Game/LevelFile.hpp"
+#include "Engine/Math/Vec3.hpp"
+#include <atomic>
+#include <vector>
+
+
+//forward declarations
+class  Planetoid;
+class  JobSystem;
+struct StreamingCell;
+
+
+//constants
+constexpr float	 WORLD_STREAMING_DEFAULT_CELL_SIZE = 250.0f;
+constexpr float	 WORLD_STREAMING_DEFAULT_LOAD_RADIUS = 600.0f;
+constexpr float	 WORLD_STREAMING_DEFAULT_UNLOAD_RADIUS = 800.0f;
+constexpr size_t WORLD_STREAMING_DEFAULT_BUDGET_BYTES = 256 * 1024 * 1024;
+
+
+struct WorldStreamerConfig
+{
+	JobSystem* m_jobSystem = nullptr;	//cells are built on the calling thread without one
+	float	   m_cellSize = WORLD_STREAMING_DEFAULT_CELL_SIZE;
+	float	   m_loadRadius = WORLD_STREAMING_DEFAULT_LOAD_RADIUS;		//cells closer than this are loaded, keep it well over the biggest planetoid and its field
+	float	   m_unloadRadius = WORLD_STREAMING_DEFAULT_UNLOAD_RADIUS;	//and only unloaded past this, so walking along a cell's edge doesn't load it over and over
+	size_t	   m_budgetBytes = WORLD_STREAMING_DEFAULT_BUDGET_BYTES;		//cells only start loading while their estimated meshes fit, and the farthest are let go if the real ones don't
+};
+
+
+//what changed in one Update, whoever owns the world adds and deletes these
+struct WorldStreamingChanges
+{
+	std::vector<Planetoid*> m_planetoidsToAdd;
+	std::vector<Planetoid*> m_planetoidsToRemove;
+};
+
+
+struct WorldStreamingStats
+{
+	int	   m_numCells = 0;
+	int	   m_numLoadedCells = 0;
+	int	   m_numLoadingCells = 0;
+	int	   m_numLoadedPlanetoids = 0;
+	size_t m_residentBytes = 0;
+};
+
+
+//splits a level into cells and builds each cell's analytic planetoids in the background as the focus gets near it
+//prefabs go through the main thread only model asset registry, so Update constructs those itself just before handing the cell over
+//built planetoids are handed over through Update, once handed over they belong to the caller until Update asks for them back
+class WorldStreamer
+{
+//public member functions
+public:
+	//constructor and destructor
+	WorldStreamer(WorldStreamerConfig const& config, LevelDescription const& level);
+	~WorldStreamer();
+
+	//streaming functions
+	void				Update(Vec3 const& focusPosition, WorldStreamingChanges& out_changes);
+	WorldStreamingStats GetStats() const;
+
+//private member functions
+private:
+	void  StartLoadingCell(StreamingCell& cell);
+	void  UnloadCell(StreamingCell& cell, WorldStreamingChanges& out_changes);
+	void  CollectBuiltCells(WorldStreamingChanges& out_changes);
+	float GetDistanceToCell(StreamingCell const& cell, Vec3 const& position) const;
+
+//private member variables
+private:
+	WorldStreamerConfig			m_config;
+	std::vector<StreamingCell*> m_cells;
+	std::atomic<int>			m_numCellsBuilding = 0;
+	size_t						m_residentBytes = 0;	//measured on the loaded cells' planetoids
+};